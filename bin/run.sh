@@ -19,6 +19,139 @@
 # * limitations under the License.
 # *
 
+# Usage: run.sh [--results FILE] [--baseline FILE] [--p50-threshold PERCENT] [--p99-threshold PERCENT]
+#               [--alloc-threshold COUNT] [--min-delta NS] [--allow-not-run] [--junit FILE] [--jobs N]
+#               [test binary arguments]
+#
+# --results writes the benchmark results to FILE (MOCA_BENCH_RESULTS), a copy of
+# it is a baseline. --baseline compares the results of the run against FILE and
+# fails when a benchmark regressed beyond the thresholds: its p50 or p99 latency
+# grew by more than the given percentage and by more than --min-delta ns, or its
+# heap allocations per call grew by more than --alloc-threshold. A benchmark of
+# the baseline the run did not produce fails it too, unless --allow-not-run is
+# given for a run limited to some of the tests.
+#
+# --junit writes a JUnit XML report of every test, with its wall clock, CPU
+# time and context switches, to FILE (MOCA_TEST_REPORT).
+#
+# --jobs runs the read only L1 tests in N forked workers at a time, auto for
+# one per online CPU (MOCA_TEST_JOBS).
+
+RESULTS=""
+BASELINE=""
+JUNIT=""
+JOBS=""
+P50_THRESHOLD=25
+P99_THRESHOLD=50
+ALLOC_THRESHOLD=0
+MIN_DELTA_NS=200
+ALLOW_NOT_RUN=0
+
+usage()
+{
+    echo "Usage: $0 [--results FILE] [--baseline FILE] [--p50-threshold PERCENT] [--p99-threshold PERCENT]"
+    echo "       [--alloc-threshold COUNT] [--min-delta NS] [--allow-not-run] [--junit FILE] [--jobs N]"
+    echo "       [test binary arguments]"
+    exit 2
+}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --results) [ $# -ge 2 ] || usage; RESULTS="$2"; shift 2 ;;
+        --baseline) [ $# -ge 2 ] || usage; BASELINE="$2"; shift 2 ;;
+        --p50-threshold) [ $# -ge 2 ] || usage; P50_THRESHOLD="$2"; shift 2 ;;
+        --p99-threshold) [ $# -ge 2 ] || usage; P99_THRESHOLD="$2"; shift 2 ;;
+        --alloc-threshold) [ $# -ge 2 ] || usage; ALLOC_THRESHOLD="$2"; shift 2 ;;
+        --min-delta) [ $# -ge 2 ] || usage; MIN_DELTA_NS="$2"; shift 2 ;;
+        --allow-not-run) ALLOW_NOT_RUN=1; shift ;;
+        --junit) [ $# -ge 2 ] || usage; JUNIT="$2"; shift 2 ;;
+        --jobs) [ $# -ge 2 ] || usage; JOBS="$2"; shift 2 ;;
+        --help) usage ;;
+        *) break ;;
+    esac
+done
+
+if [ -n "$BASELINE" ]; then
+    BASELINE="$(cd "$(dirname "$BASELINE")" && pwd)/$(basename "$BASELINE")"
+    if [ ! -r "$BASELINE" ]; then
+        echo "Baseline $BASELINE not readable"
+        exit 2
+    fi
+    [ -n "$RESULTS" ] || RESULTS="moca_bench_results.csv"
+fi
+if [ -n "$RESULTS" ]; then
+    RESULTS="$(cd "$(dirname "$RESULTS")" && pwd)/$(basename "$RESULTS")"
+    export MOCA_BENCH_RESULTS="$RESULTS"
+    # The file is only truncated by the first row written, a run writing none must not leave the last run's rows
+    rm -f "$RESULTS"
+fi
+if [ -n "$JUNIT" ]; then
+    export MOCA_TEST_REPORT="$(cd "$(dirname "$JUNIT")" && pwd)/$(basename "$JUNIT")"
+fi
+if [ -n "$JOBS" ]; then
+    export MOCA_TEST_JOBS="$JOBS"
+fi
+
 cd "$(dirname "$0")"
 export LD_LIBRARY_PATH=/usr/lib:/lib:/home/root:./
-./moca_hal_test $@
+./moca_hal_test "$@"
+STATUS=$?
+
+if [ -z "$BASELINE" ]; then
+    exit $STATUS
+fi
+if [ ! -r "$RESULTS" ]; then
+    echo "No benchmark results in $RESULTS, nothing compared against $BASELINE"
+    exit 1
+fi
+
+# Rows are keyed by test and name: p50_ns is field 6, p99_ns field 7, allocations_per_call field 10
+awk -F, -v p50="$P50_THRESHOLD" -v p99="$P99_THRESHOLD" -v allocs="$ALLOC_THRESHOLD" -v minDelta="$MIN_DELTA_NS" \
+    -v allowNotRun="$ALLOW_NOT_RUN" '
+function slower(current, base, percent)
+{
+    return current > base * (1 + percent / 100.0) && current - base > minDelta
+}
+FNR == 1 { next }
+NR == FNR {
+    key = $1 "," $2
+    baseP50[key] = $6; baseP99[key] = $7; baseAllocs[key] = $10
+    next
+}
+{
+    key = $1 "," $2
+    compared++
+    if (!(key in baseP50)) {
+        printf "[bench] new        %s: %s (p50 %d ns, p99 %d ns)\n", $1, $2, $6, $7
+        next
+    }
+    seen[key] = 1
+    if (slower($6 + 0, baseP50[key] + 0, p50)) {
+        printf "[bench] REGRESSION %s: %s p50 %d ns against %d ns, threshold %s%%\n", $1, $2, $6, baseP50[key], p50
+        regressions++
+    }
+    if (slower($7 + 0, baseP99[key] + 0, p99)) {
+        printf "[bench] REGRESSION %s: %s p99 %d ns against %d ns, threshold %s%%\n", $1, $2, $7, baseP99[key], p99
+        regressions++
+    }
+    if ($10 != "" && baseAllocs[key] != "" && $10 - baseAllocs[key] > allocs + 0) {
+        printf "[bench] REGRESSION %s: %s %s allocations per call against %s, threshold %s\n", $1, $2, $10, baseAllocs[key], allocs
+        regressions++
+    }
+}
+END {
+    for (key in baseP50) {
+        if (!(key in seen)) {
+            printf "[bench] not run    %s\n", key
+            notRun++
+        }
+    }
+    printf "[bench] %d results compared against the baseline, %d regressions, %d not run\n", compared, regressions, notRun
+    exit (regressions > 0 || (notRun > 0 && !allowNotRun)) ? 1 : 0
+}' "$BASELINE" "$RESULTS"
+COMPARE=$?
+
+if [ $STATUS -ne 0 ]; then
+    exit $STATUS
+fi
+exit $COMPARE
@@ -0,0 +1,151 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_counters.h
+*
+* 64 bit extension of the MoCA counters.
+*
+* The counters of moca_stats_t and moca_mac_counters_t are 32 bits wide on
+* most drivers, BytesReceived wraps in under 15 seconds on a saturated 2.5
+* Gbps link. A tracker reads them with moca_IfGetStats() and
+* moca_IfGetExtCounter() and keeps a 64 bit total, the change over the last
+* interval and its rate for every counter.
+*
+* A counter that went down either wrapped or was reset. moca_GetResetCount()
+* is read before and after the counters: when it changed the interface was
+* reset and every counter restarted from zero, otherwise a smaller value is one
+* wrap. More than one wrap between two samples cannot be told apart, so an
+* interface must be sampled at least once per wrap time of its fastest counter.
+*
+* Totals start from the first values read and never go down, across wraps and
+* resets. The traffic between the last sample before a reset and the reset
+* itself is lost.
+*
+* ExtAggrAvgTx and ExtAggrAvgRx are averages rather than counters and are not
+* tracked.
+*/
+
+#ifndef __MOCA_COUNTERS_H__
+#define __MOCA_COUNTERS_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_COUNTERS_DEFAULT_BITS    32
+
+/**
+* @brief Tracked counters, those of moca_stats_t followed by those of moca_mac_counters_t.
+*/
+typedef enum
+{
+  MOCA_COUNTER_BytesSent = 0,
+  MOCA_COUNTER_BytesReceived,
+  MOCA_COUNTER_PacketsSent,
+  MOCA_COUNTER_PacketsReceived,
+  MOCA_COUNTER_ErrorsSent,
+  MOCA_COUNTER_ErrorsReceived,
+  MOCA_COUNTER_UnicastPacketsSent,
+  MOCA_COUNTER_UnicastPacketsReceived,
+  MOCA_COUNTER_DiscardPacketsSent,
+  MOCA_COUNTER_DiscardPacketsReceived,
+  MOCA_COUNTER_MulticastPacketsSent,
+  MOCA_COUNTER_MulticastPacketsReceived,
+  MOCA_COUNTER_BroadcastPacketsSent,
+  MOCA_COUNTER_BroadcastPacketsReceived,
+  MOCA_COUNTER_UnknownProtoPacketsReceived,
+  MOCA_COUNTER_Map,
+  MOCA_COUNTER_Rsrv,
+  MOCA_COUNTER_Lc,
+  MOCA_COUNTER_Adm,
+  MOCA_COUNTER_Probe,
+  MOCA_COUNTER_Async,
+  MOCA_COUNTER_COUNT
+} moca_counter_t;
+
+#define MOCA_COUNTER_FIRST_MAC        MOCA_COUNTER_Map
+
+/**
+* @brief Tracking state of one interface, read the results from it after every sample.
+*/
+typedef struct
+{
+  ULONG ifIndex;
+  uint64_t mask;                              /**< Largest value of a counter */
+  BOOL haveSample;
+  BOOL haveMacCounters;                       /**< The MAC counters were read at least once */
+  ULONG resetCount;                           /**< moca_GetResetCount() at the last sample */
+  uint64_t timestampNs;                       /**< CLOCK_MONOTONIC time of the last sample */
+  uint64_t intervalNs;                        /**< Time between the last two samples */
+  ULONG raw[MOCA_COUNTER_COUNT];              /**< Values last read */
+  uint64_t total[MOCA_COUNTER_COUNT];         /**< 64 bit extended values */
+  uint64_t delta[MOCA_COUNTER_COUNT];         /**< Change over the last interval */
+  double rate[MOCA_COUNTER_COUNT];            /**< delta per second */
+  uint64_t wraps[MOCA_COUNTER_COUNT];
+  uint64_t samples;
+  uint64_t resets;                            /**< Samples that found the reset count changed */
+  uint64_t failures;                          /**< Samples that could not read the statistics */
+  uint64_t retries;                           /**< Reads repeated because a reset happened during them */
+} moca_counters_t;
+
+/**
+* @brief Starts tracking an interface.
+*
+* @param[out] pCounters   - State to initialise.
+* @param[in]  ifIndex     - Interface index.
+* @param[in]  counterBits - Width of the counters of the driver, 1 to the bits of ULONG, usually MOCA_COUNTERS_DEFAULT_BITS.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if counterBits is out of range.
+*/
+INT moca_counters_init(moca_counters_t *pCounters, ULONG ifIndex, uint32_t counterBits);
+
+/**
+* @brief Reads the reset count and the counters of the interface and updates the tracking state.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if the statistics or the reset count could not be read.
+*/
+INT moca_counters_sample(moca_counters_t *pCounters);
+
+/**
+* @brief Updates the tracking state from values read by the caller.
+*
+* @param[in] pCounters    - Tracking state.
+* @param[in] resetCount   - moca_GetResetCount() when the values were read.
+* @param[in] pStats       - Statistics.
+* @param[in] pMacCounters - MAC counters, NULL to leave them unchanged.
+* @param[in] timestampNs  - CLOCK_MONOTONIC time the values were read.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if a pointer is NULL.
+*/
+INT moca_counters_update(moca_counters_t *pCounters, ULONG resetCount, const moca_stats_t *pStats,
+                         const moca_mac_counters_t *pMacCounters, uint64_t timestampNs);
+
+/**
+* @brief Name of a counter, the field name in moca_hal.h.
+*/
+const char *moca_counters_name(moca_counter_t counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_COUNTERS_H__ */
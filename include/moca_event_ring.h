@@ -0,0 +1,187 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_event_ring.h
+*
+* Bounded lock-free queue of associated device events.
+*
+* The callback registered with moca_associatedDevice_callback_register() runs
+* in the notification context of the driver, so it should only copy the event
+* and return. moca_event_ring_push() does that in a few atomic operations,
+* without locks, allocations or system calls, and a consumer thread takes the
+* events out in batches with moca_event_ring_pop().
+*
+* Any number of threads may push, unless the ring is created with
+* MOCA_EVENT_RING_SINGLE_PRODUCER, and one thread pops. Each cell carries its
+* own sequence number (the bounded queue of D. Vyukov): producers claim a
+* position with a compare and swap on the tail and publish the cell by
+* advancing its sequence, so a producer preempted mid push delays the consumer
+* at that cell but never the other producers.
+*
+* An event that finds the ring full is dropped, never blocks the producer. The
+* drops are counted and handed to the consumer with the next batch, so it
+* knows to resynchronise, for example with moca_GetAssociatedDevices().
+*
+* A consumer with nothing to do sleeps in moca_event_ring_wait(), or polls the
+* eventfd of moca_event_ring_fd(). Producers only write to the eventfd when
+* the consumer announced it is going to sleep.
+*/
+
+#ifndef __MOCA_EVENT_RING_H__
+#define __MOCA_EVENT_RING_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_EVENT_RING_SINGLE_PRODUCER   0x1     /**< Only one thread pushes, no compare and swap needed */
+
+/**
+* @brief One associated device event.
+*/
+typedef struct
+{
+  uint64_t sequence;                    /**< Position in the ring, increases by one per event pushed */
+  uint64_t timestampNs;                 /**< CLOCK_MONOTONIC time of the push */
+  ULONG ifIndex;
+  moca_associated_device_t device;      /**< Copy of the device passed to the callback */
+} moca_device_event_t;
+
+/**
+* @brief Counters of a ring since it was created.
+*/
+typedef struct
+{
+  uint64_t pushed;
+  uint64_t popped;
+  uint64_t dropped;                     /**< Events that found the ring full */
+  uint64_t batches;                     /**< moca_event_ring_pop() calls that returned events */
+  uint64_t wakeups;                     /**< eventfd writes by producers */
+  uint64_t maxDepth;                    /**< Most events waiting, seen by the consumer */
+} moca_event_ring_stats_t;
+
+typedef struct moca_event_ring_cell_s moca_event_ring_cell_t;
+
+/**
+* @brief A ring, its members are private to moca_event_ring.c.
+*
+* The producer and consumer positions live on their own cache lines.
+*/
+typedef struct
+{
+  moca_event_ring_cell_t *pCells;
+  uint64_t mask;
+  uint32_t flags;
+  int eventFd;
+  __attribute__((aligned(64))) uint64_t tail;       /**< Next position to push */
+  uint64_t dropped;
+  uint64_t wakeups;
+  int sleeping;                                      /**< Consumer is in, or entering, moca_event_ring_wait() */
+  __attribute__((aligned(64))) uint64_t head;       /**< Next position to pop, consumer only */
+  uint64_t droppedReported;
+  uint64_t batches;
+  uint64_t maxDepth;
+} moca_event_ring_t;
+
+/**
+* @brief Creates a ring.
+*
+* @param[out] pRing    - Ring to initialise.
+* @param[in]  capacity - Events held, rounded up to a power of two, at least 2.
+* @param[in]  flags    - 0 or MOCA_EVENT_RING_SINGLE_PRODUCER.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if out of memory or no eventfd is available.
+*/
+INT moca_event_ring_create(moca_event_ring_t *pRing, uint32_t capacity, uint32_t flags);
+
+/**
+* @brief Frees a ring, it must not be attached and no thread may use it any more.
+*/
+void moca_event_ring_destroy(moca_event_ring_t *pRing);
+
+uint32_t moca_event_ring_capacity(const moca_event_ring_t *pRing);
+
+/**
+* @brief Copies an event into the ring.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if the ring is full and the event was dropped.
+*/
+INT moca_event_ring_push(moca_event_ring_t *pRing, ULONG ifIndex, const moca_associated_device_t *pDevice);
+
+/**
+* @brief Takes up to maxEvents events out of the ring, oldest first, consumer thread only.
+*
+* @param[in]  pRing     - Ring to read.
+* @param[out] pEvents   - Receives the events.
+* @param[in]  maxEvents - Size of pEvents.
+* @param[out] pDropped  - Receives the events dropped since the previous call, may be NULL.
+*
+* @return Number of events copied, 0 if the ring is empty.
+*/
+uint32_t moca_event_ring_pop(moca_event_ring_t *pRing, moca_device_event_t *pEvents, uint32_t maxEvents,
+                             uint64_t *pDropped);
+
+/**
+* @brief Sleeps until the ring holds an event, consumer thread only.
+*
+* @param[in] timeoutMs - Longest time to sleep, -1 for no limit.
+*
+* @return STATUS_SUCCESS if an event is waiting, STATUS_FAILURE on timeout.
+*/
+INT moca_event_ring_wait(moca_event_ring_t *pRing, int timeoutMs);
+
+/**
+* @brief Eventfd written when an event is pushed while the consumer sleeps.
+*
+* A consumer polling it with its own loop must call moca_event_ring_arm() before poll(2), and pop when it returns
+* FALSE instead of sleeping.
+*/
+int moca_event_ring_fd(const moca_event_ring_t *pRing);
+
+/**
+* @brief Announces the consumer is going to sleep.
+*
+* @return TRUE if the ring is empty and the consumer may sleep, FALSE if events arrived meanwhile.
+*/
+BOOL moca_event_ring_arm(moca_event_ring_t *pRing);
+
+void moca_event_ring_get_stats(moca_event_ring_t *pRing, moca_event_ring_stats_t *pStats);
+
+/**
+* @brief Registers a callback with moca_associatedDevice_callback_register() that pushes every event into pRing.
+*
+* One ring can be attached at a time, attaching another replaces it.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if pRing is NULL.
+*/
+INT moca_event_ring_attach(moca_event_ring_t *pRing);
+
+/**
+* @brief Unregisters the callback and waits for a call in progress to return, the ring can then be destroyed.
+*/
+void moca_event_ring_detach(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_EVENT_RING_H__ */
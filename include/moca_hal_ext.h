@@ -0,0 +1,300 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_ext.h
+*
+* Proposed extensions to the MoCA HAL interface.
+*
+* The skeleton implements every extension natively. For vendor libraries that
+* do not provide them yet, src/moca_hal_ext.c supplies weak fallbacks built
+* from the standard moca_hal.h calls, so the suites link and run on any target
+* but only a native implementation delivers the intended savings. The fallback
+* of moca_GetFlowStatisticsPage() always fails, moca_GetFlowStatistics() takes
+* no capacity and cannot be made to read a bounded page.
+*/
+
+#ifndef __MOCA_HAL_EXT_H__
+#define __MOCA_HAL_EXT_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Full telemetry of one interface captured at a single instant.
+*/
+typedef struct
+{
+  moca_stats_t stats;                             /**< As returned by moca_IfGetStats() */
+  moca_mac_counters_t macCounters;                /**< As returned by moca_IfGetExtCounter() */
+  moca_aggregate_counters_t aggregateCounters;    /**< As returned by moca_IfGetExtAggrCounter() */
+  moca_dynamic_info_t dynamicInfo;                /**< As returned by moca_IfGetDynamicInfo() */
+  uint64_t timestampNs;                           /**< CLOCK_MONOTONIC time all fields were sampled at */
+} moca_telemetry_snapshot_t;
+
+/**
+* @brief Reads the statistics, MAC counters, aggregate counters and dynamic information of an interface in one call.
+*
+* Replaces the sequence moca_IfGetStats(), moca_IfGetExtCounter(), moca_IfGetExtAggrCounter(),
+* moca_IfGetDynamicInfo() with a single driver round trip. All fields are sampled at timestampNs.
+*
+* @param[in]  ifIndex   - Index of the MoCA interface.
+* @param[out] pSnapshot - Receives the snapshot.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful.
+* @retval STATUS_FAILURE if ifIndex is invalid, pSnapshot is NULL or any part could not be read.
+*/
+INT moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot);
+
+/**
+* @brief Reads the associated devices of an interface into a caller owned buffer.
+*
+* Unlike moca_GetAssociatedDevices() the HAL allocates nothing, so a poller can reuse one buffer for every call.
+* A buffer of kMoca_MaxMocaNodes - 1 entries is always large enough. Calling with capacity 0 and pDevices NULL
+* queries the required capacity.
+*
+* The fallback for a HAL without this call reads the count with moca_GetNumAssociatedDevices() before and after
+* moca_GetAssociatedDevices(), whose array carries no length. It retries while the two counts differ and fails after
+* a few attempts, so only entries the HAL wrote are returned.
+*
+* @param[in]  ifIndex  - Index of the MoCA interface.
+* @param[out] pDevices - Buffer receiving one entry per associated device, may be NULL if capacity is 0.
+* @param[in]  capacity - Number of entries pDevices can hold.
+* @param[out] pCount   - Receives the number of entries written, or the required capacity if it is too small.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful.
+* @retval STATUS_FAILURE if ifIndex is invalid, pCount is NULL, pDevices is NULL with a non zero capacity
+*                        or capacity is smaller than the number of associated devices. The fallback also fails
+*                        if the associations keep changing while it reads them.
+*/
+INT moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount);
+
+/**
+* @brief Bit positions of the moca_stats_t counters in moca_stats_delta_t::changedMask.
+*/
+typedef enum
+{
+  MOCA_STATS_BYTES_SENT = 0,
+  MOCA_STATS_BYTES_RECEIVED,
+  MOCA_STATS_PACKETS_SENT,
+  MOCA_STATS_PACKETS_RECEIVED,
+  MOCA_STATS_ERRORS_SENT,
+  MOCA_STATS_ERRORS_RECEIVED,
+  MOCA_STATS_UNICAST_PACKETS_SENT,
+  MOCA_STATS_UNICAST_PACKETS_RECEIVED,
+  MOCA_STATS_DISCARD_PACKETS_SENT,
+  MOCA_STATS_DISCARD_PACKETS_RECEIVED,
+  MOCA_STATS_MULTICAST_PACKETS_SENT,
+  MOCA_STATS_MULTICAST_PACKETS_RECEIVED,
+  MOCA_STATS_BROADCAST_PACKETS_SENT,
+  MOCA_STATS_BROADCAST_PACKETS_RECEIVED,
+  MOCA_STATS_UNKNOWN_PROTO_PACKETS_RECEIVED,
+  MOCA_STATS_EXT_AGGR_AVG_TX,
+  MOCA_STATS_EXT_AGGR_AVG_RX,
+  MOCA_STATS_FIELD_COUNT
+} moca_stats_field_t;
+
+#define MOCA_STATS_FIELD_BIT(field)   (1UL << (field))
+#define MOCA_STATS_ALL_FIELDS         (MOCA_STATS_FIELD_BIT(MOCA_STATS_FIELD_COUNT) - 1)
+
+/**
+* @brief Statistics that changed since a generation, see moca_IfGetStatsChangedSince().
+*/
+typedef struct
+{
+  uint64_t generation;      /**< Generation of the statistics, pass it to the next call */
+  ULONG changedMask;        /**< MOCA_STATS_FIELD_BIT() of every counter that changed, 0 if none did */
+  moca_stats_t stats;       /**< Only the counters set in changedMask are written */
+} moca_stats_delta_t;
+
+/**
+* @brief Reads the statistics counters of an interface that changed since a generation.
+*
+* The HAL numbers every change of the statistics with an increasing generation. A poller keeps its own copy of
+* moca_stats_t, passes the generation returned by its previous call and copies the counters set in changedMask.
+* When nothing changed changedMask is 0 and no counter is written, which on an idle link makes the poll cheap.
+* Generation 0, or a generation the HAL did not hand out, returns every counter.
+*
+* @param[in]  ifIndex    - Index of the MoCA interface.
+* @param[in]  generation - Generation of the caller's copy, 0 if it has none.
+* @param[out] pDelta     - Receives the current generation and the changed counters.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful.
+* @retval STATUS_FAILURE if ifIndex is invalid or pDelta is NULL.
+*/
+INT moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta);
+
+#define MOCA_FLOW_CURSOR_START    0UL           /**< Cursor of the first page */
+#define MOCA_FLOW_CURSOR_END      (~0UL)        /**< Returned once every flow has been read */
+
+/**
+* @brief Reads the PQoS flow table of an interface one bounded page at a time.
+*
+* Unlike moca_GetFlowStatistics() the caller chooses the buffer size, so a table of any size is enumerated with a
+* fixed amount of memory. Flows are returned in increasing FlowID order. Start with MOCA_FLOW_CURSOR_START and pass
+* the returned cursor to the next call until it is MOCA_FLOW_CURSOR_END. Flows created or deleted during the
+* enumeration may or may not be returned, every other flow is returned exactly once.
+*
+* Only a HAL that implements this call natively can page. Without it the call returns STATUS_FAILURE, and the caller
+* is left with moca_GetFlowStatistics() and a buffer sized for the largest table the HAL may write.
+*
+* @param[in]  ifIndex     - Index of the MoCA interface.
+* @param[in]  cursor      - MOCA_FLOW_CURSOR_START or the cursor returned by the previous call.
+* @param[out] pFlows      - Buffer receiving up to capacity flows.
+* @param[in]  capacity    - Number of entries pFlows can hold, at least 1.
+* @param[out] pCount      - Receives the number of flows written, 0 if none remain.
+* @param[out] pNextCursor - Receives the cursor of the next page, MOCA_FLOW_CURSOR_END after the last flow.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful.
+* @retval STATUS_FAILURE if ifIndex is invalid, cursor is MOCA_FLOW_CURSOR_END, capacity is 0, a pointer is NULL
+*                        or the HAL does not implement paging.
+*/
+INT moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity,
+                               ULONG *pCount, ULONG *pNextCursor);
+
+/**
+* @brief Called once an ACA started by moca_startIfAcaAsync() ends.
+*
+* Runs on a HAL thread, not the caller's. The callback may call back into the HAL, including starting the next ACA.
+*
+* @param[in] interfaceIndex - Index of the MoCA interface the ACA ran on.
+* @param[in] pacaStat       - Final status, as moca_getIfAcaStatus() would return it once the ACA ended.
+* @param[in] pContext       - The pContext passed to moca_startIfAcaAsync().
+*/
+typedef void (*moca_aca_complete_callback)(int interfaceIndex, const moca_aca_stat_t *pacaStat, void *pContext);
+
+/**
+* @brief Starts an Alternate Channel Assessment and reports its end through a callback.
+*
+* Replaces moca_setIfAcaConfig() with ACAStart set followed by a moca_getIfAcaStatus() poll loop. Only one ACA runs
+* on an interface at a time. The callback is called exactly once: when the ACA completes, fails, is cancelled with
+* moca_cancelIfAca() or is replaced by one started with moca_setIfAcaConfig(). acaCfg.ACAStart is ignored, the ACA
+* is always started.
+*
+* @param[in] interfaceIndex - Index of the MoCA interface.
+* @param[in] acaCfg         - ACA configuration, as for moca_setIfAcaConfig().
+* @param[in] callback       - Called when the ACA ends, may be NULL to rely on moca_getIfAcaEventFd() only.
+* @param[in] pContext       - Passed to the callback.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if the ACA was started, the callback follows.
+* @retval STATUS_FAILURE if interfaceIndex or acaCfg is invalid or an ACA is already running or the callback of a replaced one is still pending, the callback is not called.
+*/
+int moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext);
+
+/**
+* @brief Returns an eventfd that becomes readable whenever an ACA of an interface ends.
+*
+* Lets an event loop wait for ACA results with poll(2), epoll(7) or select(2) next to its other descriptors. The
+* descriptor is signalled for ACAs started by moca_startIfAcaAsync() and by moca_setIfAcaConfig() alike. Reading it
+* returns, and clears, the number of ACAs that ended since the last read; moca_getIfAcaStatus() then returns the
+* result. The descriptor is non blocking and owned by the HAL, the caller must not close it.
+*
+* @param[in] interfaceIndex - Index of the MoCA interface.
+*
+* @return The file descriptor, or -1 if interfaceIndex is invalid or the HAL does not support notification.
+*/
+int moca_getIfAcaEventFd(int interfaceIndex);
+
+/**
+* @brief Bit positions of the moca_cfg_t fields in the masks of moca_SetIfConfigFields().
+*/
+typedef enum
+{
+  MOCA_CFG_INSTANCE_NUMBER = 0,
+  MOCA_CFG_ALIAS,
+  MOCA_CFG_ENABLED,
+  MOCA_CFG_PREFERRED_NC,
+  MOCA_CFG_PRIVACY_ENABLED,
+  MOCA_CFG_FREQ_CURRENT_MASK,
+  MOCA_CFG_KEY_PASSPHRASE,
+  MOCA_CFG_TX_POWER_LIMIT,
+  MOCA_CFG_AUTO_POWER_CONTROL_PHY_RATE,
+  MOCA_CFG_BEACON_POWER_LIMIT,
+  MOCA_CFG_MAX_INGRESS_BW_THRESHOLD,
+  MOCA_CFG_MAX_EGRESS_BW_THRESHOLD,
+  MOCA_CFG_RESET,
+  MOCA_CFG_MIXED_MODE,
+  MOCA_CFG_CHANNEL_SCANNING,
+  MOCA_CFG_AUTO_POWER_CONTROL_ENABLE,
+  MOCA_CFG_ENABLE_TABOO_BIT,
+  MOCA_CFG_NODE_TABOO_MASK,
+  MOCA_CFG_CHANNEL_SCAN_MASK,
+  MOCA_CFG_FIELD_COUNT
+} moca_cfg_field_t;
+
+#define MOCA_CFG_FIELD_BIT(field)     (1UL << (field))
+#define MOCA_CFG_ALL_FIELDS           (MOCA_CFG_FIELD_BIT(MOCA_CFG_FIELD_COUNT) - 1)
+
+/**
+* @brief Fields a node can only apply by leaving the MoCA network and joining it again.
+*
+* They decide whether the node takes part at all, which node coordinates the network, the channels it searches and
+* who may join it. Every other field, the power control settings, the bandwidth thresholds and the names, takes effect
+* on the running link. Reset asks for a re-formation, setting it is always a change.
+*/
+#define MOCA_CFG_REFORM_FIELDS \
+  (MOCA_CFG_FIELD_BIT(MOCA_CFG_ENABLED) | MOCA_CFG_FIELD_BIT(MOCA_CFG_PREFERRED_NC) | \
+   MOCA_CFG_FIELD_BIT(MOCA_CFG_PRIVACY_ENABLED) | MOCA_CFG_FIELD_BIT(MOCA_CFG_FREQ_CURRENT_MASK) | \
+   MOCA_CFG_FIELD_BIT(MOCA_CFG_KEY_PASSPHRASE) | MOCA_CFG_FIELD_BIT(MOCA_CFG_RESET) | \
+   MOCA_CFG_FIELD_BIT(MOCA_CFG_MIXED_MODE) | MOCA_CFG_FIELD_BIT(MOCA_CFG_CHANNEL_SCANNING) | \
+   MOCA_CFG_FIELD_BIT(MOCA_CFG_ENABLE_TABOO_BIT) | MOCA_CFG_FIELD_BIT(MOCA_CFG_NODE_TABOO_MASK) | \
+   MOCA_CFG_FIELD_BIT(MOCA_CFG_CHANNEL_SCAN_MASK))
+
+/**
+* @brief Outcome of moca_SetIfConfigFields().
+*/
+typedef struct
+{
+  ULONG changedMask;        /**< MOCA_CFG_FIELD_BIT() of every selected field that differed, the only ones applied */
+  ULONG reformMask;         /**< Fields of changedMask that re-formed the link, 0 if it stayed up */
+} moca_cfg_apply_result_t;
+
+/**
+* @brief Applies the fields of a configuration that changed, re-forming the link only when one of them needs it.
+*
+* moca_SetIfConfig() takes a whole moca_cfg_t, so the driver cannot tell what changed and re-forms the link, seconds
+* of downtime, whatever the change. This call compares the fields selected by fieldMask with the current
+* configuration and applies those that differ, as one transaction: either every changed field is applied or, if the
+* resulting configuration is invalid, none is. The link re-forms, and moca_GetResetCount() advances, only if a
+* changed field is in MOCA_CFG_REFORM_FIELDS. A configuration that changes nothing does nothing.
+*
+* @param[in]  ifIndex   - Index of the MoCA interface.
+* @param[in]  pConfig   - New values, fields outside fieldMask are ignored.
+* @param[in]  fieldMask - MOCA_CFG_FIELD_BIT() of every field to apply, MOCA_CFG_ALL_FIELDS to diff them all.
+* @param[out] pResult   - Receives the fields changed and those that re-formed the link, may be NULL.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful, including when nothing changed.
+* @retval STATUS_FAILURE if ifIndex is invalid, pConfig is NULL or a changed field is out of range, nothing is applied.
+*/
+INT moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_HAL_EXT_H__ */
@@ -0,0 +1,162 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_poller.h
+*
+* Adaptive rate telemetry poller built on moca_IfGetStats().
+*
+* A poller thread reads the statistics of one interface, and optionally its
+* MAC extended counters, at an interval that follows the traffic. After
+* every sample the interval is set so that about bytesPerSample bytes pass
+* between two samples: a busy link is sampled up to every minIntervalMs, an
+* idle one backs off, at most doubling the interval per sample, down to every
+* maxIntervalMs. A burst on an idle link is therefore seen within
+* maxIntervalMs, and the sampling speeds up from the next sample on.
+*
+* Staleness is bounded: while the HAL answers, the latest sample is never
+* older than maxIntervalMs plus the duration of one call. A failed read is
+* retried after minIntervalMs. maxIntervalMs must stay below the time a 32
+* bit byte counter takes to wrap at the highest traffic expected, the byte
+* totals of a sample are extended to 64 bits across one wrap per interval.
+* The reads are bracketed by moca_GetResetCount(), as in moca_counters.c: after
+* a reset the counters restarted, and their new values are the traffic of the
+* interval rather than a wrap.
+*/
+
+#ifndef __MOCA_POLLER_H__
+#define __MOCA_POLLER_H__
+
+#include <stdint.h>
+#include <pthread.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_POLLER_DEFAULT_MIN_INTERVAL_MS     100
+#define MOCA_POLLER_DEFAULT_MAX_INTERVAL_MS     5000
+#define MOCA_POLLER_DEFAULT_BYTES_PER_SAMPLE    (1024 * 1024)
+
+/**
+* @brief One reading of the interface counters.
+*/
+typedef struct
+{
+  uint64_t sequence;                  /**< Successful samples taken before this one */
+  uint64_t timestampNs;               /**< CLOCK_MONOTONIC time the read completed */
+  moca_stats_t stats;
+  BOOL haveExtCounter;                /**< extCounter was read, moca_poller_config_t::extCounter set and the read succeeded */
+  moca_mac_counters_t extCounter;
+  ULONG resetCount;                   /**< moca_GetResetCount() after the read, 0 if it failed */
+  uint64_t txBytes;                   /**< BytesSent since the first sample, across 32 bit wraps and resets */
+  uint64_t rxBytes;                   /**< BytesReceived since the first sample, across 32 bit wraps and resets */
+  uint32_t nextIntervalMs;            /**< Interval chosen from this sample */
+} moca_poller_sample_t;
+
+/**
+* @brief Called on the poller thread after every successful sample, must not stop the poller.
+*/
+typedef void (*moca_poller_callback_t)(const moca_poller_sample_t *pSample, void *pContext);
+
+typedef struct
+{
+  ULONG ifIndex;
+  uint32_t minIntervalMs;             /**< Fastest sampling, 1 or more */
+  uint32_t maxIntervalMs;             /**< Slowest sampling and staleness bound, minIntervalMs or more */
+  uint64_t bytesPerSample;            /**< Traffic aimed for between two samples, 0 samples every minIntervalMs */
+  BOOL extCounter;                    /**< Also read moca_IfGetExtCounter() every sample */
+  moca_poller_callback_t callback;    /**< May be NULL */
+  void *pContext;
+} moca_poller_config_t;
+
+/**
+* @brief Counters of a poller since it started.
+*/
+typedef struct
+{
+  uint64_t samples;                   /**< Successful samples */
+  uint64_t failures;                  /**< Reads that failed and were retried */
+  uint64_t resets;                    /**< Samples taken after the reset count moved */
+  uint64_t cpuNs;                     /**< CPU time of the poller thread, HAL calls included */
+  uint64_t maxGapNs;                  /**< Longest time between two successful samples */
+  uint32_t intervalMs;                /**< Current interval */
+} moca_poller_stats_t;
+
+/**
+* @brief A poller, its members are private to moca_poller.c.
+*/
+typedef struct
+{
+  moca_poller_config_t config;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  BOOL running;
+  BOOL stopping;
+  BOOL haveSample;
+  BOOL haveResetCount;                /**< latest.resetCount was read */
+  moca_poller_sample_t latest;
+  moca_poller_stats_t stats;
+} moca_poller_t;
+
+/**
+* @brief Fills a configuration with the defaults for an interface.
+*/
+void moca_poller_default_config(ULONG ifIndex, moca_poller_config_t *pConfig);
+
+/**
+* @brief Interval to wait before the next sample.
+*
+* @param[in] pConfig      - Bounds and traffic aimed for.
+* @param[in] currentMs    - Interval that led to this sample.
+* @param[in] deltaBytes   - Bytes sent and received since the previous sample.
+* @param[in] elapsedNs    - Time since the previous sample.
+*
+* @return The interval in milliseconds, within the bounds of pConfig.
+*/
+uint32_t moca_poller_next_interval_ms(const moca_poller_config_t *pConfig, uint32_t currentMs, uint64_t deltaBytes,
+                                      uint64_t elapsedNs);
+
+/**
+* @brief Starts a poller thread, the first sample is taken straight away.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if the configuration is out of range or the thread cannot start.
+*/
+INT moca_poller_start(moca_poller_t *pPoller, const moca_poller_config_t *pConfig);
+
+/**
+* @brief Stops a poller thread and waits for it, a poller can be started again afterwards.
+*/
+void moca_poller_stop(moca_poller_t *pPoller);
+
+/**
+* @brief Copies the latest sample.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if no sample was taken yet.
+*/
+INT moca_poller_latest(moca_poller_t *pPoller, moca_poller_sample_t *pSample);
+
+void moca_poller_get_stats(moca_poller_t *pPoller, moca_poller_stats_t *pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_POLLER_H__ */
@@ -0,0 +1,147 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_scmod.h
+*
+* Bit loading analysis of moca_getIfScmod() output.
+*
+* moca_scmod_analyze() reduces every tx / rx entry of an SCMOD dump to a
+* histogram of bits per subcarrier, its total, average, lowest loaded and
+* highest value, and, given the previous dump, how much the loading moved
+* since. The entries are then summed per receiving node.
+*
+* The per-subcarrier work runs in a SIMD kernel, SSE2 or AVX2 on x86 and
+* NEON on ARM, picked at run time, with a scalar fallback that every kernel
+* must match exactly.
+*/
+
+#ifndef __MOCA_SCMOD_H__
+#define __MOCA_SCMOD_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_SCMOD_SUBCARRIERS      (sizeof(((moca_scmod_stat_t *)0)->bitLoading))
+#define MOCA_SCMOD_HISTOGRAM_BINS   16    /**< Bit loadings 0 to 15, larger values are counted in the last bin */
+#define MOCA_SCMOD_MAX_LINKS        (kMoca_MaxMocaNodes * (kMoca_MaxMocaNodes - 1))
+
+/**
+* @brief Implementation of the per-subcarrier work.
+*/
+typedef enum
+{
+  MOCA_SCMOD_KERNEL_AUTO = 0,   /**< Fastest kernel the CPU supports */
+  MOCA_SCMOD_KERNEL_SCALAR,
+  MOCA_SCMOD_KERNEL_SSE2,
+  MOCA_SCMOD_KERNEL_AVX2,
+  MOCA_SCMOD_KERNEL_NEON,
+  MOCA_SCMOD_KERNEL_COUNT
+} moca_scmod_kernel_t;
+
+/**
+* @brief Bit loading of one tx / rx entry.
+*/
+typedef struct
+{
+  UINT txNode;
+  UINT rxNode;
+  uint32_t histogram[MOCA_SCMOD_HISTOGRAM_BINS];  /**< Subcarriers per bit loading */
+  uint32_t totalBits;                             /**< Bits per symbol over every subcarrier */
+  uint32_t loadedSubcarriers;                     /**< Subcarriers carrying at least one bit */
+  UCHAR minBits;                                  /**< Lowest non-zero bit loading, 0 if nothing is loaded */
+  UCHAR maxBits;
+  BOOL hasPrevious;                               /**< The previous dump had this entry, the delta fields are valid */
+  double averageBits;                             /**< totalBits over MOCA_SCMOD_SUBCARRIERS */
+  int32_t deltaBits;                              /**< totalBits minus that of the previous dump */
+  uint32_t changedSubcarriers;                    /**< Subcarriers whose bit loading differs from the previous dump */
+  uint32_t absoluteDeltaBits;                     /**< Sum of the absolute per-subcarrier changes */
+} moca_scmod_link_t;
+
+/**
+* @brief Bit loading of every entry received by one node.
+*/
+typedef struct
+{
+  uint32_t links;                                 /**< Entries with this node as rxNode */
+  uint32_t histogram[MOCA_SCMOD_HISTOGRAM_BINS];
+  uint64_t totalBits;
+  uint32_t loadedSubcarriers;
+  UCHAR minBits;
+  UCHAR maxBits;
+  double averageBits;                             /**< Per subcarrier over every entry */
+  int64_t deltaBits;                              /**< Over the entries that have a previous one */
+  uint32_t changedSubcarriers;
+} moca_scmod_node_t;
+
+/**
+* @brief Result of moca_scmod_analyze().
+*/
+typedef struct
+{
+  moca_scmod_kernel_t kernel;                     /**< Kernel that ran */
+  uint32_t numLinks;
+  moca_scmod_link_t links[MOCA_SCMOD_MAX_LINKS];  /**< In the order of the dump */
+  moca_scmod_node_t nodes[kMoca_MaxMocaNodes];    /**< Indexed by rxNode */
+} moca_scmod_analysis_t;
+
+/**
+* @brief Returns the kernel MOCA_SCMOD_KERNEL_AUTO selects on this CPU.
+*/
+moca_scmod_kernel_t moca_scmod_best_kernel(void);
+
+/**
+* @brief Returns TRUE if the kernel was built in and the CPU supports it, MOCA_SCMOD_KERNEL_AUTO always is.
+*/
+BOOL moca_scmod_kernel_supported(moca_scmod_kernel_t kernel);
+
+/**
+* @brief Returns the name of a kernel, for logs.
+*/
+const char *moca_scmod_kernel_name(moca_scmod_kernel_t kernel);
+
+/**
+* @brief Analyses the bit loading of an SCMOD dump.
+*
+* Entries of pPrevious are matched to those of pEntries by txNode and rxNode,
+* entries without a match have hasPrevious FALSE. Allocates nothing, so it can
+* run on every diagnostics sweep.
+*
+* @param[in]  kernel      - Kernel to run, MOCA_SCMOD_KERNEL_AUTO for the fastest.
+* @param[in]  pEntries    - Dump returned by moca_getIfScmod().
+* @param[in]  numEntries  - Entries in pEntries, at most MOCA_SCMOD_MAX_LINKS.
+* @param[in]  pPrevious   - Previous dump of the same interface, NULL if none.
+* @param[in]  numPrevious - Entries in pPrevious.
+* @param[out] pAnalysis   - Receives the result.
+*
+* @return The status of the operation.
+* @retval STATUS_SUCCESS if successful.
+* @retval STATUS_FAILURE if an argument is NULL, the kernel is not supported, there are too many entries or a node ID is not below kMoca_MaxMocaNodes.
+*/
+int moca_scmod_analyze(moca_scmod_kernel_t kernel, const moca_scmod_stat_t *pEntries, int numEntries,
+                       const moca_scmod_stat_t *pPrevious, int numPrevious, moca_scmod_analysis_t *pAnalysis);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_SCMOD_H__ */
@@ -0,0 +1,150 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_static_cache.h
+*
+* Cache of moca_IfGetStaticInfo().
+*
+* The static info of an interface, its MAC address, firmware version and
+* capabilities, only changes when the interface is reconfigured or reset, yet
+* every TR-181 read of it goes to the driver. The cache keeps one copy per
+* interface and serves it from memory.
+*
+* An entry is dropped when its configuration is applied through
+* moca_static_cache_set_config(), moca_static_cache_set_config_fields() or
+* moca_static_cache_invalidate(), and when
+* moca_GetResetCount() moved since it was read. With revalidateMs 0 the reset
+* count is read on every lookup, so a lookup never returns static info older
+* than the last reset or configuration through the cache completed before it
+* started. The reset count is a driver call too, though usually a much cheaper
+* one; a revalidateMs above 0 skips it for that long after the last check, and
+* a reset is then noticed up to revalidateMs late.
+*
+* A configuration applied with moca_SetIfConfig() directly is only noticed if
+* the driver counts it as a reset. moca_SetIfConfigFields() called directly
+* changes fields such as TxPowerLimit, and with it TxBcastPowerReduction,
+* without re-forming the link or counting a reset, so the cache keeps serving
+* the old static info until moca_static_cache_invalidate() is called.
+*/
+
+#ifndef __MOCA_STATIC_CACHE_H__
+#define __MOCA_STATIC_CACHE_H__
+
+#include <stdint.h>
+#include <pthread.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_STATIC_CACHE_MAX_INTERFACES    16      /**< Interfaces from this ifIndex on are passed through to the driver */
+
+/**
+* @brief Counters of a cache since it was initialised.
+*/
+typedef struct
+{
+  uint64_t hits;                      /**< Lookups served from memory */
+  uint64_t misses;                    /**< Lookups that read the driver */
+  uint64_t resets;                    /**< Lookups that found their entry older than the last reset */
+  uint64_t invalidations;             /**< Entries dropped by a configuration through the cache or moca_static_cache_invalidate() */
+  uint64_t failures;                  /**< Lookups failed by the driver */
+} moca_static_cache_stats_t;
+
+/**
+* @brief A cached moca_static_info_t, private to moca_static_cache.c.
+*/
+typedef struct
+{
+  BOOL valid;
+  ULONG resetCount;                   /**< moca_GetResetCount() before and after info was read */
+  uint64_t generation;                /**< Bumped on invalidation, reads started before are not stored */
+  uint64_t checkedNs;                 /**< Last time the reset count was found unchanged */
+  moca_static_info_t info;
+} moca_static_cache_entry_t;
+
+/**
+* @brief A cache, its members are private to moca_static_cache.c.
+*/
+typedef struct
+{
+  pthread_rwlock_t lock;
+  uint32_t revalidateMs;
+  moca_static_cache_entry_t entries[MOCA_STATIC_CACHE_MAX_INTERFACES];
+  moca_static_cache_stats_t stats;
+} moca_static_cache_t;
+
+/**
+* @brief Initialises an empty cache.
+*
+* @param[in] pCache       - Cache to initialise.
+* @param[in] revalidateMs - Time a hit is served without reading the reset count, 0 reads it on every lookup.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if pCache is NULL or the lock cannot be created.
+*/
+INT moca_static_cache_init(moca_static_cache_t *pCache, uint32_t revalidateMs);
+
+void moca_static_cache_destroy(moca_static_cache_t *pCache);
+
+/**
+* @brief Static info of an interface, from the cache or from moca_IfGetStaticInfo().
+*
+* Safe to call from several threads. A lookup that misses reads the driver
+* between two reads of the reset count and only stores the result if neither a
+* reset nor an invalidation happened meanwhile.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if an argument is NULL or the driver failed.
+*/
+INT moca_static_cache_get(moca_static_cache_t *pCache, ULONG ifIndex, moca_static_info_t *pInfo);
+
+/**
+* @brief Applies a configuration with moca_SetIfConfig() and drops the entry of the interface.
+*
+* The entry is dropped even if the driver failed, it may have applied part of the configuration.
+*
+* @return The status of moca_SetIfConfig().
+*/
+INT moca_static_cache_set_config(moca_static_cache_t *pCache, ULONG ifIndex, moca_cfg_t *pConfig);
+
+/**
+* @brief Applies the changed fields of a configuration with moca_SetIfConfigFields() and drops the entry of the
+* interface if any was applied.
+*
+* A live change re-forms nothing and moves no reset count, yet TxPowerLimit alone changes the broadcast power
+* reduction of the static info. An apply that changed nothing keeps the entry, one that failed drops it.
+*
+* @return The status of moca_SetIfConfigFields().
+*/
+INT moca_static_cache_set_config_fields(moca_static_cache_t *pCache, ULONG ifIndex, const moca_cfg_t *pConfig,
+                                        ULONG fieldMask, moca_cfg_apply_result_t *pResult);
+
+/**
+* @brief Drops the entry of an interface, the next lookup reads the driver.
+*/
+void moca_static_cache_invalidate(moca_static_cache_t *pCache, ULONG ifIndex);
+
+void moca_static_cache_get_stats(moca_static_cache_t *pCache, moca_static_cache_stats_t *pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_STATIC_CACHE_H__ */
@@ -0,0 +1,179 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_stats_shm.h
+*
+* Shared memory publication of MoCA statistics.
+*
+* One publisher reads moca_IfGetStats() and moca_IfGetExtAggrCounter() and
+* writes the results to a POSIX shared memory object, one slot per interface.
+* Every consumer on the device maps the object read only and copies a slot out
+* with moca_stats_shm_read(), with no system call and no driver access.
+*
+* Each slot is guarded by a sequence lock. The writer makes the sequence odd,
+* writes the snapshot and makes it even again. A reader copies the snapshot
+* between two reads of the sequence and retries when they differ or are odd,
+* so it always gets a snapshot written as a whole, and never delays the writer.
+* Only one writer may update a slot, the slots of different interfaces may be
+* written from different threads.
+*
+* The object starts with a moca_stats_shm_header_t, followed by numInterfaces
+* moca_stats_shm_slot_t. Readers refuse an object whose header does not match
+* their build, a 32 bit reader cannot map an object written by a 64 bit writer.
+*
+* A publisher that restarts does not reuse the object: it clears the magic of
+* the old one, unlinks it and creates a new one under the same name. Readers
+* keep a valid mapping of the old object, their reads fail from then on and
+* moca_stats_shm_retired() tells them to reopen the name.
+*/
+
+#ifndef __MOCA_STATS_SHM_H__
+#define __MOCA_STATS_SHM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_STATS_SHM_DEFAULT_NAME     "/moca_hal_stats"
+#define MOCA_STATS_SHM_MAGIC            0x4d534853UL    /**< "SHSM" read as little endian bytes */
+#define MOCA_STATS_SHM_VERSION          1
+#define MOCA_STATS_SHM_MAX_INTERFACES   16
+#define MOCA_STATS_SHM_READ_ATTEMPTS    1024            /**< Before moca_stats_shm_read() gives up on a busy slot */
+
+/**
+* @brief Statistics of one interface as last published.
+*/
+typedef struct
+{
+  uint64_t sequence;                              /**< Times the slot was written, 0 if never */
+  uint64_t timestampNs;                           /**< CLOCK_MONOTONIC time of the publication */
+  ULONG ifIndex;
+  BOOL haveStats;                                 /**< stats holds the result of moca_IfGetStats() */
+  BOOL haveAggregateCounters;                     /**< aggregateCounters holds the result of moca_IfGetExtAggrCounter() */
+  moca_stats_t stats;
+  moca_aggregate_counters_t aggregateCounters;
+} moca_stats_shm_snapshot_t;
+
+typedef struct
+{
+  uint32_t magic;                                 /**< MOCA_STATS_SHM_MAGIC, written last by the publisher */
+  uint32_t version;                               /**< MOCA_STATS_SHM_VERSION */
+  uint32_t slotSize;                              /**< sizeof(moca_stats_shm_slot_t) of the publisher */
+  uint32_t numInterfaces;
+} moca_stats_shm_header_t;
+
+/**
+* @brief One interface, a cache line aligned so readers of one slot do not slow the writer of another.
+*/
+typedef struct
+{
+  uint32_t lock;                                  /**< Sequence lock, odd while the snapshot is written */
+  moca_stats_shm_snapshot_t snapshot;
+} __attribute__((aligned(64))) moca_stats_shm_slot_t;
+
+/**
+* @brief A mapping of the object, its members are private to moca_stats_shm.c.
+*/
+typedef struct
+{
+  moca_stats_shm_header_t *pHeader;
+  moca_stats_shm_slot_t *pSlots;
+  size_t size;
+  BOOL writable;
+} moca_stats_shm_t;
+
+/**
+* @brief Creates, or recreates empty, the shared memory object and maps it for publishing.
+*
+* An object left under the name is retired and unlinked, never truncated under its readers.
+*
+* @param[in]  pName         - Object name, starting with '/'.
+* @param[in]  numInterfaces - Slots, 1 to MOCA_STATS_SHM_MAX_INTERFACES.
+* @param[out] pShm          - Receives the mapping.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE.
+*/
+INT moca_stats_shm_create(const char *pName, uint32_t numInterfaces, moca_stats_shm_t *pShm);
+
+/**
+* @brief Maps an existing object read only.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if it does not exist or was not created by a matching build.
+*/
+INT moca_stats_shm_open(const char *pName, moca_stats_shm_t *pShm);
+
+/**
+* @brief Unmaps the object, it stays available to the other processes.
+*/
+void moca_stats_shm_close(moca_stats_shm_t *pShm);
+
+/**
+* @brief Removes the object name, existing mappings stay valid.
+*/
+INT moca_stats_shm_unlink(const char *pName);
+
+uint32_t moca_stats_shm_interfaces(const moca_stats_shm_t *pShm);
+
+/**
+* @brief Tells whether the publisher replaced the mapped object with a new one.
+*
+* @return TRUE once moca_stats_shm_create() recreated the name, the reader should close and reopen it.
+*/
+BOOL moca_stats_shm_retired(const moca_stats_shm_t *pShm);
+
+/**
+* @brief Writes a snapshot to a slot.
+*
+* @param[in] pShm               - Mapping from moca_stats_shm_create().
+* @param[in] slot               - Slot to write, below numInterfaces.
+* @param[in] ifIndex            - Interface the values were read from.
+* @param[in] pStats             - Statistics, NULL if unavailable.
+* @param[in] pAggregateCounters - Aggregate counters, NULL if unavailable.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if the mapping is read only or slot is out of range.
+*/
+INT moca_stats_shm_write(moca_stats_shm_t *pShm, uint32_t slot, ULONG ifIndex, const moca_stats_t *pStats,
+                         const moca_aggregate_counters_t *pAggregateCounters);
+
+/**
+* @brief Reads the statistics and the aggregate counters of an interface and writes them to a slot.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if neither could be read or the slot cannot be written.
+*/
+INT moca_stats_shm_publish(moca_stats_shm_t *pShm, uint32_t slot, ULONG ifIndex);
+
+/**
+* @brief Copies the snapshot of a slot.
+*
+* Waits for a write in progress, yielding the CPU to the writer, for up to MOCA_STATS_SHM_READ_ATTEMPTS attempts.
+*
+* @return STATUS_SUCCESS, or STATUS_FAILURE if the slot is out of range, was never written, stayed busy or the object
+*         was retired.
+*/
+INT moca_stats_shm_read(const moca_stats_shm_t *pShm, uint32_t slot, moca_stats_shm_snapshot_t *pSnapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_STATS_SHM_H__ */
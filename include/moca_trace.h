@@ -0,0 +1,178 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_trace.h
+*
+* File format of a MoCA HAL call trace.
+*
+* The test binary records every HAL call it makes to the file named by
+* MOCA_TRACE_RECORD (src/moca_trace_record.c), and the replay HAL
+* (skeletons/replay/src/moca_hal_replay.c) serves the recorded results back.
+*
+* A trace is a moca_trace_header_t followed by moca_trace_record_t entries.
+* Each record is followed by its input payload, then its output payload, and
+* padded to MOCA_TRACE_ALIGN bytes, so a reader can mmap() the file and use
+* the records in place. Payloads are the moca_hal.h structures exactly as the
+* recording build lays them out. The header carries a fingerprint of that
+* layout and a trace is only replayed by a build with the same one, a trace
+* from a 32 bit device needs a 32 bit (-m32) replay build.
+*/
+
+#ifndef __MOCA_TRACE_H__
+#define __MOCA_TRACE_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_TRACE_MAGIC          "MOCATRC"   /**< Including the terminating NUL, 8 bytes */
+#define MOCA_TRACE_VERSION        1
+#define MOCA_TRACE_ALIGN          8
+
+#define MOCA_TRACE_FLAG_NULL_ARGUMENT   0x1   /**< A pointer argument was NULL, the call is kept for the record but never replayed */
+#define MOCA_TRACE_FLAG_UNKNOWN_COUNT   0x2   /**< The entry count of the output is unknown, no payload is kept and replay returns no entries */
+
+/**
+* @brief Identifies the API of a record, values are part of the file format.
+*/
+typedef enum
+{
+  MOCA_TRACE_API_GetIfConfig = 1,
+  MOCA_TRACE_API_SetIfConfig = 2,
+  MOCA_TRACE_API_IfGetDynamicInfo = 3,
+  MOCA_TRACE_API_IfGetStaticInfo = 4,
+  MOCA_TRACE_API_IfGetStats = 5,
+  MOCA_TRACE_API_GetNumAssociatedDevices = 6,
+  MOCA_TRACE_API_IfGetExtCounter = 7,
+  MOCA_TRACE_API_IfGetExtAggrCounter = 8,
+  MOCA_TRACE_API_GetMocaCPEs = 9,
+  MOCA_TRACE_API_GetAssociatedDevices = 10,
+  MOCA_TRACE_API_FreqMaskToValue = 11,
+  MOCA_TRACE_API_HardwareEquipped = 12,
+  MOCA_TRACE_API_GetFullMeshRates = 13,
+  MOCA_TRACE_API_GetFlowStatistics = 14,
+  MOCA_TRACE_API_GetResetCount = 15,
+  MOCA_TRACE_API_setIfAcaConfig = 16,
+  MOCA_TRACE_API_getIfAcaConfig = 17,
+  MOCA_TRACE_API_cancelIfAca = 18,
+  MOCA_TRACE_API_getIfAcaStatus = 19,
+  MOCA_TRACE_API_getIfScmod = 20,
+  MOCA_TRACE_API_associatedDevice_callback_register = 21,
+  MOCA_TRACE_API_IfGetTelemetrySnapshot = 22,
+  MOCA_TRACE_API_GetAssociatedDevicesInto = 23,
+  MOCA_TRACE_API_IfGetStatsChangedSince = 24,
+  MOCA_TRACE_API_GetFlowStatisticsPage = 25,
+  MOCA_TRACE_API_startIfAcaAsync = 26,
+  MOCA_TRACE_API_getIfAcaEventFd = 27,
+  MOCA_TRACE_API_SetIfConfigFields = 28,
+  MOCA_TRACE_API_COUNT
+} moca_trace_api_t;
+
+/**
+* @brief Start of a trace file.
+*/
+typedef struct
+{
+  char magic[8];            /**< MOCA_TRACE_MAGIC */
+  uint32_t version;         /**< MOCA_TRACE_VERSION */
+  uint32_t headerSize;      /**< sizeof(moca_trace_header_t), the first record follows */
+  uint32_t layout;          /**< moca_trace_layout() of the recording build */
+  uint32_t reserved;
+  uint64_t startNs;         /**< CLOCK_MONOTONIC time recording started */
+} moca_trace_header_t;
+
+/**
+* @brief One HAL call.
+*
+* value holds the scalar result of the call: the entry count of an array output, the device count of
+* moca_GetNumAssociatedDevices(), the reset count of moca_GetResetCount(), 1 if moca_startIfAcaAsync() was
+* given a callback. The completion callback itself is not recorded. The output payload is empty when the
+* call failed, except for moca_GetAssociatedDevicesInto() which reports the required capacity in value.
+*
+* moca_GetAssociatedDevices() returns no count, and the recorder makes no HAL call of its own to learn one. A call
+* that returned devices is recorded with MOCA_TRACE_FLAG_UNKNOWN_COUNT and without them, only one that returned no
+* array keeps a count, 0. Replay serves the status and timing of such a call with an empty array.
+* moca_GetAssociatedDevicesInto() records the devices it returned.
+*
+* | API | Input payload | Output payload |
+* | --- | ------------- | -------------- |
+* | moca_SetIfConfig | moca_cfg_t | None |
+* | moca_setIfAcaConfig | moca_aca_cfg_t | None |
+* | moca_startIfAcaAsync | moca_aca_cfg_t | None |
+* | moca_SetIfConfigFields | moca_cfg_t, ULONG fieldMask | moca_cfg_apply_result_t, none without pResult |
+* | moca_FreqMaskToValue | Mask, NUL terminated | None |
+* | moca_IfGetStatsChangedSince | uint64_t generation | moca_stats_delta_t |
+* | moca_GetAssociatedDevicesInto | ULONG capacity | value x moca_associated_device_t |
+* | moca_GetFlowStatisticsPage | ULONG cursor, ULONG capacity | ULONG next cursor, value x moca_flow_table_t |
+* | Array outputs | None | value x entry |
+* | Structure outputs | None | The structure |
+*/
+typedef struct
+{
+  uint32_t api;             /**< moca_trace_api_t */
+  uint32_t flags;           /**< MOCA_TRACE_FLAG_* */
+  uint64_t startNs;         /**< Call entry, relative to moca_trace_header_t::startNs */
+  uint64_t durationNs;      /**< Time spent in the HAL */
+  int32_t ret;              /**< Returned status, BOOL for moca_HardwareEquipped(), the descriptor for moca_getIfAcaEventFd() */
+  uint32_t ifIndex;         /**< Interface argument, 0 for APIs without one */
+  uint64_t value;
+  uint32_t inputSize;       /**< Bytes of input payload following the record */
+  uint32_t outputSize;      /**< Bytes of output payload following the input */
+} moca_trace_record_t;
+
+/** Bytes from the start of a record to the start of the next one */
+#define MOCA_TRACE_RECORD_SIZE(pRecord) \
+  ((sizeof(moca_trace_record_t) + (pRecord)->inputSize + (pRecord)->outputSize + MOCA_TRACE_ALIGN - 1) & ~(size_t)(MOCA_TRACE_ALIGN - 1))
+
+#define MOCA_TRACE_INPUT(pRecord)   ((const void *)((const uint8_t *)(pRecord) + sizeof(moca_trace_record_t)))
+#define MOCA_TRACE_OUTPUT(pRecord)  ((const void *)((const uint8_t *)(pRecord) + sizeof(moca_trace_record_t) + (pRecord)->inputSize))
+
+/**
+* @brief Fingerprint of the payload layout, FNV-1a over the sizes of every recorded structure.
+*/
+static inline uint32_t moca_trace_layout(void)
+{
+  const uint32_t sizes[] =
+  {
+    sizeof(ULONG), sizeof(INT), sizeof(BOOL), sizeof(void *),
+    sizeof(moca_cfg_t), sizeof(moca_dynamic_info_t), sizeof(moca_static_info_t), sizeof(moca_stats_t),
+    sizeof(moca_mac_counters_t), sizeof(moca_aggregate_counters_t), sizeof(moca_cpe_t),
+    sizeof(moca_associated_device_t), sizeof(moca_mesh_table_t), sizeof(moca_flow_table_t),
+    sizeof(moca_aca_cfg_t), sizeof(moca_aca_stat_t), sizeof(moca_scmod_stat_t),
+    sizeof(moca_telemetry_snapshot_t), sizeof(moca_stats_delta_t), sizeof(moca_cfg_apply_result_t)
+  };
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    hash = (hash ^ sizes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_TRACE_H__ */
@@ -0,0 +1,366 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_sim.h
+* @page moca_hal_sim MoCA HAL Simulator
+*
+* ## Module's Role
+* Control interface for the in-memory MoCA network simulator that backs the
+* skeleton HAL on `TARGET=linux`. The simulator models each of its interfaces
+* as a MoCA network of up to kMoca_MaxMocaNodes nodes, each with its own PHY
+* rates, counters, CPE table and PQoS flows, so that the HAL entry points
+* return realistically sized payloads.
+*
+* The defaults can be overridden from the environment before the first HAL
+* call:
+*
+* | Variable | Meaning | Default |
+* | -------- | ------- | ------- |
+* | MOCA_SIM_INTERFACES | MoCA interfaces, ifIndex 0 to MOCA_SIM_INTERFACES - 1 | 2 |
+* | MOCA_SIM_NODES | Nodes per interface, including the local node | 8 |
+* | MOCA_SIM_CPES_PER_NODE | CPE MAC addresses learnt behind each node | 4 |
+* | MOCA_SIM_FLOWS_PER_NODE | PQoS flows ingressing at each node | 2 |
+* | MOCA_SIM_TX_BPS | Transmit traffic per interface, bytes/s | 12500000 |
+* | MOCA_SIM_RX_BPS | Receive traffic per interface, bytes/s | 25000000 |
+* | MOCA_SIM_SEED | Seed for the generated network | 1 |
+* | MOCA_SIM_ACA_MS | Run time of an ACA probing every node, milliseconds | 500 |
+* | MOCA_SIM_REFORM_MS | Downtime of a link re-formation, milliseconds | 0 |
+* | MOCA_SIM_FAULTS | Faults injected into the HAL calls, see moca_sim_SetFault() | None |
+*
+* MOCA_SIM_FAULTS holds `;` separated `api:key=value,...` entries, api being
+* the HAL function name or `*` for every API and the keys the fields of
+* moca_sim_fault_t: latency (none, fixed, uniform, longtail), min, max, tail,
+* error, hang and hangms. For example
+* `moca_IfGetStats:latency=longtail,min=200,max=500000,tail=10,error=1000`.
+*
+* Only built for the skeleton, tests using it must be guarded with
+* MOCA_HAL_SIMULATOR.
+*/
+
+#ifndef __MOCA_HAL_SIM_H__
+#define __MOCA_HAL_SIM_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_SIM_MAX_INTERFACES       16    /**< Highest number of simulated MoCA interfaces */
+#define MOCA_SIM_MAX_NODES            kMoca_MaxMocaNodes
+#define MOCA_SIM_MAX_FLOWS_PER_NODE   4096  /**< Up to 65536 flows per interface, beyond what moca_GetFlowStatistics() callers size for */
+#define MOCA_SIM_NUM_SUBCARRIERS      512   /**< Subcarriers reported per SCMOD entry */
+#define MOCA_SIM_EVENT_QUEUE_DEPTH    1024  /**< Device events buffered between the generator and the callback */
+
+/**
+* @brief Simulated network shape, applied to every interface.
+*/
+typedef struct
+{
+  ULONG numNodes;         /**< Nodes on the network including the local node, 1 - MOCA_SIM_MAX_NODES */
+  ULONG cpesPerNode;      /**< CPEs learnt behind each node, bounded by kMoca_MaxCpeList in total */
+  ULONG flowsPerNode;     /**< PQoS flows ingressing at each node, 0 - MOCA_SIM_MAX_FLOWS_PER_NODE */
+  ULONG txBytesPerSec;    /**< Traffic transmitted by the local node */
+  ULONG rxBytesPerSec;    /**< Traffic received by the local node */
+  ULONG seed;             /**< Seed for MAC addresses, PHY rates and bit loading */
+  ULONG acaDurationMs;    /**< Run time of an EVM ACA reported by every node, 1 - 60000. Fewer reporting nodes take
+                               less, down to half for a quiet line ACA, and every ACA varies by up to 10% */
+  ULONG numInterfaces;    /**< Interfaces served, 1 - MOCA_SIM_MAX_INTERFACES, calls on the others fail */
+  ULONG reformMs;         /**< Time the link reports down after a configuration that re-forms it, 0 - 60000 */
+} moca_sim_config_t;
+
+/**
+* @brief Counters of the associated device event generator, cumulative since start up.
+*/
+typedef struct
+{
+  uint64_t generated;       /**< Events produced by moca_sim_GenerateDeviceEvents() */
+  uint64_t dispatched;      /**< Events handed to the registered callback */
+  uint64_t undelivered;     /**< Events dequeued while no callback was registered */
+  uint64_t dropped;         /**< Events lost because the queue was full */
+  uint64_t maxQueueDepth;   /**< Highest number of events waiting for the callback */
+} moca_sim_event_stats_t;
+
+/**
+* @brief Identity of the event being delivered, see moca_sim_GetCurrentEvent().
+*/
+typedef struct
+{
+  uint64_t sequence;        /**< Increases by one for every generated event */
+  uint64_t timestampNs;     /**< CLOCK_MONOTONIC time the event was generated */
+} moca_sim_event_info_t;
+
+/**
+* @brief HAL APIs faults can be injected into, see moca_sim_SetFault().
+*/
+typedef enum
+{
+  MOCA_SIM_API_GetIfConfig = 0,
+  MOCA_SIM_API_SetIfConfig,
+  MOCA_SIM_API_IfGetDynamicInfo,
+  MOCA_SIM_API_IfGetStaticInfo,
+  MOCA_SIM_API_IfGetStats,
+  MOCA_SIM_API_GetNumAssociatedDevices,
+  MOCA_SIM_API_IfGetExtCounter,
+  MOCA_SIM_API_IfGetExtAggrCounter,
+  MOCA_SIM_API_GetMocaCPEs,
+  MOCA_SIM_API_GetAssociatedDevices,
+  MOCA_SIM_API_FreqMaskToValue,
+  MOCA_SIM_API_HardwareEquipped,
+  MOCA_SIM_API_GetFullMeshRates,
+  MOCA_SIM_API_GetFlowStatistics,
+  MOCA_SIM_API_GetResetCount,
+  MOCA_SIM_API_setIfAcaConfig,
+  MOCA_SIM_API_getIfAcaConfig,
+  MOCA_SIM_API_cancelIfAca,
+  MOCA_SIM_API_getIfAcaStatus,
+  MOCA_SIM_API_getIfScmod,
+  MOCA_SIM_API_IfGetTelemetrySnapshot,
+  MOCA_SIM_API_GetAssociatedDevicesInto,
+  MOCA_SIM_API_IfGetStatsChangedSince,
+  MOCA_SIM_API_GetFlowStatisticsPage,
+  MOCA_SIM_API_startIfAcaAsync,
+  MOCA_SIM_API_getIfAcaEventFd,
+  MOCA_SIM_API_SetIfConfigFields,
+  MOCA_SIM_API_COUNT,
+  MOCA_SIM_API_ALL = MOCA_SIM_API_COUNT     /**< Every API at once, moca_sim_SetFault() only */
+} moca_sim_api_t;
+
+/**
+* @brief Distribution of the latency added to a HAL call.
+*/
+typedef enum
+{
+  MOCA_SIM_LATENCY_NONE = 0,
+  MOCA_SIM_LATENCY_FIXED,       /**< minUs on every call */
+  MOCA_SIM_LATENCY_UNIFORM,     /**< Uniform between minUs and maxUs */
+  MOCA_SIM_LATENCY_LONG_TAIL    /**< From minUs, doubled with probability tailPercent again and again, up to maxUs */
+} moca_sim_latency_t;
+
+/**
+* @brief Faults injected into every call of one API, before the call is served.
+*
+* A call first hangs, with probability hangPpm, then waits for its latency and
+* finally fails with STATUS_FAILURE, with probability errorPpm, without being
+* served. The long tail latency is Pareto like: with tailPercent 10, one call in
+* 10 takes at least twice minUs, one in 100 four times, one in 1000 eight times.
+*/
+typedef struct
+{
+  moca_sim_latency_t latency;
+  ULONG minUs;
+  ULONG maxUs;              /**< Upper bound of the uniform and long tail latency */
+  ULONG tailPercent;        /**< Long tail only, 1 - 99 */
+  ULONG errorPpm;           /**< Calls per million failing */
+  ULONG hangPpm;            /**< Calls per million hanging */
+  ULONG hangMs;             /**< Length of a hang, 0 hangs until the faults of the API are changed */
+} moca_sim_fault_t;
+
+/**
+* @brief Faults injected into one API, cumulative since start up.
+*/
+typedef struct
+{
+  uint64_t calls;           /**< Calls made while a fault was set */
+  uint64_t delayed;         /**< Calls given latency */
+  uint64_t delayNs;         /**< Latency added in total, hangs excluded */
+  uint64_t errors;          /**< Calls failed */
+  uint64_t hangs;           /**< Calls hung */
+} moca_sim_fault_stats_t;
+
+/**
+* @brief Reads the configuration currently applied to the simulator.
+*
+* @param[out] pConfig - Receives the configuration.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if pConfig is NULL.
+*/
+INT moca_sim_GetConfig(moca_sim_config_t *pConfig);
+
+/**
+* @brief Rebuilds every simulated network from a new configuration.
+*
+* Counters, CPE tables, flows and ACA state are regenerated. As the
+* counters restart, the reset count is incremented once when an interface
+* that was already served is rebuilt. Interfaces beyond numInterfaces stop
+* being served, those added come up with a fresh network.
+*
+* @param[in] pConfig - Configuration to apply.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if the configuration is out of range.
+*/
+INT moca_sim_Configure(const moca_sim_config_t *pConfig);
+
+/**
+* @brief Restores the configuration taken from the environment at start up.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE.
+*/
+INT moca_sim_Reset(void);
+
+/**
+* @brief Changes the traffic carried by one interface.
+*
+* Counters accumulated so far are kept, new traffic accrues at the given
+* rates from now on. A rate of zero models an idle link.
+*
+* @param[in] ifIndex       - Interface index.
+* @param[in] txBytesPerSec - New transmit rate.
+* @param[in] rxBytesPerSec - New receive rate.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if ifIndex is invalid.
+*/
+INT moca_sim_SetTraffic(ULONG ifIndex, ULONG txBytesPerSec, ULONG rxBytesPerSec);
+
+/**
+* @brief Moves the counters of an interface forward, as if traffic had passed or time had elapsed.
+*
+* Byte and packet counters advance by the given traffic, the MAC counters that
+* count cycles by the given time, so tests can make the 32 bit counters wrap
+* without waiting. Nothing else changes, the reset count stays the same.
+*
+* @param[in] ifIndex  - Interface index.
+* @param[in] txBytes  - Bytes added to the transmitted traffic.
+* @param[in] rxBytes  - Bytes added to the received traffic.
+* @param[in] upMs     - Milliseconds added to the time the link has been up.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if ifIndex is invalid.
+*/
+INT moca_sim_AdvanceCounters(ULONG ifIndex, uint64_t txBytes, uint64_t rxBytes, uint64_t upMs);
+
+/**
+* @brief Changes the PHY rate of one direction of a node pair, as a link event would.
+*
+* Only the changed pair of the cached moca_GetFullMeshRates() table is rebuilt
+* on the next read. PHYTxRate and PHYRxRate of moca_GetAssociatedDevices() follow
+* the pairs that include the local node.
+*
+* @param[in] ifIndex    - Interface index.
+* @param[in] txNodeId   - Transmitting node.
+* @param[in] rxNodeId   - Receiving node, different from txNodeId.
+* @param[in] rateMbps   - New PHY rate.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if an index is out of range.
+*/
+INT moca_sim_SetPhyRate(ULONG ifIndex, ULONG txNodeId, ULONG rxNodeId, ULONG rateMbps);
+
+/**
+* @brief Installs a new firmware version on an interface.
+*
+* Like an upgrade on a real device the interface resets: the link re-forms,
+* the counters restart from zero and moca_GetResetCount() advances. The new
+* version is reported by moca_IfGetStaticInfo().
+*
+* @param[in] ifIndex  - Interface index.
+* @param[in] pVersion - Firmware version, shorter than FirmwareVersion.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if ifIndex or pVersion is invalid.
+*/
+INT moca_sim_SetFirmwareVersion(ULONG ifIndex, const char *pVersion);
+
+/**
+* @brief Marks every node pair as changed, so the next moca_GetFullMeshRates()
+*        rebuilds the whole table as it does after a topology change.
+*
+* @param[in] ifIndex - Interface index.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if ifIndex is invalid.
+*/
+INT moca_sim_InvalidateFullMesh(ULONG ifIndex);
+
+/**
+* @brief Starts a storm of associated device join and leave events.
+*
+* A generator thread flaps the remote nodes of the interface in turn, each
+* node alternating leave and join, at the given rate. Events are queued for a
+* dispatcher thread that calls the callback registered with
+* moca_associatedDevice_callback_register(), so a slow callback never blocks
+* the generator or the HAL. Events that find the queue full are dropped. The
+* topology reported by the other HAL calls does not change.
+*
+* @param[in] ifIndex       - Interface index, must have remote nodes.
+* @param[in] count         - Number of events to generate.
+* @param[in] eventsPerSec  - Generation rate, 0 for as fast as possible.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if ifIndex is invalid, the
+*         interface has no remote node or a storm is already running.
+*/
+INT moca_sim_GenerateDeviceEvents(ULONG ifIndex, ULONG count, ULONG eventsPerSec);
+
+/**
+* @brief Waits until the running storm is generated and every queued event is delivered or dropped.
+*
+* The first caller joins the storm thread and waits for the whole storm to be
+* generated, however long that takes. timeoutMs only bounds the wait for the
+* queue to drain afterwards, and for callers concurrent with the first one the
+* wait for it to finish joining.
+*
+* @param[in] timeoutMs - Longest time to wait for the queue to drain.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE on timeout.
+*/
+INT moca_sim_WaitDeviceEvents(ULONG timeoutMs);
+
+/**
+* @brief Identifies the event being delivered, only valid from inside the callback.
+*
+* @param[out] pInfo - Receives the sequence number and generation time.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if pInfo is NULL or the caller is not the callback.
+*/
+INT moca_sim_GetCurrentEvent(moca_sim_event_info_t *pInfo);
+
+/**
+* @brief Reads the event generator counters.
+*
+* @param[out] pStats - Receives the counters.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if pStats is NULL.
+*/
+INT moca_sim_GetEventStats(moca_sim_event_stats_t *pStats);
+
+/**
+* @brief Sets the faults injected into an API, replacing those set before.
+*
+* Takes effect on the next call, calls hung by the previous faults of the API
+* are released. Calls are not slowed down in any way while no fault is set.
+*
+* @param[in] api    - API to inject into, MOCA_SIM_API_ALL for every API.
+* @param[in] pFault - Faults to inject, NULL to stop injecting.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if api is out of range or pFault is inconsistent.
+*/
+INT moca_sim_SetFault(moca_sim_api_t api, const moca_sim_fault_t *pFault);
+
+/**
+* @brief Reads the faults injected into an API.
+*
+* @param[in]  api    - API to query.
+* @param[out] pStats - Receives the counters.
+*
+* @return STATUS_SUCCESS or STATUS_FAILURE if api is out of range or pStats is NULL.
+*/
+INT moca_sim_GetFaultStats(moca_sim_api_t api, moca_sim_fault_stats_t *pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_HAL_SIM_H__ */
@@ -0,0 +1,722 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_replay.c
+*
+* Skeleton MoCA HAL serving the calls of a recorded trace, see moca_trace.h.
+*
+* The trace named by MOCA_REPLAY_TRACE is mapped read only on the first call
+* and its records are indexed per API and interface. Each call returns the
+* next recorded result of its API on its interface, wrapping around at the
+* end, so a trace of one test run can drive any number of runs. Records of
+* calls made with a NULL pointer are not served, the replay checks pointer
+* arguments itself. An interface with no record of an API fails the call.
+* moca_FreqMaskToValue() is served from a record of the same mask.
+*
+* With MOCA_REPLAY_TIMING=original every call takes as long as it took on the
+* recording device, otherwise results are returned as fast as they are copied.
+*
+* Registered callbacks are kept but never called, the trace holds the calls
+* made into the HAL and not the events raised by it. For the same reason an
+* ACA the trace shows moca_startIfAcaAsync() accepting is reported successful
+* as soon as it starts, and moca_getIfAcaEventFd() is not supported.
+*/
+
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include "moca_trace.h"
+
+#define MOCA_REPLAY_MAX_IF            8   /**< Interfaces indexed separately, the others share one stream */
+#define MOCA_REPLAY_MAX_MESH_ENTRIES  (kMoca_MaxMocaNodes * (kMoca_MaxMocaNodes - 1))
+#define MOCA_REPLAY_MAX_FLOWS         kMoca_MaxCpeList    /**< Flow table size callers of moca_GetFlowStatistics() provide */
+
+#define NS_PER_SEC              1000000000ULL
+
+typedef struct
+{
+  const moca_trace_record_t **ppRecords;
+  uint32_t count;
+  uint32_t next;                /**< Atomic, index of the next record to serve modulo count */
+} moca_replay_stream_t;
+
+static pthread_once_t gReplayOnce = PTHREAD_ONCE_INIT;
+static moca_replay_stream_t gStreams[MOCA_TRACE_API_COUNT][MOCA_REPLAY_MAX_IF + 1];
+static BOOL gReplayOriginalTiming = FALSE;
+static moca_associatedDevice_callback gCallback = NULL;
+
+static uint64_t moca_replay_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t moca_replay_if(ULONG ifIndex)
+{
+  return (ifIndex < MOCA_REPLAY_MAX_IF) ? (uint32_t)ifIndex : MOCA_REPLAY_MAX_IF;
+}
+
+/* Calls fn for every servable record of the trace, returns the number of records */
+static uint32_t moca_replay_scan(const uint8_t *pBase, size_t size, const moca_trace_header_t *pHeader,
+                                 void (*fn)(const moca_trace_record_t *pRecord))
+{
+  size_t offset = pHeader->headerSize;
+  const moca_trace_record_t *pRecord;
+  uint32_t count = 0;
+
+  while (offset + sizeof(moca_trace_record_t) <= size)
+  {
+    pRecord = (const moca_trace_record_t *)(pBase + offset);
+    /* A trace cut short by a crash ends with a partial record */
+    if (offset + MOCA_TRACE_RECORD_SIZE(pRecord) > size)
+    {
+      break;
+    }
+    if (pRecord->api > 0 && pRecord->api < MOCA_TRACE_API_COUNT && (pRecord->flags & MOCA_TRACE_FLAG_NULL_ARGUMENT) == 0)
+    {
+      fn(pRecord);
+    }
+    offset += MOCA_TRACE_RECORD_SIZE(pRecord);
+    count++;
+  }
+  return count;
+}
+
+static void moca_replay_count(const moca_trace_record_t *pRecord)
+{
+  gStreams[pRecord->api][moca_replay_if(pRecord->ifIndex)].count++;
+}
+
+static void moca_replay_add(const moca_trace_record_t *pRecord)
+{
+  moca_replay_stream_t *pStream = &gStreams[pRecord->api][moca_replay_if(pRecord->ifIndex)];
+
+  pStream->ppRecords[pStream->next++] = pRecord;
+}
+
+static void moca_replay_load(void)
+{
+  const char *pPath = getenv("MOCA_REPLAY_TRACE");
+  const char *pTiming = getenv("MOCA_REPLAY_TIMING");
+  const moca_trace_header_t *pHeader;
+  const moca_trace_record_t **ppIndex;
+  const uint8_t *pBase;
+  struct stat st;
+  size_t total = 0;
+  uint32_t records, api, i;
+  int fd;
+
+  gReplayOriginalTiming = (pTiming != NULL && strcmp(pTiming, "original") == 0);
+  if (pPath == NULL)
+  {
+    fprintf(stderr, "moca_hal_replay: MOCA_REPLAY_TRACE not set, every call fails\n");
+    return;
+  }
+  fd = open(pPath, O_RDONLY | O_CLOEXEC);
+  if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(moca_trace_header_t))
+  {
+    fprintf(stderr, "moca_hal_replay: cannot read [%s], every call fails\n", pPath);
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+    return;
+  }
+  pBase = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (pBase == MAP_FAILED)
+  {
+    fprintf(stderr, "moca_hal_replay: cannot map [%s], every call fails\n", pPath);
+    return;
+  }
+  pHeader = (const moca_trace_header_t *)pBase;
+  if (memcmp(pHeader->magic, MOCA_TRACE_MAGIC, sizeof(pHeader->magic)) != 0 || pHeader->version != MOCA_TRACE_VERSION ||
+      pHeader->headerSize < sizeof(moca_trace_header_t) || pHeader->headerSize > (size_t)st.st_size)
+  {
+    fprintf(stderr, "moca_hal_replay: [%s] is not a version %d trace, every call fails\n", pPath, MOCA_TRACE_VERSION);
+    munmap((void *)pBase, (size_t)st.st_size);
+    return;
+  }
+  if (pHeader->layout != moca_trace_layout())
+  {
+    fprintf(stderr, "moca_hal_replay: [%s] was recorded with different structure layouts, every call fails\n", pPath);
+    munmap((void *)pBase, (size_t)st.st_size);
+    return;
+  }
+
+  records = moca_replay_scan(pBase, (size_t)st.st_size, pHeader, moca_replay_count);
+  for (api = 0; api < MOCA_TRACE_API_COUNT; api++)
+  {
+    for (i = 0; i <= MOCA_REPLAY_MAX_IF; i++)
+    {
+      total += gStreams[api][i].count;
+    }
+  }
+  if (total == 0)
+  {
+    fprintf(stderr, "moca_hal_replay: [%s] holds no calls to serve, every call fails\n", pPath);
+    return;
+  }
+  /* The index is mapped rather than allocated to stay out of the allocation accounting of the first call */
+  ppIndex = mmap(NULL, total * sizeof(*ppIndex), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ppIndex == MAP_FAILED)
+  {
+    memset(gStreams, 0, sizeof(gStreams));
+    return;
+  }
+  for (api = 0; api < MOCA_TRACE_API_COUNT; api++)
+  {
+    for (i = 0; i <= MOCA_REPLAY_MAX_IF; i++)
+    {
+      gStreams[api][i].ppRecords = ppIndex;
+      ppIndex += gStreams[api][i].count;
+    }
+  }
+  moca_replay_scan(pBase, (size_t)st.st_size, pHeader, moca_replay_add);
+  for (api = 0; api < MOCA_TRACE_API_COUNT; api++)
+  {
+    for (i = 0; i <= MOCA_REPLAY_MAX_IF; i++)
+    {
+      gStreams[api][i].next = 0;
+    }
+  }
+  fprintf(stderr, "moca_hal_replay: serving %lu of %u calls from [%s]\n", (unsigned long)total, records, pPath);
+}
+
+/* Returns the next record of an API on an interface and the time its call started, NULL if there is none */
+static const moca_trace_record_t *moca_replay_next(moca_trace_api_t api, ULONG ifIndex, uint64_t *pStartNs)
+{
+  moca_replay_stream_t *pStream;
+  uint32_t next;
+
+  *pStartNs = moca_replay_now_ns();
+  pthread_once(&gReplayOnce, moca_replay_load);
+  pStream = &gStreams[api][moca_replay_if(ifIndex)];
+  if (pStream->count == 0)
+  {
+    return NULL;
+  }
+  next = __atomic_fetch_add(&pStream->next, 1, __ATOMIC_RELAXED);
+  return pStream->ppRecords[next % pStream->count];
+}
+
+/* Returns the next record of an API whose input payload matches, for the calls that are a function of their input */
+static const moca_trace_record_t *moca_replay_next_input(moca_trace_api_t api, ULONG ifIndex, const void *pInput,
+                                                         size_t size, uint64_t *pStartNs)
+{
+  moca_replay_stream_t *pStream;
+  const moca_trace_record_t *pRecord;
+  uint32_t next, i;
+
+  *pStartNs = moca_replay_now_ns();
+  pthread_once(&gReplayOnce, moca_replay_load);
+  pStream = &gStreams[api][moca_replay_if(ifIndex)];
+  next = __atomic_load_n(&pStream->next, __ATOMIC_RELAXED);
+  for (i = 0; i < pStream->count; i++)
+  {
+    pRecord = pStream->ppRecords[(next + i) % pStream->count];
+    if (pRecord->inputSize == size && memcmp(MOCA_TRACE_INPUT(pRecord), pInput, size) == 0)
+    {
+      __atomic_store_n(&pStream->next, next + i + 1, __ATOMIC_RELAXED);
+      return pRecord;
+    }
+  }
+  return NULL;
+}
+
+/* Returns the recorded status once the call has taken as long as the recorded one, if asked to */
+static INT moca_replay_return(const moca_trace_record_t *pRecord, uint64_t startNs)
+{
+  struct timespec until;
+  uint64_t endNs;
+
+  if (gReplayOriginalTiming)
+  {
+    endNs = startNs + pRecord->durationNs;
+    until.tv_sec = (time_t)(endNs / NS_PER_SEC);
+    until.tv_nsec = (long)(endNs % NS_PER_SEC);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) != 0)
+    {
+    }
+  }
+  return pRecord->ret;
+}
+
+/* Serves a call returning one structure, the recorded output must have the size of the structure */
+static INT moca_replay_struct(moca_trace_api_t api, ULONG ifIndex, void *pData, size_t size)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  if (pData == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pRecord = moca_replay_next(api, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pRecord->ret == STATUS_SUCCESS)
+  {
+    if (pRecord->outputSize != size)
+    {
+      return STATUS_FAILURE;
+    }
+    memcpy(pData, MOCA_TRACE_OUTPUT(pRecord), size);
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+/* Serves a call returning an array into a caller buffer, pCount receives the number of entries. The APIs take no
+   capacity, a record of more than maxEntries entries, which the caller's buffer need not hold, fails the call. */
+static INT moca_replay_array(moca_trace_api_t api, ULONG ifIndex, void *pEntries, size_t entrySize, ULONG maxEntries,
+                             ULONG *pCount)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  pRecord = moca_replay_next(api, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pRecord->ret == STATUS_SUCCESS)
+  {
+    if (pRecord->value > maxEntries || pRecord->outputSize != pRecord->value * entrySize)
+    {
+      return STATUS_FAILURE;
+    }
+    memcpy(pEntries, MOCA_TRACE_OUTPUT(pRecord), pRecord->outputSize);
+    *pCount = (ULONG)pRecord->value;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+/* Serves a call returning an array the HAL allocates, *ppEntries is NULL when it is empty */
+static INT moca_replay_alloc_array(moca_trace_api_t api, ULONG ifIndex, void **ppEntries, size_t entrySize, ULONG *pCount)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  *ppEntries = NULL;
+  *pCount = 0;
+  pRecord = moca_replay_next(api, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pRecord->ret == STATUS_SUCCESS && pRecord->value > 0)
+  {
+    if (pRecord->outputSize != pRecord->value * entrySize)
+    {
+      return STATUS_FAILURE;
+    }
+    *ppEntries = malloc(pRecord->outputSize);
+    if (*ppEntries == NULL)
+    {
+      return STATUS_FAILURE;
+    }
+    memcpy(*ppEntries, MOCA_TRACE_OUTPUT(pRecord), pRecord->outputSize);
+    *pCount = (ULONG)pRecord->value;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+/* Serves a call returning only a status and the scalar value */
+static INT moca_replay_scalar(moca_trace_api_t api, ULONG ifIndex, ULONG *pValue)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  pRecord = moca_replay_next(api, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pValue != NULL && pRecord->ret == STATUS_SUCCESS)
+  {
+    *pValue = (ULONG)pRecord->value;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+void moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc)
+{
+  gCallback = callback_proc;
+}
+
+INT moca_GetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
+{
+  return moca_replay_struct(MOCA_TRACE_API_GetIfConfig, ifIndex, pmoca_config, sizeof(moca_cfg_t));
+}
+
+INT moca_SetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
+{
+  if (pmoca_config == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_scalar(MOCA_TRACE_API_SetIfConfig, ifIndex, NULL);
+}
+
+INT moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  (void)fieldMask;
+  if (pConfig == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pRecord = moca_replay_next(MOCA_TRACE_API_SetIfConfigFields, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* A call recorded without pResult leaves no output, the caller is told nothing changed */
+  if (pResult != NULL && pRecord->ret == STATUS_SUCCESS)
+  {
+    if (pRecord->outputSize == sizeof(moca_cfg_apply_result_t))
+    {
+      memcpy(pResult, MOCA_TRACE_OUTPUT(pRecord), sizeof(moca_cfg_apply_result_t));
+    }
+    else
+    {
+      memset(pResult, 0, sizeof(moca_cfg_apply_result_t));
+    }
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+INT moca_IfGetDynamicInfo(ULONG ifIndex, moca_dynamic_info_t* pmoca_dynamic_info)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetDynamicInfo, ifIndex, pmoca_dynamic_info, sizeof(moca_dynamic_info_t));
+}
+
+INT moca_IfGetStaticInfo(ULONG ifIndex, moca_static_info_t* pmoca_static_info)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetStaticInfo, ifIndex, pmoca_static_info, sizeof(moca_static_info_t));
+}
+
+INT moca_IfGetStats(ULONG ifIndex, moca_stats_t* pmoca_stats)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetStats, ifIndex, pmoca_stats, sizeof(moca_stats_t));
+}
+
+INT moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta)
+{
+  (void)generation;
+  return moca_replay_struct(MOCA_TRACE_API_IfGetStatsChangedSince, ifIndex, pDelta, sizeof(moca_stats_delta_t));
+}
+
+INT moca_GetNumAssociatedDevices(ULONG ifIndex, ULONG* pulCount)
+{
+  if (pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_scalar(MOCA_TRACE_API_GetNumAssociatedDevices, ifIndex, pulCount);
+}
+
+INT moca_IfGetExtCounter(ULONG ifIndex, moca_mac_counters_t* pmoca_mac_counters)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetExtCounter, ifIndex, pmoca_mac_counters, sizeof(moca_mac_counters_t));
+}
+
+INT moca_IfGetExtAggrCounter(ULONG ifIndex, moca_aggregate_counters_t* pmoca_aggregate_counts)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetExtAggrCounter, ifIndex, pmoca_aggregate_counts, sizeof(moca_aggregate_counters_t));
+}
+
+INT moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot)
+{
+  return moca_replay_struct(MOCA_TRACE_API_IfGetTelemetrySnapshot, ifIndex, pSnapshot, sizeof(moca_telemetry_snapshot_t));
+}
+
+INT moca_GetMocaCPEs(ULONG ifIndex, moca_cpe_t* cpes, INT* pnum_cpes)
+{
+  ULONG count = 0;
+  INT ret;
+
+  if (cpes == NULL || pnum_cpes == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  ret = moca_replay_array(MOCA_TRACE_API_GetMocaCPEs, ifIndex, cpes, sizeof(moca_cpe_t), kMoca_MaxCpeList, &count);
+  if (ret == STATUS_SUCCESS)
+  {
+    *pnum_cpes = (INT)count;
+  }
+  return ret;
+}
+
+INT moca_GetAssociatedDevices(ULONG ifIndex, moca_associated_device_t** ppdevice_array)
+{
+  ULONG count;
+
+  if (ppdevice_array == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* Records of calls that returned devices carry MOCA_TRACE_FLAG_UNKNOWN_COUNT and none, they return an empty array */
+  return moca_replay_alloc_array(MOCA_TRACE_API_GetAssociatedDevices, ifIndex, (void **)ppdevice_array,
+                                 sizeof(moca_associated_device_t), &count);
+}
+
+INT moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+  size_t size;
+
+  if (pCount == NULL || (pDevices == NULL && capacity > 0))
+  {
+    return STATUS_FAILURE;
+  }
+  pRecord = moca_replay_next(MOCA_TRACE_API_GetAssociatedDevicesInto, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* The recorded call may have had another capacity, value is the device count either way */
+  if (pRecord->value > capacity)
+  {
+    *pCount = (ULONG)pRecord->value;
+    moca_replay_return(pRecord, startNs);
+    return STATUS_FAILURE;
+  }
+  if (pRecord->ret == STATUS_SUCCESS)
+  {
+    size = pRecord->value * sizeof(moca_associated_device_t);
+    if (pRecord->outputSize != size)
+    {
+      return STATUS_FAILURE;
+    }
+    if (size > 0)
+    {
+      memcpy(pDevices, MOCA_TRACE_OUTPUT(pRecord), size);
+    }
+    *pCount = (ULONG)pRecord->value;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+INT moca_FreqMaskToValue(UCHAR* mask)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  if (mask == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* Only a recorded conversion of the same mask is served */
+  pRecord = moca_replay_next_input(MOCA_TRACE_API_FreqMaskToValue, 0, mask, strlen((const char *)mask) + 1, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+BOOL moca_HardwareEquipped(void)
+{
+  const moca_trace_record_t *pRecord;
+  uint64_t startNs;
+
+  pRecord = moca_replay_next(MOCA_TRACE_API_HardwareEquipped, 0, &startNs);
+  if (pRecord == NULL)
+  {
+    return FALSE;
+  }
+  return (moca_replay_return(pRecord, startNs) != 0) ? TRUE : FALSE;
+}
+
+INT moca_GetFullMeshRates(ULONG ifIndex, moca_mesh_table_t* pDeviceArray, ULONG* pulCount)
+{
+  if (pDeviceArray == NULL || pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_array(MOCA_TRACE_API_GetFullMeshRates, ifIndex, pDeviceArray, sizeof(moca_mesh_table_t),
+                           MOCA_REPLAY_MAX_MESH_ENTRIES, pulCount);
+}
+
+INT moca_GetFlowStatistics(ULONG ifIndex, moca_flow_table_t* pDeviceArray, ULONG* pulCount)
+{
+  if (pDeviceArray == NULL || pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_array(MOCA_TRACE_API_GetFlowStatistics, ifIndex, pDeviceArray, sizeof(moca_flow_table_t),
+                           MOCA_REPLAY_MAX_FLOWS, pulCount);
+}
+
+INT moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity,
+                               ULONG *pCount, ULONG *pNextCursor)
+{
+  const moca_trace_record_t *pRecord;
+  const moca_flow_table_t *pRecorded;
+  uint64_t startNs;
+  ULONG count;
+
+  if (pFlows == NULL || capacity == 0 || pCount == NULL || pNextCursor == NULL || cursor == MOCA_FLOW_CURSOR_END)
+  {
+    return STATUS_FAILURE;
+  }
+  pRecord = moca_replay_next(MOCA_TRACE_API_GetFlowStatisticsPage, ifIndex, &startNs);
+  if (pRecord == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pRecord->ret == STATUS_SUCCESS)
+  {
+    if (pRecord->outputSize != sizeof(ULONG) + pRecord->value * sizeof(moca_flow_table_t))
+    {
+      return STATUS_FAILURE;
+    }
+    pRecorded = (const moca_flow_table_t *)((const uint8_t *)MOCA_TRACE_OUTPUT(pRecord) + sizeof(ULONG));
+    count = (ULONG)pRecord->value;
+    memcpy(pNextCursor, MOCA_TRACE_OUTPUT(pRecord), sizeof(ULONG));
+    /* A smaller page than recorded ends at the last flow it holds */
+    if (count > capacity)
+    {
+      count = capacity;
+      *pNextCursor = pRecorded[count - 1].FlowID;
+    }
+    memcpy(pFlows, pRecorded, count * sizeof(moca_flow_table_t));
+    *pCount = count;
+  }
+  return moca_replay_return(pRecord, startNs);
+}
+
+INT moca_GetResetCount(ULONG* resetcnt)
+{
+  if (resetcnt == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  return moca_replay_scalar(MOCA_TRACE_API_GetResetCount, 0, resetcnt);
+}
+
+int moca_setIfAcaConfig(int interfaceIndex, moca_aca_cfg_t acaCfg)
+{
+  (void)acaCfg;
+  return moca_replay_scalar(MOCA_TRACE_API_setIfAcaConfig, (ULONG)interfaceIndex, NULL);
+}
+
+int moca_getIfAcaConfig(int interfaceIndex, moca_aca_cfg_t* acaCfg)
+{
+  return moca_replay_struct(MOCA_TRACE_API_getIfAcaConfig, (ULONG)interfaceIndex, acaCfg, sizeof(moca_aca_cfg_t));
+}
+
+int moca_cancelIfAca(int interfaceIndex)
+{
+  return moca_replay_scalar(MOCA_TRACE_API_cancelIfAca, (ULONG)interfaceIndex, NULL);
+}
+
+int moca_getIfAcaStatus(int interfaceIndex, moca_aca_stat_t* pacaStat)
+{
+  return moca_replay_struct(MOCA_TRACE_API_getIfAcaStatus, (ULONG)interfaceIndex, pacaStat, sizeof(moca_aca_stat_t));
+}
+
+typedef struct
+{
+  int interfaceIndex;
+  moca_aca_complete_callback callback;
+  void *pContext;
+  moca_aca_stat_t status;
+} moca_replay_aca_t;
+
+static void *moca_replay_aca_complete(void *pArg)
+{
+  moca_replay_aca_t *pAca = (moca_replay_aca_t *)pArg;
+
+  pAca->callback(pAca->interfaceIndex, &pAca->status, pAca->pContext);
+  free(pAca);
+  return NULL;
+}
+
+int moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext)
+{
+  moca_replay_aca_t *pAca;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int ret = moca_replay_scalar(MOCA_TRACE_API_startIfAcaAsync, (ULONG)interfaceIndex, NULL);
+
+  if (ret != STATUS_SUCCESS || callback == NULL)
+  {
+    return ret;
+  }
+  pAca = calloc(1, sizeof(moca_replay_aca_t));
+  if (pAca == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pAca->interfaceIndex = interfaceIndex;
+  pAca->callback = callback;
+  pAca->pContext = pContext;
+  pAca->status.acaStatus = MOCA_ACA_STATUS_SUCCESS;
+  pAca->status.acaType = acaCfg.type;
+  /* The callback runs on a thread of the HAL, as it would on the device */
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&thread, &attr, moca_replay_aca_complete, pAca) != 0)
+  {
+    free(pAca);
+    ret = STATUS_FAILURE;
+  }
+  pthread_attr_destroy(&attr);
+  return ret;
+}
+
+int moca_getIfAcaEventFd(int interfaceIndex)
+{
+  (void)interfaceIndex;
+  return -1;
+}
+
+int moca_getIfScmod(int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat)
+{
+  ULONG count = 0;
+  int ret;
+
+  if (pnumOfEntries == NULL || ppscmodStat == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  ret = moca_replay_alloc_array(MOCA_TRACE_API_getIfScmod, (ULONG)interfaceIndex, (void **)ppscmodStat,
+                                sizeof(moca_scmod_stat_t), &count);
+  *pnumOfEntries = (int)count;
+  return ret;
+}
@@ -16,174 +16,2477 @@
 * limitations under the License.
 */
 
+/**
+* @file moca_hal.c
+*
+* Skeleton MoCA HAL backed by an in-memory network simulator, see moca_hal_sim.h.
+*
+* Each interface is a network of numNodes nodes, the local node being the
+* network coordinator. Traffic counters are not stored but derived from the
+* configured byte rates and the time elapsed since the link came up, so every
+* read returns a self consistent snapshot computed at a single instant.
+* Counters are truncated to the 32 bit width of the MoCA MAC registers.
+*/
+
 #include <string.h>
+#include <stddef.h>
 #include <stdlib.h>
-#include <setjmp.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include "moca_hal.h"
+#include "moca_hal_sim.h"
+#include "moca_hal_ext.h"
+
+#define MOCA_SIM_DEFAULT_INTERFACES       2
+#define MOCA_SIM_DEFAULT_NODES            8
+#define MOCA_SIM_DEFAULT_CPES_PER_NODE    4
+#define MOCA_SIM_DEFAULT_FLOWS_PER_NODE   2
+#define MOCA_SIM_DEFAULT_TX_BPS           12500000UL
+#define MOCA_SIM_DEFAULT_RX_BPS           25000000UL
+#define MOCA_SIM_DEFAULT_ACA_MS           500
+#define MOCA_SIM_DEFAULT_REFORM_MS        0
+
+#define MOCA_SIM_LOCAL_NODE_ID            0
+#define MOCA_SIM_BACKUP_NC_NODE_ID        1
+#define MOCA_SIM_PACKET_SIZE              1024    /**< Average packet size used to derive packet counts */
+#define MOCA_SIM_TX_PER_AGGREGATE         6       /**< Average packets per transmitted aggregate */
+#define MOCA_SIM_RX_PER_AGGREGATE         8       /**< Average packets per received aggregate */
+#define MOCA_SIM_COUNTER_MASK             0xFFFFFFFFUL
+#define MOCA_SIM_MIN_PHY_RATE             400     /**< Mbps */
+#define MOCA_SIM_MAX_PHY_RATE             700     /**< Mbps */
+#define MOCA_SIM_MAX_BITS_PER_SUBCARRIER  10      /**< 1024-QAM */
+#define MOCA_SIM_OPER_FREQ                1150    /**< MHz, channel D1 */
+#define MOCA_SIM_FLOW_LEASE_TIME          3600    /**< Seconds */
+#define MOCA_SIM_MAX_ACA_MS               60000
+#define MOCA_SIM_MAX_REFORM_MS            60000
+#define MOCA_SIM_ACA_JITTER_PERCENT       10      /**< ACA run times vary by up to this much either way */
+
+#define MOCA_FREQ_MASK_LENGTH             16      /**< Hex digits in a frequency mask */
+#define MOCA_FREQ_MASK_BASE               800     /**< MHz represented by the least significant bit */
+#define MOCA_FREQ_MASK_STEP               25      /**< MHz per bit */
+
+#define MOCA_TX_POWER_LIMIT_MIN           -31
+#define MOCA_TX_POWER_LIMIT_MAX           7
+
+#define NS_PER_SEC                        1000000000ULL
+#define MOCA_SIM_PPM                      1000000UL
+#define MOCA_SIM_MAX_FAULT_ENV            1024    /**< Longest MOCA_SIM_FAULTS value */
+
+typedef struct
+{
+  moca_associated_device_t device;    /**< Counter fields are filled on read */
+  ULONG trafficShare;                 /**< Weight of the node in the interface traffic */
+} moca_sim_node_t;
+
+typedef struct
+{
+  pthread_rwlock_t lock;
+  ULONG ifIndex;
+  moca_cfg_t config;
+  moca_static_info_t staticInfo;
+  ULONG numNodes;
+  moca_sim_node_t nodes[MOCA_SIM_MAX_NODES];
+  ULONG totalShare;
+  ULONG phyRate[MOCA_SIM_MAX_NODES][MOCA_SIM_MAX_NODES];   /**< [tx][rx] in Mbps */
+  moca_mesh_table_t mesh[MOCA_SIM_MAX_NODES * (MOCA_SIM_MAX_NODES - 1)];   /**< Last moca_GetFullMeshRates() table */
+  uint32_t meshDirty[MOCA_SIM_MAX_NODES];   /**< [tx] bit rx set while mesh[] does not match phyRate[tx][rx] */
+  BOOL meshStale;                     /**< Any meshDirty bit set */
+  moca_cpe_t cpes[kMoca_MaxCpeList];
+  ULONG numCpes;
+  moca_flow_table_t *flows;
+  ULONG numFlows;
+  moca_aca_cfg_t acaConfig;
+  moca_aca_stat_t acaStatus;
+  uint64_t acaStartNs;
+  uint64_t acaDurationNs;             /**< Run time of the current ACA */
+  ULONG acaSequence;                  /**< ACAs started, varies their run time */
+  BOOL acaNotify;                     /**< The end of the current ACA is still to be notified */
+  moca_aca_complete_callback acaCallback;   /**< Of the current ACA, NULL when started by moca_setIfAcaConfig() */
+  void *acaContext;
+  ULONG acaSuperseded;                /**< Replaced ACAs whose end is still to be notified */
+  moca_aca_complete_callback acaSupersededCallback;
+  void *acaSupersededContext;
+  moca_aca_stat_t acaSupersededStatus;
+  int acaEventFd;                     /**< -1 until moca_getIfAcaEventFd() */
+  ULONG txBytesPerSec;
+  ULONG rxBytesPerSec;
+  uint64_t txBytesBase;               /**< Bytes accrued before baseNs */
+  uint64_t rxBytesBase;
+  uint64_t baseNs;                    /**< Time the current rates took effect */
+  uint64_t linkUpNs;                  /**< Time the link last formed, counters start from here */
+  uint64_t reformUntilNs;             /**< The link is down re-forming until then */
+  pthread_mutex_t statsLock;          /**< Guards the change tracking below, taken before lock */
+  uint64_t statsGeneration;           /**< 0 until the first moca_IfGetStatsChangedSince() */
+  uint64_t statsFieldGeneration[MOCA_STATS_FIELD_COUNT];
+  moca_stats_t statsCache;            /**< Counters as of statsGeneration */
+  uint64_t statsTxBytes;              /**< Traffic the cache was computed from */
+  uint64_t statsRxBytes;
+} moca_sim_if_t;
+
+typedef struct
+{
+  uint64_t sequence;
+  uint64_t timestampNs;
+  ULONG ifIndex;
+  ULONG nodeId;
+  BOOL active;
+} moca_sim_event_t;
+
+typedef struct
+{
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  uint64_t txPackets;
+  uint64_t rxPackets;
+  uint64_t upNs;
+} moca_sim_traffic_t;
+
+static pthread_once_t gSimOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t gSimMutex = PTHREAD_MUTEX_INITIALIZER;   /**< Serialises reconfiguration and the reset count */
+static moca_sim_config_t gSimDefaultConfig;
+static moca_sim_config_t gSimConfig;
+static moca_sim_if_t gSimIf[MOCA_SIM_MAX_INTERFACES];
+static ULONG gSimNumInterfaces = 0;     /**< Atomic, interfaces moca_sim_get_if() serves */
+static ULONG gResetCount = 0;
+static moca_associatedDevice_callback gAssociatedDeviceCallback = NULL;
+
+/* Device event storm, guarded by gSimEventMutex */
+static pthread_mutex_t gSimEventMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gSimEventCond = PTHREAD_COND_INITIALIZER;
+static moca_sim_event_t gSimEventQueue[MOCA_SIM_EVENT_QUEUE_DEPTH];
+static ULONG gSimEventHead = 0;
+static ULONG gSimEventCount = 0;
+static BOOL gSimEventDispatching = FALSE;
+static BOOL gSimDispatcherStarted = FALSE;
+static BOOL gSimStormRunning = FALSE;
+static BOOL gSimStormJoining = FALSE;     /**< A waiter took gSimStormThread to join it, gSimStorm still in use */
+static pthread_t gSimStormThread;
+static uint64_t gSimEventSequence = 0;
+static moca_sim_event_stats_t gSimEventStats;
+static __thread const moca_sim_event_t *gSimCurrentEvent = NULL;   /**< Set on the dispatcher thread during a callback */
+
+typedef struct
+{
+  ULONG ifIndex;
+  ULONG count;
+  ULONG eventsPerSec;
+  ULONG remoteNodes;
+} moca_sim_storm_t;
+
+static moca_sim_storm_t gSimStorm;
+
+/* ACA completion, the worker sleeps until the next ACA ends then notifies it */
+static pthread_mutex_t gSimAcaMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gSimAcaCond = PTHREAD_COND_INITIALIZER;
+static BOOL gSimAcaWorkerStarted = FALSE;
+
+/* Fault injection, guarded by gSimFaultMutex */
+static pthread_mutex_t gSimFaultMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gSimFaultCond = PTHREAD_COND_INITIALIZER;
+static moca_sim_fault_t gSimFaults[MOCA_SIM_API_COUNT];
+static moca_sim_fault_stats_t gSimFaultStats[MOCA_SIM_API_COUNT];
+static uint64_t gSimFaultGeneration[MOCA_SIM_API_COUNT];   /**< Bumped when the faults of the API change, ends its hangs */
+static uint32_t gSimFaultCount = 0;     /**< APIs with a fault set, also read without the mutex on every call */
+static uint32_t gSimFaultThreads = 0;
+static __thread uint32_t gSimFaultRandom = 0;
+
+/* Function name of every moca_sim_api_t, as MOCA_SIM_FAULTS names them */
+static const char *gSimApiNames[MOCA_SIM_API_COUNT] =
+{
+  [MOCA_SIM_API_GetIfConfig] = "moca_GetIfConfig",
+  [MOCA_SIM_API_SetIfConfig] = "moca_SetIfConfig",
+  [MOCA_SIM_API_IfGetDynamicInfo] = "moca_IfGetDynamicInfo",
+  [MOCA_SIM_API_IfGetStaticInfo] = "moca_IfGetStaticInfo",
+  [MOCA_SIM_API_IfGetStats] = "moca_IfGetStats",
+  [MOCA_SIM_API_GetNumAssociatedDevices] = "moca_GetNumAssociatedDevices",
+  [MOCA_SIM_API_IfGetExtCounter] = "moca_IfGetExtCounter",
+  [MOCA_SIM_API_IfGetExtAggrCounter] = "moca_IfGetExtAggrCounter",
+  [MOCA_SIM_API_GetMocaCPEs] = "moca_GetMocaCPEs",
+  [MOCA_SIM_API_GetAssociatedDevices] = "moca_GetAssociatedDevices",
+  [MOCA_SIM_API_FreqMaskToValue] = "moca_FreqMaskToValue",
+  [MOCA_SIM_API_HardwareEquipped] = "moca_HardwareEquipped",
+  [MOCA_SIM_API_GetFullMeshRates] = "moca_GetFullMeshRates",
+  [MOCA_SIM_API_GetFlowStatistics] = "moca_GetFlowStatistics",
+  [MOCA_SIM_API_GetResetCount] = "moca_GetResetCount",
+  [MOCA_SIM_API_setIfAcaConfig] = "moca_setIfAcaConfig",
+  [MOCA_SIM_API_getIfAcaConfig] = "moca_getIfAcaConfig",
+  [MOCA_SIM_API_cancelIfAca] = "moca_cancelIfAca",
+  [MOCA_SIM_API_getIfAcaStatus] = "moca_getIfAcaStatus",
+  [MOCA_SIM_API_getIfScmod] = "moca_getIfScmod",
+  [MOCA_SIM_API_IfGetTelemetrySnapshot] = "moca_IfGetTelemetrySnapshot",
+  [MOCA_SIM_API_GetAssociatedDevicesInto] = "moca_GetAssociatedDevicesInto",
+  [MOCA_SIM_API_IfGetStatsChangedSince] = "moca_IfGetStatsChangedSince",
+  [MOCA_SIM_API_GetFlowStatisticsPage] = "moca_GetFlowStatisticsPage",
+  [MOCA_SIM_API_startIfAcaAsync] = "moca_startIfAcaAsync",
+  [MOCA_SIM_API_getIfAcaEventFd] = "moca_getIfAcaEventFd",
+  [MOCA_SIM_API_SetIfConfigFields] = "moca_SetIfConfigFields"
+};
+
+/* moca_stats_t offset of every moca_stats_field_t */
+static const size_t gSimStatsFieldOffset[MOCA_STATS_FIELD_COUNT] =
+{
+  [MOCA_STATS_BYTES_SENT] = offsetof(moca_stats_t, BytesSent),
+  [MOCA_STATS_BYTES_RECEIVED] = offsetof(moca_stats_t, BytesReceived),
+  [MOCA_STATS_PACKETS_SENT] = offsetof(moca_stats_t, PacketsSent),
+  [MOCA_STATS_PACKETS_RECEIVED] = offsetof(moca_stats_t, PacketsReceived),
+  [MOCA_STATS_ERRORS_SENT] = offsetof(moca_stats_t, ErrorsSent),
+  [MOCA_STATS_ERRORS_RECEIVED] = offsetof(moca_stats_t, ErrorsReceived),
+  [MOCA_STATS_UNICAST_PACKETS_SENT] = offsetof(moca_stats_t, UnicastPacketsSent),
+  [MOCA_STATS_UNICAST_PACKETS_RECEIVED] = offsetof(moca_stats_t, UnicastPacketsReceived),
+  [MOCA_STATS_DISCARD_PACKETS_SENT] = offsetof(moca_stats_t, DiscardPacketsSent),
+  [MOCA_STATS_DISCARD_PACKETS_RECEIVED] = offsetof(moca_stats_t, DiscardPacketsReceived),
+  [MOCA_STATS_MULTICAST_PACKETS_SENT] = offsetof(moca_stats_t, MulticastPacketsSent),
+  [MOCA_STATS_MULTICAST_PACKETS_RECEIVED] = offsetof(moca_stats_t, MulticastPacketsReceived),
+  [MOCA_STATS_BROADCAST_PACKETS_SENT] = offsetof(moca_stats_t, BroadcastPacketsSent),
+  [MOCA_STATS_BROADCAST_PACKETS_RECEIVED] = offsetof(moca_stats_t, BroadcastPacketsReceived),
+  [MOCA_STATS_UNKNOWN_PROTO_PACKETS_RECEIVED] = offsetof(moca_stats_t, UnknownProtoPacketsReceived),
+  [MOCA_STATS_EXT_AGGR_AVG_TX] = offsetof(moca_stats_t, ExtAggrAvgTx),
+  [MOCA_STATS_EXT_AGGR_AVG_RX] = offsetof(moca_stats_t, ExtAggrAvgRx)
+};
+
+#define MOCA_SIM_STATS_FIELD(pStats, field)   (*(ULONG *)((UCHAR *)(pStats) + gSimStatsFieldOffset[field]))
+
+typedef struct
+{
+  size_t offset;
+  size_t size;
+  BOOL string;                        /**< Compared up to the terminating NUL */
+} moca_sim_cfg_field_t;
+
+#define MOCA_SIM_CFG_FIELD(field, string)     { offsetof(moca_cfg_t, field), sizeof(((moca_cfg_t *)0)->field), string }
+
+/* moca_cfg_t member of every moca_cfg_field_t */
+static const moca_sim_cfg_field_t gSimCfgFields[MOCA_CFG_FIELD_COUNT] =
+{
+  [MOCA_CFG_INSTANCE_NUMBER] = MOCA_SIM_CFG_FIELD(InstanceNumber, FALSE),
+  [MOCA_CFG_ALIAS] = MOCA_SIM_CFG_FIELD(Alias, TRUE),
+  [MOCA_CFG_ENABLED] = MOCA_SIM_CFG_FIELD(bEnabled, FALSE),
+  [MOCA_CFG_PREFERRED_NC] = MOCA_SIM_CFG_FIELD(bPreferredNC, FALSE),
+  [MOCA_CFG_PRIVACY_ENABLED] = MOCA_SIM_CFG_FIELD(PrivacyEnabledSetting, FALSE),
+  [MOCA_CFG_FREQ_CURRENT_MASK] = MOCA_SIM_CFG_FIELD(FreqCurrentMaskSetting, FALSE),
+  [MOCA_CFG_KEY_PASSPHRASE] = MOCA_SIM_CFG_FIELD(KeyPassphrase, TRUE),
+  [MOCA_CFG_TX_POWER_LIMIT] = MOCA_SIM_CFG_FIELD(TxPowerLimit, FALSE),
+  [MOCA_CFG_AUTO_POWER_CONTROL_PHY_RATE] = MOCA_SIM_CFG_FIELD(AutoPowerControlPhyRate, FALSE),
+  [MOCA_CFG_BEACON_POWER_LIMIT] = MOCA_SIM_CFG_FIELD(BeaconPowerLimit, FALSE),
+  [MOCA_CFG_MAX_INGRESS_BW_THRESHOLD] = MOCA_SIM_CFG_FIELD(MaxIngressBWThreshold, FALSE),
+  [MOCA_CFG_MAX_EGRESS_BW_THRESHOLD] = MOCA_SIM_CFG_FIELD(MaxEgressBWThreshold, FALSE),
+  [MOCA_CFG_RESET] = MOCA_SIM_CFG_FIELD(Reset, FALSE),
+  [MOCA_CFG_MIXED_MODE] = MOCA_SIM_CFG_FIELD(MixedMode, FALSE),
+  [MOCA_CFG_CHANNEL_SCANNING] = MOCA_SIM_CFG_FIELD(ChannelScanning, FALSE),
+  [MOCA_CFG_AUTO_POWER_CONTROL_ENABLE] = MOCA_SIM_CFG_FIELD(AutoPowerControlEnable, FALSE),
+  [MOCA_CFG_ENABLE_TABOO_BIT] = MOCA_SIM_CFG_FIELD(EnableTabooBit, FALSE),
+  [MOCA_CFG_NODE_TABOO_MASK] = MOCA_SIM_CFG_FIELD(NodeTabooMask, FALSE),
+  [MOCA_CFG_CHANNEL_SCAN_MASK] = MOCA_SIM_CFG_FIELD(ChannelScanMask, FALSE)
+};
+
+/* Hex digit value plus one for every character, 0 for anything that is not a hex digit */
+static const uint8_t gSimHexDigit[256] =
+{
+  ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+  ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+  ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16
+};
+
+static uint64_t moca_sim_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t moca_sim_random(uint32_t *pState)
+{
+  /* xorshift32, deterministic for a given seed */
+  uint32_t x = *pState;
 
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *pState = x;
+  return x;
+}
+
+static uint32_t moca_sim_hash(uint32_t a, uint32_t b, uint32_t c)
+{
+  uint32_t h = a * 0x9E3779B1u ^ b * 0x85EBCA77u ^ c * 0xC2B2AE3Du;
+
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  return h;
+}
+
+static ULONG moca_sim_env(const char *name, ULONG defaultValue)
+{
+  const char *value = getenv(name);
+  char *end = NULL;
+  unsigned long parsed;
+
+  if (value == NULL || *value == '\0')
+  {
+    return defaultValue;
+  }
+  parsed = strtoul(value, &end, 0);
+  return (*end == '\0') ? (ULONG)parsed : defaultValue;
+}
+
+static BOOL moca_sim_config_valid(const moca_sim_config_t *pConfig)
+{
+  if (pConfig->numNodes < 1 || pConfig->numNodes > MOCA_SIM_MAX_NODES)
+  {
+    return FALSE;
+  }
+  if (pConfig->numNodes * pConfig->cpesPerNode > kMoca_MaxCpeList)
+  {
+    return FALSE;
+  }
+  if (pConfig->flowsPerNode > MOCA_SIM_MAX_FLOWS_PER_NODE)
+  {
+    return FALSE;
+  }
+  if (pConfig->acaDurationMs < 1 || pConfig->acaDurationMs > MOCA_SIM_MAX_ACA_MS)
+  {
+    return FALSE;
+  }
+  if (pConfig->numInterfaces < 1 || pConfig->numInterfaces > MOCA_SIM_MAX_INTERFACES)
+  {
+    return FALSE;
+  }
+  if (pConfig->reformMs > MOCA_SIM_MAX_REFORM_MS)
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static BOOL moca_sim_if_config_valid(const moca_cfg_t *pCfg)
+{
+  if (pCfg->TxPowerLimit < MOCA_TX_POWER_LIMIT_MIN || pCfg->TxPowerLimit > MOCA_TX_POWER_LIMIT_MAX)
+  {
+    return FALSE;
+  }
+  if (memchr(pCfg->KeyPassphrase, '\0', sizeof(pCfg->KeyPassphrase)) == NULL)
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static void moca_sim_format_mac(CHAR *pBuffer, size_t size, const UCHAR *pMac)
+{
+  snprintf(pBuffer, size, "%02x:%02x:%02x:%02x:%02x:%02x",
+           pMac[0], pMac[1], pMac[2], pMac[3], pMac[4], pMac[5]);
+}
+
+static void moca_sim_mask_to_bytes(UCHAR *pBytes, uint64_t mask)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+  {
+    pBytes[i] = (UCHAR)(mask >> (56 - 8 * i));
+  }
+}
+
+static uint64_t moca_sim_freq_to_mask(ULONG freq)
+{
+  return 1ULL << ((freq - MOCA_FREQ_MASK_BASE) / MOCA_FREQ_MASK_STEP);
+}
+
+/* Position of the [tx][rx] pair in the table, which skips the tx == rx entries */
+static ULONG moca_sim_mesh_index(const moca_sim_if_t *pIf, ULONG tx, ULONG rx)
+{
+  return tx * (pIf->numNodes - 1) + ((rx < tx) ? rx : rx - 1);
+}
+
+/* Caller holds the interface write lock */
+static void moca_sim_mesh_invalidate_all(moca_sim_if_t *pIf)
+{
+  uint32_t allNodes = (uint32_t)((1UL << pIf->numNodes) - 1);
+  ULONG tx;
+
+  memset(pIf->meshDirty, 0, sizeof(pIf->meshDirty));
+  for (tx = 0; tx < pIf->numNodes; tx++)
+  {
+    pIf->meshDirty[tx] = allNodes & ~(1U << tx);
+  }
+  pIf->meshStale = (pIf->numNodes > 1) ? TRUE : FALSE;
+}
+
+/* Caller holds the interface write lock, rebuilds only the pairs whose rates changed */
+static void moca_sim_mesh_refresh(moca_sim_if_t *pIf)
+{
+  ULONG tx;
+
+  for (tx = 0; tx < pIf->numNodes; tx++)
+  {
+    uint32_t dirty = pIf->meshDirty[tx];
+
+    while (dirty != 0)
+    {
+      ULONG rx = (ULONG)__builtin_ctz(dirty);
+      moca_mesh_table_t *pEntry = &pIf->mesh[moca_sim_mesh_index(pIf, tx, rx)];
+
+      dirty &= dirty - 1;
+      pEntry->RxNodeID = rx;
+      pEntry->TxNodeID = tx;
+      pEntry->TxRate = pIf->phyRate[tx][rx];
+      pEntry->TxRateNper = pIf->phyRate[tx][rx];
+      pEntry->TxRateVlper = pIf->phyRate[tx][rx] * 9 / 10;
+    }
+    pIf->meshDirty[tx] = 0;
+  }
+  pIf->meshStale = FALSE;
+}
+
+/* Caller holds the interface write lock */
+static void moca_sim_link_up(moca_sim_if_t *pIf, uint64_t now)
+{
+  pIf->txBytesBase = 0;
+  pIf->rxBytesBase = 0;
+  pIf->baseNs = now;
+  pIf->linkUpNs = now;
+}
+
+/* Caller holds the interface lock. The counters restart at once, the link reports down for reformMs */
+static void moca_sim_reform(moca_sim_if_t *pIf, uint64_t now)
+{
+  moca_sim_link_up(pIf, now);
+  pIf->reformUntilNs = now + (uint64_t)gSimConfig.reformMs * 1000000ULL;
+}
+
+/* Caller holds the interface lock. The broadcast power follows the power limit, the taboo mask the configured one */
+static void moca_sim_apply_static_config(moca_sim_if_t *pIf)
+{
+  pIf->staticInfo.TxBcastPowerReduction = (ULONG)(MOCA_TX_POWER_LIMIT_MAX - pIf->config.TxPowerLimit);
+  if (pIf->config.EnableTabooBit)
+  {
+    memcpy(pIf->staticInfo.NetworkTabooMask, pIf->config.NodeTabooMask, sizeof(pIf->staticInfo.NetworkTabooMask));
+  }
+  else
+  {
+    memset(pIf->staticInfo.NetworkTabooMask, 0, sizeof(pIf->staticInfo.NetworkTabooMask));
+  }
+}
+
+/* Caller holds the interface lock */
+static void moca_sim_traffic(const moca_sim_if_t *pIf, uint64_t now, moca_sim_traffic_t *pTraffic)
+{
+  uint64_t elapsed = now - pIf->baseNs;
+  uint64_t seconds = elapsed / NS_PER_SEC;
+  uint64_t remainder = elapsed % NS_PER_SEC;
+
+  pTraffic->txBytes = pIf->txBytesBase + (uint64_t)pIf->txBytesPerSec * seconds
+                      + (uint64_t)pIf->txBytesPerSec * remainder / NS_PER_SEC;
+  pTraffic->rxBytes = pIf->rxBytesBase + (uint64_t)pIf->rxBytesPerSec * seconds
+                      + (uint64_t)pIf->rxBytesPerSec * remainder / NS_PER_SEC;
+  pTraffic->txPackets = pTraffic->txBytes / MOCA_SIM_PACKET_SIZE;
+  pTraffic->rxPackets = pTraffic->rxBytes / MOCA_SIM_PACKET_SIZE;
+  pTraffic->upNs = now - pIf->linkUpNs;
+}
+
+static ULONG moca_sim_counter(uint64_t value)
+{
+  return (ULONG)(value & MOCA_SIM_COUNTER_MASK);
+}
+
+static void moca_sim_build_config(moca_sim_if_t *pIf)
+{
+  moca_cfg_t *pCfg = &pIf->config;
+
+  memset(pCfg, 0, sizeof(*pCfg));
+  pCfg->InstanceNumber = pIf->ifIndex + 1;
+  snprintf(pCfg->Alias, sizeof(pCfg->Alias), "MoCA%lu", pIf->ifIndex + 1);
+  pCfg->bEnabled = TRUE;
+  pCfg->bPreferredNC = TRUE;
+  pCfg->PrivacyEnabledSetting = FALSE;
+  snprintf((char *)pCfg->FreqCurrentMaskSetting, sizeof(pCfg->FreqCurrentMaskSetting),
+           "%016llx", (unsigned long long)moca_sim_freq_to_mask(MOCA_SIM_OPER_FREQ));
+  snprintf(pCfg->KeyPassphrase, sizeof(pCfg->KeyPassphrase), "99999999988888888");
+  pCfg->TxPowerLimit = MOCA_TX_POWER_LIMIT_MAX;
+  pCfg->AutoPowerControlPhyRate = 550;
+  pCfg->BeaconPowerLimit = 0;
+  pCfg->MaxIngressBWThreshold = 0;
+  pCfg->MaxEgressBWThreshold = 0;
+  pCfg->Reset = FALSE;
+  pCfg->MixedMode = FALSE;
+  pCfg->ChannelScanning = FALSE;
+  pCfg->AutoPowerControlEnable = TRUE;
+  pCfg->EnableTabooBit = FALSE;
+}
+
+static void moca_sim_build_network(moca_sim_if_t *pIf, const moca_sim_config_t *pConfig)
+{
+  uint32_t rng = (uint32_t)(pConfig->seed * 2654435761u + pIf->ifIndex + 1);
+  moca_static_info_t *pStatic = &pIf->staticInfo;
+  ULONG tx, rx, i, j;
+
+  if (rng == 0)
+  {
+    rng = 1;
+  }
+
+  pIf->numNodes = pConfig->numNodes;
+
+  memset(pStatic, 0, sizeof(*pStatic));
+  snprintf(pStatic->Name, sizeof(pStatic->Name), "moca%lu", pIf->ifIndex);
+  pStatic->MacAddress[0] = 0x00;
+  pStatic->MacAddress[1] = 0x10;
+  pStatic->MacAddress[2] = 0x18;
+  pStatic->MacAddress[3] = (UCHAR)pIf->ifIndex;
+  pStatic->MacAddress[4] = 0x00;
+  pStatic->MacAddress[5] = MOCA_SIM_LOCAL_NODE_ID;
+  snprintf(pStatic->FirmwareVersion, sizeof(pStatic->FirmwareVersion), "moca-sim-2.5.0");
+  pStatic->MaxBitRate = 2500;
+  snprintf(pStatic->HighestVersion, sizeof(pStatic->HighestVersion), "2.5");
+  /* Band D, 1125 - 1675 MHz */
+  moca_sim_mask_to_bytes(pStatic->FreqCapabilityMask, ((1ULL << 23) - 1) << 13);
+  pStatic->TxBcastPowerReduction = 0;
+  pStatic->QAM256Capable = TRUE;
+  pStatic->PacketAggregationCapability = TRUE;
+
+  for (tx = 0; tx < MOCA_SIM_MAX_NODES; tx++)
+  {
+    for (rx = 0; rx < MOCA_SIM_MAX_NODES; rx++)
+    {
+      pIf->phyRate[tx][rx] = (tx == rx) ? 0 :
+        MOCA_SIM_MIN_PHY_RATE + moca_sim_random(&rng) % (MOCA_SIM_MAX_PHY_RATE - MOCA_SIM_MIN_PHY_RATE + 1);
+    }
+  }
+
+  moca_sim_mesh_invalidate_all(pIf);
+
+  memset(pIf->nodes, 0, sizeof(pIf->nodes));
+  pIf->totalShare = 0;
+  for (i = 0; i < pIf->numNodes; i++)
+  {
+    moca_sim_node_t *pNode = &pIf->nodes[i];
+    moca_associated_device_t *pDevice = &pNode->device;
+
+    memcpy(pDevice->MACAddress, pStatic->MacAddress, sizeof(pDevice->MACAddress));
+    pDevice->MACAddress[4] = (UCHAR)(moca_sim_random(&rng) & 0xFF);
+    pDevice->MACAddress[5] = (UCHAR)i;
+    pDevice->NodeID = i;
+    pDevice->PreferredNC = (i == MOCA_SIM_LOCAL_NODE_ID) ? TRUE : FALSE;
+    snprintf(pDevice->HighestVersion, sizeof(pDevice->HighestVersion), (i % 4 == 3) ? "2.0" : "2.5");
+    pDevice->PHYTxRate = pIf->phyRate[i][MOCA_SIM_LOCAL_NODE_ID];
+    pDevice->PHYRxRate = pIf->phyRate[MOCA_SIM_LOCAL_NODE_ID][i];
+    pDevice->TxPowerControlReduction = moca_sim_random(&rng) % 10;
+    pDevice->RxPowerLevel = -(INT)(20 + moca_sim_random(&rng) % 30);
+    pDevice->TxBcastRate = MOCA_SIM_MIN_PHY_RATE;
+    pDevice->RxBcastPowerLevel = pDevice->RxPowerLevel - 2;
+    pDevice->QAM256Capable = TRUE;
+    pDevice->PacketAggregationCapability = TRUE;
+    pDevice->RxSNR = 30 + moca_sim_random(&rng) % 15;
+    pDevice->Active = TRUE;
+    pDevice->RxBcastRate = MOCA_SIM_MIN_PHY_RATE;
+    pDevice->NumberOfClients = pConfig->cpesPerNode;
+    pNode->trafficShare = (i == MOCA_SIM_LOCAL_NODE_ID) ? 0 : 1 + moca_sim_random(&rng) % 8;
+    pIf->totalShare += pNode->trafficShare;
+  }
+
+  pIf->numCpes = 0;
+  for (i = 0; i < pIf->numNodes; i++)
+  {
+    for (j = 0; j < pConfig->cpesPerNode; j++)
+    {
+      UCHAR *pMac = pIf->cpes[pIf->numCpes++].mac_addr;
+
+      pMac[0] = 0x02;   /* Locally administered */
+      pMac[1] = (UCHAR)pIf->ifIndex;
+      pMac[2] = (UCHAR)i;
+      pMac[3] = (UCHAR)j;
+      pMac[4] = (UCHAR)(moca_sim_random(&rng) & 0xFF);
+      pMac[5] = (UCHAR)(moca_sim_random(&rng) & 0xFF);
+    }
+  }
+
+  free(pIf->flows);
+  pIf->flows = NULL;
+  pIf->numFlows = 0;
+  if (pIf->numNodes > 1 && pConfig->flowsPerNode > 0)
+  {
+    pIf->flows = calloc(pIf->numNodes * pConfig->flowsPerNode, sizeof(moca_flow_table_t));
+    for (i = 0; pIf->flows != NULL && i < pIf->numNodes; i++)
+    {
+      for (j = 0; j < pConfig->flowsPerNode; j++)
+      {
+        moca_flow_table_t *pFlow = &pIf->flows[pIf->numFlows];
+        UCHAR group[6] = { 0x01, 0x00, 0x5e, 0x00, (UCHAR)i, (UCHAR)j };
+
+        pFlow->FlowID = ++pIf->numFlows;
+        pFlow->IngressNodeID = i;
+        pFlow->EgressNodeID = (i + 1 + j % (pIf->numNodes - 1)) % pIf->numNodes;
+        pFlow->LeaseTime = MOCA_SIM_FLOW_LEASE_TIME;
+        pFlow->FlowTimeLeft = MOCA_SIM_FLOW_LEASE_TIME;
+        moca_sim_format_mac(pFlow->DestinationMACAddress, sizeof(pFlow->DestinationMACAddress), group);
+        pFlow->PacketSize = 1316;
+        pFlow->PeakDataRate = 8000 + moca_sim_random(&rng) % 12000;
+        pFlow->BurstSize = 2;
+        pFlow->FlowTag = j;
+      }
+    }
+  }
+
+  memset(&pIf->acaConfig, 0, sizeof(pIf->acaConfig));
+  pIf->acaConfig.NodeID = MOCA_SIM_LOCAL_NODE_ID;
+  pIf->acaConfig.type = MOCA_ACA_TYPE_EVM;
+  pIf->acaConfig.channel = MOCA_SIM_OPER_FREQ;
+  pIf->acaConfig.ReportNodes = (UINT)((1UL << pIf->numNodes) - 1);
+  pIf->acaConfig.ACAStart = FALSE;
+  memset(&pIf->acaStatus, 0, sizeof(pIf->acaStatus));
+  pIf->acaStatus.acaStatus = MOCA_ACA_STATUS_SUCCESS;
+  pIf->acaStatus.acaType = MOCA_ACA_TYPE_EVM;
+  if (pIf->acaNotify == TRUE)
+  {
+    /* Reconfiguring the network aborts a running ACA */
+    pIf->acaStatus.acaStatus = MOCA_ACA_STATUS_FAIL;
+  }
+  pIf->acaStartNs = 0;
+
+  pIf->txBytesPerSec = pConfig->txBytesPerSec;
+  pIf->rxBytesPerSec = pConfig->rxBytesPerSec;
+  moca_sim_link_up(pIf, moca_sim_now_ns());
+  pIf->reformUntilNs = 0;
+}
+
+static BOOL moca_sim_fault_valid(const moca_sim_fault_t *pFault)
+{
+  if (pFault->latency > MOCA_SIM_LATENCY_LONG_TAIL || pFault->errorPpm > MOCA_SIM_PPM || pFault->hangPpm > MOCA_SIM_PPM)
+  {
+    return FALSE;
+  }
+  if ((pFault->latency == MOCA_SIM_LATENCY_UNIFORM || pFault->latency == MOCA_SIM_LATENCY_LONG_TAIL) &&
+      pFault->maxUs < pFault->minUs)
+  {
+    return FALSE;
+  }
+  if (pFault->latency == MOCA_SIM_LATENCY_LONG_TAIL && (pFault->tailPercent < 1 || pFault->tailPercent > 99))
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static BOOL moca_sim_fault_active(const moca_sim_fault_t *pFault)
+{
+  return (pFault->latency != MOCA_SIM_LATENCY_NONE || pFault->errorPpm > 0 || pFault->hangPpm > 0) ? TRUE : FALSE;
+}
+
+/* Caller holds gSimFaultMutex, pFault NULL clears */
+static void moca_sim_set_fault(moca_sim_api_t api, const moca_sim_fault_t *pFault)
+{
+  BOOL wasActive = moca_sim_fault_active(&gSimFaults[api]);
+  BOOL isActive;
+
+  if (pFault != NULL)
+  {
+    gSimFaults[api] = *pFault;
+  }
+  else
+  {
+    memset(&gSimFaults[api], 0, sizeof(gSimFaults[api]));
+  }
+  isActive = moca_sim_fault_active(&gSimFaults[api]);
+  if (isActive != wasActive)
+  {
+    __atomic_store_n(&gSimFaultCount, (isActive == TRUE) ? gSimFaultCount + 1 : gSimFaultCount - 1, __ATOMIC_RELEASE);
+  }
+  gSimFaultGeneration[api]++;
+}
+
+/* Parses one "api:key=value,..." entry of MOCA_SIM_FAULTS */
+static BOOL moca_sim_parse_fault(char *pEntry)
+{
+  moca_sim_fault_t fault;
+  char *pKeys = strchr(pEntry, ':');
+  char *pSave = NULL;
+  char *pKey;
+  char *pValue;
+  char *end;
+  ULONG number;
+  int api;
+
+  if (pKeys == NULL)
+  {
+    return FALSE;
+  }
+  *pKeys++ = '\0';
+  for (api = 0; api < MOCA_SIM_API_COUNT && strcmp(pEntry, gSimApiNames[api]) != 0; api++)
+  {
+  }
+  if (api == MOCA_SIM_API_COUNT && strcmp(pEntry, "*") != 0)
+  {
+    return FALSE;
+  }
+  memset(&fault, 0, sizeof(fault));
+  for (pKey = strtok_r(pKeys, ",", &pSave); pKey != NULL; pKey = strtok_r(NULL, ",", &pSave))
+  {
+    pValue = strchr(pKey, '=');
+    if (pValue == NULL)
+    {
+      return FALSE;
+    }
+    *pValue++ = '\0';
+    if (strcmp(pKey, "latency") == 0)
+    {
+      if (strcmp(pValue, "none") == 0)
+      {
+        fault.latency = MOCA_SIM_LATENCY_NONE;
+      }
+      else if (strcmp(pValue, "fixed") == 0)
+      {
+        fault.latency = MOCA_SIM_LATENCY_FIXED;
+      }
+      else if (strcmp(pValue, "uniform") == 0)
+      {
+        fault.latency = MOCA_SIM_LATENCY_UNIFORM;
+      }
+      else if (strcmp(pValue, "longtail") == 0)
+      {
+        fault.latency = MOCA_SIM_LATENCY_LONG_TAIL;
+      }
+      else
+      {
+        return FALSE;
+      }
+      continue;
+    }
+    number = strtoul(pValue, &end, 0);
+    if (*pValue == '\0' || *end != '\0')
+    {
+      return FALSE;
+    }
+    if (strcmp(pKey, "min") == 0)
+    {
+      fault.minUs = number;
+    }
+    else if (strcmp(pKey, "max") == 0)
+    {
+      fault.maxUs = number;
+    }
+    else if (strcmp(pKey, "tail") == 0)
+    {
+      fault.tailPercent = number;
+    }
+    else if (strcmp(pKey, "error") == 0)
+    {
+      fault.errorPpm = number;
+    }
+    else if (strcmp(pKey, "hang") == 0)
+    {
+      fault.hangPpm = number;
+    }
+    else if (strcmp(pKey, "hangms") == 0)
+    {
+      fault.hangMs = number;
+    }
+    else
+    {
+      return FALSE;
+    }
+  }
+  if (moca_sim_fault_valid(&fault) == FALSE)
+  {
+    return FALSE;
+  }
+  pthread_mutex_lock(&gSimFaultMutex);
+  for (number = 0; number < MOCA_SIM_API_COUNT; number++)
+  {
+    if (api == MOCA_SIM_API_ALL || number == (ULONG)api)
+    {
+      moca_sim_set_fault((moca_sim_api_t)number, &fault);
+    }
+  }
+  pthread_mutex_unlock(&gSimFaultMutex);
+  return TRUE;
+}
+
+static void moca_sim_parse_faults(const char *pValue)
+{
+  char buffer[MOCA_SIM_MAX_FAULT_ENV];
+  char *pSave = NULL;
+  char *pEntry;
+
+  if (pValue == NULL || *pValue == '\0')
+  {
+    return;
+  }
+  if (strlen(pValue) >= sizeof(buffer))
+  {
+    fprintf(stderr, "moca_hal_sim: MOCA_SIM_FAULTS longer than %d characters, ignored\n", MOCA_SIM_MAX_FAULT_ENV - 1);
+    return;
+  }
+  strcpy(buffer, pValue);
+  for (pEntry = strtok_r(buffer, ";", &pSave); pEntry != NULL; pEntry = strtok_r(NULL, ";", &pSave))
+  {
+    if (moca_sim_parse_fault(pEntry) == FALSE)
+    {
+      fprintf(stderr, "moca_hal_sim: invalid MOCA_SIM_FAULTS entry for [%s], ignored\n", pEntry);
+    }
+  }
+}
+
+static void moca_sim_init(void)
+{
+  ULONG i;
+
+  gSimDefaultConfig.numNodes = moca_sim_env("MOCA_SIM_NODES", MOCA_SIM_DEFAULT_NODES);
+  gSimDefaultConfig.cpesPerNode = moca_sim_env("MOCA_SIM_CPES_PER_NODE", MOCA_SIM_DEFAULT_CPES_PER_NODE);
+  gSimDefaultConfig.flowsPerNode = moca_sim_env("MOCA_SIM_FLOWS_PER_NODE", MOCA_SIM_DEFAULT_FLOWS_PER_NODE);
+  gSimDefaultConfig.txBytesPerSec = moca_sim_env("MOCA_SIM_TX_BPS", MOCA_SIM_DEFAULT_TX_BPS);
+  gSimDefaultConfig.rxBytesPerSec = moca_sim_env("MOCA_SIM_RX_BPS", MOCA_SIM_DEFAULT_RX_BPS);
+  gSimDefaultConfig.seed = moca_sim_env("MOCA_SIM_SEED", 1);
+  gSimDefaultConfig.acaDurationMs = moca_sim_env("MOCA_SIM_ACA_MS", MOCA_SIM_DEFAULT_ACA_MS);
+  gSimDefaultConfig.numInterfaces = moca_sim_env("MOCA_SIM_INTERFACES", MOCA_SIM_DEFAULT_INTERFACES);
+  gSimDefaultConfig.reformMs = moca_sim_env("MOCA_SIM_REFORM_MS", MOCA_SIM_DEFAULT_REFORM_MS);
+  if (moca_sim_config_valid(&gSimDefaultConfig) == FALSE)
+  {
+    fprintf(stderr, "moca_hal_sim: invalid MOCA_SIM_* environment, using defaults\n");
+    gSimDefaultConfig.numNodes = MOCA_SIM_DEFAULT_NODES;
+    gSimDefaultConfig.cpesPerNode = MOCA_SIM_DEFAULT_CPES_PER_NODE;
+    gSimDefaultConfig.flowsPerNode = MOCA_SIM_DEFAULT_FLOWS_PER_NODE;
+    gSimDefaultConfig.acaDurationMs = MOCA_SIM_DEFAULT_ACA_MS;
+    gSimDefaultConfig.numInterfaces = MOCA_SIM_DEFAULT_INTERFACES;
+    gSimDefaultConfig.reformMs = MOCA_SIM_DEFAULT_REFORM_MS;
+  }
+  gSimConfig = gSimDefaultConfig;
+
+  for (i = 0; i < MOCA_SIM_MAX_INTERFACES; i++)
+  {
+    moca_sim_if_t *pIf = &gSimIf[i];
+
+    pthread_rwlock_init(&pIf->lock, NULL);
+    pthread_mutex_init(&pIf->statsLock, NULL);
+    pIf->ifIndex = i;
+    pIf->acaEventFd = -1;
+    moca_sim_build_config(pIf);
+    if (i < gSimConfig.numInterfaces)
+    {
+      moca_sim_build_network(pIf, &gSimConfig);
+    }
+  }
+  __atomic_store_n(&gSimNumInterfaces, gSimConfig.numInterfaces, __ATOMIC_RELEASE);
+  moca_sim_parse_faults(getenv("MOCA_SIM_FAULTS"));
+}
+
+static moca_sim_if_t *moca_sim_get_if(ULONG ifIndex)
+{
+  pthread_once(&gSimOnce, moca_sim_init);
+  if (ifIndex >= __atomic_load_n(&gSimNumInterfaces, __ATOMIC_ACQUIRE))
+  {
+    return NULL;
+  }
+  return &gSimIf[ifIndex];
+}
+
+/* EVM probes every reporting node in turn, a quiet line measurement only listens */
+static uint64_t moca_sim_aca_duration_ns(const moca_sim_if_t *pIf, const moca_aca_cfg_t *pCfg)
+{
+  uint64_t duration = (uint64_t)gSimConfig.acaDurationMs * 1000000ULL;
+  uint32_t jitter = moca_sim_hash((uint32_t)gSimConfig.seed, pIf->ifIndex, pIf->acaSequence) % (2 * MOCA_SIM_ACA_JITTER_PERCENT + 1);
+  ULONG reporting = 0;
+  ULONG i;
+
+  for (i = 0; i < pIf->numNodes; i++)
+  {
+    reporting += (pCfg->ReportNodes >> i) & 1;
+  }
+  if (pCfg->type == MOCA_ACA_TYPE_EVM)
+  {
+    duration = duration / 2 + duration * reporting / (2 * pIf->numNodes);
+  }
+  else
+  {
+    duration /= 2;
+  }
+  return duration * (100 - MOCA_SIM_ACA_JITTER_PERCENT + jitter) / 100;
+}
+
+/* Caller holds the interface lock for writing */
+static void moca_sim_aca_start(moca_sim_if_t *pIf, const moca_aca_cfg_t *pCfg, moca_aca_complete_callback callback, void *pContext)
+{
+  if (pIf->acaNotify == TRUE)
+  {
+    /* The ACA being replaced, or one that ended but was not notified yet, still owes its caller an end */
+    pIf->acaSuperseded++;
+    if (pIf->acaCallback != NULL)
+    {
+      pIf->acaSupersededCallback = pIf->acaCallback;
+      pIf->acaSupersededContext = pIf->acaContext;
+      pIf->acaSupersededStatus = pIf->acaStatus;
+      if (pIf->acaSupersededStatus.acaStatus == MOCA_ACA_STATUS_INPROGRESS)
+      {
+        pIf->acaSupersededStatus.acaStatus = MOCA_ACA_STATUS_FAIL;
+      }
+    }
+  }
+  memset(&pIf->acaStatus, 0, sizeof(pIf->acaStatus));
+  pIf->acaStatus.acaStatus = MOCA_ACA_STATUS_INPROGRESS;
+  pIf->acaStatus.acaType = pCfg->type;
+  pIf->acaSequence++;
+  pIf->acaStartNs = moca_sim_now_ns();
+  pIf->acaDurationNs = moca_sim_aca_duration_ns(pIf, pCfg);
+  pIf->acaNotify = TRUE;
+  pIf->acaCallback = callback;
+  pIf->acaContext = pContext;
+}
+
+/* Ends the current ACA once its run time has passed, caller holds the interface lock for writing */
+static void moca_sim_aca_update(moca_sim_if_t *pIf, uint64_t now)
+{
+  uint32_t h;
+
+  if (pIf->acaStatus.acaStatus == MOCA_ACA_STATUS_INPROGRESS && now - pIf->acaStartNs >= pIf->acaDurationNs)
+  {
+    h = moca_sim_hash(pIf->ifIndex, pIf->acaSequence, 0x41434121);
+    pIf->acaStatus.acaStatus = MOCA_ACA_STATUS_SUCCESS;
+    /* dBm, power of the probes received or the noise floor of a quiet line */
+    pIf->acaStatus.acaPower = (pIf->acaStatus.acaType == MOCA_ACA_TYPE_EVM) ? -(INT)(35 + h % 20) : -(INT)(80 + h % 15);
+    pIf->acaConfig.ACAStart = FALSE;
+  }
+}
+
+static void *moca_sim_aca_worker(void *pArg)
+{
+  (void)pArg;
+
+  pthread_mutex_lock(&gSimAcaMutex);
+  for (;;)
+  {
+    moca_aca_complete_callback callback = NULL;
+    void *pContext = NULL;
+    moca_aca_stat_t status;
+    uint64_t ended = 0;
+    uint64_t next = UINT64_MAX;
+    uint64_t now = moca_sim_now_ns();
+    struct timespec ts;
+    int eventFd = -1;
+    int interfaceIndex = -1;
+    ULONG i;
+
+    for (i = 0; i < MOCA_SIM_MAX_INTERFACES && ended == 0; i++)
+    {
+      moca_sim_if_t *pIf = &gSimIf[i];
+
+      pthread_rwlock_wrlock(&pIf->lock);
+      if (pIf->acaSuperseded > 0)
+      {
+        ended = pIf->acaSuperseded;
+        callback = pIf->acaSupersededCallback;
+        pContext = pIf->acaSupersededContext;
+        status = pIf->acaSupersededStatus;
+        pIf->acaSuperseded = 0;
+        pIf->acaSupersededCallback = NULL;
+      }
+      else if (pIf->acaNotify == TRUE)
+      {
+        moca_sim_aca_update(pIf, now);
+        if (pIf->acaStatus.acaStatus != MOCA_ACA_STATUS_INPROGRESS)
+        {
+          ended = 1;
+          callback = pIf->acaCallback;
+          pContext = pIf->acaContext;
+          status = pIf->acaStatus;
+          pIf->acaNotify = FALSE;
+          pIf->acaCallback = NULL;
+        }
+        else if (pIf->acaStartNs + pIf->acaDurationNs < next)
+        {
+          next = pIf->acaStartNs + pIf->acaDurationNs;
+        }
+      }
+      eventFd = pIf->acaEventFd;
+      interfaceIndex = (int)i;
+      pthread_rwlock_unlock(&pIf->lock);
+    }
+
+    if (ended > 0)
+    {
+      /* No lock is held while notifying, the callback may start the next ACA */
+      pthread_mutex_unlock(&gSimAcaMutex);
+      if (eventFd >= 0 && write(eventFd, &ended, sizeof(ended)) != (ssize_t)sizeof(ended))
+      {
+        fprintf(stderr, "moca_hal_sim: ACA eventfd write failed\n");
+      }
+      if (callback != NULL)
+      {
+        callback(interfaceIndex, &status, pContext);
+      }
+      pthread_mutex_lock(&gSimAcaMutex);
+    }
+    else if (next == UINT64_MAX)
+    {
+      pthread_cond_wait(&gSimAcaCond, &gSimAcaMutex);
+    }
+    else
+    {
+      clock_gettime(CLOCK_REALTIME, &ts);
+      next -= (next > now) ? now : next;
+      ts.tv_sec += (time_t)(next / NS_PER_SEC);
+      ts.tv_nsec += (long)(next % NS_PER_SEC);
+      if (ts.tv_nsec >= (long)NS_PER_SEC)
+      {
+        ts.tv_sec++;
+        ts.tv_nsec -= (long)NS_PER_SEC;
+      }
+      pthread_cond_timedwait(&gSimAcaCond, &gSimAcaMutex, &ts);
+    }
+  }
+  return NULL;
+}
+
+/* Starts the ACA worker on first use and has it look at every interface again, FALSE if it cannot run */
+static BOOL moca_sim_aca_wake(void)
+{
+  pthread_t worker;
+  BOOL running;
+
+  pthread_mutex_lock(&gSimAcaMutex);
+  if (gSimAcaWorkerStarted == FALSE && pthread_create(&worker, NULL, moca_sim_aca_worker, NULL) == 0)
+  {
+    pthread_detach(worker);
+    gSimAcaWorkerStarted = TRUE;
+  }
+  running = gSimAcaWorkerStarted;
+  pthread_cond_signal(&gSimAcaCond);
+  pthread_mutex_unlock(&gSimAcaMutex);
+  return running;
+}
+
+INT moca_sim_GetConfig(moca_sim_config_t *pConfig)
+{
+  if (pConfig == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_once(&gSimOnce, moca_sim_init);
+  pthread_mutex_lock(&gSimMutex);
+  *pConfig = gSimConfig;
+  pthread_mutex_unlock(&gSimMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_Configure(const moca_sim_config_t *pConfig)
+{
+  ULONG served;
+  ULONG i;
+
+  if (pConfig == NULL || moca_sim_config_valid(pConfig) == FALSE)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_once(&gSimOnce, moca_sim_init);
+  pthread_mutex_lock(&gSimMutex);
+  gSimConfig = *pConfig;
+  served = __atomic_load_n(&gSimNumInterfaces, __ATOMIC_RELAXED);
+  /* Interfaces removed are no longer served before their networks go, those added only once built */
+  if (gSimConfig.numInterfaces < served)
+  {
+    __atomic_store_n(&gSimNumInterfaces, gSimConfig.numInterfaces, __ATOMIC_RELEASE);
+  }
+  for (i = 0; i < gSimConfig.numInterfaces; i++)
+  {
+    pthread_rwlock_wrlock(&gSimIf[i].lock);
+    moca_sim_build_network(&gSimIf[i], &gSimConfig);
+    pthread_rwlock_unlock(&gSimIf[i].lock);
+  }
+  __atomic_store_n(&gSimNumInterfaces, gSimConfig.numInterfaces, __ATOMIC_RELEASE);
+  /* Rebuilding a served interface restarts its counters, readers must see that as a reset and not as a wrap */
+  if (served > 0 && gSimConfig.numInterfaces > 0)
+  {
+    gResetCount++;
+  }
+  pthread_mutex_unlock(&gSimMutex);
+  /* An ACA the rebuild aborted is notified now */
+  pthread_mutex_lock(&gSimAcaMutex);
+  pthread_cond_signal(&gSimAcaCond);
+  pthread_mutex_unlock(&gSimAcaMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_Reset(void)
+{
+  pthread_once(&gSimOnce, moca_sim_init);
+  return moca_sim_Configure(&gSimDefaultConfig);
+}
+
+INT moca_sim_SetTraffic(ULONG ifIndex, ULONG txBytesPerSec, ULONG rxBytesPerSec)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t traffic;
+  uint64_t now;
+
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  now = moca_sim_now_ns();
+  moca_sim_traffic(pIf, now, &traffic);
+  pIf->txBytesBase = traffic.txBytes;
+  pIf->rxBytesBase = traffic.rxBytes;
+  pIf->baseNs = now;
+  pIf->txBytesPerSec = txBytesPerSec;
+  pIf->rxBytesPerSec = rxBytesPerSec;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_AdvanceCounters(ULONG ifIndex, uint64_t txBytes, uint64_t rxBytes, uint64_t upMs)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* upNs is taken modulo 2^64, so moving the link up time before the clock origin is harmless */
+  pthread_rwlock_wrlock(&pIf->lock);
+  pIf->txBytesBase += txBytes;
+  pIf->rxBytesBase += rxBytes;
+  pIf->linkUpNs -= upMs * 1000000ULL;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_SetPhyRate(ULONG ifIndex, ULONG txNodeId, ULONG rxNodeId, ULONG rateMbps)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (pIf == NULL || txNodeId == rxNodeId)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  if (txNodeId >= pIf->numNodes || rxNodeId >= pIf->numNodes)
+  {
+    pthread_rwlock_unlock(&pIf->lock);
+    return STATUS_FAILURE;
+  }
+  if (pIf->phyRate[txNodeId][rxNodeId] != rateMbps)
+  {
+    pIf->phyRate[txNodeId][rxNodeId] = rateMbps;
+    pIf->meshDirty[txNodeId] |= 1U << rxNodeId;
+    pIf->meshStale = TRUE;
+    if (rxNodeId == MOCA_SIM_LOCAL_NODE_ID)
+    {
+      pIf->nodes[txNodeId].device.PHYTxRate = rateMbps;
+    }
+    else if (txNodeId == MOCA_SIM_LOCAL_NODE_ID)
+    {
+      pIf->nodes[rxNodeId].device.PHYRxRate = rateMbps;
+    }
+  }
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_SetFirmwareVersion(ULONG ifIndex, const char *pVersion)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (pIf == NULL || pVersion == NULL || strlen(pVersion) >= sizeof(pIf->staticInfo.FirmwareVersion))
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  snprintf(pIf->staticInfo.FirmwareVersion, sizeof(pIf->staticInfo.FirmwareVersion), "%s", pVersion);
+  moca_sim_reform(pIf, moca_sim_now_ns());
+  pthread_rwlock_unlock(&pIf->lock);
+
+  pthread_mutex_lock(&gSimMutex);
+  gResetCount++;
+  pthread_mutex_unlock(&gSimMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_InvalidateFullMesh(ULONG ifIndex)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  moca_sim_mesh_invalidate_all(pIf);
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+static void *moca_sim_event_dispatcher(void *pArg)
+{
+  (void)pArg;
+
+  pthread_mutex_lock(&gSimEventMutex);
+  for (;;)
+  {
+    moca_sim_event_t event;
+    moca_associatedDevice_callback callback;
+    moca_associated_device_t device;
+    moca_sim_if_t *pIf;
+
+    while (gSimEventCount == 0)
+    {
+      gSimEventDispatching = FALSE;
+      pthread_cond_broadcast(&gSimEventCond);
+      pthread_cond_wait(&gSimEventCond, &gSimEventMutex);
+    }
+    event = gSimEventQueue[gSimEventHead];
+    gSimEventHead = (gSimEventHead + 1) % MOCA_SIM_EVENT_QUEUE_DEPTH;
+    gSimEventCount--;
+    gSimEventDispatching = TRUE;
+    pthread_mutex_unlock(&gSimEventMutex);
+
+    pthread_mutex_lock(&gSimMutex);
+    callback = gAssociatedDeviceCallback;
+    pthread_mutex_unlock(&gSimMutex);
+
+    /* No HAL lock is held while the callback runs, it may call back into the HAL */
+    pIf = &gSimIf[event.ifIndex];
+    pthread_rwlock_rdlock(&pIf->lock);
+    device = pIf->nodes[event.nodeId % pIf->numNodes].device;
+    pthread_rwlock_unlock(&pIf->lock);
+    device.Active = event.active;
+    if (callback != NULL)
+    {
+      gSimCurrentEvent = &event;
+      callback(event.ifIndex, &device);
+      gSimCurrentEvent = NULL;
+    }
+
+    pthread_mutex_lock(&gSimEventMutex);
+    if (callback != NULL)
+    {
+      gSimEventStats.dispatched++;
+    }
+    else
+    {
+      gSimEventStats.undelivered++;
+    }
+  }
+  return NULL;
+}
+
+static void *moca_sim_event_storm(void *pArg)
+{
+  const moca_sim_storm_t *pStorm = (const moca_sim_storm_t *)pArg;
+  uint64_t start = moca_sim_now_ns();
+  ULONG i;
+
+  for (i = 0; i < pStorm->count; i++)
+  {
+    moca_sim_event_t *pEvent;
+    ULONG round = i / pStorm->remoteNodes;
+
+    if (pStorm->eventsPerSec > 0)
+    {
+      uint64_t due = start + (uint64_t)i * NS_PER_SEC / pStorm->eventsPerSec;
+      uint64_t now = moca_sim_now_ns();
+
+      if (due > now)
+      {
+        struct timespec ts = { (time_t)((due - now) / NS_PER_SEC), (long)((due - now) % NS_PER_SEC) };
+
+        nanosleep(&ts, NULL);
+      }
+    }
+    pthread_mutex_lock(&gSimEventMutex);
+    gSimEventStats.generated++;
+    gSimEventSequence++;
+    if (gSimEventCount == MOCA_SIM_EVENT_QUEUE_DEPTH)
+    {
+      gSimEventStats.dropped++;
+      pthread_mutex_unlock(&gSimEventMutex);
+      continue;
+    }
+    pEvent = &gSimEventQueue[(gSimEventHead + gSimEventCount) % MOCA_SIM_EVENT_QUEUE_DEPTH];
+    pEvent->sequence = gSimEventSequence;
+    pEvent->timestampNs = moca_sim_now_ns();
+    pEvent->ifIndex = pStorm->ifIndex;
+    /* Remote nodes in turn, every node leaves on its even rounds and joins back on the odd ones */
+    pEvent->nodeId = MOCA_SIM_LOCAL_NODE_ID + 1 + i % pStorm->remoteNodes;
+    pEvent->active = (round % 2) ? TRUE : FALSE;
+    gSimEventCount++;
+    if (gSimEventCount > gSimEventStats.maxQueueDepth)
+    {
+      gSimEventStats.maxQueueDepth = gSimEventCount;
+    }
+    pthread_cond_broadcast(&gSimEventCond);
+    pthread_mutex_unlock(&gSimEventMutex);
+  }
+  return NULL;
+}
+
+INT moca_sim_GenerateDeviceEvents(ULONG ifIndex, ULONG count, ULONG eventsPerSec)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  pthread_t dispatcher;
+  ULONG remoteNodes;
+
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  remoteNodes = pIf->numNodes - 1;
+  pthread_rwlock_unlock(&pIf->lock);
+  if (remoteNodes == 0)
+  {
+    return STATUS_FAILURE;
+  }
+
+  pthread_mutex_lock(&gSimEventMutex);
+  if (gSimStormRunning == TRUE || gSimStormJoining == TRUE)
+  {
+    pthread_mutex_unlock(&gSimEventMutex);
+    return STATUS_FAILURE;
+  }
+  if (gSimDispatcherStarted == FALSE)
+  {
+    if (pthread_create(&dispatcher, NULL, moca_sim_event_dispatcher, NULL) != 0)
+    {
+      pthread_mutex_unlock(&gSimEventMutex);
+      return STATUS_FAILURE;
+    }
+    pthread_detach(dispatcher);
+    gSimDispatcherStarted = TRUE;
+  }
+  gSimStorm.ifIndex = ifIndex;
+  gSimStorm.count = count;
+  gSimStorm.eventsPerSec = eventsPerSec;
+  gSimStorm.remoteNodes = remoteNodes;
+  if (pthread_create(&gSimStormThread, NULL, moca_sim_event_storm, &gSimStorm) != 0)
+  {
+    pthread_mutex_unlock(&gSimEventMutex);
+    return STATUS_FAILURE;
+  }
+  gSimStormRunning = TRUE;
+  pthread_mutex_unlock(&gSimEventMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_WaitDeviceEvents(ULONG timeoutMs)
+{
+  uint64_t deadline = moca_sim_now_ns() + (uint64_t)timeoutMs * 1000000ULL;
+  struct timespec poll = { 0, 1000000 };
+  pthread_t storm;
+  BOOL join = FALSE;
+
+  /* Only the first waiter joins the storm, the others wait below until it has */
+  pthread_mutex_lock(&gSimEventMutex);
+  if (gSimStormRunning == TRUE)
+  {
+    storm = gSimStormThread;
+    gSimStormRunning = FALSE;
+    gSimStormJoining = TRUE;
+    join = TRUE;
+  }
+  pthread_mutex_unlock(&gSimEventMutex);
+  if (join == TRUE)
+  {
+    pthread_join(storm, NULL);
+    pthread_mutex_lock(&gSimEventMutex);
+    gSimStormJoining = FALSE;
+    pthread_mutex_unlock(&gSimEventMutex);
+  }
+  /* The generator is done, wait for the dispatcher to drain the queue */
+  for (;;)
+  {
+    BOOL idle;
+
+    pthread_mutex_lock(&gSimEventMutex);
+    idle = (gSimEventCount == 0 && gSimEventDispatching == FALSE && gSimStormJoining == FALSE) ? TRUE : FALSE;
+    pthread_mutex_unlock(&gSimEventMutex);
+    if (idle == TRUE)
+    {
+      return STATUS_SUCCESS;
+    }
+    if (moca_sim_now_ns() >= deadline)
+    {
+      return STATUS_FAILURE;
+    }
+    nanosleep(&poll, NULL);
+  }
+}
+
+INT moca_sim_GetCurrentEvent(moca_sim_event_info_t *pInfo)
+{
+  if (pInfo == NULL || gSimCurrentEvent == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pInfo->sequence = gSimCurrentEvent->sequence;
+  pInfo->timestampNs = gSimCurrentEvent->timestampNs;
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_GetEventStats(moca_sim_event_stats_t *pStats)
+{
+  if (pStats == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_mutex_lock(&gSimEventMutex);
+  *pStats = gSimEventStats;
+  pthread_mutex_unlock(&gSimEventMutex);
+  return STATUS_SUCCESS;
+}
+
+/* Caller holds gSimFaultMutex */
+static uint64_t moca_sim_fault_latency_ns(const moca_sim_fault_t *pFault)
+{
+  uint64_t us = pFault->minUs;
+
+  switch (pFault->latency)
+  {
+    case MOCA_SIM_LATENCY_FIXED:
+      break;
+    case MOCA_SIM_LATENCY_UNIFORM:
+      us += moca_sim_random(&gSimFaultRandom) % (pFault->maxUs - pFault->minUs + 1);
+      break;
+    case MOCA_SIM_LATENCY_LONG_TAIL:
+      /* Each doubling is taken with probability tailPercent, the result falls anywhere in its octave */
+      if (us == 0)
+      {
+        us = 1;
+      }
+      while (us < pFault->maxUs && moca_sim_random(&gSimFaultRandom) % 100 < pFault->tailPercent)
+      {
+        us *= 2;
+      }
+      if (us > pFault->minUs)
+      {
+        us += moca_sim_random(&gSimFaultRandom) % us;
+      }
+      if (us > pFault->maxUs)
+      {
+        us = pFault->maxUs;
+      }
+      break;
+    default:
+      us = 0;
+      break;
+  }
+  return us * 1000ULL;
+}
+
+/* Applies the faults of an API at the start of a call, STATUS_FAILURE when the call must fail */
+static INT moca_sim_inject(moca_sim_api_t api)
+{
+  moca_sim_fault_stats_t *pStats = &gSimFaultStats[api];
+  uint64_t generation;
+  uint64_t delayNs;
+  struct timespec ts;
+  BOOL fail;
+
+  pthread_once(&gSimOnce, moca_sim_init);
+  if (__atomic_load_n(&gSimFaultCount, __ATOMIC_ACQUIRE) == 0)
+  {
+    return STATUS_SUCCESS;
+  }
+  pthread_mutex_lock(&gSimFaultMutex);
+  if (moca_sim_fault_active(&gSimFaults[api]) == FALSE)
+  {
+    pthread_mutex_unlock(&gSimFaultMutex);
+    return STATUS_SUCCESS;
+  }
+  if (gSimFaultRandom == 0)
+  {
+    gSimFaultRandom = moca_sim_hash((uint32_t)gSimConfig.seed, ++gSimFaultThreads, 0x46415554) | 1;
+  }
+  pStats->calls++;
+  if (gSimFaults[api].hangPpm > 0 && moca_sim_random(&gSimFaultRandom) % MOCA_SIM_PPM < gSimFaults[api].hangPpm)
+  {
+    pStats->hangs++;
+    generation = gSimFaultGeneration[api];
+    if (gSimFaults[api].hangMs == 0)
+    {
+      while (generation == gSimFaultGeneration[api])
+      {
+        pthread_cond_wait(&gSimFaultCond, &gSimFaultMutex);
+      }
+    }
+    else
+    {
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_sec += gSimFaults[api].hangMs / 1000;
+      ts.tv_nsec += (long)(gSimFaults[api].hangMs % 1000) * 1000000L;
+      if (ts.tv_nsec >= (long)NS_PER_SEC)
+      {
+        ts.tv_sec++;
+        ts.tv_nsec -= (long)NS_PER_SEC;
+      }
+      while (generation == gSimFaultGeneration[api] &&
+             pthread_cond_timedwait(&gSimFaultCond, &gSimFaultMutex, &ts) != ETIMEDOUT)
+      {
+      }
+    }
+  }
+  /* A released hang carries on with the faults set since */
+  delayNs = moca_sim_fault_latency_ns(&gSimFaults[api]);
+  fail = (gSimFaults[api].errorPpm > 0 && moca_sim_random(&gSimFaultRandom) % MOCA_SIM_PPM < gSimFaults[api].errorPpm) ? TRUE : FALSE;
+  if (delayNs > 0)
+  {
+    pStats->delayed++;
+    pStats->delayNs += delayNs;
+  }
+  if (fail == TRUE)
+  {
+    pStats->errors++;
+  }
+  pthread_mutex_unlock(&gSimFaultMutex);
+
+  if (delayNs > 0)
+  {
+    ts.tv_sec = (time_t)(delayNs / NS_PER_SEC);
+    ts.tv_nsec = (long)(delayNs % NS_PER_SEC);
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+  }
+  return (fail == TRUE) ? STATUS_FAILURE : STATUS_SUCCESS;
+}
+
+INT moca_sim_SetFault(moca_sim_api_t api, const moca_sim_fault_t *pFault)
+{
+  int i;
+
+  if (api > MOCA_SIM_API_ALL || (pFault != NULL && moca_sim_fault_valid(pFault) == FALSE))
+  {
+    return STATUS_FAILURE;
+  }
+  /* Faults from the environment are applied first, so they do not override this call */
+  pthread_once(&gSimOnce, moca_sim_init);
+  pthread_mutex_lock(&gSimFaultMutex);
+  for (i = 0; i < MOCA_SIM_API_COUNT; i++)
+  {
+    if (api == MOCA_SIM_API_ALL || i == (int)api)
+    {
+      moca_sim_set_fault((moca_sim_api_t)i, pFault);
+    }
+  }
+  pthread_cond_broadcast(&gSimFaultCond);
+  pthread_mutex_unlock(&gSimFaultMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_sim_GetFaultStats(moca_sim_api_t api, moca_sim_fault_stats_t *pStats)
+{
+  if (api >= MOCA_SIM_API_COUNT || pStats == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_mutex_lock(&gSimFaultMutex);
+  *pStats = gSimFaultStats[api];
+  pthread_mutex_unlock(&gSimFaultMutex);
+  return STATUS_SUCCESS;
+}
 
 void moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc)
 {
-  /*TODO: Implement Me!*/
-  (void)callback_proc;
+  pthread_mutex_lock(&gSimMutex);
+  gAssociatedDeviceCallback = callback_proc;
+  pthread_mutex_unlock(&gSimMutex);
 }
 
 INT moca_GetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_config;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_GetIfConfig) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_config == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  *pmoca_config = pIf->config;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_SetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_config;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_SetIfConfig) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_config == NULL || moca_sim_if_config_valid(pmoca_config) == FALSE)
+  {
+    return STATUS_FAILURE;
+  }
+
+  /* The driver cannot tell which fields changed, every apply re-forms the link */
+  pthread_rwlock_wrlock(&pIf->lock);
+  pIf->config = *pmoca_config;
+  pIf->config.Reset = FALSE;
+  moca_sim_apply_static_config(pIf);
+  moca_sim_reform(pIf, moca_sim_now_ns());
+  pthread_rwlock_unlock(&pIf->lock);
+
+  pthread_mutex_lock(&gSimMutex);
+  gResetCount++;
+  pthread_mutex_unlock(&gSimMutex);
+  return STATUS_SUCCESS;
+}
+
+INT moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_cfg_t merged;
+  ULONG changed = 0;
+  ULONG reform;
+  int i;
+
+  if (moca_sim_inject(MOCA_SIM_API_SetIfConfigFields) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pConfig == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+
+  /* Diffed and applied under one lock, a concurrent apply is either wholly before or wholly after */
+  pthread_rwlock_wrlock(&pIf->lock);
+  merged = pIf->config;
+  for (i = 0; i < MOCA_CFG_FIELD_COUNT; i++)
+  {
+    const moca_sim_cfg_field_t *pField = &gSimCfgFields[i];
+    UCHAR *pTo = (UCHAR *)&merged + pField->offset;
+    const UCHAR *pFrom = (const UCHAR *)pConfig + pField->offset;
+    int differs;
+
+    if ((fieldMask & MOCA_CFG_FIELD_BIT(i)) == 0)
+    {
+      continue;
+    }
+    differs = pField->string ? strncmp((const char *)pTo, (const char *)pFrom, pField->size)
+                             : memcmp(pTo, pFrom, pField->size);
+    if (differs != 0)
+    {
+      memcpy(pTo, pFrom, pField->size);
+      changed |= MOCA_CFG_FIELD_BIT(i);
+    }
+  }
+  if (moca_sim_if_config_valid(&merged) == FALSE)
+  {
+    pthread_rwlock_unlock(&pIf->lock);
+    return STATUS_FAILURE;
+  }
+  reform = changed & MOCA_CFG_REFORM_FIELDS;
+  if (changed != 0)
+  {
+    pIf->config = merged;
+    pIf->config.Reset = FALSE;
+    moca_sim_apply_static_config(pIf);
+  }
+  if (reform != 0)
+  {
+    moca_sim_reform(pIf, moca_sim_now_ns());
+  }
+  pthread_rwlock_unlock(&pIf->lock);
+
+  if (reform != 0)
+  {
+    pthread_mutex_lock(&gSimMutex);
+    gResetCount++;
+    pthread_mutex_unlock(&gSimMutex);
+  }
+  if (pResult != NULL)
+  {
+    pResult->changedMask = changed;
+    pResult->reformMask = reform;
+  }
+  return STATUS_SUCCESS;
+}
+
+/* The fill helpers expect the interface read lock to be held */
+static void moca_sim_fill_dynamic_info(const moca_sim_if_t *pIf, uint64_t now, moca_dynamic_info_t *pInfo)
+{
+  uint64_t upSeconds = (now - pIf->linkUpNs) / NS_PER_SEC;
+
+  memset(pInfo, 0, sizeof(*pInfo));
+  pInfo->Status = (pIf->config.bEnabled && now >= pIf->reformUntilNs) ? IF_STATUS_Up : IF_STATUS_Down;
+  pInfo->LastChange = (ULONG)upSeconds;
+  pInfo->MaxIngressBW = pIf->staticInfo.MaxBitRate;
+  pInfo->MaxEgressBW = pIf->staticInfo.MaxBitRate;
+  snprintf(pInfo->CurrentVersion, sizeof(pInfo->CurrentVersion), "%s", pIf->staticInfo.HighestVersion);
+  pInfo->NetworkCoordinator = MOCA_SIM_LOCAL_NODE_ID;
+  pInfo->NodeID = MOCA_SIM_LOCAL_NODE_ID;
+  pInfo->MaxNodes = (pIf->numNodes == MOCA_SIM_MAX_NODES) ? TRUE : FALSE;
+  pInfo->BackupNC = (pIf->numNodes > 1) ? MOCA_SIM_BACKUP_NC_NODE_ID : MOCA_SIM_LOCAL_NODE_ID;
+  pInfo->PrivacyEnabled = pIf->config.PrivacyEnabledSetting;
+  moca_sim_mask_to_bytes(pInfo->FreqCurrentMask, moca_sim_freq_to_mask(MOCA_SIM_OPER_FREQ));
+  pInfo->CurrentOperFreq = MOCA_SIM_OPER_FREQ;
+  pInfo->LastOperFreq = MOCA_SIM_OPER_FREQ;
+  pInfo->TxBcastRate = MOCA_SIM_MIN_PHY_RATE;
+  pInfo->MaxIngressBWThresholdReached = FALSE;
+  pInfo->MaxEgressBWThresholdReached = FALSE;
+  pInfo->NumberOfConnectedClients = pIf->numCpes;
+  moca_sim_format_mac(pInfo->NetworkCoordinatorMACAddress, sizeof(pInfo->NetworkCoordinatorMACAddress),
+                      pIf->staticInfo.MacAddress);
+  pInfo->LinkUpTime = (ULONG)upSeconds;
+}
+
+static void moca_sim_fill_stats(const moca_sim_traffic_t *pTraffic, moca_stats_t *pStats)
+{
+  uint64_t ucastTx, mcastTx, bcastTx, ucastRx, mcastRx, bcastRx;
+
+  /* Each class is scaled on its own so that every counter is monotonic, the totals are their sum */
+  ucastTx = pTraffic->txPackets * 90 / 100;
+  mcastTx = pTraffic->txPackets * 6 / 100;
+  bcastTx = pTraffic->txPackets * 4 / 100;
+  ucastRx = pTraffic->rxPackets * 90 / 100;
+  mcastRx = pTraffic->rxPackets * 6 / 100;
+  bcastRx = pTraffic->rxPackets * 4 / 100;
+  memset(pStats, 0, sizeof(*pStats));
+  pStats->BytesSent = moca_sim_counter(pTraffic->txBytes);
+  pStats->BytesReceived = moca_sim_counter(pTraffic->rxBytes);
+  pStats->PacketsSent = moca_sim_counter(ucastTx + mcastTx + bcastTx);
+  pStats->PacketsReceived = moca_sim_counter(ucastRx + mcastRx + bcastRx);
+  pStats->ErrorsSent = moca_sim_counter(pTraffic->txPackets / 1000000);
+  pStats->ErrorsReceived = moca_sim_counter(pTraffic->rxPackets / 200000);
+  pStats->UnicastPacketsSent = moca_sim_counter(ucastTx);
+  pStats->UnicastPacketsReceived = moca_sim_counter(ucastRx);
+  pStats->DiscardPacketsSent = moca_sim_counter(pTraffic->txPackets / 100000);
+  pStats->DiscardPacketsReceived = moca_sim_counter(pTraffic->rxPackets / 100000);
+  pStats->MulticastPacketsSent = moca_sim_counter(mcastTx);
+  pStats->MulticastPacketsReceived = moca_sim_counter(mcastRx);
+  pStats->BroadcastPacketsSent = moca_sim_counter(bcastTx);
+  pStats->BroadcastPacketsReceived = moca_sim_counter(bcastRx);
+  pStats->UnknownProtoPacketsReceived = moca_sim_counter(pTraffic->rxPackets / 1000000);
+  pStats->ExtAggrAvgTx = MOCA_SIM_TX_PER_AGGREGATE;
+  pStats->ExtAggrAvgRx = MOCA_SIM_RX_PER_AGGREGATE;
+}
+
+static void moca_sim_fill_mac_counters(const moca_sim_if_t *pIf, const moca_sim_traffic_t *pTraffic,
+                                       moca_mac_counters_t *pCounters)
+{
+  ULONG remoteNodes = pIf->numNodes - 1;
+  /* One MAP per millisecond cycle, one reservation request per remote node per cycle */
+  uint64_t upMs = pTraffic->upNs / 1000000;
+
+  memset(pCounters, 0, sizeof(*pCounters));
+  pCounters->Map = moca_sim_counter(upMs);
+  pCounters->Rsrv = moca_sim_counter(upMs * remoteNodes);
+  pCounters->Lc = moca_sim_counter(upMs / 100);
+  pCounters->Adm = moca_sim_counter(remoteNodes);
+  pCounters->Probe = moca_sim_counter(upMs / 1000);
+  pCounters->Async = moca_sim_counter(pTraffic->rxPackets / 64);
+}
+
+static void moca_sim_fill_aggregate_counters(const moca_sim_traffic_t *pTraffic, moca_aggregate_counters_t *pCounters)
+{
+  pCounters->Tx = moca_sim_counter(pTraffic->txPackets / MOCA_SIM_TX_PER_AGGREGATE);
+  pCounters->Rx = moca_sim_counter(pTraffic->rxPackets / MOCA_SIM_RX_PER_AGGREGATE);
 }
 
 INT moca_IfGetDynamicInfo(ULONG ifIndex, moca_dynamic_info_t* pmoca_dynamic_info)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_dynamic_info;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetDynamicInfo) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_dynamic_info == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_fill_dynamic_info(pIf, moca_sim_now_ns(), pmoca_dynamic_info);
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_IfGetStaticInfo(ULONG ifIndex, moca_static_info_t* pmoca_static_info)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_static_info;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetStaticInfo) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_static_info == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  *pmoca_static_info = pIf->staticInfo;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_IfGetStats(ULONG ifIndex, moca_stats_t* pmoca_stats)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_stats;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t t;
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetStats) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_stats == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_traffic(pIf, moca_sim_now_ns(), &t);
+  pthread_rwlock_unlock(&pIf->lock);
+
+  moca_sim_fill_stats(&t, pmoca_stats);
+  return STATUS_SUCCESS;
+}
+
+INT moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t t;
+  moca_stats_t stats;
+  int field;
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetStatsChangedSince) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pDelta == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_mutex_lock(&pIf->statsLock);
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_traffic(pIf, moca_sim_now_ns(), &t);
+  pthread_rwlock_unlock(&pIf->lock);
+
+  /* Every counter derives from the byte counts, while they stand still nothing is recomputed */
+  if (pIf->statsGeneration == 0 || t.txBytes != pIf->statsTxBytes || t.rxBytes != pIf->statsRxBytes)
+  {
+    moca_sim_fill_stats(&t, &stats);
+    pIf->statsGeneration++;
+    for (field = 0; field < MOCA_STATS_FIELD_COUNT; field++)
+    {
+      if (pIf->statsGeneration == 1 ||
+          MOCA_SIM_STATS_FIELD(&stats, field) != MOCA_SIM_STATS_FIELD(&pIf->statsCache, field))
+      {
+        pIf->statsFieldGeneration[field] = pIf->statsGeneration;
+      }
+    }
+    pIf->statsCache = stats;
+    pIf->statsTxBytes = t.txBytes;
+    pIf->statsRxBytes = t.rxBytes;
+  }
+
+  pDelta->generation = pIf->statsGeneration;
+  pDelta->changedMask = 0;
+  if (generation != pIf->statsGeneration)
+  {
+    for (field = 0; field < MOCA_STATS_FIELD_COUNT; field++)
+    {
+      /* A generation from the future is unknown, the caller gets everything */
+      if (generation > pIf->statsGeneration || pIf->statsFieldGeneration[field] > generation)
+      {
+        pDelta->changedMask |= MOCA_STATS_FIELD_BIT(field);
+        MOCA_SIM_STATS_FIELD(&pDelta->stats, field) = MOCA_SIM_STATS_FIELD(&pIf->statsCache, field);
+      }
+    }
+  }
+  pthread_mutex_unlock(&pIf->statsLock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_GetNumAssociatedDevices(ULONG ifIndex, ULONG* pulCount)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pulCount;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_GetNumAssociatedDevices) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  *pulCount = pIf->numNodes - 1;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_IfGetExtCounter(ULONG ifIndex, moca_mac_counters_t* pmoca_mac_counters)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_mac_counters;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t t;
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetExtCounter) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_mac_counters == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_traffic(pIf, moca_sim_now_ns(), &t);
+  moca_sim_fill_mac_counters(pIf, &t, pmoca_mac_counters);
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_IfGetExtAggrCounter(ULONG ifIndex, moca_aggregate_counters_t* pmoca_aggregate_counts)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pmoca_aggregate_counts;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t t;
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetExtAggrCounter) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pmoca_aggregate_counts == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_traffic(pIf, moca_sim_now_ns(), &t);
+  pthread_rwlock_unlock(&pIf->lock);
+
+  moca_sim_fill_aggregate_counters(&t, pmoca_aggregate_counts);
+  return STATUS_SUCCESS;
+}
+
+INT moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_sim_traffic_t t;
+  uint64_t now;
+
+  if (moca_sim_inject(MOCA_SIM_API_IfGetTelemetrySnapshot) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pSnapshot == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* One lock and one clock read, every part describes the same instant */
+  pthread_rwlock_rdlock(&pIf->lock);
+  now = moca_sim_now_ns();
+  moca_sim_traffic(pIf, now, &t);
+  moca_sim_fill_dynamic_info(pIf, now, &pSnapshot->dynamicInfo);
+  moca_sim_fill_mac_counters(pIf, &t, &pSnapshot->macCounters);
+  pthread_rwlock_unlock(&pIf->lock);
+
+  moca_sim_fill_stats(&t, &pSnapshot->stats);
+  moca_sim_fill_aggregate_counters(&t, &pSnapshot->aggregateCounters);
+  pSnapshot->timestampNs = now;
+  return STATUS_SUCCESS;
 }
 
 INT moca_GetMocaCPEs(ULONG ifIndex, moca_cpe_t* cpes, INT* pnum_cpes)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)cpes;
-  (void)pnum_cpes;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_GetMocaCPEs) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || cpes == NULL || pnum_cpes == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  memcpy(cpes, pIf->cpes, pIf->numCpes * sizeof(moca_cpe_t));
+  *pnum_cpes = (INT)pIf->numCpes;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+/* Fills pDevices with every remote node, the read lock must be held, returns the number written */
+static ULONG moca_sim_fill_associated_devices(const moca_sim_if_t *pIf, moca_associated_device_t *pDevices)
+{
+  moca_sim_traffic_t t;
+  ULONG i, count = 0;
+
+  moca_sim_traffic(pIf, moca_sim_now_ns(), &t);
+  for (i = 0; i < pIf->numNodes; i++)
+  {
+    const moca_sim_node_t *pNode = &pIf->nodes[i];
+    moca_associated_device_t *pDevice;
+
+    if (i == MOCA_SIM_LOCAL_NODE_ID)
+    {
+      continue;
+    }
+    pDevice = &pDevices[count++];
+    *pDevice = pNode->device;
+    /* The remote node transmits what the local node receives and vice versa */
+    pDevice->TxPackets = moca_sim_counter(t.rxPackets * pNode->trafficShare / pIf->totalShare);
+    pDevice->RxPackets = moca_sim_counter(t.txPackets * pNode->trafficShare / pIf->totalShare);
+    pDevice->RxErroredAndMissedPackets = moca_sim_counter(t.txPackets * pNode->trafficShare / pIf->totalShare / 200000);
+  }
+  return count;
 }
 
 INT moca_GetAssociatedDevices(ULONG ifIndex, moca_associated_device_t** ppdevice_array)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)ppdevice_array;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  moca_associated_device_t *pArray;
+
+  if (moca_sim_inject(MOCA_SIM_API_GetAssociatedDevices) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || ppdevice_array == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  *ppdevice_array = NULL;
+  pthread_rwlock_rdlock(&pIf->lock);
+  if (pIf->numNodes > 1)
+  {
+    pArray = malloc((pIf->numNodes - 1) * sizeof(moca_associated_device_t));
+    if (pArray == NULL)
+    {
+      pthread_rwlock_unlock(&pIf->lock);
+      return STATUS_FAILURE;
+    }
+    moca_sim_fill_associated_devices(pIf, pArray);
+    *ppdevice_array = pArray;
+  }
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+INT moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  ULONG required;
+
+  if (moca_sim_inject(MOCA_SIM_API_GetAssociatedDevicesInto) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pCount == NULL || (pDevices == NULL && capacity > 0))
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  required = pIf->numNodes - 1;
+  if (required > capacity)
+  {
+    pthread_rwlock_unlock(&pIf->lock);
+    *pCount = required;
+    return STATUS_FAILURE;
+  }
+  *pCount = moca_sim_fill_associated_devices(pIf, pDevices);
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_FreqMaskToValue(UCHAR* mask)
 {
-  /*TODO: Implement Me!*/
-  (void)mask;
-  return (INT)0;
+  uint64_t value = 0;
+  int i;
+
+  if (moca_sim_inject(MOCA_SIM_API_FreqMaskToValue) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (mask == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  /* One table lookup validates and decodes each digit, a NUL ends the loop as an invalid digit */
+  for (i = 0; i < MOCA_FREQ_MASK_LENGTH; i++)
+  {
+    uint8_t digit = gSimHexDigit[mask[i]];
+
+    if (digit == 0)
+    {
+      return STATUS_FAILURE;
+    }
+    value = (value << 4) | (uint64_t)(digit - 1);
+  }
+  if (mask[MOCA_FREQ_MASK_LENGTH] != '\0' || value == 0)
+  {
+    return STATUS_FAILURE;
+  }
+  /* The lowest selected channel is the operating frequency */
+  return MOCA_FREQ_MASK_BASE + __builtin_ctzll(value) * MOCA_FREQ_MASK_STEP;
 }
 
 BOOL moca_HardwareEquipped(void)
 {
-  /*TODO: Implement Me!*/
-  return (BOOL)0;
+  if (moca_sim_inject(MOCA_SIM_API_HardwareEquipped) != STATUS_SUCCESS)
+  {
+    return FALSE;
+  }
+  /* The simulator has no MoCA hardware behind it */
+  return FALSE;
 }
 
 INT moca_GetFullMeshRates(ULONG ifIndex, moca_mesh_table_t* pDeviceArray, ULONG* pulCount)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pDeviceArray;
-  (void)pulCount;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  ULONG count;
+
+  if (moca_sim_inject(MOCA_SIM_API_GetFullMeshRates) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pDeviceArray == NULL || pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  if (pIf->meshStale == TRUE)
+  {
+    /* Rates changed since the last read, another reader may refresh first */
+    pthread_rwlock_unlock(&pIf->lock);
+    pthread_rwlock_wrlock(&pIf->lock);
+    moca_sim_mesh_refresh(pIf);
+  }
+  count = pIf->numNodes * (pIf->numNodes - 1);
+  memcpy(pDeviceArray, pIf->mesh, count * sizeof(moca_mesh_table_t));
+  pthread_rwlock_unlock(&pIf->lock);
+  *pulCount = count;
+  return STATUS_SUCCESS;
+}
+
+/* Caller holds the interface lock, flows are kept in increasing FlowID order */
+static ULONG moca_sim_flow_after(const moca_sim_if_t *pIf, ULONG flowId)
+{
+  ULONG low = 0, high = pIf->numFlows;
+
+  while (low < high)
+  {
+    ULONG middle = low + (high - low) / 2;
+
+    if (pIf->flows[middle].FlowID <= flowId)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/* Caller holds the interface lock */
+static void moca_sim_fill_flows(const moca_sim_if_t *pIf, ULONG first, ULONG count, moca_flow_table_t *pFlows)
+{
+  ULONG elapsed = (ULONG)((moca_sim_now_ns() - pIf->linkUpNs) / NS_PER_SEC);
+  ULONG i;
+
+  for (i = 0; i < count; i++)
+  {
+    const moca_flow_table_t *pFlow = &pIf->flows[first + i];
+
+    pFlows[i] = *pFlow;
+    pFlows[i].FlowTimeLeft = pFlow->LeaseTime - (elapsed % pFlow->LeaseTime);
+  }
 }
 
 INT moca_GetFlowStatistics(ULONG ifIndex, moca_flow_table_t* pDeviceArray, ULONG* pulCount)
 {
-  /*TODO: Implement Me!*/
-  (void)ifIndex;
-  (void)pDeviceArray;
-  (void)pulCount;
-  return (INT)0;
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_GetFlowStatistics) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pDeviceArray == NULL || pulCount == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  moca_sim_fill_flows(pIf, 0, pIf->numFlows, pDeviceArray);
+  *pulCount = pIf->numFlows;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
+
+INT moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity,
+                               ULONG *pCount, ULONG *pNextCursor)
+{
+  moca_sim_if_t *pIf = moca_sim_get_if(ifIndex);
+  ULONG first, count;
+
+  if (moca_sim_inject(MOCA_SIM_API_GetFlowStatisticsPage) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pFlows == NULL || capacity == 0 || pCount == NULL || pNextCursor == NULL ||
+      cursor == MOCA_FLOW_CURSOR_END)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  /* The cursor is the last FlowID returned, so flows added or removed since do not shift the pages */
+  first = moca_sim_flow_after(pIf, cursor);
+  count = (pIf->numFlows - first < capacity) ? pIf->numFlows - first : capacity;
+  moca_sim_fill_flows(pIf, first, count, pFlows);
+  *pCount = count;
+  *pNextCursor = (first + count < pIf->numFlows) ? pIf->flows[first + count - 1].FlowID : MOCA_FLOW_CURSOR_END;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 INT moca_GetResetCount(ULONG* resetcnt)
 {
-  /*TODO: Implement Me!*/
-  (void)resetcnt;
-  return (INT)0;
+  if (moca_sim_inject(MOCA_SIM_API_GetResetCount) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (resetcnt == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_once(&gSimOnce, moca_sim_init);
+  pthread_mutex_lock(&gSimMutex);
+  *resetcnt = gResetCount;
+  pthread_mutex_unlock(&gSimMutex);
+  return STATUS_SUCCESS;
 }
 
 int moca_setIfAcaConfig(int interfaceIndex, moca_aca_cfg_t acaCfg)
 {
-  /*TODO: Implement Me!*/
-  (void)interfaceIndex;
-  (void)acaCfg;
-  return (int)0;
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_setIfAcaConfig) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (acaCfg.type != MOCA_ACA_TYPE_EVM && acaCfg.type != MOCA_ACA_TYPE_QUIET)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  if (acaCfg.NodeID >= pIf->numNodes)
+  {
+    pthread_rwlock_unlock(&pIf->lock);
+    return STATUS_FAILURE;
+  }
+  pIf->acaConfig = acaCfg;
+  if (acaCfg.ACAStart)
+  {
+    moca_sim_aca_start(pIf, &acaCfg, NULL, NULL);
+  }
+  pthread_rwlock_unlock(&pIf->lock);
+  if (acaCfg.ACAStart)
+  {
+    /* Only signals moca_getIfAcaEventFd(), the status is still polled */
+    moca_sim_aca_wake();
+  }
+  return STATUS_SUCCESS;
 }
 
 int moca_getIfAcaConfig(int interfaceIndex, moca_aca_cfg_t* acaCfg)
 {
-  /*TODO: Implement Me!*/
-  (void)interfaceIndex;
-  (void)acaCfg;
-  return (int)0;
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_getIfAcaConfig) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || acaCfg == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_rdlock(&pIf->lock);
+  *acaCfg = pIf->acaConfig;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
 int moca_cancelIfAca(int interfaceIndex)
 {
-  /*TODO: Implement Me!*/
-  (void)interfaceIndex;
-  return (int)0;
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+  BOOL notify;
+
+  if (moca_sim_inject(MOCA_SIM_API_cancelIfAca) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  moca_sim_aca_update(pIf, moca_sim_now_ns());
+  if (pIf->acaStatus.acaStatus == MOCA_ACA_STATUS_INPROGRESS)
+  {
+    pIf->acaStatus.acaStatus = MOCA_ACA_STATUS_FAIL;
+  }
+  pIf->acaConfig.ACAStart = FALSE;
+  notify = pIf->acaNotify;
+  pthread_rwlock_unlock(&pIf->lock);
+  if (notify == TRUE)
+  {
+    moca_sim_aca_wake();
+  }
+  return STATUS_SUCCESS;
 }
 
 int moca_getIfAcaStatus(int interfaceIndex, moca_aca_stat_t* pacaStat)
 {
-  /*TODO: Implement Me!*/
-  (void)interfaceIndex;
-  (void)pacaStat;
-  return (int)0;
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_getIfAcaStatus) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pacaStat == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  moca_sim_aca_update(pIf, moca_sim_now_ns());
+  *pacaStat = pIf->acaStatus;
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
 }
 
-int moca_getIfScmod(int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat)
+int moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext)
+{
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+
+  if (moca_sim_inject(MOCA_SIM_API_startIfAcaAsync) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  if (acaCfg.type != MOCA_ACA_TYPE_EVM && acaCfg.type != MOCA_ACA_TYPE_QUIET)
+  {
+    return STATUS_FAILURE;
+  }
+  /* Without the worker the callback would never come */
+  if (moca_sim_aca_wake() == FALSE)
+  {
+    return STATUS_FAILURE;
+  }
+  pthread_rwlock_wrlock(&pIf->lock);
+  moca_sim_aca_update(pIf, moca_sim_now_ns());
+  /* Busy until the previous callback was delivered, so at most one waits in acaSupersededCallback */
+  if (acaCfg.NodeID >= pIf->numNodes || pIf->acaStatus.acaStatus == MOCA_ACA_STATUS_INPROGRESS ||
+      pIf->acaSupersededCallback != NULL)
+  {
+    pthread_rwlock_unlock(&pIf->lock);
+    return STATUS_FAILURE;
+  }
+  acaCfg.ACAStart = TRUE;
+  pIf->acaConfig = acaCfg;
+  moca_sim_aca_start(pIf, &acaCfg, callback, pContext);
+  pthread_rwlock_unlock(&pIf->lock);
+  moca_sim_aca_wake();
+  return STATUS_SUCCESS;
+}
+
+int moca_getIfAcaEventFd(int interfaceIndex)
 {
-  /*TODO: Implement Me!*/
-  (void)interfaceIndex;
-  (void)pnumOfEntries;
-  (void)ppscmodStat;
-  return (int)0;
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+  int eventFd;
+
+  if (moca_sim_inject(MOCA_SIM_API_getIfAcaEventFd) != STATUS_SUCCESS)
+  {
+    return -1;
+  }
+  if (pIf == NULL)
+  {
+    return -1;
+  }
+  /* The worker reads the descriptor under gSimAcaMutex and the interface lock */
+  pthread_mutex_lock(&gSimAcaMutex);
+  pthread_rwlock_wrlock(&pIf->lock);
+  if (pIf->acaEventFd < 0)
+  {
+    pIf->acaEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  }
+  eventFd = pIf->acaEventFd;
+  pthread_rwlock_unlock(&pIf->lock);
+  pthread_mutex_unlock(&gSimAcaMutex);
+  return eventFd;
 }
 
+int moca_getIfScmod(int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat)
+{
+  moca_sim_if_t *pIf = (interfaceIndex < 0) ? NULL : moca_sim_get_if((ULONG)interfaceIndex);
+  moca_scmod_stat_t *pStat;
+  ULONG tx, rx;
+  int count = 0;
+  int sc;
+
+  if (moca_sim_inject(MOCA_SIM_API_getIfScmod) != STATUS_SUCCESS)
+  {
+    return STATUS_FAILURE;
+  }
+  if (pIf == NULL || pnumOfEntries == NULL || ppscmodStat == NULL)
+  {
+    return STATUS_FAILURE;
+  }
+  *ppscmodStat = NULL;
+  *pnumOfEntries = 0;
+  pthread_rwlock_rdlock(&pIf->lock);
+  if (pIf->numNodes > 1)
+  {
+    pStat = calloc(pIf->numNodes * (pIf->numNodes - 1), sizeof(moca_scmod_stat_t));
+    if (pStat == NULL)
+    {
+      pthread_rwlock_unlock(&pIf->lock);
+      return STATUS_FAILURE;
+    }
+    for (tx = 0; tx < pIf->numNodes; tx++)
+    {
+      for (rx = 0; rx < pIf->numNodes; rx++)
+      {
+        moca_scmod_stat_t *pEntry;
+        /* Scale the mean bit loading with the PHY rate of the link */
+        int mean = (int)(pIf->phyRate[tx][rx] * MOCA_SIM_MAX_BITS_PER_SUBCARRIER / (MOCA_SIM_MAX_PHY_RATE + 100));
+
+        if (tx == rx)
+        {
+          continue;
+        }
+        pEntry = &pStat[count++];
+        pEntry->txNode = (UINT)tx;
+        pEntry->rxNode = (UINT)rx;
+        for (sc = 0; sc < MOCA_SIM_NUM_SUBCARRIERS; sc++)
+        {
+          int bits = mean + (int)(moca_sim_hash((uint32_t)tx, (uint32_t)rx, (uint32_t)sc) % 5) - 2;
+
+          /* Edge and notched subcarriers carry nothing */
+          if (sc < 4 || sc >= MOCA_SIM_NUM_SUBCARRIERS - 4 || bits < 0)
+          {
+            bits = 0;
+          }
+          pEntry->bitLoading[sc] = (UCHAR)((bits > MOCA_SIM_MAX_BITS_PER_SUBCARRIER) ? MOCA_SIM_MAX_BITS_PER_SUBCARRIER : bits);
+        }
+      }
+    }
+    *ppscmodStat = pStat;
+    *pnumOfEntries = count;
+  }
+  pthread_rwlock_unlock(&pIf->lock);
+  return STATUS_SUCCESS;
+}
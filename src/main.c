@@ -20,6 +20,7 @@
 #include <ut_log.h>
 #include <stdlib.h>
 #include "moca_hal.h"
+#include "moca_test_report.h"
 
 extern int register_hal_tests( void );
 
@@ -48,6 +49,7 @@ int main(int argc, char** argv)
         return 1;
     }
     UT_run_tests();
+    moca_test_report_write();
 
     return 0;
 }
@@ -0,0 +1,390 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_alloc.c
+*
+* Counting replacements for the C library allocator, see moca_alloc.h.
+*
+* The aligned allocators are replaced as well, their blocks are released with
+* free like any other. Nothing in here may allocate. The ownership of blocks
+* allocated inside a scope is kept in a fixed open addressing table guarded
+* by a spin lock, the lock is only taken while a scope is active or the
+* table is not empty.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include "moca_alloc.h"
+
+#if defined(__GLIBC__)
+
+#include <malloc.h>
+
+#define MOCA_ALLOC_OWNER_SLOTS  8192    /**< Power of two */
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void *__libc_valloc(size_t size);
+extern void *__libc_pvalloc(size_t size);
+
+typedef struct
+{
+  void *ptr;            /**< NULL for an empty slot */
+  size_t size;
+  uint32_t scopeId;
+} moca_alloc_owner_t;
+
+static moca_alloc_stats_t gAllocStats;
+static uint64_t gAllocLiveBytes = 0;
+static moca_alloc_scope_stats_t gScopeStats[MOCA_ALLOC_MAX_SCOPES];
+static moca_alloc_owner_t gOwners[MOCA_ALLOC_OWNER_SLOTS];
+static uint32_t gOwnerCount = 0;
+static char gOwnerLock = 0;
+static __thread uint32_t gThreadScope = MOCA_ALLOC_NO_SCOPE;
+static __thread uint32_t gThreadScopeDepth = 0;
+
+static void moca_alloc_lock(void)
+{
+    while (__atomic_test_and_set(&gOwnerLock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void moca_alloc_unlock(void)
+{
+    __atomic_clear(&gOwnerLock, __ATOMIC_RELEASE);
+}
+
+static uint32_t moca_alloc_slot(const void *ptr)
+{
+    uintptr_t key = (uintptr_t)ptr;
+
+    /* Blocks are 16 byte aligned, mix the remaining bits */
+    key >>= 4;
+    key ^= key >> 15;
+    key *= 0x9E3779B1u;
+    return (uint32_t)key & (MOCA_ALLOC_OWNER_SLOTS - 1);
+}
+
+/* Called with the lock held */
+static void moca_alloc_owner_insert(void *ptr, size_t size, uint32_t scopeId)
+{
+    uint32_t slot = moca_alloc_slot(ptr);
+    moca_alloc_scope_stats_t *pScope = &gScopeStats[scopeId];
+
+    /* Keep one slot free so a lookup always terminates */
+    if (gOwnerCount >= MOCA_ALLOC_OWNER_SLOTS - 1)
+    {
+        pScope->untracked++;
+        return;
+    }
+    while (gOwners[slot].ptr != NULL)
+    {
+        slot = (slot + 1) & (MOCA_ALLOC_OWNER_SLOTS - 1);
+    }
+    gOwners[slot].ptr = ptr;
+    gOwners[slot].size = size;
+    gOwners[slot].scopeId = scopeId;
+    gOwnerCount++;
+    pScope->outstandingBlocks++;
+    pScope->outstandingBytes += size;
+}
+
+/* Called with the lock held */
+static void moca_alloc_owner_remove(void *ptr)
+{
+    uint32_t slot = moca_alloc_slot(ptr);
+    uint32_t next;
+
+    while (gOwners[slot].ptr != ptr)
+    {
+        if (gOwners[slot].ptr == NULL)
+        {
+            return;
+        }
+        slot = (slot + 1) & (MOCA_ALLOC_OWNER_SLOTS - 1);
+    }
+    gScopeStats[gOwners[slot].scopeId].outstandingBlocks--;
+    gScopeStats[gOwners[slot].scopeId].outstandingBytes -= gOwners[slot].size;
+    gOwnerCount--;
+
+    /* Backward shift deletion, move up every entry that probed past the freed slot */
+    next = (slot + 1) & (MOCA_ALLOC_OWNER_SLOTS - 1);
+    while (gOwners[next].ptr != NULL)
+    {
+        uint32_t home = moca_alloc_slot(gOwners[next].ptr);
+
+        if (((next - home) & (MOCA_ALLOC_OWNER_SLOTS - 1)) >= ((next - slot) & (MOCA_ALLOC_OWNER_SLOTS - 1)))
+        {
+            gOwners[slot] = gOwners[next];
+            slot = next;
+        }
+        next = (next + 1) & (MOCA_ALLOC_OWNER_SLOTS - 1);
+    }
+    gOwners[slot].ptr = NULL;
+}
+
+static void moca_alloc_raise_peak(uint64_t liveBytes)
+{
+    uint64_t peak = __atomic_load_n(&gAllocStats.peakBytes, __ATOMIC_RELAXED);
+
+    while (liveBytes > peak &&
+           !__atomic_compare_exchange_n(&gAllocStats.peakBytes, &peak, liveBytes, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/* A block from an allocator not replaced here was never added, the live byte count must not wrap below zero */
+static void moca_alloc_drop_live(uint64_t size)
+{
+    uint64_t live = __atomic_load_n(&gAllocLiveBytes, __ATOMIC_RELAXED);
+
+    while (!__atomic_compare_exchange_n(&gAllocLiveBytes, &live, (live > size) ? live - size : 0, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void moca_alloc_count_allocation(void *ptr)
+{
+    size_t size;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+    size = malloc_usable_size(ptr);
+    __atomic_add_fetch(&gAllocStats.allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&gAllocStats.bytesAllocated, size, __ATOMIC_RELAXED);
+    moca_alloc_raise_peak(__atomic_add_fetch(&gAllocLiveBytes, size, __ATOMIC_RELAXED));
+    if (gThreadScope != MOCA_ALLOC_NO_SCOPE)
+    {
+        moca_alloc_lock();
+        gScopeStats[gThreadScope].allocations++;
+        gScopeStats[gThreadScope].bytesAllocated += size;
+        moca_alloc_owner_insert(ptr, size, gThreadScope);
+        moca_alloc_unlock();
+    }
+}
+
+static void moca_alloc_count_free(void *ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    __atomic_add_fetch(&gAllocStats.frees, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&gAllocStats.bytesFreed, size, __ATOMIC_RELAXED);
+    moca_alloc_drop_live(size);
+    if (gThreadScope != MOCA_ALLOC_NO_SCOPE || __atomic_load_n(&gOwnerCount, __ATOMIC_RELAXED) > 0)
+    {
+        moca_alloc_lock();
+        if (gThreadScope != MOCA_ALLOC_NO_SCOPE)
+        {
+            gScopeStats[gThreadScope].frees++;
+        }
+        moca_alloc_owner_remove(ptr);
+        moca_alloc_unlock();
+    }
+}
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void *calloc(size_t count, size_t size)
+{
+    void *ptr = __libc_calloc(count, size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    size_t oldSize;
+    void *newPtr;
+
+    if (ptr == NULL)
+    {
+        newPtr = __libc_realloc(NULL, size);
+        moca_alloc_count_allocation(newPtr);
+        return newPtr;
+    }
+    oldSize = malloc_usable_size(ptr);
+    newPtr = __libc_realloc(ptr, size);
+    if (newPtr == NULL && size != 0)
+    {
+        /* Failed, the old block is untouched */
+        return NULL;
+    }
+    /* Only the address of the old block is used from here on */
+    moca_alloc_count_free(ptr, oldSize);
+    moca_alloc_count_allocation(newPtr);
+    return newPtr;
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *ptr;
+
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+    {
+        return EINVAL;
+    }
+    ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL)
+    {
+        return ENOMEM;
+    }
+    moca_alloc_count_allocation(ptr);
+    *memptr = ptr;
+    return 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void *valloc(size_t size)
+{
+    void *ptr = __libc_valloc(size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void *pvalloc(size_t size)
+{
+    void *ptr = __libc_pvalloc(size);
+
+    moca_alloc_count_allocation(ptr);
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    if (ptr != NULL)
+    {
+        moca_alloc_count_free(ptr, malloc_usable_size(ptr));
+    }
+    __libc_free(ptr);
+}
+
+bool moca_alloc_supported(void)
+{
+    return true;
+}
+
+void moca_alloc_get_stats(moca_alloc_stats_t *pStats)
+{
+    pStats->allocations = __atomic_load_n(&gAllocStats.allocations, __ATOMIC_RELAXED);
+    pStats->frees = __atomic_load_n(&gAllocStats.frees, __ATOMIC_RELAXED);
+    pStats->bytesAllocated = __atomic_load_n(&gAllocStats.bytesAllocated, __ATOMIC_RELAXED);
+    pStats->bytesFreed = __atomic_load_n(&gAllocStats.bytesFreed, __ATOMIC_RELAXED);
+    pStats->peakBytes = __atomic_load_n(&gAllocStats.peakBytes, __ATOMIC_RELAXED);
+}
+
+void moca_alloc_reset_peak(void)
+{
+    __atomic_store_n(&gAllocStats.peakBytes, __atomic_load_n(&gAllocLiveBytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void moca_alloc_scope_enter(uint32_t scopeId)
+{
+    if (gThreadScopeDepth++ > 0 || scopeId == MOCA_ALLOC_NO_SCOPE || scopeId >= MOCA_ALLOC_MAX_SCOPES)
+    {
+        return;
+    }
+    __atomic_add_fetch(&gScopeStats[scopeId].calls, 1, __ATOMIC_RELAXED);
+    gThreadScope = scopeId;
+}
+
+void moca_alloc_scope_leave(void)
+{
+    if (gThreadScopeDepth > 0 && --gThreadScopeDepth == 0)
+    {
+        gThreadScope = MOCA_ALLOC_NO_SCOPE;
+    }
+}
+
+void moca_alloc_get_scope_stats(uint32_t scopeId, moca_alloc_scope_stats_t *pStats)
+{
+    if (scopeId >= MOCA_ALLOC_MAX_SCOPES)
+    {
+        memset(pStats, 0, sizeof(*pStats));
+        return;
+    }
+    moca_alloc_lock();
+    *pStats = gScopeStats[scopeId];
+    moca_alloc_unlock();
+}
+
+#else
+
+bool moca_alloc_supported(void)
+{
+    return false;
+}
+
+void moca_alloc_get_stats(moca_alloc_stats_t *pStats)
+{
+    memset(pStats, 0, sizeof(*pStats));
+}
+
+void moca_alloc_reset_peak(void)
+{
+}
+
+void moca_alloc_scope_enter(uint32_t scopeId)
+{
+    (void)scopeId;
+}
+
+void moca_alloc_scope_leave(void)
+{
+}
+
+void moca_alloc_get_scope_stats(uint32_t scopeId, moca_alloc_scope_stats_t *pStats)
+{
+    (void)scopeId;
+    memset(pStats, 0, sizeof(*pStats));
+}
+
+#endif
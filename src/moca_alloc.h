@@ -0,0 +1,116 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_alloc.h
+*
+* Heap allocation accounting for the test binary.
+*
+* moca_alloc.c replaces malloc, calloc, realloc, free and the aligned allocators
+* (posix_memalign, aligned_alloc, memalign, valloc, pvalloc) for the whole process,
+* including a HAL linked as a shared library, and counts every call. Counting
+* needs the glibc __libc_* entry points, on other C libraries the counters stay
+* at zero and moca_alloc_supported() returns false.
+*
+* Allocations made while a thread is inside a scope are also charged to that
+* scope. Blocks allocated in a scope are remembered until freed, wherever that
+* happens, so a scope's outstanding blocks are exactly what it handed out and
+* nobody released yet. moca_hal_wrap.c opens one scope per HAL API call.
+*/
+
+#ifndef __MOCA_ALLOC_H__
+#define __MOCA_ALLOC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Process wide allocation counters.
+*/
+typedef struct
+{
+  uint64_t allocations;     /**< Successful allocator calls that returned a new block */
+  uint64_t frees;           /**< free calls and realloc calls that released a block */
+  uint64_t bytesAllocated;  /**< Usable size of every block handed out */
+  uint64_t bytesFreed;      /**< Usable size of every block released */
+  uint64_t peakBytes;       /**< Highest live byte count since start up or moca_alloc_reset_peak(), which sets it to the current one */
+} moca_alloc_stats_t;
+
+#define MOCA_ALLOC_NO_SCOPE     0
+#define MOCA_ALLOC_MAX_SCOPES   64      /**< Scope IDs are 1 to MOCA_ALLOC_MAX_SCOPES - 1 */
+
+/**
+* @brief Allocation counters of one scope.
+*/
+typedef struct
+{
+  uint64_t calls;               /**< Times the scope was entered */
+  uint64_t allocations;         /**< Blocks allocated inside the scope */
+  uint64_t frees;               /**< Blocks freed inside the scope, whoever allocated them */
+  uint64_t bytesAllocated;
+  uint64_t outstandingBlocks;   /**< Blocks allocated inside the scope and not freed yet */
+  uint64_t outstandingBytes;
+  uint64_t untracked;           /**< Blocks that did not fit the ownership table, missing from outstanding */
+} moca_alloc_scope_stats_t;
+
+/**
+* @brief Returns true if allocations are being counted.
+*/
+bool moca_alloc_supported(void);
+
+/**
+* @brief Reads the counters accumulated since the process started.
+*/
+void moca_alloc_get_stats(moca_alloc_stats_t *pStats);
+
+/**
+* @brief Restarts the high-water mark from the bytes currently allocated, to measure the peak of one operation.
+*/
+void moca_alloc_reset_peak(void);
+
+/**
+* @brief Charges the calling thread's allocations to scopeId until the matching moca_alloc_scope_leave().
+*
+* Scopes nest, allocations are charged to the outermost one only.
+*
+* @param[in] scopeId - 1 to MOCA_ALLOC_MAX_SCOPES - 1.
+*/
+void moca_alloc_scope_enter(uint32_t scopeId);
+void moca_alloc_scope_leave(void);
+
+/**
+* @brief Reads the counters of a scope accumulated since the process started.
+*/
+void moca_alloc_get_scope_stats(uint32_t scopeId, moca_alloc_scope_stats_t *pStats);
+
+/**
+* @brief Returns the title of the test running, NULL outside a test.
+*
+* Kept by the UT_add_test wrapper of moca_alloc_report.c, which reports the allocations of every test.
+*/
+const char *moca_alloc_current_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_ALLOC_H__ */
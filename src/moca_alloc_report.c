@@ -0,0 +1,182 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_alloc_report.c
+*
+* Per test allocation report.
+*
+* UT_add_test is wrapped at link time (-Wl,--wrap=UT_add_test) so every test
+* is registered through a trampoline that snapshots the moca_alloc counters
+* around it. After each test one line is logged with the heap allocations it
+* made and the blocks still live at its end, followed by one line per HAL API
+* it called. Blocks a HAL API handed out that the test never freed are
+* reported as leaked and charged to that API.
+*
+* The trampoline also times each test for moca_test_report.c, UT_add_suite is
+* wrapped as well so the report knows the suite of every test. Before running
+* a test it offers it to moca_test_parallel.c, which runs the measured test in
+* a worker process when its suite runs in parallel.
+*/
+
+#include <stdio.h>
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_alloc.h"
+#include "moca_hal_wrap.h"
+#include "moca_test_parallel.h"
+#include "moca_test_report.h"
+
+#define MOCA_ALLOC_MAX_TESTS    256
+
+typedef struct
+{
+    UT_test_suite_t *pSuite;
+    const char *pTitle;
+    UT_TestFunction_t function;
+} moca_alloc_test_t;
+
+extern UT_test_suite_t *__real_UT_add_suite(const char *pTitle, UT_InitialiseFunction_t pInitFunction,
+                                            UT_CleanupFunction_t pCleanupFunction);
+extern UT_test_t *__real_UT_add_test(UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunction_t pFunction);
+
+static moca_alloc_test_t gAllocTests[MOCA_ALLOC_MAX_TESTS];
+static uint32_t gAllocTestCount = 0;
+static moca_alloc_scope_stats_t gScopeBefore[MOCA_ALLOC_MAX_SCOPES];
+static const char *gAllocCurrentTest = NULL;
+
+static void moca_alloc_measure_test(uint32_t index)
+{
+    const moca_alloc_test_t *pTest = &gAllocTests[index];
+    moca_alloc_stats_t before, after;
+    moca_alloc_scope_stats_t scope;
+    uint32_t apiCount = moca_hal_wrap_api_count();
+    uint32_t id;
+
+    for (id = 1; id <= apiCount; id++)
+    {
+        moca_alloc_get_scope_stats(id, &gScopeBefore[id]);
+    }
+    moca_alloc_get_stats(&before);
+
+    gAllocCurrentTest = pTest->pTitle;
+    moca_test_report_begin(pTest->pSuite, pTest->pTitle);
+    pTest->function();
+    moca_test_report_end();
+    gAllocCurrentTest = NULL;
+
+    moca_alloc_get_stats(&after);
+    if (!moca_alloc_supported())
+    {
+        return;
+    }
+    UT_LOG("[alloc] %s: %llu allocations, %llu bytes, %lld blocks live at exit",
+           pTest->pTitle,
+           (unsigned long long)(after.allocations - before.allocations),
+           (unsigned long long)(after.bytesAllocated - before.bytesAllocated),
+           (long long)((after.allocations - after.frees) - (before.allocations - before.frees)));
+    for (id = 1; id <= apiCount; id++)
+    {
+        const moca_alloc_scope_stats_t *pBefore = &gScopeBefore[id];
+        uint64_t calls;
+
+        moca_alloc_get_scope_stats(id, &scope);
+        calls = scope.calls - pBefore->calls;
+        if (calls == 0)
+        {
+            continue;
+        }
+        UT_LOG("[alloc]   %s: %llu calls, %.2f allocations/call, %.0f bytes/call, %lld blocks leaked (%lld bytes)%s",
+               moca_hal_wrap_api_name(id),
+               (unsigned long long)calls,
+               (double)(scope.allocations - pBefore->allocations) / (double)calls,
+               (double)(scope.bytesAllocated - pBefore->bytesAllocated) / (double)calls,
+               (long long)(scope.outstandingBlocks - pBefore->outstandingBlocks),
+               (long long)(scope.outstandingBytes - pBefore->outstandingBytes),
+               (scope.untracked != pBefore->untracked) ? ", ownership table full" : "");
+    }
+}
+
+static void moca_alloc_run_test(uint32_t index)
+{
+    if (!moca_test_parallel_dispatch(index, moca_alloc_measure_test))
+    {
+        moca_alloc_measure_test(index);
+    }
+}
+
+const char *moca_alloc_current_test(void)
+{
+    return gAllocCurrentTest;
+}
+
+/* One trampoline per registration slot, a CUnit style test function takes no arguments */
+#define MOCA_ALLOC_TRAMPOLINE(n)    static void moca_alloc_test_##n(void) { moca_alloc_run_test(0x##n); }
+#define MOCA_ALLOC_TRAMPOLINES(h) \
+    MOCA_ALLOC_TRAMPOLINE(h##0) MOCA_ALLOC_TRAMPOLINE(h##1) MOCA_ALLOC_TRAMPOLINE(h##2) MOCA_ALLOC_TRAMPOLINE(h##3) \
+    MOCA_ALLOC_TRAMPOLINE(h##4) MOCA_ALLOC_TRAMPOLINE(h##5) MOCA_ALLOC_TRAMPOLINE(h##6) MOCA_ALLOC_TRAMPOLINE(h##7) \
+    MOCA_ALLOC_TRAMPOLINE(h##8) MOCA_ALLOC_TRAMPOLINE(h##9) MOCA_ALLOC_TRAMPOLINE(h##a) MOCA_ALLOC_TRAMPOLINE(h##b) \
+    MOCA_ALLOC_TRAMPOLINE(h##c) MOCA_ALLOC_TRAMPOLINE(h##d) MOCA_ALLOC_TRAMPOLINE(h##e) MOCA_ALLOC_TRAMPOLINE(h##f)
+#define MOCA_ALLOC_ENTRIES(h) \
+    moca_alloc_test_##h##0, moca_alloc_test_##h##1, moca_alloc_test_##h##2, moca_alloc_test_##h##3, \
+    moca_alloc_test_##h##4, moca_alloc_test_##h##5, moca_alloc_test_##h##6, moca_alloc_test_##h##7, \
+    moca_alloc_test_##h##8, moca_alloc_test_##h##9, moca_alloc_test_##h##a, moca_alloc_test_##h##b, \
+    moca_alloc_test_##h##c, moca_alloc_test_##h##d, moca_alloc_test_##h##e, moca_alloc_test_##h##f,
+
+MOCA_ALLOC_TRAMPOLINES(0) MOCA_ALLOC_TRAMPOLINES(1) MOCA_ALLOC_TRAMPOLINES(2) MOCA_ALLOC_TRAMPOLINES(3)
+MOCA_ALLOC_TRAMPOLINES(4) MOCA_ALLOC_TRAMPOLINES(5) MOCA_ALLOC_TRAMPOLINES(6) MOCA_ALLOC_TRAMPOLINES(7)
+MOCA_ALLOC_TRAMPOLINES(8) MOCA_ALLOC_TRAMPOLINES(9) MOCA_ALLOC_TRAMPOLINES(a) MOCA_ALLOC_TRAMPOLINES(b)
+MOCA_ALLOC_TRAMPOLINES(c) MOCA_ALLOC_TRAMPOLINES(d) MOCA_ALLOC_TRAMPOLINES(e) MOCA_ALLOC_TRAMPOLINES(f)
+
+static const UT_TestFunction_t gAllocTrampolines[MOCA_ALLOC_MAX_TESTS] =
+{
+    MOCA_ALLOC_ENTRIES(0) MOCA_ALLOC_ENTRIES(1) MOCA_ALLOC_ENTRIES(2) MOCA_ALLOC_ENTRIES(3)
+    MOCA_ALLOC_ENTRIES(4) MOCA_ALLOC_ENTRIES(5) MOCA_ALLOC_ENTRIES(6) MOCA_ALLOC_ENTRIES(7)
+    MOCA_ALLOC_ENTRIES(8) MOCA_ALLOC_ENTRIES(9) MOCA_ALLOC_ENTRIES(a) MOCA_ALLOC_ENTRIES(b)
+    MOCA_ALLOC_ENTRIES(c) MOCA_ALLOC_ENTRIES(d) MOCA_ALLOC_ENTRIES(e) MOCA_ALLOC_ENTRIES(f)
+};
+
+UT_test_suite_t *__wrap_UT_add_suite(const char *pTitle, UT_InitialiseFunction_t pInitFunction,
+                                     UT_CleanupFunction_t pCleanupFunction)
+{
+    UT_test_suite_t *pSuite = __real_UT_add_suite(pTitle, pInitFunction, pCleanupFunction);
+
+    moca_test_report_add_suite(pSuite, pTitle);
+    return pSuite;
+}
+
+UT_test_t *__wrap_UT_add_test(UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunction_t pFunction)
+{
+    uint32_t index = gAllocTestCount;
+
+    if (index >= MOCA_ALLOC_MAX_TESTS || pFunction == NULL)
+    {
+        if (index == MOCA_ALLOC_MAX_TESTS)
+        {
+            printf("moca_alloc: more than %d tests, %s and later are not reported\n", MOCA_ALLOC_MAX_TESTS, pTitle);
+            gAllocTestCount++;
+        }
+        return __real_UT_add_test(pSuite, pTitle, pFunction);
+    }
+    gAllocTests[index].pSuite = pSuite;
+    gAllocTests[index].pTitle = pTitle;
+    gAllocTests[index].function = pFunction;
+    moca_test_parallel_register(index, pSuite, pTitle);
+    gAllocTestCount++;
+    return __real_UT_add_test(pSuite, pTitle, gAllocTrampolines[index]);
+}
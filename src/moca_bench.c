@@ -0,0 +1,310 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include "moca_alloc.h"
+#include "moca_bench.h"
+
+static int gResultsFd = -2;     /**< -2 until MOCA_BENCH_RESULTS is looked up, -1 if not written */
+
+uint64_t moca_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t moca_bench_env_u32(const char *pName, uint32_t defaultValue, uint32_t maxValue)
+{
+    const char *value = getenv(pName);
+    unsigned long parsed;
+
+    if (value == NULL)
+    {
+        return defaultValue;
+    }
+    parsed = strtoul(value, NULL, 0);
+    if (parsed == 0)
+    {
+        return defaultValue;
+    }
+    return (parsed > maxValue) ? maxValue : (uint32_t)parsed;
+}
+
+uint32_t moca_bench_iterations(void)
+{
+    return moca_bench_env_u32("MOCA_BENCH_ITERATIONS", MOCA_BENCH_DEFAULT_ITERATIONS, UINT32_MAX);
+}
+
+void moca_bench_sleep_ns(uint64_t ns)
+{
+    struct timespec ts = { (time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL) };
+
+    nanosleep(&ts, NULL);
+}
+
+static uint32_t moca_bench_bucket(uint64_t value)
+{
+    uint32_t magnitude;
+
+    if (value < MOCA_BENCH_SUB_BUCKETS)
+    {
+        return (uint32_t)value;
+    }
+    /* Keep the top MOCA_BENCH_SUB_BUCKET_BITS significant bits, the shift selects the magnitude */
+    magnitude = 63 - (uint32_t)__builtin_clzll(value) - MOCA_BENCH_SUB_BUCKET_BITS + 1;
+    return magnitude * MOCA_BENCH_SUB_BUCKETS + (uint32_t)((value >> magnitude) & (MOCA_BENCH_SUB_BUCKETS - 1));
+}
+
+static uint64_t moca_bench_bucket_upper(uint32_t bucket)
+{
+    uint32_t magnitude = bucket / MOCA_BENCH_SUB_BUCKETS;
+    uint64_t sub = bucket % MOCA_BENCH_SUB_BUCKETS;
+
+    if (magnitude == 0)
+    {
+        return sub;
+    }
+    return ((sub + 1) << magnitude) - 1;
+}
+
+void moca_bench_histogram_reset(moca_bench_histogram_t *pHistogram)
+{
+    memset(pHistogram, 0, sizeof(*pHistogram));
+    pHistogram->min = UINT64_MAX;
+}
+
+void moca_bench_histogram_record(moca_bench_histogram_t *pHistogram, uint64_t valueNs)
+{
+    pHistogram->buckets[moca_bench_bucket(valueNs)]++;
+    pHistogram->count++;
+    pHistogram->sum += valueNs;
+    if (valueNs < pHistogram->min)
+    {
+        pHistogram->min = valueNs;
+    }
+    if (valueNs > pHistogram->max)
+    {
+        pHistogram->max = valueNs;
+    }
+}
+
+void moca_bench_histogram_merge(moca_bench_histogram_t *pDestination, const moca_bench_histogram_t *pSource)
+{
+    uint32_t i;
+
+    for (i = 0; i < MOCA_BENCH_BUCKETS; i++)
+    {
+        pDestination->buckets[i] += pSource->buckets[i];
+    }
+    pDestination->count += pSource->count;
+    pDestination->sum += pSource->sum;
+    pDestination->countedCalls += pSource->countedCalls;
+    pDestination->allocations += pSource->allocations;
+    pDestination->bytesAllocated += pSource->bytesAllocated;
+    if (pSource->min < pDestination->min)
+    {
+        pDestination->min = pSource->min;
+    }
+    if (pSource->max > pDestination->max)
+    {
+        pDestination->max = pSource->max;
+    }
+}
+
+uint64_t moca_bench_histogram_percentile(const moca_bench_histogram_t *pHistogram, double percentile)
+{
+    uint64_t rank;
+    uint64_t seen = 0;
+    uint32_t i;
+
+    if (pHistogram->count == 0)
+    {
+        return 0;
+    }
+    rank = (uint64_t)(percentile / 100.0 * (double)pHistogram->count + 0.5);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    for (i = 0; i < MOCA_BENCH_BUCKETS; i++)
+    {
+        seen += pHistogram->buckets[i];
+        if (seen >= rank)
+        {
+            uint64_t upper = moca_bench_bucket_upper(i);
+
+            /* The bucket bound can overshoot the largest sample seen */
+            return (upper > pHistogram->max) ? pHistogram->max : upper;
+        }
+    }
+    return pHistogram->max;
+}
+
+uint32_t moca_bench_run(moca_bench_op_t op, void *pContext, uint32_t iterations, moca_bench_histogram_t *pHistogram)
+{
+    moca_alloc_stats_t before, after;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    moca_bench_histogram_reset(pHistogram);
+    for (i = 0; i < MOCA_BENCH_DEFAULT_WARMUP; i++)
+    {
+        (void)op(pContext);
+    }
+    moca_alloc_get_stats(&before);
+    for (i = 0; i < iterations; i++)
+    {
+        uint64_t start = moca_bench_now_ns();
+        int status = op(pContext);
+
+        moca_bench_histogram_record(pHistogram, moca_bench_now_ns() - start);
+        if (status != 0)
+        {
+            failures++;
+        }
+    }
+    moca_alloc_get_stats(&after);
+    if (moca_alloc_supported())
+    {
+        pHistogram->countedCalls = iterations;
+        pHistogram->allocations = after.allocations - before.allocations;
+        pHistogram->bytesAllocated = after.bytesAllocated - before.bytesAllocated;
+    }
+    return failures;
+}
+
+/* Appends len bytes to the results file, written without stdio so that reporting allocates nothing */
+static void moca_bench_write_results(const char *pLine, size_t len)
+{
+    const char *pPath;
+    ssize_t written;
+
+    if (gResultsFd == -2)
+    {
+        pPath = getenv("MOCA_BENCH_RESULTS");
+        gResultsFd = -1;
+        if (pPath != NULL && pPath[0] != '\0')
+        {
+            gResultsFd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (gResultsFd < 0)
+            {
+                UT_LOG("Cannot create %s, benchmark results not written", pPath);
+                return;
+            }
+            moca_bench_write_results(MOCA_BENCH_RESULTS_HEADER "\n", sizeof(MOCA_BENCH_RESULTS_HEADER));
+        }
+    }
+    while (len > 0 && gResultsFd >= 0)
+    {
+        written = write(gResultsFd, pLine, len);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            UT_LOG("Writing the benchmark results failed, no more results are written");
+            close(gResultsFd);
+            gResultsFd = -1;
+            return;
+        }
+        pLine += written;
+        len -= (size_t)written;
+    }
+}
+
+/* Copies a name into a CSV field, the separator and line breaks are replaced */
+static void moca_bench_csv_field(char *pField, size_t size, const char *pName)
+{
+    size_t i;
+
+    for (i = 0; pName != NULL && pName[i] != '\0' && i + 1 < size; i++)
+    {
+        pField[i] = (pName[i] == ',' || pName[i] == '\n' || pName[i] == '\r' || pName[i] == '"') ? ';' : pName[i];
+    }
+    pField[i] = '\0';
+}
+
+static void moca_bench_report_results(const char *pName, const moca_bench_histogram_t *pHistogram)
+{
+    char test[128];
+    char name[128];
+    char allocations[64] = "";
+    char line[512];
+    int len;
+
+    if (gResultsFd == -1)
+    {
+        return;
+    }
+    moca_bench_csv_field(test, sizeof(test), moca_alloc_current_test());
+    moca_bench_csv_field(name, sizeof(name), pName);
+    if (pHistogram->countedCalls > 0)
+    {
+        snprintf(allocations, sizeof(allocations), "%.2f,%.0f",
+                 (double)pHistogram->allocations / (double)pHistogram->countedCalls,
+                 (double)pHistogram->bytesAllocated / (double)pHistogram->countedCalls);
+    }
+    else
+    {
+        snprintf(allocations, sizeof(allocations), ",");
+    }
+    len = snprintf(line, sizeof(line), "%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%s\n",
+                   test, name,
+                   (unsigned long long)pHistogram->count,
+                   (unsigned long long)pHistogram->min,
+                   (unsigned long long)(pHistogram->sum / pHistogram->count),
+                   (unsigned long long)moca_bench_histogram_percentile(pHistogram, 50.0),
+                   (unsigned long long)moca_bench_histogram_percentile(pHistogram, 99.0),
+                   (unsigned long long)moca_bench_histogram_percentile(pHistogram, 99.9),
+                   (unsigned long long)pHistogram->max,
+                   allocations);
+    if (len > 0 && (size_t)len < sizeof(line))
+    {
+        moca_bench_write_results(line, (size_t)len);
+    }
+}
+
+void moca_bench_report(const char *pName, const moca_bench_histogram_t *pHistogram)
+{
+    if (pHistogram->count == 0)
+    {
+        UT_LOG("%s: no samples", pName);
+        return;
+    }
+    UT_LOG("%s: count=%llu min=%lluns mean=%lluns p50=%lluns p99=%lluns p99.9=%lluns max=%lluns",
+           pName,
+           (unsigned long long)pHistogram->count,
+           (unsigned long long)pHistogram->min,
+           (unsigned long long)(pHistogram->sum / pHistogram->count),
+           (unsigned long long)moca_bench_histogram_percentile(pHistogram, 50.0),
+           (unsigned long long)moca_bench_histogram_percentile(pHistogram, 99.0),
+           (unsigned long long)moca_bench_histogram_percentile(pHistogram, 99.9),
+           (unsigned long long)pHistogram->max);
+    moca_bench_report_results(pName, pHistogram);
+}
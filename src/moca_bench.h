@@ -0,0 +1,144 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_bench.h
+*
+* Latency measurement helpers shared by the benchmark suites.
+*
+* Latencies are recorded into a log-linear histogram: every power of two
+* range is split into MOCA_BENCH_SUB_BUCKETS / 2 linear buckets, which bounds
+* the error of a reported percentile to 2 / MOCA_BENCH_SUB_BUCKETS (6.25%) of
+* its value while keeping the memory per histogram fixed.
+*
+* When MOCA_BENCH_RESULTS names a file, moca_bench_report() also writes one
+* CSV row per report to it, see MOCA_BENCH_RESULTS_HEADER. bin/run.sh compares
+* such a file against a stored baseline.
+*/
+
+#ifndef __MOCA_BENCH_H__
+#define __MOCA_BENCH_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_BENCH_SUB_BUCKET_BITS   5
+#define MOCA_BENCH_SUB_BUCKETS       (1 << MOCA_BENCH_SUB_BUCKET_BITS)
+#define MOCA_BENCH_BUCKETS           ((64 - MOCA_BENCH_SUB_BUCKET_BITS + 1) * MOCA_BENCH_SUB_BUCKETS)
+
+#define MOCA_BENCH_DEFAULT_ITERATIONS  5000
+#define MOCA_BENCH_DEFAULT_WARMUP      100
+
+/**
+* @brief Latency histogram in nanoseconds.
+*/
+typedef struct
+{
+  uint64_t count;
+  uint64_t min;
+  uint64_t max;
+  uint64_t sum;
+  uint64_t countedCalls;      /**< Samples whose heap allocations were counted, by moca_bench_run() */
+  uint64_t allocations;       /**< Heap allocations made by the counted calls */
+  uint64_t bytesAllocated;
+  uint64_t buckets[MOCA_BENCH_BUCKETS];
+} moca_bench_histogram_t;
+
+/** First line of a results file, the allocation columns are empty when allocations were not counted */
+#define MOCA_BENCH_RESULTS_HEADER \
+  "test,name,count,min_ns,mean_ns,p50_ns,p99_ns,p999_ns,max_ns,allocations_per_call,bytes_per_call"
+
+/**
+* @brief Operation timed by moca_bench_run(), returns the HAL status of one call.
+*/
+typedef int (*moca_bench_op_t)(void *pContext);
+
+/**
+* @brief Reads the monotonic clock.
+*
+* @return Time in nanoseconds.
+*/
+uint64_t moca_bench_now_ns(void);
+
+/**
+* @brief Number of timed iterations per benchmark, MOCA_BENCH_ITERATIONS overrides the default.
+*/
+uint32_t moca_bench_iterations(void);
+
+/**
+* @brief Reads a positive setting of a suite from the environment.
+*
+* @param[in] pName        - Environment variable.
+* @param[in] defaultValue - Returned when the variable is unset, not a number or 0.
+* @param[in] maxValue     - Larger values are capped to it.
+*
+* @return The setting.
+*/
+uint32_t moca_bench_env_u32(const char *pName, uint32_t defaultValue, uint32_t maxValue);
+
+/**
+* @brief Sleeps for ns nanoseconds, less if a signal interrupts it.
+*/
+void moca_bench_sleep_ns(uint64_t ns);
+
+void moca_bench_histogram_reset(moca_bench_histogram_t *pHistogram);
+void moca_bench_histogram_record(moca_bench_histogram_t *pHistogram, uint64_t valueNs);
+
+/**
+* @brief Merges pSource into pDestination.
+*/
+void moca_bench_histogram_merge(moca_bench_histogram_t *pDestination, const moca_bench_histogram_t *pSource);
+
+/**
+* @brief Returns the value at or below which the given percentage of samples fall.
+*
+* @param[in] pHistogram - Histogram to query.
+* @param[in] percentile - Percentile in the range 0 - 100.
+*
+* @return Upper bound of the bucket holding the percentile, 0 if the histogram is empty.
+*/
+uint64_t moca_bench_histogram_percentile(const moca_bench_histogram_t *pHistogram, double percentile);
+
+/**
+* @brief Runs op once per warm up iteration and then times iterations calls.
+*
+* @param[in]  op          - Operation to time.
+* @param[in]  pContext    - Passed to op.
+* @param[in]  iterations  - Number of timed calls.
+* @param[out] pHistogram  - Receives one sample per timed call and the heap allocations of the timed calls, reset first.
+*
+* @return Number of calls that did not return 0.
+*/
+uint32_t moca_bench_run(moca_bench_op_t op, void *pContext, uint32_t iterations, moca_bench_histogram_t *pHistogram);
+
+/**
+* @brief Logs count, min, mean, p50, p99, p99.9 and max of a histogram.
+*
+* The same figures are written to the MOCA_BENCH_RESULTS file, keyed by the running test and pName, so pName
+* must be unique within a test.
+*/
+void moca_bench_report(const char *pName, const moca_bench_histogram_t *pHistogram);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_BENCH_H__ */
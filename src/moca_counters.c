@@ -0,0 +1,192 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_counters.c
+*
+* 64 bit extension of the MoCA counters, see moca_counters.h.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "moca_hal.h"
+#include "moca_counters.h"
+
+#define MOCA_COUNTERS_READ_ATTEMPTS    3
+
+typedef struct
+{
+    const char *pName;
+    size_t offset;
+} moca_counters_field_t;
+
+#define MOCA_COUNTERS_STATS_FIELD(field)    { #field, offsetof(moca_stats_t, field) }
+#define MOCA_COUNTERS_MAC_FIELD(field)      { #field, offsetof(moca_mac_counters_t, field) }
+
+/* In moca_counter_t order */
+static const moca_counters_field_t gCountersFields[MOCA_COUNTER_COUNT] =
+{
+    MOCA_COUNTERS_STATS_FIELD(BytesSent),
+    MOCA_COUNTERS_STATS_FIELD(BytesReceived),
+    MOCA_COUNTERS_STATS_FIELD(PacketsSent),
+    MOCA_COUNTERS_STATS_FIELD(PacketsReceived),
+    MOCA_COUNTERS_STATS_FIELD(ErrorsSent),
+    MOCA_COUNTERS_STATS_FIELD(ErrorsReceived),
+    MOCA_COUNTERS_STATS_FIELD(UnicastPacketsSent),
+    MOCA_COUNTERS_STATS_FIELD(UnicastPacketsReceived),
+    MOCA_COUNTERS_STATS_FIELD(DiscardPacketsSent),
+    MOCA_COUNTERS_STATS_FIELD(DiscardPacketsReceived),
+    MOCA_COUNTERS_STATS_FIELD(MulticastPacketsSent),
+    MOCA_COUNTERS_STATS_FIELD(MulticastPacketsReceived),
+    MOCA_COUNTERS_STATS_FIELD(BroadcastPacketsSent),
+    MOCA_COUNTERS_STATS_FIELD(BroadcastPacketsReceived),
+    MOCA_COUNTERS_STATS_FIELD(UnknownProtoPacketsReceived),
+    MOCA_COUNTERS_MAC_FIELD(Map),
+    MOCA_COUNTERS_MAC_FIELD(Rsrv),
+    MOCA_COUNTERS_MAC_FIELD(Lc),
+    MOCA_COUNTERS_MAC_FIELD(Adm),
+    MOCA_COUNTERS_MAC_FIELD(Probe),
+    MOCA_COUNTERS_MAC_FIELD(Async),
+};
+
+INT moca_counters_init(moca_counters_t *pCounters, ULONG ifIndex, uint32_t counterBits)
+{
+    if (pCounters == NULL || counterBits == 0 || counterBits > sizeof(ULONG) * 8)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(pCounters, 0, sizeof(*pCounters));
+    pCounters->ifIndex = ifIndex;
+    pCounters->mask = (counterBits >= 64) ? UINT64_MAX : ((1ULL << counterBits) - 1);
+    return STATUS_SUCCESS;
+}
+
+const char *moca_counters_name(moca_counter_t counter)
+{
+    return ((unsigned)counter < MOCA_COUNTER_COUNT) ? gCountersFields[counter].pName : NULL;
+}
+
+/* Tracks the counters first to last from the structure at pBase */
+static void moca_counters_track(moca_counters_t *pCounters, const void *pBase, uint32_t first, uint32_t last,
+                                BOOL reset, double seconds)
+{
+    uint64_t mask = pCounters->mask;
+    uint32_t i;
+
+    for (i = first; i < last; i++)
+    {
+        uint64_t current = (uint64_t)*(const ULONG *)((const char *)pBase + gCountersFields[i].offset) & mask;
+        uint64_t previous = (uint64_t)pCounters->raw[i] & mask;
+        uint64_t delta;
+
+        if (pCounters->haveSample == FALSE || (i >= MOCA_COUNTER_FIRST_MAC && pCounters->haveMacCounters == FALSE))
+        {
+            /* First value, the total starts from it */
+            pCounters->total[i] = current;
+            delta = 0;
+        }
+        else if (reset)
+        {
+            delta = current;
+        }
+        else
+        {
+            /* Modulo the counter width, a smaller value is one wrap */
+            delta = (current - previous) & mask;
+            pCounters->wraps[i] += (current < previous);
+        }
+        pCounters->raw[i] = (ULONG)current;
+        pCounters->total[i] += delta;
+        pCounters->delta[i] = delta;
+        pCounters->rate[i] = (seconds > 0.0) ? (double)delta / seconds : 0.0;
+    }
+}
+
+INT moca_counters_update(moca_counters_t *pCounters, ULONG resetCount, const moca_stats_t *pStats,
+                         const moca_mac_counters_t *pMacCounters, uint64_t timestampNs)
+{
+    BOOL reset;
+    double seconds;
+
+    if (pCounters == NULL || pStats == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    reset = (pCounters->haveSample && resetCount != pCounters->resetCount) ? TRUE : FALSE;
+    pCounters->intervalNs = pCounters->haveSample ? timestampNs - pCounters->timestampNs : 0;
+    seconds = (double)pCounters->intervalNs / 1e9;
+
+    moca_counters_track(pCounters, pStats, 0, MOCA_COUNTER_FIRST_MAC, reset, seconds);
+    if (pMacCounters != NULL)
+    {
+        moca_counters_track(pCounters, pMacCounters, MOCA_COUNTER_FIRST_MAC, MOCA_COUNTER_COUNT, reset, seconds);
+        pCounters->haveMacCounters = TRUE;
+    }
+    else
+    {
+        memset(&pCounters->delta[MOCA_COUNTER_FIRST_MAC], 0, sizeof(pCounters->delta[0]) * (MOCA_COUNTER_COUNT - MOCA_COUNTER_FIRST_MAC));
+        memset(&pCounters->rate[MOCA_COUNTER_FIRST_MAC], 0, sizeof(pCounters->rate[0]) * (MOCA_COUNTER_COUNT - MOCA_COUNTER_FIRST_MAC));
+    }
+
+    pCounters->resets += reset;
+    pCounters->resetCount = resetCount;
+    pCounters->timestampNs = timestampNs;
+    pCounters->haveSample = TRUE;
+    pCounters->samples++;
+    return STATUS_SUCCESS;
+}
+
+INT moca_counters_sample(moca_counters_t *pCounters)
+{
+    moca_stats_t stats;
+    moca_mac_counters_t macCounters;
+    ULONG before, after;
+    BOOL haveMacCounters = FALSE;
+    struct timespec now;
+    uint32_t attempt;
+
+    if (pCounters == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    for (attempt = 0; attempt < MOCA_COUNTERS_READ_ATTEMPTS; attempt++)
+    {
+        if (moca_GetResetCount(&before) != STATUS_SUCCESS ||
+            moca_IfGetStats(pCounters->ifIndex, &stats) != STATUS_SUCCESS)
+        {
+            pCounters->failures++;
+            return STATUS_FAILURE;
+        }
+        haveMacCounters = (moca_IfGetExtCounter(pCounters->ifIndex, &macCounters) == STATUS_SUCCESS) ? TRUE : FALSE;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (moca_GetResetCount(&after) != STATUS_SUCCESS)
+        {
+            pCounters->failures++;
+            return STATUS_FAILURE;
+        }
+        if (before == after)
+        {
+            break;
+        }
+        /* A reset during the reads leaves some counters from before it */
+        pCounters->retries++;
+    }
+    return moca_counters_update(pCounters, after, &stats, haveMacCounters ? &macCounters : NULL,
+                                (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
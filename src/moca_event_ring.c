@@ -0,0 +1,331 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_event_ring.c
+*
+* Bounded lock-free queue of associated device events, see moca_event_ring.h.
+*
+* A cell is free for the push at position pos when its sequence equals pos,
+* and holds the event of position pos once its sequence is pos + 1. Popping it
+* sets the sequence to pos + capacity, freeing it for the next lap.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "moca_hal.h"
+#include "moca_event_ring.h"
+
+struct moca_event_ring_cell_s
+{
+    uint64_t sequence;
+    moca_device_event_t event;
+};
+
+static moca_event_ring_t *gAttachedRing = NULL;
+static int gAttachedCalls = 0;          /**< Callbacks running, detach waits for them */
+
+static uint64_t moca_event_ring_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+INT moca_event_ring_create(moca_event_ring_t *pRing, uint32_t capacity, uint32_t flags)
+{
+    uint64_t cells = 2;
+    uint64_t i;
+
+    if (pRing == NULL || capacity > 0x80000000UL)
+    {
+        return STATUS_FAILURE;
+    }
+    while (cells < capacity)
+    {
+        cells <<= 1;
+    }
+    memset(pRing, 0, sizeof(*pRing));
+    pRing->pCells = calloc((size_t)cells, sizeof(moca_event_ring_cell_t));
+    if (pRing->pCells == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    pRing->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (pRing->eventFd < 0)
+    {
+        free(pRing->pCells);
+        pRing->pCells = NULL;
+        return STATUS_FAILURE;
+    }
+    for (i = 0; i < cells; i++)
+    {
+        pRing->pCells[i].sequence = i;
+    }
+    pRing->mask = cells - 1;
+    pRing->flags = flags;
+    return STATUS_SUCCESS;
+}
+
+void moca_event_ring_destroy(moca_event_ring_t *pRing)
+{
+    if (pRing == NULL || pRing->pCells == NULL)
+    {
+        return;
+    }
+    close(pRing->eventFd);
+    free(pRing->pCells);
+    memset(pRing, 0, sizeof(*pRing));
+    pRing->eventFd = -1;
+}
+
+uint32_t moca_event_ring_capacity(const moca_event_ring_t *pRing)
+{
+    return (pRing == NULL || pRing->pCells == NULL) ? 0 : (uint32_t)(pRing->mask + 1);
+}
+
+/* Claims the cell of the next position, NULL if the ring is full */
+static moca_event_ring_cell_t *moca_event_ring_claim(moca_event_ring_t *pRing, uint64_t *pPosition)
+{
+    uint64_t position = __atomic_load_n(&pRing->tail, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        moca_event_ring_cell_t *pCell = &pRing->pCells[position & pRing->mask];
+        int64_t diff = (int64_t)(__atomic_load_n(&pCell->sequence, __ATOMIC_ACQUIRE) - position);
+
+        if (diff == 0)
+        {
+            if (pRing->flags & MOCA_EVENT_RING_SINGLE_PRODUCER)
+            {
+                __atomic_store_n(&pRing->tail, position + 1, __ATOMIC_RELAXED);
+                *pPosition = position;
+                return pCell;
+            }
+            if (__atomic_compare_exchange_n(&pRing->tail, &position, position + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *pPosition = position;
+                return pCell;
+            }
+            /* position was reloaded by the failed compare and swap */
+        }
+        else if (diff < 0)
+        {
+            /* The cell still holds the event of the previous lap */
+            return NULL;
+        }
+        else
+        {
+            position = __atomic_load_n(&pRing->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+INT moca_event_ring_push(moca_event_ring_t *pRing, ULONG ifIndex, const moca_associated_device_t *pDevice)
+{
+    moca_event_ring_cell_t *pCell;
+    uint64_t position;
+
+    if (pRing == NULL || pRing->pCells == NULL || pDevice == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    pCell = moca_event_ring_claim(pRing, &position);
+    if (pCell == NULL)
+    {
+        __atomic_fetch_add(&pRing->dropped, 1, __ATOMIC_RELAXED);
+        return STATUS_FAILURE;
+    }
+    pCell->event.sequence = position;
+    pCell->event.timestampNs = moca_event_ring_now_ns();
+    pCell->event.ifIndex = ifIndex;
+    memcpy(&pCell->event.device, pDevice, sizeof(pCell->event.device));
+    __atomic_store_n(&pCell->sequence, position + 1, __ATOMIC_RELEASE);
+
+    /* Pairs with the store in moca_event_ring_arm(), either the consumer sees the event or this sees it sleeping */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pRing->sleeping, __ATOMIC_RELAXED) != 0 &&
+        __atomic_exchange_n(&pRing->sleeping, 0, __ATOMIC_RELAXED) != 0)
+    {
+        uint64_t one = 1;
+
+        __atomic_fetch_add(&pRing->wakeups, 1, __ATOMIC_RELAXED);
+        if (write(pRing->eventFd, &one, sizeof(one)) != sizeof(one))
+        {
+            /* The counter is saturated, the consumer is woken anyway */
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
+uint32_t moca_event_ring_pop(moca_event_ring_t *pRing, moca_device_event_t *pEvents, uint32_t maxEvents,
+                             uint64_t *pDropped)
+{
+    uint64_t head, depth, dropped;
+    uint32_t count = 0;
+
+    if (pRing == NULL || pRing->pCells == NULL || pEvents == NULL)
+    {
+        return 0;
+    }
+    head = pRing->head;
+    depth = __atomic_load_n(&pRing->tail, __ATOMIC_RELAXED) - head;
+    if (depth > pRing->maxDepth)
+    {
+        pRing->maxDepth = depth;
+    }
+    while (count < maxEvents)
+    {
+        moca_event_ring_cell_t *pCell = &pRing->pCells[head & pRing->mask];
+
+        if (__atomic_load_n(&pCell->sequence, __ATOMIC_ACQUIRE) != head + 1)
+        {
+            /* Empty, or the producer of this position has not finished yet */
+            break;
+        }
+        pEvents[count++] = pCell->event;
+        __atomic_store_n(&pCell->sequence, head + pRing->mask + 1, __ATOMIC_RELEASE);
+        head++;
+    }
+    __atomic_store_n(&pRing->head, head, __ATOMIC_RELAXED);
+    pRing->batches += (count > 0);
+
+    dropped = __atomic_load_n(&pRing->dropped, __ATOMIC_RELAXED);
+    if (pDropped != NULL)
+    {
+        *pDropped = dropped - pRing->droppedReported;
+    }
+    pRing->droppedReported = dropped;
+    return count;
+}
+
+static BOOL moca_event_ring_ready(moca_event_ring_t *pRing)
+{
+    const moca_event_ring_cell_t *pCell = &pRing->pCells[pRing->head & pRing->mask];
+
+    return (__atomic_load_n(&pCell->sequence, __ATOMIC_ACQUIRE) == pRing->head + 1) ? TRUE : FALSE;
+}
+
+BOOL moca_event_ring_arm(moca_event_ring_t *pRing)
+{
+    uint64_t value;
+
+    if (pRing == NULL || pRing->pCells == NULL)
+    {
+        return FALSE;
+    }
+    /* Clear a wake up left by an earlier arm */
+    while (read(pRing->eventFd, &value, sizeof(value)) == sizeof(value))
+    {
+    }
+    __atomic_store_n(&pRing->sleeping, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (moca_event_ring_ready(pRing))
+    {
+        __atomic_store_n(&pRing->sleeping, 0, __ATOMIC_RELAXED);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+INT moca_event_ring_wait(moca_event_ring_t *pRing, int timeoutMs)
+{
+    struct pollfd pfd;
+    int result;
+
+    if (pRing == NULL || pRing->pCells == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    if (moca_event_ring_ready(pRing) || moca_event_ring_arm(pRing) == FALSE)
+    {
+        return STATUS_SUCCESS;
+    }
+    pfd.fd = pRing->eventFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    do
+    {
+        result = poll(&pfd, 1, timeoutMs);
+    } while (result < 0 && errno == EINTR);
+    __atomic_store_n(&pRing->sleeping, 0, __ATOMIC_RELAXED);
+    return moca_event_ring_ready(pRing) ? STATUS_SUCCESS : STATUS_FAILURE;
+}
+
+int moca_event_ring_fd(const moca_event_ring_t *pRing)
+{
+    return (pRing == NULL) ? -1 : pRing->eventFd;
+}
+
+void moca_event_ring_get_stats(moca_event_ring_t *pRing, moca_event_ring_stats_t *pStats)
+{
+    if (pRing == NULL || pStats == NULL)
+    {
+        return;
+    }
+    memset(pStats, 0, sizeof(*pStats));
+    pStats->pushed = __atomic_load_n(&pRing->tail, __ATOMIC_RELAXED);
+    pStats->popped = __atomic_load_n(&pRing->head, __ATOMIC_RELAXED);
+    pStats->dropped = __atomic_load_n(&pRing->dropped, __ATOMIC_RELAXED);
+    pStats->batches = pRing->batches;
+    pStats->wakeups = __atomic_load_n(&pRing->wakeups, __ATOMIC_RELAXED);
+    pStats->maxDepth = pRing->maxDepth;
+}
+
+static INT moca_event_ring_on_device(ULONG ifIndex, moca_associated_device_t *pDevice)
+{
+    moca_event_ring_t *pRing;
+    INT status = STATUS_FAILURE;
+
+    __atomic_fetch_add(&gAttachedCalls, 1, __ATOMIC_SEQ_CST);
+    pRing = __atomic_load_n(&gAttachedRing, __ATOMIC_SEQ_CST);
+    if (pRing != NULL)
+    {
+        status = moca_event_ring_push(pRing, ifIndex, pDevice);
+    }
+    __atomic_fetch_sub(&gAttachedCalls, 1, __ATOMIC_RELEASE);
+    return status;
+}
+
+INT moca_event_ring_attach(moca_event_ring_t *pRing)
+{
+    if (pRing == NULL || pRing->pCells == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    __atomic_store_n(&gAttachedRing, pRing, __ATOMIC_SEQ_CST);
+    moca_associatedDevice_callback_register(moca_event_ring_on_device);
+    return STATUS_SUCCESS;
+}
+
+void moca_event_ring_detach(void)
+{
+    __atomic_store_n(&gAttachedRing, NULL, __ATOMIC_SEQ_CST);
+    moca_associatedDevice_callback_register(NULL);
+    while (__atomic_load_n(&gAttachedCalls, __ATOMIC_ACQUIRE) != 0)
+    {
+        sched_yield();
+    }
+}
@@ -0,0 +1,313 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_ext.c
+*
+* Weak fallbacks for the moca_hal_ext.h extensions, composed from the standard
+* moca_hal.h calls. A HAL library that implements an extension overrides the
+* fallback at link time. The asynchronous ACA fallback polls moca_getIfAcaStatus()
+* on a thread of its own, so it saves the caller the loop but not its cost. The
+* partial configuration fallback only skips applies that change nothing, any
+* change is still a full moca_SetIfConfig(). Flow table paging has no fallback.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+
+__attribute__((weak)) INT moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot)
+{
+    struct timespec ts;
+
+    if (pSnapshot == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    /* Four round trips, the parts are sampled at slightly different times */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    pSnapshot->timestampNs = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    if (moca_IfGetStats(ifIndex, &pSnapshot->stats) != STATUS_SUCCESS ||
+        moca_IfGetExtCounter(ifIndex, &pSnapshot->macCounters) != STATUS_SUCCESS ||
+        moca_IfGetExtAggrCounter(ifIndex, &pSnapshot->aggregateCounters) != STATUS_SUCCESS ||
+        moca_IfGetDynamicInfo(ifIndex, &pSnapshot->dynamicInfo) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    return STATUS_SUCCESS;
+}
+
+#define MOCA_EXT_DEVICES_READ_ATTEMPTS  3     /**< Reads of the associated devices before a changing count fails them */
+
+__attribute__((weak)) INT moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount)
+{
+    moca_associated_device_t *pArray = NULL;
+    ULONG count = 0;
+    ULONG after = 0;
+    uint32_t attempt;
+
+    if (pCount == NULL || (pDevices == NULL && capacity > 0))
+    {
+        return STATUS_FAILURE;
+    }
+    /* Still allocates inside the HAL, only the caller side is allocation free */
+    for (attempt = 0; attempt < MOCA_EXT_DEVICES_READ_ATTEMPTS; attempt++)
+    {
+        pArray = NULL;
+        if (moca_GetNumAssociatedDevices(ifIndex, &count) != STATUS_SUCCESS ||
+            moca_GetAssociatedDevices(ifIndex, &pArray) != STATUS_SUCCESS ||
+            moca_GetNumAssociatedDevices(ifIndex, &after) != STATUS_SUCCESS)
+        {
+            free(pArray);
+            return STATUS_FAILURE;
+        }
+        /* The array carries no length, it is only trusted to hold a count read on both sides of it */
+        if (count == after)
+        {
+            break;
+        }
+        free(pArray);
+        pArray = NULL;
+    }
+    if (count != after)
+    {
+        return STATUS_FAILURE;
+    }
+    if (count > capacity)
+    {
+        free(pArray);
+        *pCount = count;
+        return STATUS_FAILURE;
+    }
+    if (count > 0 && pArray != NULL)
+    {
+        memcpy(pDevices, pArray, count * sizeof(moca_associated_device_t));
+    }
+    free(pArray);
+    *pCount = count;
+    return STATUS_SUCCESS;
+}
+
+__attribute__((weak)) INT moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta)
+{
+    if (pDelta == NULL || moca_IfGetStats(ifIndex, &pDelta->stats) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    /* Without change tracking in the HAL every poll reports every counter */
+    pDelta->generation = generation + 1;
+    pDelta->changedMask = MOCA_STATS_ALL_FIELDS;
+    return STATUS_SUCCESS;
+}
+
+__attribute__((weak)) INT moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity,
+                                                     ULONG *pCount, ULONG *pNextCursor)
+{
+    (void)ifIndex;
+    (void)cursor;
+    (void)pFlows;
+    (void)capacity;
+    (void)pCount;
+    (void)pNextCursor;
+    /* moca_GetFlowStatistics() writes as many flows as the HAL has, no buffer makes a page of it bounded */
+    return STATUS_FAILURE;
+}
+
+#define MOCA_EXT_ACA_POLL_NS      10000000L   /**< Status poll interval of the ACA fallback */
+
+typedef struct
+{
+    int interfaceIndex;
+    moca_aca_complete_callback callback;
+    void *pContext;
+} moca_ext_aca_t;
+
+static void *moca_ext_aca_poller(void *pArg)
+{
+    moca_ext_aca_t *pAca = (moca_ext_aca_t *)pArg;
+    struct timespec interval = { 0, MOCA_EXT_ACA_POLL_NS };
+    moca_aca_stat_t status;
+
+    /* The poll loop the native implementation saves, moved to a thread of its own */
+    do
+    {
+        nanosleep(&interval, NULL);
+        if (moca_getIfAcaStatus(pAca->interfaceIndex, &status) != STATUS_SUCCESS)
+        {
+            memset(&status, 0, sizeof(status));
+            status.acaStatus = MOCA_ACA_STATUS_FAIL;
+        }
+    } while (status.acaStatus == MOCA_ACA_STATUS_INPROGRESS);
+    pAca->callback(pAca->interfaceIndex, &status, pAca->pContext);
+    free(pAca);
+    return NULL;
+}
+
+__attribute__((weak)) int moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext)
+{
+    moca_ext_aca_t *pAca = NULL;
+    moca_aca_stat_t status;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int ret;
+
+    if (moca_getIfAcaStatus(interfaceIndex, &status) != STATUS_SUCCESS || status.acaStatus == MOCA_ACA_STATUS_INPROGRESS)
+    {
+        return STATUS_FAILURE;
+    }
+    if (callback != NULL)
+    {
+        pAca = malloc(sizeof(moca_ext_aca_t));
+        if (pAca == NULL)
+        {
+            return STATUS_FAILURE;
+        }
+        pAca->interfaceIndex = interfaceIndex;
+        pAca->callback = callback;
+        pAca->pContext = pContext;
+    }
+    acaCfg.ACAStart = TRUE;
+    if (moca_setIfAcaConfig(interfaceIndex, acaCfg) != STATUS_SUCCESS)
+    {
+        free(pAca);
+        return STATUS_FAILURE;
+    }
+    if (pAca == NULL)
+    {
+        return STATUS_SUCCESS;
+    }
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    ret = pthread_create(&thread, &attr, moca_ext_aca_poller, pAca);
+    pthread_attr_destroy(&attr);
+    if (ret != 0)
+    {
+        /* The ACA runs but nobody would report its end */
+        moca_cancelIfAca(interfaceIndex);
+        free(pAca);
+        return STATUS_FAILURE;
+    }
+    return STATUS_SUCCESS;
+}
+
+__attribute__((weak)) int moca_getIfAcaEventFd(int interfaceIndex)
+{
+    /* Notification needs the HAL, only a native implementation can signal it */
+    (void)interfaceIndex;
+    return -1;
+}
+
+typedef struct
+{
+    size_t offset;
+    size_t size;
+    BOOL string;            /**< Compared up to the terminating NUL */
+} moca_ext_cfg_field_t;
+
+#define MOCA_EXT_CFG_FIELD(field, string) { offsetof(moca_cfg_t, field), sizeof(((moca_cfg_t *)0)->field), string }
+
+/* In moca_cfg_field_t order */
+static const moca_ext_cfg_field_t gExtCfgFields[MOCA_CFG_FIELD_COUNT] =
+{
+    MOCA_EXT_CFG_FIELD(InstanceNumber, FALSE),
+    MOCA_EXT_CFG_FIELD(Alias, TRUE),
+    MOCA_EXT_CFG_FIELD(bEnabled, FALSE),
+    MOCA_EXT_CFG_FIELD(bPreferredNC, FALSE),
+    MOCA_EXT_CFG_FIELD(PrivacyEnabledSetting, FALSE),
+    MOCA_EXT_CFG_FIELD(FreqCurrentMaskSetting, FALSE),
+    MOCA_EXT_CFG_FIELD(KeyPassphrase, TRUE),
+    MOCA_EXT_CFG_FIELD(TxPowerLimit, FALSE),
+    MOCA_EXT_CFG_FIELD(AutoPowerControlPhyRate, FALSE),
+    MOCA_EXT_CFG_FIELD(BeaconPowerLimit, FALSE),
+    MOCA_EXT_CFG_FIELD(MaxIngressBWThreshold, FALSE),
+    MOCA_EXT_CFG_FIELD(MaxEgressBWThreshold, FALSE),
+    MOCA_EXT_CFG_FIELD(Reset, FALSE),
+    MOCA_EXT_CFG_FIELD(MixedMode, FALSE),
+    MOCA_EXT_CFG_FIELD(ChannelScanning, FALSE),
+    MOCA_EXT_CFG_FIELD(AutoPowerControlEnable, FALSE),
+    MOCA_EXT_CFG_FIELD(EnableTabooBit, FALSE),
+    MOCA_EXT_CFG_FIELD(NodeTabooMask, FALSE),
+    MOCA_EXT_CFG_FIELD(ChannelScanMask, FALSE)
+};
+
+/* Copies the selected fields of pConfig that differ into pCurrent, returns their mask */
+static ULONG moca_ext_cfg_merge(moca_cfg_t *pCurrent, const moca_cfg_t *pConfig, ULONG fieldMask)
+{
+    ULONG changed = 0;
+    int i;
+
+    for (i = 0; i < MOCA_CFG_FIELD_COUNT; i++)
+    {
+        const moca_ext_cfg_field_t *pField = &gExtCfgFields[i];
+        char *pTo = (char *)pCurrent + pField->offset;
+        const char *pFrom = (const char *)pConfig + pField->offset;
+
+        if ((fieldMask & MOCA_CFG_FIELD_BIT(i)) == 0)
+        {
+            continue;
+        }
+        if (pField->string ? strncmp(pTo, pFrom, pField->size) != 0 : memcmp(pTo, pFrom, pField->size) != 0)
+        {
+            memcpy(pTo, pFrom, pField->size);
+            changed |= MOCA_CFG_FIELD_BIT(i);
+        }
+    }
+    return changed;
+}
+
+__attribute__((weak)) INT moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult)
+{
+    moca_cfg_t merged;
+    ULONG changed;
+    ULONG before = 0, after = 0;
+    BOOL counted;
+
+    if (pConfig == NULL || moca_GetIfConfig(ifIndex, &merged) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    if (pResult != NULL)
+    {
+        memset(pResult, 0, sizeof(*pResult));
+    }
+    /* Skipping an apply that changes nothing is the one saving available without the HAL */
+    changed = moca_ext_cfg_merge(&merged, pConfig, fieldMask);
+    if (changed == 0)
+    {
+        return STATUS_SUCCESS;
+    }
+    /* A full apply, not atomic with the read above, re-forms the link if the driver does so for any change */
+    counted = (moca_GetResetCount(&before) == STATUS_SUCCESS) ? TRUE : FALSE;
+    if (moca_SetIfConfig(ifIndex, &merged) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    if (pResult != NULL)
+    {
+        pResult->changedMask = changed;
+        if (!counted || moca_GetResetCount(&after) != STATUS_SUCCESS || after != before)
+        {
+            pResult->reformMask = changed;
+        }
+    }
+    return STATUS_SUCCESS;
+}
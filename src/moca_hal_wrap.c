@@ -0,0 +1,129 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_wrap.c
+*
+* Allocation scope and trace record per HAL API call, see moca_hal_wrap.h.
+*/
+
+#include <stddef.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include "moca_alloc.h"
+#include "moca_hal_wrap.h"
+#include "moca_trace_record.h"
+
+/* X(api, return type, parameters, arguments) for every API returning a value */
+#define MOCA_WRAP_APIS(X) \
+    X(moca_GetIfConfig, INT, (ULONG ifIndex, moca_cfg_t* pmoca_config), (ifIndex, pmoca_config)) \
+    X(moca_SetIfConfig, INT, (ULONG ifIndex, moca_cfg_t* pmoca_config), (ifIndex, pmoca_config)) \
+    X(moca_IfGetDynamicInfo, INT, (ULONG ifIndex, moca_dynamic_info_t* pmoca_dynamic_info), (ifIndex, pmoca_dynamic_info)) \
+    X(moca_IfGetStaticInfo, INT, (ULONG ifIndex, moca_static_info_t* pmoca_static_info), (ifIndex, pmoca_static_info)) \
+    X(moca_IfGetStats, INT, (ULONG ifIndex, moca_stats_t* pmoca_stats), (ifIndex, pmoca_stats)) \
+    X(moca_GetNumAssociatedDevices, INT, (ULONG ifIndex, ULONG* pulCount), (ifIndex, pulCount)) \
+    X(moca_IfGetExtCounter, INT, (ULONG ifIndex, moca_mac_counters_t* pmoca_mac_counters), (ifIndex, pmoca_mac_counters)) \
+    X(moca_IfGetExtAggrCounter, INT, (ULONG ifIndex, moca_aggregate_counters_t* pmoca_aggregate_counts), (ifIndex, pmoca_aggregate_counts)) \
+    X(moca_GetMocaCPEs, INT, (ULONG ifIndex, moca_cpe_t* cpes, INT* pnum_cpes), (ifIndex, cpes, pnum_cpes)) \
+    X(moca_GetAssociatedDevices, INT, (ULONG ifIndex, moca_associated_device_t** ppdevice_array), (ifIndex, ppdevice_array)) \
+    X(moca_FreqMaskToValue, INT, (UCHAR* mask), (mask)) \
+    X(moca_HardwareEquipped, BOOL, (void), ()) \
+    X(moca_GetFullMeshRates, INT, (ULONG ifIndex, moca_mesh_table_t* pDeviceArray, ULONG* pulCount), (ifIndex, pDeviceArray, pulCount)) \
+    X(moca_GetFlowStatistics, INT, (ULONG ifIndex, moca_flow_table_t* pDeviceArray, ULONG* pulCount), (ifIndex, pDeviceArray, pulCount)) \
+    X(moca_GetResetCount, INT, (ULONG* resetcnt), (resetcnt)) \
+    X(moca_setIfAcaConfig, int, (int interfaceIndex, moca_aca_cfg_t acaCfg), (interfaceIndex, acaCfg)) \
+    X(moca_getIfAcaConfig, int, (int interfaceIndex, moca_aca_cfg_t* acaCfg), (interfaceIndex, acaCfg)) \
+    X(moca_cancelIfAca, int, (int interfaceIndex), (interfaceIndex)) \
+    X(moca_getIfAcaStatus, int, (int interfaceIndex, moca_aca_stat_t* pacaStat), (interfaceIndex, pacaStat)) \
+    X(moca_getIfScmod, int, (int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat), (interfaceIndex, pnumOfEntries, ppscmodStat)) \
+    X(moca_IfGetTelemetrySnapshot, INT, (ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot), (ifIndex, pSnapshot)) \
+    X(moca_GetAssociatedDevicesInto, INT, (ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount), (ifIndex, pDevices, capacity, pCount)) \
+    X(moca_IfGetStatsChangedSince, INT, (ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta), (ifIndex, generation, pDelta)) \
+    X(moca_GetFlowStatisticsPage, INT, (ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity, ULONG *pCount, ULONG *pNextCursor), (ifIndex, cursor, pFlows, capacity, pCount, pNextCursor)) \
+    X(moca_startIfAcaAsync, int, (int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext), (interfaceIndex, acaCfg, callback, pContext)) \
+    X(moca_getIfAcaEventFd, int, (int interfaceIndex), (interfaceIndex)) \
+    X(moca_SetIfConfigFields, INT, (ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult), (ifIndex, pConfig, fieldMask, pResult))
+
+#define MOCA_WRAP_ID(api, type, params, args)       MOCA_WRAP_ID_##api,
+#define MOCA_WRAP_NAME(api, type, params, args)     #api,
+#define MOCA_WRAP_FUNCTION(api, type, params, args) \
+    extern type __real_##api params; \
+    type __wrap_##api params \
+    { \
+        type ret; \
+        uint64_t startNs = moca_trace_begin(); \
+        moca_alloc_scope_enter(MOCA_WRAP_ID_##api); \
+        ret = __real_##api args; \
+        moca_alloc_scope_leave(); \
+        if (startNs != 0) \
+        { \
+            moca_trace_end(startNs, (int32_t)ret); \
+            moca_trace_record_##api args; \
+        } \
+        return ret; \
+    }
+
+enum
+{
+    MOCA_WRAP_ID_NONE = MOCA_ALLOC_NO_SCOPE,
+    MOCA_WRAP_APIS(MOCA_WRAP_ID)
+    MOCA_WRAP_ID_moca_associatedDevice_callback_register,
+    MOCA_WRAP_ID_COUNT
+};
+
+/* Fails to compile if the APIs outgrow the moca_alloc scope IDs */
+typedef char moca_wrap_scope_check_t[(MOCA_WRAP_ID_COUNT <= MOCA_ALLOC_MAX_SCOPES) ? 1 : -1];
+
+static const char *gWrapApiNames[MOCA_WRAP_ID_COUNT] =
+{
+    NULL,
+    MOCA_WRAP_APIS(MOCA_WRAP_NAME)
+    "moca_associatedDevice_callback_register"
+};
+
+MOCA_WRAP_APIS(MOCA_WRAP_FUNCTION)
+
+extern void __real_moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc);
+
+void __wrap_moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc)
+{
+    uint64_t startNs = moca_trace_begin();
+
+    moca_alloc_scope_enter(MOCA_WRAP_ID_moca_associatedDevice_callback_register);
+    __real_moca_associatedDevice_callback_register(callback_proc);
+    moca_alloc_scope_leave();
+    if (startNs != 0)
+    {
+        moca_trace_end(startNs, STATUS_SUCCESS);
+        moca_trace_record_moca_associatedDevice_callback_register(callback_proc);
+    }
+}
+
+uint32_t moca_hal_wrap_api_count(void)
+{
+    return MOCA_WRAP_ID_COUNT - 1;
+}
+
+const char *moca_hal_wrap_api_name(uint32_t scopeId)
+{
+    if (scopeId == MOCA_WRAP_ID_NONE || scopeId >= MOCA_WRAP_ID_COUNT)
+    {
+        return NULL;
+    }
+    return gWrapApiNames[scopeId];
+}
@@ -0,0 +1,56 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_hal_wrap.h
+*
+* Link time wrappers that charge the allocations of every HAL API call to a
+* moca_alloc scope of its own.
+*
+* The Makefile links with -Wl,--wrap=<api> for every entry of MOCA_WRAP_APIS,
+* so the test code's calls land in __wrap_<api>, which opens the scope and
+* calls the HAL through __real_<api>. When MOCA_TRACE_RECORD is set the
+* wrapper also records the call, see moca_trace_record.h. An API added to
+* moca_hal.h or moca_hal_ext.h needs an entry here and in
+* MOCA_WRAP_APIS, a recorder in moca_trace_record.c and an ID in moca_trace.h.
+*/
+
+#ifndef __MOCA_HAL_WRAP_H__
+#define __MOCA_HAL_WRAP_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Returns the number of wrapped APIs, their scope IDs are 1 to the returned count.
+*/
+uint32_t moca_hal_wrap_api_count(void);
+
+/**
+* @brief Returns the name of the API charged to a scope ID, NULL for an unknown ID.
+*/
+const char *moca_hal_wrap_api_name(uint32_t scopeId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_HAL_WRAP_H__ */
@@ -0,0 +1,302 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_poller.c
+*
+* Adaptive rate telemetry poller, see moca_poller.h.
+*
+* The thread reads the counters without holding the poller lock, then
+* publishes the sample under it and waits on a CLOCK_MONOTONIC condition
+* variable until the next sample is due, so moca_poller_stop() wakes it at
+* once.
+*/
+
+#include <string.h>
+#include <time.h>
+#include "moca_hal.h"
+#include "moca_poller.h"
+
+#define MOCA_POLLER_NS_PER_MS    1000000ULL
+#define MOCA_POLLER_READ_ATTEMPTS    3
+
+static uint64_t moca_poller_clock_ns(clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/* Counters are 32 bit on most drivers, a smaller reading is taken as one wrap unless they restarted on a reset */
+static uint64_t moca_poller_delta(ULONG previous, ULONG current, BOOL reset)
+{
+    if (reset)
+    {
+        return (uint64_t)current;
+    }
+    if (current >= previous)
+    {
+        return (uint64_t)(current - previous);
+    }
+    return (uint64_t)(uint32_t)(current - previous);
+}
+
+void moca_poller_default_config(ULONG ifIndex, moca_poller_config_t *pConfig)
+{
+    if (pConfig == NULL)
+    {
+        return;
+    }
+    memset(pConfig, 0, sizeof(*pConfig));
+    pConfig->ifIndex = ifIndex;
+    pConfig->minIntervalMs = MOCA_POLLER_DEFAULT_MIN_INTERVAL_MS;
+    pConfig->maxIntervalMs = MOCA_POLLER_DEFAULT_MAX_INTERVAL_MS;
+    pConfig->bytesPerSample = MOCA_POLLER_DEFAULT_BYTES_PER_SAMPLE;
+}
+
+uint32_t moca_poller_next_interval_ms(const moca_poller_config_t *pConfig, uint32_t currentMs, uint64_t deltaBytes,
+                                      uint64_t elapsedNs)
+{
+    uint64_t targetMs = pConfig->maxIntervalMs;
+    uint64_t backOffMs = (uint64_t)((currentMs > pConfig->minIntervalMs) ? currentMs : pConfig->minIntervalMs) * 2;
+
+    if (pConfig->bytesPerSample == 0)
+    {
+        return pConfig->minIntervalMs;
+    }
+    if (deltaBytes > 0 && elapsedNs > 0)
+    {
+        /* Time the observed rate takes to move bytesPerSample */
+        double ms = (double)pConfig->bytesPerSample * (double)elapsedNs / ((double)deltaBytes * (double)MOCA_POLLER_NS_PER_MS);
+
+        targetMs = (ms < (double)pConfig->maxIntervalMs) ? (uint64_t)ms : pConfig->maxIntervalMs;
+    }
+    /* Speed up at once, back off gradually so a pause within a burst does not leave it unsampled */
+    if (targetMs > backOffMs)
+    {
+        targetMs = backOffMs;
+    }
+    if (targetMs < pConfig->minIntervalMs)
+    {
+        targetMs = pConfig->minIntervalMs;
+    }
+    if (targetMs > pConfig->maxIntervalMs)
+    {
+        targetMs = pConfig->maxIntervalMs;
+    }
+    return (uint32_t)targetMs;
+}
+
+/* Caller holds the poller lock */
+static void moca_poller_publish(moca_poller_t *pPoller, moca_poller_sample_t *pSample, BOOL haveResetCount,
+                                uint32_t *pIntervalMs)
+{
+    const moca_poller_sample_t *pLatest = &pPoller->latest;
+
+    if (pPoller->haveSample)
+    {
+        BOOL reset = (haveResetCount && pPoller->haveResetCount && pSample->resetCount != pLatest->resetCount) ? TRUE : FALSE;
+        uint64_t txDelta = moca_poller_delta(pLatest->stats.BytesSent, pSample->stats.BytesSent, reset);
+        uint64_t rxDelta = moca_poller_delta(pLatest->stats.BytesReceived, pSample->stats.BytesReceived, reset);
+        uint64_t gapNs = pSample->timestampNs - pLatest->timestampNs;
+
+        pPoller->stats.resets += reset;
+
+        pSample->txBytes = pLatest->txBytes + txDelta;
+        pSample->rxBytes = pLatest->rxBytes + rxDelta;
+        *pIntervalMs = moca_poller_next_interval_ms(&pPoller->config, *pIntervalMs, txDelta + rxDelta, gapNs);
+        if (gapNs > pPoller->stats.maxGapNs)
+        {
+            pPoller->stats.maxGapNs = gapNs;
+        }
+    }
+    else
+    {
+        *pIntervalMs = pPoller->config.minIntervalMs;
+    }
+    pSample->sequence = pPoller->stats.samples++;
+    pSample->nextIntervalMs = *pIntervalMs;
+    pPoller->latest = *pSample;
+    pPoller->haveSample = TRUE;
+    pPoller->haveResetCount = haveResetCount;
+}
+
+static void *moca_poller_main(void *pArg)
+{
+    moca_poller_t *pPoller = (moca_poller_t *)pArg;
+    const moca_poller_config_t *pConfig = &pPoller->config;
+    uint32_t intervalMs = pConfig->minIntervalMs;
+    moca_poller_sample_t sample;
+
+    pthread_mutex_lock(&pPoller->lock);
+    while (pPoller->stopping == FALSE)
+    {
+        uint64_t deadlineNs;
+        struct timespec deadline;
+        uint32_t waitMs;
+        uint32_t attempt;
+        ULONG before = 0;
+        BOOL haveResetCount = FALSE;
+        INT status = STATUS_FAILURE;
+
+        pthread_mutex_unlock(&pPoller->lock);
+        /* Without a reset count from the HAL a smaller reading can only be taken as a wrap */
+        for (attempt = 0; attempt < MOCA_POLLER_READ_ATTEMPTS; attempt++)
+        {
+            memset(&sample, 0, sizeof(sample));
+            haveResetCount = (moca_GetResetCount(&before) == STATUS_SUCCESS) ? TRUE : FALSE;
+            status = moca_IfGetStats(pConfig->ifIndex, &sample.stats);
+            if (status == STATUS_SUCCESS && pConfig->extCounter)
+            {
+                sample.haveExtCounter = (moca_IfGetExtCounter(pConfig->ifIndex, &sample.extCounter) == STATUS_SUCCESS) ? TRUE : FALSE;
+            }
+            sample.timestampNs = moca_poller_clock_ns(CLOCK_MONOTONIC);
+            if (haveResetCount && moca_GetResetCount(&sample.resetCount) != STATUS_SUCCESS)
+            {
+                haveResetCount = FALSE;
+                sample.resetCount = 0;
+            }
+            /* A reset during the reads leaves some counters from before it */
+            if (status != STATUS_SUCCESS || haveResetCount == FALSE || sample.resetCount == before)
+            {
+                break;
+            }
+        }
+        pthread_mutex_lock(&pPoller->lock);
+
+        if (status == STATUS_SUCCESS)
+        {
+            moca_poller_publish(pPoller, &sample, haveResetCount, &intervalMs);
+            waitMs = intervalMs;
+        }
+        else
+        {
+            pPoller->stats.failures++;
+            waitMs = pConfig->minIntervalMs;
+        }
+        pPoller->stats.intervalMs = intervalMs;
+        pPoller->stats.cpuNs = moca_poller_clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+        if (status == STATUS_SUCCESS && pConfig->callback != NULL)
+        {
+            pthread_mutex_unlock(&pPoller->lock);
+            pConfig->callback(&sample, pConfig->pContext);
+            pthread_mutex_lock(&pPoller->lock);
+        }
+
+        deadlineNs = sample.timestampNs + (uint64_t)waitMs * MOCA_POLLER_NS_PER_MS;
+        deadline.tv_sec = (time_t)(deadlineNs / 1000000000ULL);
+        deadline.tv_nsec = (long)(deadlineNs % 1000000000ULL);
+        while (pPoller->stopping == FALSE && moca_poller_clock_ns(CLOCK_MONOTONIC) < deadlineNs)
+        {
+            pthread_cond_timedwait(&pPoller->cond, &pPoller->lock, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&pPoller->lock);
+    return NULL;
+}
+
+INT moca_poller_start(moca_poller_t *pPoller, const moca_poller_config_t *pConfig)
+{
+    pthread_condattr_t attr;
+
+    if (pPoller == NULL || pConfig == NULL || pConfig->minIntervalMs == 0 || pConfig->maxIntervalMs < pConfig->minIntervalMs)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(pPoller, 0, sizeof(*pPoller));
+    pPoller->config = *pConfig;
+    pPoller->stats.intervalMs = pConfig->minIntervalMs;
+    pthread_mutex_init(&pPoller->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pPoller->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (pthread_create(&pPoller->thread, NULL, moca_poller_main, pPoller) != 0)
+    {
+        pthread_cond_destroy(&pPoller->cond);
+        pthread_mutex_destroy(&pPoller->lock);
+        return STATUS_FAILURE;
+    }
+    pPoller->running = TRUE;
+    return STATUS_SUCCESS;
+}
+
+void moca_poller_stop(moca_poller_t *pPoller)
+{
+    if (pPoller == NULL || pPoller->running == FALSE)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pPoller->lock);
+    pPoller->stopping = TRUE;
+    pthread_cond_signal(&pPoller->cond);
+    pthread_mutex_unlock(&pPoller->lock);
+    pthread_join(pPoller->thread, NULL);
+    pthread_cond_destroy(&pPoller->cond);
+    pthread_mutex_destroy(&pPoller->lock);
+    pPoller->running = FALSE;
+}
+
+/* The lock only exists while the thread runs, a stopped poller keeps its final values */
+INT moca_poller_latest(moca_poller_t *pPoller, moca_poller_sample_t *pSample)
+{
+    BOOL locked;
+    INT status = STATUS_FAILURE;
+
+    if (pPoller == NULL || pSample == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    locked = pPoller->running;
+    if (locked)
+    {
+        pthread_mutex_lock(&pPoller->lock);
+    }
+    if (pPoller->haveSample)
+    {
+        *pSample = pPoller->latest;
+        status = STATUS_SUCCESS;
+    }
+    if (locked)
+    {
+        pthread_mutex_unlock(&pPoller->lock);
+    }
+    return status;
+}
+
+void moca_poller_get_stats(moca_poller_t *pPoller, moca_poller_stats_t *pStats)
+{
+    BOOL locked;
+
+    if (pPoller == NULL || pStats == NULL)
+    {
+        return;
+    }
+    locked = pPoller->running;
+    if (locked)
+    {
+        pthread_mutex_lock(&pPoller->lock);
+    }
+    *pStats = pPoller->stats;
+    if (locked)
+    {
+        pthread_mutex_unlock(&pPoller->lock);
+    }
+}
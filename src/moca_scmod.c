@@ -0,0 +1,531 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_scmod.c
+*
+* SCMOD bit loading analysis, see moca_scmod.h.
+*
+* A kernel reduces a run of subcarriers to a moca_scmod_acc_t. The SIMD
+* kernels count a histogram bin by comparing every lane against its value
+* into byte counters, one pass over the run per bin, and fold the counters
+* into the 32 bit totals before a lane can wrap. The last bin is what the
+* others did not count. Sums go through sum of absolute differences,
+* against zero for the totals and against the previous dump for the
+* absolute delta. Subcarriers left over after the last full vector go
+* through the scalar kernel.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "moca_hal.h"
+#include "moca_scmod.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define MOCA_SCMOD_HAVE_AVX2
+#endif
+#if defined(__SSE2__)
+#define MOCA_SCMOD_HAVE_SSE2
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MOCA_SCMOD_HAVE_NEON
+#endif
+
+#define MOCA_SCMOD_FLUSH_BLOCKS   255     /**< Vectors before a byte counter can wrap */
+
+typedef struct
+{
+    uint32_t histogram[MOCA_SCMOD_HISTOGRAM_BINS];
+    uint32_t totalBits;
+    uint32_t previousTotalBits;
+    uint32_t absoluteDeltaBits;
+    uint32_t unchanged;
+    uint8_t minBits;        /**< Lowest non-zero value, 0xFF if none */
+    uint8_t maxBits;
+} moca_scmod_acc_t;
+
+/* pPrevious is NULL when there is nothing to compare against */
+typedef void (*moca_scmod_kernel_fn_t)(const uint8_t *pBits, const uint8_t *pPrevious, size_t count,
+                                       moca_scmod_acc_t *pAcc);
+
+static const char * const gScmodKernelNames[MOCA_SCMOD_KERNEL_COUNT] =
+{
+    [MOCA_SCMOD_KERNEL_AUTO] = "auto",
+    [MOCA_SCMOD_KERNEL_SCALAR] = "scalar",
+    [MOCA_SCMOD_KERNEL_SSE2] = "sse2",
+    [MOCA_SCMOD_KERNEL_AVX2] = "avx2",
+    [MOCA_SCMOD_KERNEL_NEON] = "neon"
+};
+
+static void moca_scmod_kernel_scalar(const uint8_t *pBits, const uint8_t *pPrevious, size_t count,
+                                     moca_scmod_acc_t *pAcc)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        uint8_t bits = pBits[i];
+
+        pAcc->histogram[(bits < MOCA_SCMOD_HISTOGRAM_BINS) ? bits : MOCA_SCMOD_HISTOGRAM_BINS - 1]++;
+        pAcc->totalBits += bits;
+        if (bits != 0 && bits < pAcc->minBits)
+        {
+            pAcc->minBits = bits;
+        }
+        if (bits > pAcc->maxBits)
+        {
+            pAcc->maxBits = bits;
+        }
+        if (pPrevious != NULL)
+        {
+            uint8_t previous = pPrevious[i];
+
+            pAcc->previousTotalBits += previous;
+            pAcc->absoluteDeltaBits += (bits > previous) ? (uint32_t)(bits - previous) : (uint32_t)(previous - bits);
+            pAcc->unchanged += (bits == previous);
+        }
+    }
+}
+
+/* Lowest and highest byte of a vector stored to memory */
+static void moca_scmod_fold_min_max(const uint8_t *pMin, const uint8_t *pMax, size_t lanes, moca_scmod_acc_t *pAcc)
+{
+    size_t i;
+
+    for (i = 0; i < lanes; i++)
+    {
+        if (pMin[i] < pAcc->minBits)
+        {
+            pAcc->minBits = pMin[i];
+        }
+        if (pMax[i] > pAcc->maxBits)
+        {
+            pAcc->maxBits = pMax[i];
+        }
+    }
+}
+
+#ifdef MOCA_SCMOD_HAVE_SSE2
+static uint32_t moca_scmod_sse2_sum(__m128i sad)
+{
+    uint64_t lanes[2];
+
+    _mm_storeu_si128((__m128i *)lanes, sad);
+    return (uint32_t)(lanes[0] + lanes[1]);
+}
+
+static void moca_scmod_kernel_sse2(const uint8_t *pBits, const uint8_t *pPrevious, size_t count,
+                                   moca_scmod_acc_t *pAcc)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_set1_epi8(MOCA_SCMOD_HISTOGRAM_BINS - 1);
+    size_t blocks = count / sizeof(__m128i);
+    __m128i vMin = _mm_set1_epi8((char)0xFF);
+    __m128i vMax = zero;
+    __m128i total = zero;
+    __m128i previousTotal = zero;
+    __m128i absoluteDelta = zero;
+    uint8_t minLanes[sizeof(__m128i)], maxLanes[sizeof(__m128i)];
+    size_t block = 0;
+    uint32_t counted;
+    int bin;
+
+    while (block < blocks)
+    {
+        size_t end = (blocks - block > MOCA_SCMOD_FLUSH_BLOCKS) ? block + MOCA_SCMOD_FLUSH_BLOCKS : blocks;
+        size_t first = block;
+        __m128i same = zero;
+
+        for (; block < end; block++)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(pBits + block * sizeof(__m128i)));
+
+            total = _mm_add_epi64(total, _mm_sad_epu8(v, zero));
+            vMax = _mm_max_epu8(vMax, v);
+            /* Zero becomes 0xFF so it never wins the minimum */
+            vMin = _mm_min_epu8(vMin, _mm_or_si128(v, _mm_cmpeq_epi8(v, zero)));
+            if (pPrevious != NULL)
+            {
+                __m128i previous = _mm_loadu_si128((const __m128i *)(pPrevious + block * sizeof(__m128i)));
+
+                previousTotal = _mm_add_epi64(previousTotal, _mm_sad_epu8(previous, zero));
+                absoluteDelta = _mm_add_epi64(absoluteDelta, _mm_sad_epu8(v, previous));
+                same = _mm_sub_epi8(same, _mm_cmpeq_epi8(v, previous));
+            }
+        }
+        /* One pass per bin keeps its counter in a register, the chunk is still in L1 */
+        counted = 0;
+        for (bin = 0; bin < MOCA_SCMOD_HISTOGRAM_BINS - 1; bin++)
+        {
+            const __m128i value = _mm_set1_epi8((char)bin);
+            __m128i counter = zero;
+            size_t i;
+            uint32_t n;
+
+            for (i = first; i < end; i++)
+            {
+                __m128i v = _mm_min_epu8(_mm_loadu_si128((const __m128i *)(pBits + i * sizeof(__m128i))), top);
+
+                counter = _mm_sub_epi8(counter, _mm_cmpeq_epi8(v, value));
+            }
+            n = moca_scmod_sse2_sum(_mm_sad_epu8(counter, zero));
+            pAcc->histogram[bin] += n;
+            counted += n;
+        }
+        pAcc->histogram[MOCA_SCMOD_HISTOGRAM_BINS - 1] += (uint32_t)((end - first) * sizeof(__m128i)) - counted;
+        pAcc->unchanged += moca_scmod_sse2_sum(_mm_sad_epu8(same, zero));
+    }
+    pAcc->totalBits += moca_scmod_sse2_sum(total);
+    pAcc->previousTotalBits += moca_scmod_sse2_sum(previousTotal);
+    pAcc->absoluteDeltaBits += moca_scmod_sse2_sum(absoluteDelta);
+    _mm_storeu_si128((__m128i *)minLanes, vMin);
+    _mm_storeu_si128((__m128i *)maxLanes, vMax);
+    moca_scmod_fold_min_max(minLanes, maxLanes, sizeof(__m128i), pAcc);
+
+    blocks *= sizeof(__m128i);
+    moca_scmod_kernel_scalar(pBits + blocks, (pPrevious != NULL) ? pPrevious + blocks : NULL, count - blocks, pAcc);
+}
+#endif
+
+#ifdef MOCA_SCMOD_HAVE_AVX2
+__attribute__((target("avx2")))
+static uint32_t moca_scmod_avx2_sum(__m256i sad)
+{
+    uint64_t lanes[4];
+
+    _mm256_storeu_si256((__m256i *)lanes, sad);
+    return (uint32_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+__attribute__((target("avx2")))
+static void moca_scmod_kernel_avx2(const uint8_t *pBits, const uint8_t *pPrevious, size_t count,
+                                   moca_scmod_acc_t *pAcc)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi8(MOCA_SCMOD_HISTOGRAM_BINS - 1);
+    size_t blocks = count / sizeof(__m256i);
+    __m256i vMin = _mm256_set1_epi8((char)0xFF);
+    __m256i vMax = zero;
+    __m256i total = zero;
+    __m256i previousTotal = zero;
+    __m256i absoluteDelta = zero;
+    uint8_t minLanes[sizeof(__m256i)], maxLanes[sizeof(__m256i)];
+    size_t block = 0;
+    uint32_t counted;
+    int bin;
+
+    while (block < blocks)
+    {
+        size_t end = (blocks - block > MOCA_SCMOD_FLUSH_BLOCKS) ? block + MOCA_SCMOD_FLUSH_BLOCKS : blocks;
+        size_t first = block;
+        __m256i same = zero;
+
+        for (; block < end; block++)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(pBits + block * sizeof(__m256i)));
+
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(v, zero));
+            vMax = _mm256_max_epu8(vMax, v);
+            vMin = _mm256_min_epu8(vMin, _mm256_or_si256(v, _mm256_cmpeq_epi8(v, zero)));
+            if (pPrevious != NULL)
+            {
+                __m256i previous = _mm256_loadu_si256((const __m256i *)(pPrevious + block * sizeof(__m256i)));
+
+                previousTotal = _mm256_add_epi64(previousTotal, _mm256_sad_epu8(previous, zero));
+                absoluteDelta = _mm256_add_epi64(absoluteDelta, _mm256_sad_epu8(v, previous));
+                same = _mm256_sub_epi8(same, _mm256_cmpeq_epi8(v, previous));
+            }
+        }
+        counted = 0;
+        for (bin = 0; bin < MOCA_SCMOD_HISTOGRAM_BINS - 1; bin++)
+        {
+            const __m256i value = _mm256_set1_epi8((char)bin);
+            __m256i counter = zero;
+            size_t i;
+            uint32_t n;
+
+            for (i = first; i < end; i++)
+            {
+                __m256i v = _mm256_min_epu8(_mm256_loadu_si256((const __m256i *)(pBits + i * sizeof(__m256i))), top);
+
+                counter = _mm256_sub_epi8(counter, _mm256_cmpeq_epi8(v, value));
+            }
+            n = moca_scmod_avx2_sum(_mm256_sad_epu8(counter, zero));
+            pAcc->histogram[bin] += n;
+            counted += n;
+        }
+        pAcc->histogram[MOCA_SCMOD_HISTOGRAM_BINS - 1] += (uint32_t)((end - first) * sizeof(__m256i)) - counted;
+        pAcc->unchanged += moca_scmod_avx2_sum(_mm256_sad_epu8(same, zero));
+    }
+    pAcc->totalBits += moca_scmod_avx2_sum(total);
+    pAcc->previousTotalBits += moca_scmod_avx2_sum(previousTotal);
+    pAcc->absoluteDeltaBits += moca_scmod_avx2_sum(absoluteDelta);
+    _mm256_storeu_si256((__m256i *)minLanes, vMin);
+    _mm256_storeu_si256((__m256i *)maxLanes, vMax);
+    moca_scmod_fold_min_max(minLanes, maxLanes, sizeof(__m256i), pAcc);
+
+    blocks *= sizeof(__m256i);
+    moca_scmod_kernel_scalar(pBits + blocks, (pPrevious != NULL) ? pPrevious + blocks : NULL, count - blocks, pAcc);
+}
+#endif
+
+#ifdef MOCA_SCMOD_HAVE_NEON
+static uint32_t moca_scmod_neon_sum_u8(uint8x16_t v)
+{
+    uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(v)));
+
+    return (uint32_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+}
+
+static uint32_t moca_scmod_neon_sum_u32(uint32x4_t v)
+{
+    uint64x2_t sum = vpaddlq_u32(v);
+
+    return (uint32_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+}
+
+static void moca_scmod_kernel_neon(const uint8_t *pBits, const uint8_t *pPrevious, size_t count,
+                                   moca_scmod_acc_t *pAcc)
+{
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t top = vdupq_n_u8(MOCA_SCMOD_HISTOGRAM_BINS - 1);
+    size_t blocks = count / sizeof(uint8x16_t);
+    uint8x16_t vMin = vdupq_n_u8(0xFF);
+    uint8x16_t vMax = zero;
+    uint32x4_t total = vdupq_n_u32(0);
+    uint32x4_t previousTotal = vdupq_n_u32(0);
+    uint32x4_t absoluteDelta = vdupq_n_u32(0);
+    uint8_t minLanes[sizeof(uint8x16_t)], maxLanes[sizeof(uint8x16_t)];
+    size_t block = 0;
+    uint32_t counted;
+    int bin;
+
+    while (block < blocks)
+    {
+        size_t end = (blocks - block > MOCA_SCMOD_FLUSH_BLOCKS) ? block + MOCA_SCMOD_FLUSH_BLOCKS : blocks;
+        size_t first = block;
+        uint8x16_t same = zero;
+
+        for (; block < end; block++)
+        {
+            uint8x16_t v = vld1q_u8(pBits + block * sizeof(uint8x16_t));
+
+            total = vpadalq_u16(total, vpaddlq_u8(v));
+            vMax = vmaxq_u8(vMax, v);
+            vMin = vminq_u8(vMin, vorrq_u8(v, vceqq_u8(v, zero)));
+            if (pPrevious != NULL)
+            {
+                uint8x16_t previous = vld1q_u8(pPrevious + block * sizeof(uint8x16_t));
+
+                previousTotal = vpadalq_u16(previousTotal, vpaddlq_u8(previous));
+                absoluteDelta = vpadalq_u16(absoluteDelta, vpaddlq_u8(vabdq_u8(v, previous)));
+                same = vsubq_u8(same, vceqq_u8(v, previous));
+            }
+        }
+        counted = 0;
+        for (bin = 0; bin < MOCA_SCMOD_HISTOGRAM_BINS - 1; bin++)
+        {
+            const uint8x16_t value = vdupq_n_u8((uint8_t)bin);
+            uint8x16_t counter = zero;
+            size_t i;
+            uint32_t n;
+
+            for (i = first; i < end; i++)
+            {
+                counter = vsubq_u8(counter, vceqq_u8(vminq_u8(vld1q_u8(pBits + i * sizeof(uint8x16_t)), top), value));
+            }
+            n = moca_scmod_neon_sum_u8(counter);
+            pAcc->histogram[bin] += n;
+            counted += n;
+        }
+        pAcc->histogram[MOCA_SCMOD_HISTOGRAM_BINS - 1] += (uint32_t)((end - first) * sizeof(uint8x16_t)) - counted;
+        pAcc->unchanged += moca_scmod_neon_sum_u8(same);
+    }
+    pAcc->totalBits += moca_scmod_neon_sum_u32(total);
+    pAcc->previousTotalBits += moca_scmod_neon_sum_u32(previousTotal);
+    pAcc->absoluteDeltaBits += moca_scmod_neon_sum_u32(absoluteDelta);
+    vst1q_u8(minLanes, vMin);
+    vst1q_u8(maxLanes, vMax);
+    moca_scmod_fold_min_max(minLanes, maxLanes, sizeof(uint8x16_t), pAcc);
+
+    blocks *= sizeof(uint8x16_t);
+    moca_scmod_kernel_scalar(pBits + blocks, (pPrevious != NULL) ? pPrevious + blocks : NULL, count - blocks, pAcc);
+}
+#endif
+
+static moca_scmod_kernel_fn_t moca_scmod_kernel_fn(moca_scmod_kernel_t kernel)
+{
+    switch (kernel)
+    {
+        case MOCA_SCMOD_KERNEL_SCALAR:
+            return moca_scmod_kernel_scalar;
+#ifdef MOCA_SCMOD_HAVE_SSE2
+        case MOCA_SCMOD_KERNEL_SSE2:
+            return moca_scmod_kernel_sse2;
+#endif
+#ifdef MOCA_SCMOD_HAVE_AVX2
+        case MOCA_SCMOD_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? moca_scmod_kernel_avx2 : NULL;
+#endif
+#ifdef MOCA_SCMOD_HAVE_NEON
+        case MOCA_SCMOD_KERNEL_NEON:
+            return moca_scmod_kernel_neon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+moca_scmod_kernel_t moca_scmod_best_kernel(void)
+{
+    static const moca_scmod_kernel_t preference[] =
+    {
+        MOCA_SCMOD_KERNEL_AVX2, MOCA_SCMOD_KERNEL_SSE2, MOCA_SCMOD_KERNEL_NEON
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(preference) / sizeof(preference[0]); i++)
+    {
+        if (moca_scmod_kernel_fn(preference[i]) != NULL)
+        {
+            return preference[i];
+        }
+    }
+    return MOCA_SCMOD_KERNEL_SCALAR;
+}
+
+BOOL moca_scmod_kernel_supported(moca_scmod_kernel_t kernel)
+{
+    return (kernel == MOCA_SCMOD_KERNEL_AUTO || moca_scmod_kernel_fn(kernel) != NULL) ? TRUE : FALSE;
+}
+
+const char *moca_scmod_kernel_name(moca_scmod_kernel_t kernel)
+{
+    return ((unsigned)kernel < MOCA_SCMOD_KERNEL_COUNT) ? gScmodKernelNames[kernel] : "unknown";
+}
+
+int moca_scmod_analyze(moca_scmod_kernel_t kernel, const moca_scmod_stat_t *pEntries, int numEntries,
+                       const moca_scmod_stat_t *pPrevious, int numPrevious, moca_scmod_analysis_t *pAnalysis)
+{
+    const moca_scmod_stat_t *previousOf[kMoca_MaxMocaNodes][kMoca_MaxMocaNodes];
+    moca_scmod_kernel_fn_t fn;
+    int i;
+
+    if (kernel == MOCA_SCMOD_KERNEL_AUTO)
+    {
+        kernel = moca_scmod_best_kernel();
+    }
+    fn = moca_scmod_kernel_fn(kernel);
+    if (fn == NULL || pAnalysis == NULL || numEntries < 0 || numEntries > (int)MOCA_SCMOD_MAX_LINKS ||
+        (pEntries == NULL && numEntries > 0) || (pPrevious == NULL && numPrevious > 0))
+    {
+        return STATUS_FAILURE;
+    }
+
+    memset(previousOf, 0, sizeof(previousOf));
+    for (i = 0; i < numPrevious; i++)
+    {
+        if (pPrevious[i].txNode < kMoca_MaxMocaNodes && pPrevious[i].rxNode < kMoca_MaxMocaNodes)
+        {
+            previousOf[pPrevious[i].txNode][pPrevious[i].rxNode] = &pPrevious[i];
+        }
+    }
+
+    pAnalysis->kernel = kernel;
+    pAnalysis->numLinks = 0;
+    memset(pAnalysis->nodes, 0, sizeof(pAnalysis->nodes));
+    for (i = 0; i < numEntries; i++)
+    {
+        const moca_scmod_stat_t *pEntry = &pEntries[i];
+        moca_scmod_link_t *pLink = &pAnalysis->links[i];
+        moca_scmod_node_t *pNode;
+        const moca_scmod_stat_t *pOld;
+        moca_scmod_acc_t acc;
+        int bin;
+
+        if (pEntry->txNode >= kMoca_MaxMocaNodes || pEntry->rxNode >= kMoca_MaxMocaNodes)
+        {
+            return STATUS_FAILURE;
+        }
+        pOld = previousOf[pEntry->txNode][pEntry->rxNode];
+        memset(&acc, 0, sizeof(acc));
+        acc.minBits = 0xFF;
+        fn(pEntry->bitLoading, (pOld != NULL) ? pOld->bitLoading : NULL, MOCA_SCMOD_SUBCARRIERS, &acc);
+
+        memset(pLink, 0, sizeof(*pLink));
+        pLink->txNode = pEntry->txNode;
+        pLink->rxNode = pEntry->rxNode;
+        memcpy(pLink->histogram, acc.histogram, sizeof(pLink->histogram));
+        pLink->totalBits = acc.totalBits;
+        pLink->loadedSubcarriers = (uint32_t)MOCA_SCMOD_SUBCARRIERS - acc.histogram[0];
+        pLink->minBits = (pLink->loadedSubcarriers > 0) ? acc.minBits : 0;
+        pLink->maxBits = acc.maxBits;
+        pLink->averageBits = (double)acc.totalBits / (double)MOCA_SCMOD_SUBCARRIERS;
+        if (pOld != NULL)
+        {
+            pLink->hasPrevious = TRUE;
+            pLink->deltaBits = (int32_t)acc.totalBits - (int32_t)acc.previousTotalBits;
+            pLink->changedSubcarriers = (uint32_t)MOCA_SCMOD_SUBCARRIERS - acc.unchanged;
+            pLink->absoluteDeltaBits = acc.absoluteDeltaBits;
+        }
+
+        pNode = &pAnalysis->nodes[pEntry->rxNode];
+        if (pNode->links == 0)
+        {
+            pNode->minBits = 0xFF;
+        }
+        pNode->links++;
+        for (bin = 0; bin < MOCA_SCMOD_HISTOGRAM_BINS; bin++)
+        {
+            pNode->histogram[bin] += pLink->histogram[bin];
+        }
+        pNode->totalBits += pLink->totalBits;
+        pNode->loadedSubcarriers += pLink->loadedSubcarriers;
+        if (pLink->loadedSubcarriers > 0 && pLink->minBits < pNode->minBits)
+        {
+            pNode->minBits = pLink->minBits;
+        }
+        if (pLink->maxBits > pNode->maxBits)
+        {
+            pNode->maxBits = pLink->maxBits;
+        }
+        pNode->deltaBits += pLink->deltaBits;
+        pNode->changedSubcarriers += pLink->changedSubcarriers;
+        pAnalysis->numLinks++;
+    }
+    for (i = 0; i < kMoca_MaxMocaNodes; i++)
+    {
+        moca_scmod_node_t *pNode = &pAnalysis->nodes[i];
+
+        if (pNode->links > 0)
+        {
+            if (pNode->loadedSubcarriers == 0)
+            {
+                pNode->minBits = 0;
+            }
+            pNode->averageBits = (double)pNode->totalBits / ((double)pNode->links * (double)MOCA_SCMOD_SUBCARRIERS);
+        }
+    }
+    return STATUS_SUCCESS;
+}
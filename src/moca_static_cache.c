@@ -0,0 +1,222 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_static_cache.c
+*
+* Cache of moca_IfGetStaticInfo(), see moca_static_cache.h.
+*/
+
+#include <string.h>
+#include <time.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include "moca_static_cache.h"
+
+#define MOCA_STATIC_CACHE_READ_ATTEMPTS    3
+#define NS_PER_MS                          1000000ULL
+
+static uint64_t moca_static_cache_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Counters are bumped by concurrent readers holding the read lock */
+static void moca_static_cache_count(uint64_t *pCounter)
+{
+    __atomic_fetch_add(pCounter, 1, __ATOMIC_RELAXED);
+}
+
+INT moca_static_cache_init(moca_static_cache_t *pCache, uint32_t revalidateMs)
+{
+    if (pCache == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(pCache, 0, sizeof(*pCache));
+    if (pthread_rwlock_init(&pCache->lock, NULL) != 0)
+    {
+        return STATUS_FAILURE;
+    }
+    pCache->revalidateMs = revalidateMs;
+    return STATUS_SUCCESS;
+}
+
+void moca_static_cache_destroy(moca_static_cache_t *pCache)
+{
+    if (pCache != NULL)
+    {
+        pthread_rwlock_destroy(&pCache->lock);
+    }
+}
+
+INT moca_static_cache_get(moca_static_cache_t *pCache, ULONG ifIndex, moca_static_info_t *pInfo)
+{
+    moca_static_cache_entry_t *pEntry;
+    moca_static_info_t info;
+    uint64_t generation;
+    uint64_t now = 0;
+    ULONG before, after;
+    int attempt;
+
+    if (pCache == NULL || pInfo == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    if (ifIndex >= MOCA_STATIC_CACHE_MAX_INTERFACES)
+    {
+        moca_static_cache_count(&pCache->stats.misses);
+        if (moca_IfGetStaticInfo(ifIndex, pInfo) != STATUS_SUCCESS)
+        {
+            moca_static_cache_count(&pCache->stats.failures);
+            return STATUS_FAILURE;
+        }
+        return STATUS_SUCCESS;
+    }
+    pEntry = &pCache->entries[ifIndex];
+
+    if (pCache->revalidateMs > 0)
+    {
+        now = moca_static_cache_now_ns();
+        pthread_rwlock_rdlock(&pCache->lock);
+        if (pEntry->valid && now - __atomic_load_n(&pEntry->checkedNs, __ATOMIC_RELAXED) < pCache->revalidateMs * NS_PER_MS)
+        {
+            *pInfo = pEntry->info;
+            pthread_rwlock_unlock(&pCache->lock);
+            moca_static_cache_count(&pCache->stats.hits);
+            return STATUS_SUCCESS;
+        }
+        pthread_rwlock_unlock(&pCache->lock);
+    }
+
+    for (attempt = 0; attempt < MOCA_STATIC_CACHE_READ_ATTEMPTS; attempt++)
+    {
+        if (moca_GetResetCount(&before) != STATUS_SUCCESS)
+        {
+            moca_static_cache_count(&pCache->stats.failures);
+            return STATUS_FAILURE;
+        }
+        pthread_rwlock_rdlock(&pCache->lock);
+        if (pEntry->valid && pEntry->resetCount == before)
+        {
+            *pInfo = pEntry->info;
+            if (pCache->revalidateMs > 0)
+            {
+                __atomic_store_n(&pEntry->checkedNs, now, __ATOMIC_RELAXED);
+            }
+            pthread_rwlock_unlock(&pCache->lock);
+            moca_static_cache_count(&pCache->stats.hits);
+            return STATUS_SUCCESS;
+        }
+        if (pEntry->valid)
+        {
+            moca_static_cache_count(&pCache->stats.resets);
+        }
+        generation = pEntry->generation;
+        pthread_rwlock_unlock(&pCache->lock);
+
+        moca_static_cache_count(&pCache->stats.misses);
+        if (moca_IfGetStaticInfo(ifIndex, &info) != STATUS_SUCCESS || moca_GetResetCount(&after) != STATUS_SUCCESS)
+        {
+            moca_static_cache_count(&pCache->stats.failures);
+            return STATUS_FAILURE;
+        }
+        *pInfo = info;
+        if (before == after)
+        {
+            /* An invalidation since the read may have changed what the driver returns now */
+            pthread_rwlock_wrlock(&pCache->lock);
+            if (pEntry->generation == generation)
+            {
+                pEntry->info = info;
+                pEntry->resetCount = before;
+                pEntry->checkedNs = (pCache->revalidateMs > 0) ? moca_static_cache_now_ns() : 0;
+                pEntry->valid = TRUE;
+            }
+            pthread_rwlock_unlock(&pCache->lock);
+            return STATUS_SUCCESS;
+        }
+    }
+    /* The interface keeps resetting, the latest read is returned without being stored */
+    return STATUS_SUCCESS;
+}
+
+void moca_static_cache_invalidate(moca_static_cache_t *pCache, ULONG ifIndex)
+{
+    if (pCache == NULL || ifIndex >= MOCA_STATIC_CACHE_MAX_INTERFACES)
+    {
+        return;
+    }
+    pthread_rwlock_wrlock(&pCache->lock);
+    pCache->entries[ifIndex].valid = FALSE;
+    pCache->entries[ifIndex].generation++;
+    pthread_rwlock_unlock(&pCache->lock);
+    moca_static_cache_count(&pCache->stats.invalidations);
+}
+
+INT moca_static_cache_set_config(moca_static_cache_t *pCache, ULONG ifIndex, moca_cfg_t *pConfig)
+{
+    INT status;
+
+    if (pCache == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    status = moca_SetIfConfig(ifIndex, pConfig);
+    moca_static_cache_invalidate(pCache, ifIndex);
+    return status;
+}
+
+INT moca_static_cache_set_config_fields(moca_static_cache_t *pCache, ULONG ifIndex, const moca_cfg_t *pConfig,
+                                        ULONG fieldMask, moca_cfg_apply_result_t *pResult)
+{
+    moca_cfg_apply_result_t result;
+    INT status;
+
+    if (pCache == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(&result, 0, sizeof(result));
+    status = moca_SetIfConfigFields(ifIndex, pConfig, fieldMask, &result);
+    if (status != STATUS_SUCCESS || result.changedMask != 0)
+    {
+        moca_static_cache_invalidate(pCache, ifIndex);
+    }
+    if (pResult != NULL)
+    {
+        *pResult = result;
+    }
+    return status;
+}
+
+void moca_static_cache_get_stats(moca_static_cache_t *pCache, moca_static_cache_stats_t *pStats)
+{
+    if (pCache == NULL || pStats == NULL)
+    {
+        return;
+    }
+    pStats->hits = __atomic_load_n(&pCache->stats.hits, __ATOMIC_RELAXED);
+    pStats->misses = __atomic_load_n(&pCache->stats.misses, __ATOMIC_RELAXED);
+    pStats->resets = __atomic_load_n(&pCache->stats.resets, __ATOMIC_RELAXED);
+    pStats->invalidations = __atomic_load_n(&pCache->stats.invalidations, __ATOMIC_RELAXED);
+    pStats->failures = __atomic_load_n(&pCache->stats.failures, __ATOMIC_RELAXED);
+}
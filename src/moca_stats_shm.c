@@ -0,0 +1,289 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_stats_shm.c
+*
+* Shared memory publication of MoCA statistics, see moca_stats_shm.h.
+*
+* The sequence lock follows the usual fence based form: the snapshot is
+* copied with plain memcpy() between the fences, and a copy that raced a
+* write is thrown away by the sequence check.
+*/
+
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "moca_hal.h"
+#include "moca_stats_shm.h"
+
+static size_t moca_stats_shm_size(uint32_t numInterfaces)
+{
+    /* Slots start on their own cache line */
+    size_t header = (sizeof(moca_stats_shm_header_t) + sizeof(moca_stats_shm_slot_t) - 1) / sizeof(moca_stats_shm_slot_t);
+
+    return (header + numInterfaces) * sizeof(moca_stats_shm_slot_t);
+}
+
+static void moca_stats_shm_attach(moca_stats_shm_t *pShm, void *pBase, size_t size, BOOL writable)
+{
+    pShm->pHeader = (moca_stats_shm_header_t *)pBase;
+    pShm->pSlots = (moca_stats_shm_slot_t *)((char *)pBase + moca_stats_shm_size(0));
+    pShm->size = size;
+    pShm->writable = writable;
+}
+
+/* Clears the magic of an earlier object so its readers see it retired, they keep a valid mapping of it */
+static void moca_stats_shm_retire(const char *pName)
+{
+    moca_stats_shm_header_t *pHeader;
+    struct stat st;
+    int fd;
+
+    fd = shm_open(pName, O_RDWR, 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(moca_stats_shm_header_t))
+    {
+        pHeader = mmap(NULL, sizeof(moca_stats_shm_header_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (pHeader != MAP_FAILED)
+        {
+            __atomic_store_n(&pHeader->magic, 0, __ATOMIC_RELEASE);
+            munmap(pHeader, sizeof(moca_stats_shm_header_t));
+        }
+    }
+    close(fd);
+    shm_unlink(pName);
+}
+
+INT moca_stats_shm_create(const char *pName, uint32_t numInterfaces, moca_stats_shm_t *pShm)
+{
+    size_t size = moca_stats_shm_size(numInterfaces);
+    void *pBase;
+    int fd;
+
+    if (pName == NULL || pShm == NULL || numInterfaces == 0 || numInterfaces > MOCA_STATS_SHM_MAX_INTERFACES)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(pShm, 0, sizeof(*pShm));
+    /* Shrinking an object readers have mapped would fault their next read, a new one is created instead */
+    moca_stats_shm_retire(pName);
+    fd = shm_open(pName, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return STATUS_FAILURE;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        return STATUS_FAILURE;
+    }
+    pBase = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pBase == MAP_FAILED)
+    {
+        return STATUS_FAILURE;
+    }
+    moca_stats_shm_attach(pShm, pBase, size, TRUE);
+    pShm->pHeader->version = MOCA_STATS_SHM_VERSION;
+    pShm->pHeader->slotSize = (uint32_t)sizeof(moca_stats_shm_slot_t);
+    pShm->pHeader->numInterfaces = numInterfaces;
+    __atomic_store_n(&pShm->pHeader->magic, (uint32_t)MOCA_STATS_SHM_MAGIC, __ATOMIC_RELEASE);
+    return STATUS_SUCCESS;
+}
+
+INT moca_stats_shm_open(const char *pName, moca_stats_shm_t *pShm)
+{
+    const moca_stats_shm_header_t *pHeader;
+    struct stat st;
+    void *pBase;
+    int fd;
+
+    if (pName == NULL || pShm == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    memset(pShm, 0, sizeof(*pShm));
+    fd = shm_open(pName, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return STATUS_FAILURE;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < moca_stats_shm_size(1))
+    {
+        close(fd);
+        return STATUS_FAILURE;
+    }
+    pBase = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pBase == MAP_FAILED)
+    {
+        return STATUS_FAILURE;
+    }
+    pHeader = (const moca_stats_shm_header_t *)pBase;
+    if (__atomic_load_n(&pHeader->magic, __ATOMIC_ACQUIRE) != MOCA_STATS_SHM_MAGIC ||
+        pHeader->version != MOCA_STATS_SHM_VERSION || pHeader->slotSize != sizeof(moca_stats_shm_slot_t) ||
+        pHeader->numInterfaces == 0 || pHeader->numInterfaces > MOCA_STATS_SHM_MAX_INTERFACES ||
+        moca_stats_shm_size(pHeader->numInterfaces) > (size_t)st.st_size)
+    {
+        munmap(pBase, (size_t)st.st_size);
+        return STATUS_FAILURE;
+    }
+    moca_stats_shm_attach(pShm, pBase, (size_t)st.st_size, FALSE);
+    return STATUS_SUCCESS;
+}
+
+void moca_stats_shm_close(moca_stats_shm_t *pShm)
+{
+    if (pShm == NULL || pShm->pHeader == NULL)
+    {
+        return;
+    }
+    munmap(pShm->pHeader, pShm->size);
+    memset(pShm, 0, sizeof(*pShm));
+}
+
+INT moca_stats_shm_unlink(const char *pName)
+{
+    if (pName == NULL || shm_unlink(pName) != 0)
+    {
+        return STATUS_FAILURE;
+    }
+    return STATUS_SUCCESS;
+}
+
+uint32_t moca_stats_shm_interfaces(const moca_stats_shm_t *pShm)
+{
+    if (pShm == NULL || pShm->pHeader == NULL)
+    {
+        return 0;
+    }
+    return pShm->pHeader->numInterfaces;
+}
+
+BOOL moca_stats_shm_retired(const moca_stats_shm_t *pShm)
+{
+    if (pShm == NULL || pShm->pHeader == NULL)
+    {
+        return FALSE;
+    }
+    return (__atomic_load_n(&pShm->pHeader->magic, __ATOMIC_ACQUIRE) != MOCA_STATS_SHM_MAGIC) ? TRUE : FALSE;
+}
+
+INT moca_stats_shm_write(moca_stats_shm_t *pShm, uint32_t slot, ULONG ifIndex, const moca_stats_t *pStats,
+                         const moca_aggregate_counters_t *pAggregateCounters)
+{
+    moca_stats_shm_slot_t *pSlot;
+    moca_stats_shm_snapshot_t *pSnapshot;
+    struct timespec now;
+    uint32_t lock;
+
+    if (pShm == NULL || pShm->writable == FALSE || slot >= moca_stats_shm_interfaces(pShm))
+    {
+        return STATUS_FAILURE;
+    }
+    pSlot = &pShm->pSlots[slot];
+    pSnapshot = &pSlot->snapshot;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    lock = __atomic_load_n(&pSlot->lock, __ATOMIC_RELAXED);
+    __atomic_store_n(&pSlot->lock, lock + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    pSnapshot->sequence++;
+    pSnapshot->timestampNs = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    pSnapshot->ifIndex = ifIndex;
+    pSnapshot->haveStats = (pStats != NULL) ? TRUE : FALSE;
+    pSnapshot->haveAggregateCounters = (pAggregateCounters != NULL) ? TRUE : FALSE;
+    if (pStats != NULL)
+    {
+        memcpy(&pSnapshot->stats, pStats, sizeof(pSnapshot->stats));
+    }
+    else
+    {
+        memset(&pSnapshot->stats, 0, sizeof(pSnapshot->stats));
+    }
+    if (pAggregateCounters != NULL)
+    {
+        memcpy(&pSnapshot->aggregateCounters, pAggregateCounters, sizeof(pSnapshot->aggregateCounters));
+    }
+    else
+    {
+        memset(&pSnapshot->aggregateCounters, 0, sizeof(pSnapshot->aggregateCounters));
+    }
+
+    __atomic_store_n(&pSlot->lock, lock + 2, __ATOMIC_RELEASE);
+    return STATUS_SUCCESS;
+}
+
+INT moca_stats_shm_publish(moca_stats_shm_t *pShm, uint32_t slot, ULONG ifIndex)
+{
+    moca_stats_t stats;
+    moca_aggregate_counters_t aggregateCounters;
+    BOOL haveStats, haveAggregateCounters;
+
+    haveStats = (moca_IfGetStats(ifIndex, &stats) == STATUS_SUCCESS) ? TRUE : FALSE;
+    haveAggregateCounters = (moca_IfGetExtAggrCounter(ifIndex, &aggregateCounters) == STATUS_SUCCESS) ? TRUE : FALSE;
+    if (haveStats == FALSE && haveAggregateCounters == FALSE)
+    {
+        return STATUS_FAILURE;
+    }
+    return moca_stats_shm_write(pShm, slot, ifIndex, haveStats ? &stats : NULL,
+                                haveAggregateCounters ? &aggregateCounters : NULL);
+}
+
+INT moca_stats_shm_read(const moca_stats_shm_t *pShm, uint32_t slot, moca_stats_shm_snapshot_t *pSnapshot)
+{
+    const moca_stats_shm_slot_t *pSlot;
+    uint32_t attempt;
+
+    if (pShm == NULL || pSnapshot == NULL || slot >= moca_stats_shm_interfaces(pShm))
+    {
+        return STATUS_FAILURE;
+    }
+    if (moca_stats_shm_retired(pShm))
+    {
+        return STATUS_FAILURE;
+    }
+    pSlot = &pShm->pSlots[slot];
+    for (attempt = 0; attempt < MOCA_STATS_SHM_READ_ATTEMPTS; attempt++)
+    {
+        uint32_t begin = __atomic_load_n(&pSlot->lock, __ATOMIC_ACQUIRE);
+
+        if (begin & 1)
+        {
+            /* The writer may be preempted mid write on this CPU */
+            sched_yield();
+            continue;
+        }
+        memcpy(pSnapshot, &pSlot->snapshot, sizeof(*pSnapshot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&pSlot->lock, __ATOMIC_RELAXED) == begin)
+        {
+            return (begin != 0) ? STATUS_SUCCESS : STATUS_FAILURE;
+        }
+    }
+    return STATUS_FAILURE;
+}
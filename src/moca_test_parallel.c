@@ -0,0 +1,464 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_test_parallel.c
+*
+* Forks the worker processes of moca_test_parallel.h and replays their
+* results to CUnit.
+*
+* Workers post their result to a shared anonymous mapping and write their
+* output to a temporary file, the parent polls them with waitpid(WNOHANG) so
+* it can kill the ones that run for too long. CUnit goes on with the next test
+* after a fatal assertion, so a worker whose test hit one finds itself in a
+* trampoline again and posts the result it has.
+*/
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_test_parallel.h"
+#include "moca_test_report.h"
+
+#define MOCA_TEST_PARALLEL_MAX_TESTS        MOCA_TEST_REPORT_MAX_TESTS
+#define MOCA_TEST_PARALLEL_MAX_SUITES       MOCA_TEST_REPORT_MAX_SUITES
+#define MOCA_TEST_PARALLEL_MAX_SERIAL       64
+#define MOCA_TEST_PARALLEL_TIMEOUT_S        300
+#define MOCA_TEST_PARALLEL_POLL_NS          1000000     /**< Between two waitpid() rounds when no worker ended */
+
+/* Written by the worker, read by the parent once the worker is reaped */
+typedef struct
+{
+    int posted;
+    int exited;                 /**< The test called exit() */
+    moca_test_report_result_t result;
+} moca_test_parallel_slot_t;
+
+typedef struct
+{
+    UT_test_suite_t *pSuite;
+    const char *pTitle;
+    bool batched;               /**< Ran in a worker, or was meant to */
+    bool started;               /**< A worker was forked, false if it could not be and the test runs in the parent */
+    bool finished;
+    bool lost;                  /**< The worker exited without posting a result, or in the middle of its test */
+    pid_t pid;
+    FILE *pOutput;
+    uint64_t startNs;
+    moca_test_report_result_t result;
+} moca_test_parallel_test_t;
+
+static moca_test_parallel_test_t gParallelTests[MOCA_TEST_PARALLEL_MAX_TESTS];
+static uint32_t gParallelTestCount = 0;
+static UT_test_suite_t *gParallelSuites[MOCA_TEST_PARALLEL_MAX_SUITES];
+static uint32_t gParallelSuiteCount = 0;
+static const char *gParallelSerial[MOCA_TEST_PARALLEL_MAX_SERIAL];
+static uint32_t gParallelSerialCount = 0;
+static moca_test_parallel_slot_t *gParallelSlots = NULL;
+static int gParallelJobs = -1;                  /**< -1 until MOCA_TEST_JOBS is read, 0 runs every test in the parent */
+static uint64_t gParallelTimeoutNs = 0;
+static bool gParallelWorker = false;
+static uint32_t gParallelWorkerIndex = 0;
+
+static uint64_t moca_test_parallel_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void moca_test_parallel_register(uint32_t index, UT_test_suite_t *pSuite, const char *pTitle)
+{
+    if (index >= MOCA_TEST_PARALLEL_MAX_TESTS)
+    {
+        return;
+    }
+    gParallelTests[index].pSuite = pSuite;
+    gParallelTests[index].pTitle = pTitle;
+    if (index >= gParallelTestCount)
+    {
+        gParallelTestCount = index + 1;
+    }
+}
+
+void moca_test_parallel_suite(UT_test_suite_t *pSuite)
+{
+    if (pSuite != NULL && gParallelSuiteCount < MOCA_TEST_PARALLEL_MAX_SUITES)
+    {
+        gParallelSuites[gParallelSuiteCount++] = pSuite;
+    }
+}
+
+void moca_test_parallel_serial(const char *pTitle)
+{
+    if (pTitle != NULL && gParallelSerialCount < MOCA_TEST_PARALLEL_MAX_SERIAL)
+    {
+        gParallelSerial[gParallelSerialCount++] = pTitle;
+    }
+}
+
+static bool moca_test_parallel_is_suite(const UT_test_suite_t *pSuite)
+{
+    uint32_t i;
+
+    for (i = 0; i < gParallelSuiteCount; i++)
+    {
+        if (gParallelSuites[i] == pSuite)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool moca_test_parallel_is_serial(const char *pTitle)
+{
+    uint32_t i;
+
+    for (i = 0; i < gParallelSerialCount; i++)
+    {
+        if (strcmp(gParallelSerial[i], pTitle) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Reads MOCA_TEST_JOBS and MOCA_TEST_TIMEOUT once, returns the number of workers to run at once */
+static int moca_test_parallel_jobs(void)
+{
+    const char *pJobs, *pTimeout;
+    char *pEnd;
+    long value;
+
+    if (gParallelJobs >= 0)
+    {
+        return gParallelJobs;
+    }
+    gParallelJobs = 0;
+    pJobs = getenv("MOCA_TEST_JOBS");
+    if (pJobs == NULL || *pJobs == '\0')
+    {
+        return 0;
+    }
+    if (getenv("MOCA_TRACE_RECORD") != NULL && *getenv("MOCA_TRACE_RECORD") != '\0')
+    {
+        UT_LOG("[parallel] MOCA_TRACE_RECORD is set, tests run serially so that every HAL call is recorded");
+        return 0;
+    }
+    if (strcmp(pJobs, "auto") == 0)
+    {
+        value = 0;
+    }
+    else
+    {
+        value = strtol(pJobs, &pEnd, 10);
+        if (*pEnd != '\0' || value < 0)
+        {
+            UT_LOG("[parallel] MOCA_TEST_JOBS=%s is not a number of jobs, tests run serially", pJobs);
+            return 0;
+        }
+    }
+    if (value == 0)
+    {
+        value = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    gParallelJobs = (value > 0) ? (int)((value < MOCA_TEST_PARALLEL_MAX_TESTS) ? value : MOCA_TEST_PARALLEL_MAX_TESTS) : 1;
+
+    value = MOCA_TEST_PARALLEL_TIMEOUT_S;
+    pTimeout = getenv("MOCA_TEST_TIMEOUT");
+    if (pTimeout != NULL && *pTimeout != '\0')
+    {
+        value = strtol(pTimeout, &pEnd, 10);
+        if (*pEnd != '\0' || value <= 0)
+        {
+            UT_LOG("[parallel] MOCA_TEST_TIMEOUT=%s is not a number of seconds, using %d", pTimeout, MOCA_TEST_PARALLEL_TIMEOUT_S);
+            value = MOCA_TEST_PARALLEL_TIMEOUT_S;
+        }
+    }
+    gParallelTimeoutNs = (uint64_t)value * 1000000000ULL;
+
+    gParallelSlots = mmap(NULL, sizeof(moca_test_parallel_slot_t) * MOCA_TEST_PARALLEL_MAX_TESTS,
+                          PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (gParallelSlots == MAP_FAILED)
+    {
+        UT_LOG("[parallel] Cannot map the result slots (%s), tests run serially", strerror(errno));
+        gParallelSlots = NULL;
+        gParallelJobs = 0;
+    }
+    return gParallelJobs;
+}
+
+/* Posts the result of the test of this worker and ends it, the CUnit state of a worker is never looked at */
+static void moca_test_parallel_worker_exit(void)
+{
+    moca_test_parallel_slot_t *pSlot = &gParallelSlots[gParallelWorkerIndex];
+
+    moca_test_report_end();
+    if (moca_test_report_last(&pSlot->result))
+    {
+        pSlot->posted = 1;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    _exit(0);
+}
+
+static void moca_test_parallel_worker_atexit(void)
+{
+    gParallelSlots[gParallelWorkerIndex].exited = 1;
+    moca_test_parallel_worker_exit();
+}
+
+static void moca_test_parallel_start(uint32_t index, void (*run)(uint32_t index))
+{
+    moca_test_parallel_test_t *pTest = &gParallelTests[index];
+    pid_t pid;
+
+    gParallelSlots[index].posted = 0;
+    gParallelSlots[index].exited = 0;
+    pTest->pOutput = tmpfile();
+    if (pTest->pOutput == NULL)
+    {
+        UT_LOG("[parallel] %s: cannot create its output file (%s), it runs serially", pTest->pTitle, strerror(errno));
+        return;
+    }
+    pTest->startNs = moca_test_parallel_now_ns();
+    pid = fork();
+    if (pid < 0)
+    {
+        UT_LOG("[parallel] %s: fork failed (%s), it runs serially", pTest->pTitle, strerror(errno));
+        fclose(pTest->pOutput);
+        pTest->pOutput = NULL;
+        return;
+    }
+    if (pid == 0)
+    {
+        gParallelWorker = true;
+        gParallelWorkerIndex = index;
+        dup2(fileno(pTest->pOutput), STDOUT_FILENO);
+        dup2(fileno(pTest->pOutput), STDERR_FILENO);
+        /* A test calling exit() still reports what it measured */
+        atexit(moca_test_parallel_worker_atexit);
+        run(index);
+        moca_test_parallel_worker_exit();
+    }
+    pTest->pid = pid;
+    pTest->started = true;
+}
+
+static void moca_test_parallel_finish(moca_test_parallel_test_t *pTest, uint32_t index, int status, bool timedOut)
+{
+    const moca_test_parallel_slot_t *pSlot = &gParallelSlots[index];
+
+    pTest->finished = true;
+    memset(&pTest->result, 0, sizeof(pTest->result));
+    if (pSlot->posted)
+    {
+        pTest->result = pSlot->result;
+        pTest->lost = (pSlot->exited != 0);
+    }
+    else
+    {
+        pTest->result.wallNs = moca_test_parallel_now_ns() - pTest->startNs;
+        pTest->lost = !timedOut && !WIFSIGNALED(status);
+    }
+    if (pTest->lost && pTest->result.failures == 0)
+    {
+        /* Counts the assertion failed in its place */
+        pTest->result.failures = 1;
+    }
+    pTest->result.timedOut = timedOut;
+    if (!timedOut && WIFSIGNALED(status))
+    {
+        pTest->result.signal = WTERMSIG(status);
+    }
+}
+
+/* Reaps the workers that ended or ran out of time, returns how many */
+static uint32_t moca_test_parallel_reap(const uint32_t *pOrder, uint32_t count)
+{
+    uint64_t now = moca_test_parallel_now_ns();
+    uint32_t reaped = 0;
+    uint32_t i;
+    int status;
+
+    for (i = 0; i < count; i++)
+    {
+        moca_test_parallel_test_t *pTest = &gParallelTests[pOrder[i]];
+        pid_t pid;
+
+        if (!pTest->started || pTest->finished)
+        {
+            continue;
+        }
+        pid = waitpid(pTest->pid, &status, WNOHANG);
+        if (pid == pTest->pid)
+        {
+            moca_test_parallel_finish(pTest, pOrder[i], status, false);
+            reaped++;
+        }
+        else if (pid < 0 && errno != EINTR)
+        {
+            /* Someone else reaped it, there is no status left to read */
+            moca_test_parallel_finish(pTest, pOrder[i], 0, false);
+            reaped++;
+        }
+        else if (now - pTest->startNs > gParallelTimeoutNs)
+        {
+            kill(pTest->pid, SIGKILL);
+            while (waitpid(pTest->pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+            moca_test_parallel_finish(pTest, pOrder[i], status, true);
+            reaped++;
+        }
+    }
+    return reaped;
+}
+
+/* Runs every test of the suite that is not serial in workers, jobs at a time */
+static void moca_test_parallel_run_batch(UT_test_suite_t *pSuite, void (*run)(uint32_t index))
+{
+    static uint32_t order[MOCA_TEST_PARALLEL_MAX_TESTS];
+    const struct timespec poll = { 0, MOCA_TEST_PARALLEL_POLL_NS };
+    uint32_t count = 0, next = 0, running = 0, workers = 0;
+    uint64_t startNs, testNs = 0;
+    uint32_t i;
+
+    for (i = 0; i < gParallelTestCount; i++)
+    {
+        moca_test_parallel_test_t *pTest = &gParallelTests[i];
+
+        if (pTest->pSuite == pSuite && !pTest->batched && !moca_test_parallel_is_serial(pTest->pTitle))
+        {
+            pTest->batched = true;
+            order[count++] = i;
+        }
+    }
+    /* Whatever is buffered would be written again by every worker */
+    fflush(NULL);
+    startNs = moca_test_parallel_now_ns();
+    while (next < count || running > 0)
+    {
+        uint32_t reaped;
+
+        while (next < count && running < (uint32_t)gParallelJobs)
+        {
+            moca_test_parallel_start(order[next], run);
+            if (gParallelTests[order[next]].started)
+            {
+                running++;
+                workers++;
+            }
+            next++;
+        }
+        reaped = moca_test_parallel_reap(order, count);
+        running -= reaped;
+        if (reaped == 0 && running > 0)
+        {
+            nanosleep(&poll, NULL);
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        testNs += gParallelTests[order[i]].result.wallNs;
+    }
+    UT_LOG("[parallel] %u tests in %u workers, %d at a time: %.3f ms wall against %.3f ms of test time",
+           count, workers, gParallelJobs, (double)(moca_test_parallel_now_ns() - startNs) / 1e6, (double)testNs / 1e6);
+}
+
+/* Prints what the worker of a test wrote and reports its result as if the test had run here */
+static void moca_test_parallel_replay(moca_test_parallel_test_t *pTest)
+{
+    char buffer[4096];
+    size_t size;
+
+    fflush(stdout);
+    rewind(pTest->pOutput);
+    while ((size = fread(buffer, 1, sizeof(buffer), pTest->pOutput)) > 0)
+    {
+        fwrite(buffer, 1, size, stdout);
+    }
+    fclose(pTest->pOutput);
+    pTest->pOutput = NULL;
+    fflush(stdout);
+
+    moca_test_report_add(pTest->pSuite, pTest->pTitle, &pTest->result);
+    if (pTest->result.timedOut)
+    {
+        UT_LOG("[parallel] %s: killed after %llu s", pTest->pTitle, (unsigned long long)(gParallelTimeoutNs / 1000000000ULL));
+        UT_FAIL("Test timed out in its worker process");
+    }
+    else if (pTest->result.signal != 0)
+    {
+        UT_LOG("[parallel] %s: worker killed by signal %d (%s)", pTest->pTitle, pTest->result.signal, strsignal(pTest->result.signal));
+        UT_FAIL("Worker process killed by a signal");
+    }
+    else if (pTest->lost)
+    {
+        UT_LOG("[parallel] %s: worker exited before its test ended", pTest->pTitle);
+        UT_FAIL("Worker process exited before its test ended");
+    }
+    else if (pTest->result.failures > 0)
+    {
+        UT_FAIL("Assertions failed in the worker process");
+    }
+}
+
+bool moca_test_parallel_dispatch(uint32_t index, void (*run)(uint32_t index))
+{
+    moca_test_parallel_test_t *pTest;
+
+    if (gParallelWorker)
+    {
+        /* Back in a trampoline, the test of this worker ended on a fatal assertion */
+        moca_test_parallel_worker_exit();
+    }
+    if (index >= gParallelTestCount || moca_test_parallel_jobs() == 0)
+    {
+        return false;
+    }
+    pTest = &gParallelTests[index];
+    if (!moca_test_parallel_is_suite(pTest->pSuite) || moca_test_parallel_is_serial(pTest->pTitle))
+    {
+        return false;
+    }
+    if (!pTest->batched)
+    {
+        moca_test_parallel_run_batch(pTest->pSuite, run);
+    }
+    if (!pTest->started)
+    {
+        return false;
+    }
+    pTest->started = false;
+    moca_test_parallel_replay(pTest);
+    return true;
+}
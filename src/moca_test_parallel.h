@@ -0,0 +1,82 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_test_parallel.h
+*
+* Parallel, process isolated execution of the tests of a suite.
+*
+* When MOCA_TEST_JOBS is set, the tests of the suites marked with
+* moca_test_parallel_suite() run in forked worker processes, up to
+* MOCA_TEST_JOBS of them at once ("auto" or 0 is one per online CPU). The
+* first test of such a suite that CUnit reaches starts the batch: every test
+* of the suite not marked with moca_test_parallel_serial() is forked, and the
+* suite waits for all of them. Each worker inherits the state the suite
+* initialisation left, so a crash, a hang or a HAL state change stays in its
+* copy of the process. Then, as CUnit reaches each test, its captured output
+* is printed, its measurements go to moca_test_report.c and a failure of the
+* worker is reported as one failed assertion of the test. Tests marked serial
+* run in the test binary itself once the batch is over, in their usual order.
+*
+* A worker killed by a signal, or by MOCA_TEST_TIMEOUT seconds (300 by
+* default) passing, fails its test and the suite goes on. Parallel runs are
+* disabled when MOCA_TRACE_RECORD is set, the calls of a worker would not
+* reach the trace.
+*/
+
+#ifndef __MOCA_TEST_PARALLEL_H__
+#define __MOCA_TEST_PARALLEL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ut.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Records the test registered in slot index of the UT_add_test trampolines.
+*/
+void moca_test_parallel_register(uint32_t index, UT_test_suite_t *pSuite, const char *pTitle);
+
+/**
+* @brief Marks a suite whose tests may run in parallel worker processes.
+*/
+void moca_test_parallel_suite(UT_test_suite_t *pSuite);
+
+/**
+* @brief Marks a test that changes state the other tests read, it always runs in the test binary, never alongside another test.
+*/
+void moca_test_parallel_serial(const char *pTitle);
+
+/**
+* @brief Called by the trampoline of a test, runs it in a worker process when its suite runs in parallel.
+*
+* @param index  Slot of the test.
+* @param run    Runs the test of a slot in the calling process, called in the worker.
+*
+* @return true if the test ran in a worker and its result was reported, false if the caller runs it.
+*/
+bool moca_test_parallel_dispatch(uint32_t index, void (*run)(uint32_t index));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_TEST_PARALLEL_H__ */
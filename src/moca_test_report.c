@@ -0,0 +1,355 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_test_report.c
+*
+* Per test measurements and JUnit report, see moca_test_report.h.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_test_report.h"
+
+#define MOCA_TEST_REPORT_SLOWEST    5       /**< Tests listed in the summary */
+#define MOCA_TEST_REPORT_NO_SUITE   MOCA_TEST_REPORT_MAX_SUITES
+
+typedef struct
+{
+    UT_test_suite_t *pSuite;
+    const char *pName;
+} moca_test_report_suite_t;
+
+typedef struct
+{
+    const char *pTitle;
+    uint32_t suite;             /**< Index in gReportSuites, MOCA_TEST_REPORT_NO_SUITE if not known */
+    moca_test_report_result_t result;
+} moca_test_report_entry_t;
+
+/* ut-core runs on CUnit, which keeps one failure record per failed assertion */
+extern unsigned int CU_get_number_of_failures(void);
+
+static moca_test_report_suite_t gReportSuites[MOCA_TEST_REPORT_MAX_SUITES];
+static uint32_t gReportSuiteCount = 0;
+static moca_test_report_entry_t gReportTests[MOCA_TEST_REPORT_MAX_TESTS];
+static uint32_t gReportTestCount = 0;
+static moca_test_report_entry_t *gReportCurrent = NULL;
+static moca_test_report_entry_t *gReportLast = NULL;
+static struct rusage gReportUsageBefore;
+static uint64_t gReportStartNs;
+static unsigned int gReportFailuresBefore;
+
+static uint64_t moca_test_report_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t moca_test_report_timeval_ns(const struct timeval *pBefore, const struct timeval *pAfter)
+{
+    int64_t us = ((int64_t)pAfter->tv_sec - (int64_t)pBefore->tv_sec) * 1000000 +
+                 ((int64_t)pAfter->tv_usec - (int64_t)pBefore->tv_usec);
+
+    return (us > 0) ? (uint64_t)us * 1000 : 0;
+}
+
+void moca_test_report_add_suite(UT_test_suite_t *pSuite, const char *pName)
+{
+    if (pSuite == NULL || gReportSuiteCount >= MOCA_TEST_REPORT_MAX_SUITES)
+    {
+        return;
+    }
+    gReportSuites[gReportSuiteCount].pSuite = pSuite;
+    gReportSuites[gReportSuiteCount].pName = pName;
+    gReportSuiteCount++;
+}
+
+static moca_test_report_entry_t *moca_test_report_new_entry(UT_test_suite_t *pSuite, const char *pTitle)
+{
+    moca_test_report_entry_t *pEntry;
+    uint32_t i;
+
+    if (gReportTestCount >= MOCA_TEST_REPORT_MAX_TESTS)
+    {
+        return NULL;
+    }
+    pEntry = &gReportTests[gReportTestCount++];
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->pTitle = pTitle;
+    pEntry->suite = MOCA_TEST_REPORT_NO_SUITE;
+    for (i = 0; i < gReportSuiteCount; i++)
+    {
+        if (gReportSuites[i].pSuite == pSuite)
+        {
+            pEntry->suite = i;
+            break;
+        }
+    }
+    return pEntry;
+}
+
+static void moca_test_report_log(const moca_test_report_entry_t *pEntry)
+{
+    const moca_test_report_result_t *pResult = &pEntry->result;
+
+    UT_LOG("[time] %s: %.3f ms wall, %.3f ms user, %.3f ms system, %ld voluntary and %ld involuntary context switches",
+           pEntry->pTitle, (double)pResult->wallNs / 1e6, (double)pResult->userNs / 1e6, (double)pResult->systemNs / 1e6,
+           pResult->voluntarySwitches, pResult->involuntarySwitches);
+}
+
+void moca_test_report_begin(UT_test_suite_t *pSuite, const char *pTitle)
+{
+    moca_test_report_entry_t *pEntry = moca_test_report_new_entry(pSuite, pTitle);
+
+    if (pEntry == NULL)
+    {
+        return;
+    }
+    gReportCurrent = pEntry;
+    gReportFailuresBefore = CU_get_number_of_failures();
+    getrusage(RUSAGE_SELF, &gReportUsageBefore);
+    gReportStartNs = moca_test_report_now_ns();
+}
+
+void moca_test_report_end(void)
+{
+    moca_test_report_entry_t *pEntry = gReportCurrent;
+    uint64_t endNs = moca_test_report_now_ns();
+    struct rusage after;
+
+    if (pEntry == NULL)
+    {
+        return;
+    }
+    getrusage(RUSAGE_SELF, &after);
+    gReportCurrent = NULL;
+    gReportLast = pEntry;
+
+    pEntry->result.wallNs = endNs - gReportStartNs;
+    pEntry->result.userNs = moca_test_report_timeval_ns(&gReportUsageBefore.ru_utime, &after.ru_utime);
+    pEntry->result.systemNs = moca_test_report_timeval_ns(&gReportUsageBefore.ru_stime, &after.ru_stime);
+    pEntry->result.voluntarySwitches = after.ru_nvcsw - gReportUsageBefore.ru_nvcsw;
+    pEntry->result.involuntarySwitches = after.ru_nivcsw - gReportUsageBefore.ru_nivcsw;
+    pEntry->result.failures = CU_get_number_of_failures() - gReportFailuresBefore;
+    moca_test_report_log(pEntry);
+}
+
+bool moca_test_report_last(moca_test_report_result_t *pResult)
+{
+    if (gReportLast == NULL || pResult == NULL)
+    {
+        return false;
+    }
+    *pResult = gReportLast->result;
+    return true;
+}
+
+void moca_test_report_add(UT_test_suite_t *pSuite, const char *pTitle, const moca_test_report_result_t *pResult)
+{
+    moca_test_report_entry_t *pEntry = moca_test_report_new_entry(pSuite, pTitle);
+
+    if (pEntry == NULL || pResult == NULL)
+    {
+        return;
+    }
+    pEntry->result = *pResult;
+    gReportLast = pEntry;
+}
+
+/* Time the test spent neither on a CPU of its own nor of its threads, waiting for a driver or sleeping */
+static uint64_t moca_test_report_off_cpu_ns(const moca_test_report_entry_t *pEntry)
+{
+    uint64_t cpuNs = pEntry->result.userNs + pEntry->result.systemNs;
+
+    return (pEntry->result.wallNs > cpuNs) ? pEntry->result.wallNs - cpuNs : 0;
+}
+
+static void moca_test_report_log_slowest(void)
+{
+    const moca_test_report_entry_t *slowest[MOCA_TEST_REPORT_SLOWEST] = { NULL };
+    uint32_t i, j;
+
+    for (i = 0; i < gReportTestCount; i++)
+    {
+        const moca_test_report_entry_t *pEntry = &gReportTests[i];
+
+        for (j = 0; j < MOCA_TEST_REPORT_SLOWEST; j++)
+        {
+            if (slowest[j] == NULL || pEntry->result.wallNs > slowest[j]->result.wallNs)
+            {
+                memmove(&slowest[j + 1], &slowest[j], (MOCA_TEST_REPORT_SLOWEST - j - 1) * sizeof(slowest[0]));
+                slowest[j] = pEntry;
+                break;
+            }
+        }
+    }
+    for (j = 0; j < MOCA_TEST_REPORT_SLOWEST && slowest[j] != NULL; j++)
+    {
+        UT_LOG("[time] slowest %u: %s, %.3f ms wall of which %.3f ms off CPU", j + 1, slowest[j]->pTitle,
+               (double)slowest[j]->result.wallNs / 1e6, (double)moca_test_report_off_cpu_ns(slowest[j]) / 1e6);
+    }
+}
+
+static void moca_test_report_xml_escaped(FILE *pFile, const char *pText)
+{
+    for (; *pText != '\0'; pText++)
+    {
+        switch (*pText)
+        {
+            case '&':
+                fputs("&amp;", pFile);
+                break;
+            case '<':
+                fputs("&lt;", pFile);
+                break;
+            case '>':
+                fputs("&gt;", pFile);
+                break;
+            case '"':
+                fputs("&quot;", pFile);
+                break;
+            default:
+                fputc(*pText, pFile);
+                break;
+        }
+    }
+}
+
+static const char *moca_test_report_suite_name(uint32_t suite)
+{
+    return (suite < gReportSuiteCount && gReportSuites[suite].pName != NULL) ? gReportSuites[suite].pName : "moca_hal";
+}
+
+/* A test whose process was killed did not finish, which JUnit reports as an error rather than a failure */
+static uint32_t moca_test_report_errored(const moca_test_report_entry_t *pEntry)
+{
+    return (pEntry->result.timedOut || pEntry->result.signal != 0) ? 1 : 0;
+}
+
+static void moca_test_report_write_testcase(FILE *pFile, const moca_test_report_entry_t *pEntry)
+{
+    fputs("    <testcase classname=\"", pFile);
+    moca_test_report_xml_escaped(pFile, moca_test_report_suite_name(pEntry->suite));
+    fputs("\" name=\"", pFile);
+    moca_test_report_xml_escaped(pFile, pEntry->pTitle);
+    fprintf(pFile, "\" time=\"%.6f\">\n", (double)pEntry->result.wallNs / 1e9);
+    fputs("      <properties>\n", pFile);
+    fprintf(pFile, "        <property name=\"user_cpu_ms\" value=\"%.3f\"/>\n", (double)pEntry->result.userNs / 1e6);
+    fprintf(pFile, "        <property name=\"system_cpu_ms\" value=\"%.3f\"/>\n", (double)pEntry->result.systemNs / 1e6);
+    fprintf(pFile, "        <property name=\"off_cpu_ms\" value=\"%.3f\"/>\n", (double)moca_test_report_off_cpu_ns(pEntry) / 1e6);
+    fprintf(pFile, "        <property name=\"voluntary_context_switches\" value=\"%ld\"/>\n", pEntry->result.voluntarySwitches);
+    fprintf(pFile, "        <property name=\"involuntary_context_switches\" value=\"%ld\"/>\n", pEntry->result.involuntarySwitches);
+    fputs("      </properties>\n", pFile);
+    if (pEntry->result.timedOut)
+    {
+        fputs("      <error type=\"timeout\" message=\"Killed for taking too long\"/>\n", pFile);
+    }
+    else if (pEntry->result.signal != 0)
+    {
+        fprintf(pFile, "      <error type=\"signal\" message=\"Killed by signal %d\"/>\n", pEntry->result.signal);
+    }
+    if (pEntry->result.failures > 0)
+    {
+        fprintf(pFile, "      <failure type=\"assertion\" message=\"%u failed assertions\"/>\n", pEntry->result.failures);
+    }
+    fputs("    </testcase>\n", pFile);
+}
+
+int moca_test_report_write(void)
+{
+    const char *pPath = getenv("MOCA_TEST_REPORT");
+    uint64_t totalNs = 0;
+    uint32_t totalFailures = 0, totalErrors = 0;
+    uint32_t suite, i;
+    FILE *pFile;
+    int status;
+
+    moca_test_report_log_slowest();
+    if (pPath == NULL || *pPath == '\0')
+    {
+        return 0;
+    }
+    pFile = fopen(pPath, "w");
+    if (pFile == NULL)
+    {
+        UT_LOG("[time] Cannot write the test report to %s", pPath);
+        return -1;
+    }
+    for (i = 0; i < gReportTestCount; i++)
+    {
+        totalNs += gReportTests[i].result.wallNs;
+        totalFailures += (gReportTests[i].result.failures > 0);
+        totalErrors += moca_test_report_errored(&gReportTests[i]);
+    }
+    fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", pFile);
+    fprintf(pFile, "<testsuites name=\"moca_hal\" tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.6f\">\n",
+            gReportTestCount, totalFailures, totalErrors, (double)totalNs / 1e9);
+    /* Suites in registration order, then the tests of suites registered without the wrapper */
+    for (suite = 0; suite <= gReportSuiteCount; suite++)
+    {
+        uint32_t tests = 0, failures = 0, errors = 0;
+        uint64_t suiteNs = 0;
+
+        if (suite == gReportSuiteCount)
+        {
+            suite = MOCA_TEST_REPORT_NO_SUITE;
+        }
+        for (i = 0; i < gReportTestCount; i++)
+        {
+            if (gReportTests[i].suite == suite)
+            {
+                tests++;
+                failures += (gReportTests[i].result.failures > 0);
+                errors += moca_test_report_errored(&gReportTests[i]);
+                suiteNs += gReportTests[i].result.wallNs;
+            }
+        }
+        if (tests > 0)
+        {
+            fputs("  <testsuite name=\"", pFile);
+            moca_test_report_xml_escaped(pFile, moca_test_report_suite_name(suite));
+            fprintf(pFile, "\" tests=\"%u\" failures=\"%u\" errors=\"%u\" skipped=\"0\" time=\"%.6f\">\n",
+                    tests, failures, errors, (double)suiteNs / 1e9);
+            for (i = 0; i < gReportTestCount; i++)
+            {
+                if (gReportTests[i].suite == suite)
+                {
+                    moca_test_report_write_testcase(pFile, &gReportTests[i]);
+                }
+            }
+            fputs("  </testsuite>\n", pFile);
+        }
+    }
+    fputs("</testsuites>\n", pFile);
+    status = ferror(pFile) ? -1 : 0;
+    if (fclose(pFile) != 0)
+    {
+        status = -1;
+    }
+    UT_LOG("[time] JUnit report of %u tests written to %s%s", gReportTestCount, pPath, (status == 0) ? "" : " with errors");
+    return status;
+}
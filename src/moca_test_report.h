@@ -0,0 +1,104 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_test_report.h
+*
+* Per test wall clock, CPU time and context switches, and a JUnit report.
+*
+* The UT_add_test trampolines of moca_alloc_report.c run every test between
+* moca_test_report_begin() and moca_test_report_end(). The figures of each
+* test are logged when it ends. CPU time and context switches are those of
+* the whole process, so they include the threads a test or the HAL starts.
+*
+* When MOCA_TEST_REPORT names a file, moca_test_report_write() writes a
+* JUnit XML report of every test to it, with the figures as properties, so a
+* CI server shows slow or blocking HAL calls next to the test results.
+*/
+
+#ifndef __MOCA_TEST_REPORT_H__
+#define __MOCA_TEST_REPORT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ut.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCA_TEST_REPORT_MAX_TESTS    256
+#define MOCA_TEST_REPORT_MAX_SUITES   32
+
+/**
+* @brief Measurements and outcome of one test.
+*/
+typedef struct
+{
+  uint64_t wallNs;
+  uint64_t userNs;
+  uint64_t systemNs;
+  long voluntarySwitches;
+  long involuntarySwitches;
+  unsigned int failures;      /**< Failed assertions */
+  int signal;                 /**< Signal that killed the process running the test, 0 if none */
+  bool timedOut;              /**< The process running the test was killed for taking too long */
+} moca_test_report_result_t;
+
+/**
+* @brief Remembers the name of a suite for the report, called by the UT_add_suite wrapper.
+*/
+void moca_test_report_add_suite(UT_test_suite_t *pSuite, const char *pName);
+
+/**
+* @brief Starts measuring a test.
+*
+* @param[in] pSuite - Suite the test was registered in.
+* @param[in] pTitle - Test title, must outlive the report.
+*/
+void moca_test_report_begin(UT_test_suite_t *pSuite, const char *pTitle);
+
+/**
+* @brief Ends the measurement started by moca_test_report_begin() and logs it.
+*/
+void moca_test_report_end(void);
+
+/**
+* @brief Reads the result of the last test measured with moca_test_report_begin() and moca_test_report_end().
+*
+* @return false if no test was measured.
+*/
+bool moca_test_report_last(moca_test_report_result_t *pResult);
+
+/**
+* @brief Adds a test measured elsewhere, by a test worker process that logged its figures, to the report.
+*/
+void moca_test_report_add(UT_test_suite_t *pSuite, const char *pTitle, const moca_test_report_result_t *pResult);
+
+/**
+* @brief Writes the JUnit report to the MOCA_TEST_REPORT file, does nothing if it is not set.
+*
+* @return 0 on success or when no report is wanted, -1 if the file could not be written.
+*/
+int moca_test_report_write(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_TEST_REPORT_H__ */
@@ -0,0 +1,493 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_trace_record.c
+*
+* HAL call recorder, see moca_trace_record.h.
+*
+* Records are staged in a static buffer and written with write(2), so the
+* recorder allocates nothing and stays out of the moca_alloc accounting of
+* the test that made the call. The buffer is flushed when full and at exit,
+* a run that crashes loses its last records but leaves a readable trace.
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include "moca_trace.h"
+#include "moca_trace_record.h"
+
+#define MOCA_TRACE_BUFFER_SIZE  (1024 * 1024)
+
+typedef struct
+{
+    const void *pData;
+    size_t size;
+} moca_trace_part_t;
+
+typedef struct
+{
+    uint64_t startNs;
+    uint64_t endNs;
+    int32_t ret;
+} moca_trace_result_t;
+
+extern INT __real_moca_GetNumAssociatedDevices(ULONG ifIndex, ULONG* pulCount);
+
+static pthread_once_t gTraceOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t gTraceLock = PTHREAD_MUTEX_INITIALIZER;
+static int gTraceFd = -1;
+static uint64_t gTraceStartNs = 0;
+static uint8_t gTraceBuffer[MOCA_TRACE_BUFFER_SIZE];
+static size_t gTraceUsed = 0;
+static __thread moca_trace_result_t gThreadResult;
+
+static uint64_t moca_trace_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void moca_trace_write_fd(const void *pData, size_t size)
+{
+    const uint8_t *pByte = pData;
+    ssize_t written;
+
+    while (size > 0 && gTraceFd >= 0)
+    {
+        written = write(gTraceFd, pByte, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            fprintf(stderr, "moca_trace: write failed, recording stopped\n");
+            close(gTraceFd);
+            gTraceFd = -1;
+            return;
+        }
+        pByte += written;
+        size -= (size_t)written;
+    }
+}
+
+static void moca_trace_flush(void)
+{
+    moca_trace_write_fd(gTraceBuffer, gTraceUsed);
+    gTraceUsed = 0;
+}
+
+/* Caller holds gTraceLock */
+static void moca_trace_append(const void *pData, size_t size)
+{
+    if (gTraceUsed + size > sizeof(gTraceBuffer))
+    {
+        moca_trace_flush();
+        if (size > sizeof(gTraceBuffer))
+        {
+            moca_trace_write_fd(pData, size);
+            return;
+        }
+    }
+    memcpy(gTraceBuffer + gTraceUsed, pData, size);
+    gTraceUsed += size;
+}
+
+static void moca_trace_close(void)
+{
+    pthread_mutex_lock(&gTraceLock);
+    moca_trace_flush();
+    if (gTraceFd >= 0)
+    {
+        close(gTraceFd);
+        gTraceFd = -1;
+    }
+    pthread_mutex_unlock(&gTraceLock);
+}
+
+static void moca_trace_open(void)
+{
+    const char *pPath = getenv("MOCA_TRACE_RECORD");
+    moca_trace_header_t header;
+
+    if (pPath == NULL || pPath[0] == '\0')
+    {
+        return;
+    }
+    gTraceFd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (gTraceFd < 0)
+    {
+        fprintf(stderr, "moca_trace: cannot create [%s], recording disabled\n", pPath);
+        return;
+    }
+    gTraceStartNs = moca_trace_now_ns();
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MOCA_TRACE_MAGIC, sizeof(header.magic));
+    header.version = MOCA_TRACE_VERSION;
+    header.headerSize = sizeof(header);
+    header.layout = moca_trace_layout();
+    header.startNs = gTraceStartNs;
+    moca_trace_append(&header, sizeof(header));
+    atexit(moca_trace_close);
+}
+
+uint64_t moca_trace_begin(void)
+{
+    uint64_t now;
+
+    pthread_once(&gTraceOnce, moca_trace_open);
+    if (gTraceFd < 0)
+    {
+        return 0;
+    }
+    now = moca_trace_now_ns();
+    return (now == 0) ? 1 : now;
+}
+
+void moca_trace_end(uint64_t startNs, int32_t ret)
+{
+    gThreadResult.startNs = startNs;
+    gThreadResult.endNs = moca_trace_now_ns();
+    gThreadResult.ret = ret;
+}
+
+/* Writes the record of the call completed by moca_trace_end(), the first inputParts parts are the input payload */
+static void moca_trace_write(moca_trace_api_t api, uint32_t flags, ULONG ifIndex, uint64_t value,
+                             const moca_trace_part_t *pParts, size_t inputParts, size_t partCount)
+{
+    static const uint8_t padding[MOCA_TRACE_ALIGN];
+    moca_trace_record_t record;
+    size_t i;
+
+    memset(&record, 0, sizeof(record));
+    record.api = api;
+    record.flags = flags;
+    record.durationNs = gThreadResult.endNs - gThreadResult.startNs;
+    record.ret = gThreadResult.ret;
+    record.ifIndex = (uint32_t)ifIndex;
+    record.value = value;
+    for (i = 0; i < partCount; i++)
+    {
+        if (i < inputParts)
+        {
+            record.inputSize += (uint32_t)pParts[i].size;
+        }
+        else
+        {
+            record.outputSize += (uint32_t)pParts[i].size;
+        }
+    }
+
+    pthread_mutex_lock(&gTraceLock);
+    if (gTraceFd >= 0)
+    {
+        record.startNs = (gThreadResult.startNs > gTraceStartNs) ? gThreadResult.startNs - gTraceStartNs : 0;
+        moca_trace_append(&record, sizeof(record));
+        for (i = 0; i < partCount; i++)
+        {
+            moca_trace_append(pParts[i].pData, pParts[i].size);
+        }
+        moca_trace_append(padding, MOCA_TRACE_RECORD_SIZE(&record) - sizeof(record) - record.inputSize - record.outputSize);
+    }
+    pthread_mutex_unlock(&gTraceLock);
+}
+
+/* Call returning one structure through pData */
+static void moca_trace_write_struct(moca_trace_api_t api, ULONG ifIndex, const void *pData, size_t size)
+{
+    moca_trace_part_t part = { pData, size };
+
+    if (pData == NULL)
+    {
+        moca_trace_write(api, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write(api, 0, ifIndex, 0, &part, 0, (gThreadResult.ret == STATUS_SUCCESS) ? 1 : 0);
+}
+
+/* Call returning count entries of entrySize bytes */
+static void moca_trace_write_array(moca_trace_api_t api, ULONG ifIndex, BOOL nullArgument, const void *pEntries,
+                                   ULONG count, size_t entrySize)
+{
+    moca_trace_part_t part = { pEntries, count * entrySize };
+
+    if (nullArgument)
+    {
+        moca_trace_write(api, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    if (gThreadResult.ret != STATUS_SUCCESS || pEntries == NULL)
+    {
+        count = 0;
+        part.size = 0;
+    }
+    moca_trace_write(api, 0, ifIndex, count, &part, 0, (part.size > 0) ? 1 : 0);
+}
+
+void moca_trace_record_moca_GetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_GetIfConfig, ifIndex, pmoca_config, sizeof(moca_cfg_t));
+}
+
+void moca_trace_record_moca_SetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config)
+{
+    moca_trace_part_t part = { pmoca_config, sizeof(moca_cfg_t) };
+
+    if (pmoca_config == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_SetIfConfig, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write(MOCA_TRACE_API_SetIfConfig, 0, ifIndex, 0, &part, 1, 1);
+}
+
+void moca_trace_record_moca_IfGetDynamicInfo(ULONG ifIndex, moca_dynamic_info_t* pmoca_dynamic_info)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetDynamicInfo, ifIndex, pmoca_dynamic_info, sizeof(moca_dynamic_info_t));
+}
+
+void moca_trace_record_moca_IfGetStaticInfo(ULONG ifIndex, moca_static_info_t* pmoca_static_info)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetStaticInfo, ifIndex, pmoca_static_info, sizeof(moca_static_info_t));
+}
+
+void moca_trace_record_moca_IfGetStats(ULONG ifIndex, moca_stats_t* pmoca_stats)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetStats, ifIndex, pmoca_stats, sizeof(moca_stats_t));
+}
+
+void moca_trace_record_moca_GetNumAssociatedDevices(ULONG ifIndex, ULONG* pulCount)
+{
+    if (pulCount == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_GetNumAssociatedDevices, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write(MOCA_TRACE_API_GetNumAssociatedDevices, 0, ifIndex,
+                     (gThreadResult.ret == STATUS_SUCCESS) ? *pulCount : 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_IfGetExtCounter(ULONG ifIndex, moca_mac_counters_t* pmoca_mac_counters)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetExtCounter, ifIndex, pmoca_mac_counters, sizeof(moca_mac_counters_t));
+}
+
+void moca_trace_record_moca_IfGetExtAggrCounter(ULONG ifIndex, moca_aggregate_counters_t* pmoca_aggregate_counts)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetExtAggrCounter, ifIndex, pmoca_aggregate_counts, sizeof(moca_aggregate_counters_t));
+}
+
+void moca_trace_record_moca_GetMocaCPEs(ULONG ifIndex, moca_cpe_t* cpes, INT* pnum_cpes)
+{
+    BOOL nullArgument = (cpes == NULL || pnum_cpes == NULL);
+    ULONG count = (nullArgument || *pnum_cpes < 0) ? 0 : (ULONG)*pnum_cpes;
+
+    moca_trace_write_array(MOCA_TRACE_API_GetMocaCPEs, ifIndex, nullArgument, cpes, count, sizeof(moca_cpe_t));
+}
+
+void moca_trace_record_moca_GetAssociatedDevices(ULONG ifIndex, moca_associated_device_t** ppdevice_array)
+{
+    /* The API returns no count, and a call of the recorder's own to learn it would change the session recorded */
+    if (ppdevice_array != NULL && *ppdevice_array != NULL && gThreadResult.ret == STATUS_SUCCESS)
+    {
+        moca_trace_write(MOCA_TRACE_API_GetAssociatedDevices, MOCA_TRACE_FLAG_UNKNOWN_COUNT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write_array(MOCA_TRACE_API_GetAssociatedDevices, ifIndex, (ppdevice_array == NULL), NULL, 0,
+                           sizeof(moca_associated_device_t));
+}
+
+void moca_trace_record_moca_FreqMaskToValue(UCHAR* mask)
+{
+    moca_trace_part_t part = { mask, 0 };
+
+    if (mask == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_FreqMaskToValue, MOCA_TRACE_FLAG_NULL_ARGUMENT, 0, 0, NULL, 0, 0);
+        return;
+    }
+    part.size = strlen((const char *)mask) + 1;
+    moca_trace_write(MOCA_TRACE_API_FreqMaskToValue, 0, 0, 0, &part, 1, 1);
+}
+
+void moca_trace_record_moca_HardwareEquipped(void)
+{
+    moca_trace_write(MOCA_TRACE_API_HardwareEquipped, 0, 0, 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_GetFullMeshRates(ULONG ifIndex, moca_mesh_table_t* pDeviceArray, ULONG* pulCount)
+{
+    BOOL nullArgument = (pDeviceArray == NULL || pulCount == NULL);
+
+    moca_trace_write_array(MOCA_TRACE_API_GetFullMeshRates, ifIndex, nullArgument, pDeviceArray,
+                           nullArgument ? 0 : *pulCount, sizeof(moca_mesh_table_t));
+}
+
+void moca_trace_record_moca_GetFlowStatistics(ULONG ifIndex, moca_flow_table_t* pDeviceArray, ULONG* pulCount)
+{
+    BOOL nullArgument = (pDeviceArray == NULL || pulCount == NULL);
+
+    moca_trace_write_array(MOCA_TRACE_API_GetFlowStatistics, ifIndex, nullArgument, pDeviceArray,
+                           nullArgument ? 0 : *pulCount, sizeof(moca_flow_table_t));
+}
+
+void moca_trace_record_moca_GetResetCount(ULONG* resetcnt)
+{
+    if (resetcnt == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_GetResetCount, MOCA_TRACE_FLAG_NULL_ARGUMENT, 0, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write(MOCA_TRACE_API_GetResetCount, 0, 0, (gThreadResult.ret == STATUS_SUCCESS) ? *resetcnt : 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_setIfAcaConfig(int interfaceIndex, moca_aca_cfg_t acaCfg)
+{
+    moca_trace_part_t part = { &acaCfg, sizeof(acaCfg) };
+
+    moca_trace_write(MOCA_TRACE_API_setIfAcaConfig, 0, (ULONG)interfaceIndex, 0, &part, 1, 1);
+}
+
+void moca_trace_record_moca_getIfAcaConfig(int interfaceIndex, moca_aca_cfg_t* acaCfg)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_getIfAcaConfig, (ULONG)interfaceIndex, acaCfg, sizeof(moca_aca_cfg_t));
+}
+
+void moca_trace_record_moca_cancelIfAca(int interfaceIndex)
+{
+    moca_trace_write(MOCA_TRACE_API_cancelIfAca, 0, (ULONG)interfaceIndex, 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_getIfAcaStatus(int interfaceIndex, moca_aca_stat_t* pacaStat)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_getIfAcaStatus, (ULONG)interfaceIndex, pacaStat, sizeof(moca_aca_stat_t));
+}
+
+void moca_trace_record_moca_getIfScmod(int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat)
+{
+    BOOL nullArgument = (pnumOfEntries == NULL || ppscmodStat == NULL);
+    ULONG count = (nullArgument || *pnumOfEntries < 0) ? 0 : (ULONG)*pnumOfEntries;
+
+    moca_trace_write_array(MOCA_TRACE_API_getIfScmod, (ULONG)interfaceIndex, nullArgument,
+                           nullArgument ? NULL : *ppscmodStat, count, sizeof(moca_scmod_stat_t));
+}
+
+void moca_trace_record_moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc)
+{
+    moca_trace_write(MOCA_TRACE_API_associatedDevice_callback_register, 0, 0, (callback_proc != NULL) ? 1 : 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot)
+{
+    moca_trace_write_struct(MOCA_TRACE_API_IfGetTelemetrySnapshot, ifIndex, pSnapshot, sizeof(moca_telemetry_snapshot_t));
+}
+
+void moca_trace_record_moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount)
+{
+    moca_trace_part_t parts[2] = { { &capacity, sizeof(capacity) }, { pDevices, 0 } };
+    ULONG required = 0;
+
+    if (pCount == NULL || (pDevices == NULL && capacity > 0))
+    {
+        moca_trace_write(MOCA_TRACE_API_GetAssociatedDevicesInto, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, parts, 1, 1);
+        return;
+    }
+    if (gThreadResult.ret == STATUS_SUCCESS)
+    {
+        parts[1].size = *pCount * sizeof(moca_associated_device_t);
+        moca_trace_write(MOCA_TRACE_API_GetAssociatedDevicesInto, 0, ifIndex, *pCount, parts, 1, 2);
+        return;
+    }
+    /* *pCount is only written when the capacity was too small, ask the HAL rather than trusting it */
+    if (__real_moca_GetNumAssociatedDevices(ifIndex, &required) != STATUS_SUCCESS || required <= capacity)
+    {
+        required = 0;
+    }
+    moca_trace_write(MOCA_TRACE_API_GetAssociatedDevicesInto, 0, ifIndex, required, parts, 1, 1);
+}
+
+void moca_trace_record_moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta)
+{
+    moca_trace_part_t parts[2] = { { &generation, sizeof(generation) }, { pDelta, sizeof(moca_stats_delta_t) } };
+
+    if (pDelta == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_IfGetStatsChangedSince, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, parts, 1, 1);
+        return;
+    }
+    moca_trace_write(MOCA_TRACE_API_IfGetStatsChangedSince, 0, ifIndex, 0, parts, 1,
+                     (gThreadResult.ret == STATUS_SUCCESS) ? 2 : 1);
+}
+
+void moca_trace_record_moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity,
+                                                  ULONG *pCount, ULONG *pNextCursor)
+{
+    ULONG input[2] = { cursor, capacity };
+    moca_trace_part_t parts[3] = { { input, sizeof(input) }, { pNextCursor, sizeof(ULONG) }, { pFlows, 0 } };
+
+    if (pFlows == NULL || pCount == NULL || pNextCursor == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_GetFlowStatisticsPage, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, parts, 1, 1);
+        return;
+    }
+    if (gThreadResult.ret != STATUS_SUCCESS)
+    {
+        moca_trace_write(MOCA_TRACE_API_GetFlowStatisticsPage, 0, ifIndex, 0, parts, 1, 1);
+        return;
+    }
+    parts[2].size = *pCount * sizeof(moca_flow_table_t);
+    moca_trace_write(MOCA_TRACE_API_GetFlowStatisticsPage, 0, ifIndex, *pCount, parts, 1, 3);
+}
+
+void moca_trace_record_moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext)
+{
+    moca_trace_part_t part = { &acaCfg, sizeof(acaCfg) };
+
+    (void)pContext;
+    moca_trace_write(MOCA_TRACE_API_startIfAcaAsync, 0, (ULONG)interfaceIndex, (callback != NULL) ? 1 : 0, &part, 1, 1);
+}
+
+void moca_trace_record_moca_getIfAcaEventFd(int interfaceIndex)
+{
+    moca_trace_write(MOCA_TRACE_API_getIfAcaEventFd, 0, (ULONG)interfaceIndex, 0, NULL, 0, 0);
+}
+
+void moca_trace_record_moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult)
+{
+    moca_trace_part_t parts[3] = { { pConfig, sizeof(moca_cfg_t) }, { &fieldMask, sizeof(fieldMask) }, { pResult, sizeof(moca_cfg_apply_result_t) } };
+
+    if (pConfig == NULL)
+    {
+        moca_trace_write(MOCA_TRACE_API_SetIfConfigFields, MOCA_TRACE_FLAG_NULL_ARGUMENT, ifIndex, 0, NULL, 0, 0);
+        return;
+    }
+    moca_trace_write(MOCA_TRACE_API_SetIfConfigFields, 0, ifIndex, 0, parts, 2,
+                     (pResult != NULL && gThreadResult.ret == STATUS_SUCCESS) ? 3 : 2);
+}
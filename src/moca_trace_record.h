@@ -0,0 +1,86 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file moca_trace_record.h
+*
+* Records every HAL call of the test binary to a trace file, see moca_trace.h.
+*
+* Recording is enabled by naming the trace file in the MOCA_TRACE_RECORD
+* environment variable. The link time wrappers of moca_hal_wrap.c time each
+* call with moca_trace_begin() and moca_trace_end(), then hand the arguments,
+* now holding the returned structures, to moca_trace_record_<api>().
+*/
+
+#ifndef __MOCA_TRACE_RECORD_H__
+#define __MOCA_TRACE_RECORD_H__
+
+#include <stdint.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Starts timing a HAL call.
+*
+* @return The start time to pass to moca_trace_end(), 0 when recording is disabled.
+*/
+uint64_t moca_trace_begin(void);
+
+/**
+* @brief Completes the timing of a HAL call and keeps its result for the moca_trace_record_<api>() call that follows on this thread.
+*/
+void moca_trace_end(uint64_t startNs, int32_t ret);
+
+void moca_trace_record_moca_GetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config);
+void moca_trace_record_moca_SetIfConfig(ULONG ifIndex, moca_cfg_t* pmoca_config);
+void moca_trace_record_moca_IfGetDynamicInfo(ULONG ifIndex, moca_dynamic_info_t* pmoca_dynamic_info);
+void moca_trace_record_moca_IfGetStaticInfo(ULONG ifIndex, moca_static_info_t* pmoca_static_info);
+void moca_trace_record_moca_IfGetStats(ULONG ifIndex, moca_stats_t* pmoca_stats);
+void moca_trace_record_moca_GetNumAssociatedDevices(ULONG ifIndex, ULONG* pulCount);
+void moca_trace_record_moca_IfGetExtCounter(ULONG ifIndex, moca_mac_counters_t* pmoca_mac_counters);
+void moca_trace_record_moca_IfGetExtAggrCounter(ULONG ifIndex, moca_aggregate_counters_t* pmoca_aggregate_counts);
+void moca_trace_record_moca_GetMocaCPEs(ULONG ifIndex, moca_cpe_t* cpes, INT* pnum_cpes);
+void moca_trace_record_moca_GetAssociatedDevices(ULONG ifIndex, moca_associated_device_t** ppdevice_array);
+void moca_trace_record_moca_FreqMaskToValue(UCHAR* mask);
+void moca_trace_record_moca_HardwareEquipped(void);
+void moca_trace_record_moca_GetFullMeshRates(ULONG ifIndex, moca_mesh_table_t* pDeviceArray, ULONG* pulCount);
+void moca_trace_record_moca_GetFlowStatistics(ULONG ifIndex, moca_flow_table_t* pDeviceArray, ULONG* pulCount);
+void moca_trace_record_moca_GetResetCount(ULONG* resetcnt);
+void moca_trace_record_moca_setIfAcaConfig(int interfaceIndex, moca_aca_cfg_t acaCfg);
+void moca_trace_record_moca_getIfAcaConfig(int interfaceIndex, moca_aca_cfg_t* acaCfg);
+void moca_trace_record_moca_cancelIfAca(int interfaceIndex);
+void moca_trace_record_moca_getIfAcaStatus(int interfaceIndex, moca_aca_stat_t* pacaStat);
+void moca_trace_record_moca_getIfScmod(int interfaceIndex, int* pnumOfEntries, moca_scmod_stat_t** ppscmodStat);
+void moca_trace_record_moca_associatedDevice_callback_register(moca_associatedDevice_callback callback_proc);
+void moca_trace_record_moca_IfGetTelemetrySnapshot(ULONG ifIndex, moca_telemetry_snapshot_t *pSnapshot);
+void moca_trace_record_moca_GetAssociatedDevicesInto(ULONG ifIndex, moca_associated_device_t *pDevices, ULONG capacity, ULONG *pCount);
+void moca_trace_record_moca_IfGetStatsChangedSince(ULONG ifIndex, uint64_t generation, moca_stats_delta_t *pDelta);
+void moca_trace_record_moca_GetFlowStatisticsPage(ULONG ifIndex, ULONG cursor, moca_flow_table_t *pFlows, ULONG capacity, ULONG *pCount, ULONG *pNextCursor);
+void moca_trace_record_moca_startIfAcaAsync(int interfaceIndex, moca_aca_cfg_t acaCfg, moca_aca_complete_callback callback, void *pContext);
+void moca_trace_record_moca_getIfAcaEventFd(int interfaceIndex);
+void moca_trace_record_moca_SetIfConfigFields(ULONG ifIndex, const moca_cfg_t *pConfig, ULONG fieldMask, moca_cfg_apply_result_t *pResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCA_TRACE_RECORD_H__ */
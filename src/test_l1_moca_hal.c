@@ -33,10 +33,21 @@
 #include <ut.h>
 #include <ut_log.h>
 #include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include "moca_test_parallel.h"
 #include <limits.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
 
 extern int init_moca_hal_init(void);
 
@@ -211,8 +222,12 @@ void test_l1_moca_hal_positive1_moca_SetIfConfig( void )
     UT_LOG("Entering test_l1_moca_hal_positive1_moca_SetIfConfig...");
 
     ULONG ifIndex = 0;
-    moca_cfg_t *pmoca_config;
-    
+    moca_cfg_t mocaConfig;
+    moca_cfg_t *pmoca_config = &mocaConfig;
+
+    // Start from the current configuration so every field is valid
+    UT_ASSERT_EQUAL(moca_GetIfConfig(ifIndex, pmoca_config), STATUS_SUCCESS);
+
     UT_LOG("Invoking moca_SetIfConfig.");
     INT ret = moca_SetIfConfig(ifIndex, pmoca_config);
     UT_LOG("Return: ret = %d", ret);
@@ -474,7 +489,7 @@ void test_l1_moca_hal_positive1_moca_GetMocaCPEs(void) {
     UT_LOG("Entering test_l1_moca_hal_positive1_moca_GetMocaCPEs...");
 
     ULONG ifIndex = 0;
-    moca_cpe_t cpes[10];
+    moca_cpe_t cpes[kMoca_MaxCpeList];
     INT num_cpes = 0;
     UT_LOG("Invoking moca_GetMocaCPEs with valid interface index and memory allocation for output parameter.");
     INT status = moca_GetMocaCPEs(ifIndex, cpes, &num_cpes);
@@ -613,7 +628,7 @@ void test_l1_moca_hal_positive1_moca_GetFullMeshRates(void) {
     
     //Input Parameters
     ULONG ifIndex = 1;
-    moca_mesh_table_t *pDeviceArray;
+    moca_mesh_table_t pDeviceArray[kMoca_MaxMocaNodes * kMoca_MaxMocaNodes];
     ULONG pulCount = 0;
 
     //Invoking moca_GetFullMeshRates with valid inputs
@@ -679,12 +694,13 @@ void test_l1_moca_hal_positive1_moca_GetFlowStatistics(void) {
     UT_LOG("Entering test_l1_moca_hal_positive1_moca_GetFlowStatistics...");
 
     ULONG ifIndex = 0;
-    moca_flow_table_t pDeviceArray;
+    // The API carries no capacity, size the table generously
+    moca_flow_table_t pDeviceArray[kMoca_MaxCpeList];
     ULONG num_cpes;
 
     /* Test implementation */
     UT_LOG("Invoking moca_GetFlowStatistics with ifIndex = %lu, cpes = valid memory location, num_cpes = valid memory location");
-    INT ret = moca_GetFlowStatistics(ifIndex, &pDeviceArray, &num_cpes);
+    INT ret = moca_GetFlowStatistics(ifIndex, pDeviceArray, &num_cpes);
 
     /* Test description */
     UT_LOG("Output: ret = %d", ret);
@@ -760,7 +776,8 @@ void test_l1_moca_hal_positive1_moca_GetAssociatedDevices(void) {
 
     // Input
     ULONG ifIndex = 0;
-    moca_associated_device_t **ppdevice_array;
+    moca_associated_device_t *pdevice_array = NULL;
+    moca_associated_device_t **ppdevice_array = &pdevice_array;
     
     
     // Invoking API
@@ -774,6 +791,9 @@ void test_l1_moca_hal_positive1_moca_GetAssociatedDevices(void) {
     // Assertion
     UT_ASSERT_EQUAL(status, STATUS_SUCCESS);
 
+    // The array is allocated by the HAL and owned by the caller
+    free(pdevice_array);
+
     UT_LOG("Exiting test_l1_moca_hal_positive1_moca_GetAssociatedDevices...");
 }
 
@@ -876,7 +896,7 @@ void test_l1_moca_hal_positive1_moca_HardwareEquipped( void )
     
     BOOL result = moca_HardwareEquipped();
     UT_LOG("Result: %d\n", result);
-    if(access("/dev/bmoca0") == 0)
+    if(access("/dev/bmoca0", F_OK) == 0)
     {
     UT_ASSERT_EQUAL(TRUE, result);
     }
@@ -940,7 +960,7 @@ void test_l1_moca_hal_positive1_moca_getIfScmod(void)
 
     int interfaceIndex = 0;
     int numOfEntries = 0;
-    moca_scmod_stat_t *pscmodStat;
+    moca_scmod_stat_t *pscmodStat = NULL;
     
     // Invoke the API
     UT_LOG("Invoking moca_getIfScmod.");
@@ -949,6 +969,9 @@ void test_l1_moca_hal_positive1_moca_getIfScmod(void)
     // Validate the return status
     UT_ASSERT_EQUAL(status, STATUS_SUCCESS);
 
+    // The array is allocated by the HAL and owned by the caller
+    free(pscmodStat);
+
     UT_LOG("Exiting test_l1_moca_hal_positive1_moca_getIfScmod...");
 }
 
@@ -1248,6 +1271,9 @@ void test_l1_moca_hal_positive1_moca_setIfAcaConfig(void) {
     int interfaceIndex = 0;
     moca_aca_cfg_t config;
 
+    // Start from the current configuration so every field is valid
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig(interfaceIndex, &config), STATUS_SUCCESS);
+
     UT_LOG("Invoking moca_setIfAcaConfig");
     int status = moca_setIfAcaConfig(interfaceIndex, config);
     UT_LOG("Return Value: %d", status);
@@ -1518,21 +1544,1434 @@ void test_l1_moca_hal_negative3_moca_FreqMaskToValue(void)
     UT_LOG("Exiting test_l1_moca_hal_negative3_moca_FreqMaskToValue");
 }
 
+/**
+* @brief This test verifies that moca_IfGetTelemetrySnapshot returns a consistent snapshot for a valid interface.
+*
+* The snapshot is compared against the individual calls taken just before and after it, every counter must lie between the two readings.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 043
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Read moca_IfGetStats before the snapshot | ifIndex = 0 | STATUS_SUCCESS | Should be successful |
+* | 02 | Invoke moca_IfGetTelemetrySnapshot | ifIndex = 0, valid pointer | STATUS_SUCCESS, timestampNs != 0 | Should be successful |
+* | 03 | Read moca_IfGetStats after the snapshot | ifIndex = 0 | Snapshot counters between the two readings | Should be successful |
+* | 04 | Compare the dynamic info | ifIndex = 0 | NodeID and NetworkCoordinator match moca_IfGetDynamicInfo | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_IfGetTelemetrySnapshot(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_IfGetTelemetrySnapshot...");
+
+    ULONG ifIndex = 0;
+    moca_stats_t before, after;
+    moca_dynamic_info_t dynamicInfo;
+    moca_telemetry_snapshot_t snapshot;
+
+    UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &before), STATUS_SUCCESS);
+    INT ret = moca_IfGetTelemetrySnapshot(ifIndex, &snapshot);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_IfGetDynamicInfo(ifIndex, &dynamicInfo), STATUS_SUCCESS);
 
+    UT_LOG("timestampNs: %llu", (unsigned long long)snapshot.timestampNs);
+    UT_ASSERT_TRUE(snapshot.timestampNs != 0);
 
-static UT_test_suite_t * pSuite = NULL;
+    // Counters are 32 bit and may wrap, compare the distances from the first reading
+    UT_ASSERT_TRUE((uint32_t)(snapshot.stats.BytesSent - before.BytesSent) <= (uint32_t)(after.BytesSent - before.BytesSent));
+    UT_ASSERT_TRUE((uint32_t)(snapshot.stats.BytesReceived - before.BytesReceived) <= (uint32_t)(after.BytesReceived - before.BytesReceived));
+    UT_ASSERT_TRUE((uint32_t)(snapshot.stats.PacketsSent - before.PacketsSent) <= (uint32_t)(after.PacketsSent - before.PacketsSent));
+    UT_ASSERT_TRUE((uint32_t)(snapshot.stats.PacketsReceived - before.PacketsReceived) <= (uint32_t)(after.PacketsReceived - before.PacketsReceived));
+
+    UT_ASSERT_EQUAL(snapshot.dynamicInfo.NodeID, dynamicInfo.NodeID);
+    UT_ASSERT_EQUAL(snapshot.dynamicInfo.NetworkCoordinator, dynamicInfo.NetworkCoordinator);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_IfGetTelemetrySnapshot...");
+}
 
 /**
- * @brief Register the main tests for this module
- *
- * @return int - 0 on success, otherwise failure
- */
-int test_moca_hal_register(void)
+* @brief This test verifies that moca_IfGetTelemetrySnapshot rejects a NULL snapshot pointer.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 044
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_IfGetTelemetrySnapshot with a NULL pointer | ifIndex = 0, pSnapshot = NULL | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_IfGetTelemetrySnapshot(void)
 {
-    // Create the test suite
-    pSuite = UT_add_suite("[L1 moca_hal]", init_moca_hal_init, NULL);
-    if (pSuite == NULL) {
-        return -1;
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_IfGetTelemetrySnapshot...");
+
+    INT ret = moca_IfGetTelemetrySnapshot(0, NULL);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_IfGetTelemetrySnapshot...");
+}
+
+/**
+* @brief This test verifies that moca_IfGetTelemetrySnapshot rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 045
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_IfGetTelemetrySnapshot with an out of range index | ifIndex = ULONG_MAX, valid pointer | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative2_moca_IfGetTelemetrySnapshot(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative2_moca_IfGetTelemetrySnapshot...");
+
+    moca_telemetry_snapshot_t snapshot;
+    INT ret = moca_IfGetTelemetrySnapshot(ULONG_MAX, &snapshot);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative2_moca_IfGetTelemetrySnapshot...");
+}
+
+/**
+* @brief This test verifies that moca_GetAssociatedDevicesInto fills a caller owned buffer.
+*
+* The number of entries written must match moca_GetNumAssociatedDevices and every node ID must be valid.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 046
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Query the required capacity | ifIndex = 0, pDevices = NULL, capacity = 0 | pCount = moca_GetNumAssociatedDevices | Fails if any device is associated |
+* | 02 | Invoke moca_GetAssociatedDevicesInto with a full size buffer | ifIndex = 0, capacity = kMoca_MaxMocaNodes - 1 | STATUS_SUCCESS, count = moca_GetNumAssociatedDevices | Should be successful |
+* | 03 | Check the node IDs | None | NodeID < kMoca_MaxMocaNodes | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_GetAssociatedDevicesInto(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_GetAssociatedDevicesInto...");
+
+    ULONG ifIndex = 0;
+    moca_associated_device_t devices[kMoca_MaxMocaNodes - 1];
+    ULONG numDevices = 0;
+    ULONG required = 0;
+    ULONG count = 0;
+    ULONG i;
+
+    UT_ASSERT_EQUAL(moca_GetNumAssociatedDevices(ifIndex, &numDevices), STATUS_SUCCESS);
+
+    moca_GetAssociatedDevicesInto(ifIndex, NULL, 0, &required);
+    UT_LOG("Required capacity: %lu", required);
+    UT_ASSERT_EQUAL(required, numDevices);
+
+    INT ret = moca_GetAssociatedDevicesInto(ifIndex, devices, kMoca_MaxMocaNodes - 1, &count);
+    UT_LOG("Return Value: %d, count: %lu", ret, count);
+    UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(count, numDevices);
+
+    for (i = 0; i < count && i < kMoca_MaxMocaNodes - 1; i++)
+    {
+        UT_ASSERT_TRUE(devices[i].NodeID < kMoca_MaxMocaNodes);
+    }
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_GetAssociatedDevicesInto...");
+}
+
+/**
+* @brief This test verifies that moca_GetAssociatedDevicesInto rejects a NULL count pointer.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 047
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetAssociatedDevicesInto with pCount = NULL | ifIndex = 0, valid buffer, pCount = NULL | STATUS_FAILURE | Should fail |
+* | 02 | Invoke moca_GetAssociatedDevicesInto with a NULL buffer and non zero capacity | ifIndex = 0, pDevices = NULL, capacity = 1 | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_GetAssociatedDevicesInto(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_GetAssociatedDevicesInto...");
+
+    moca_associated_device_t devices[kMoca_MaxMocaNodes - 1];
+    ULONG count = 0;
+
+    INT ret = moca_GetAssociatedDevicesInto(0, devices, kMoca_MaxMocaNodes - 1, NULL);
+    UT_LOG("Return Value with NULL pCount: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    ret = moca_GetAssociatedDevicesInto(0, NULL, 1, &count);
+    UT_LOG("Return Value with NULL pDevices: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_GetAssociatedDevicesInto...");
+}
+
+/**
+* @brief This test verifies that moca_GetAssociatedDevicesInto reports the required capacity when the buffer is too small.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 048
+* **Priority:** High
+*
+* **Pre-Conditions:** At least two devices are associated, otherwise the test is skipped
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetAssociatedDevicesInto with a buffer one entry short | ifIndex = 0, capacity = count - 1 | STATUS_FAILURE, pCount = count, entry past the capacity untouched | Should fail |
+*/
+void test_l1_moca_hal_negative2_moca_GetAssociatedDevicesInto(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative2_moca_GetAssociatedDevicesInto...");
+
+    moca_associated_device_t devices[kMoca_MaxMocaNodes];
+    ULONG numDevices = 0;
+    ULONG count = 0;
+
+    UT_ASSERT_EQUAL(moca_GetNumAssociatedDevices(0, &numDevices), STATUS_SUCCESS);
+    if (numDevices < 2 || numDevices > kMoca_MaxMocaNodes - 1)
+    {
+        UT_LOG("%lu associated devices, skipping", numDevices);
+        UT_LOG("Exiting test_l1_moca_hal_negative2_moca_GetAssociatedDevicesInto...");
+        return;
+    }
+
+    // A guard entry past the capacity must not be written
+    memset(devices, 0xA5, sizeof(devices));
+    INT ret = moca_GetAssociatedDevicesInto(0, devices, numDevices - 1, &count);
+    UT_LOG("Return Value: %d, count: %lu", ret, count);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+    UT_ASSERT_EQUAL(count, numDevices);
+    UT_ASSERT_EQUAL(devices[numDevices - 1].NodeID, devices[numDevices].NodeID);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative2_moca_GetAssociatedDevicesInto...");
+}
+
+/**
+* @brief This test verifies that moca_GetAssociatedDevicesInto rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 049
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetAssociatedDevicesInto with an out of range index | ifIndex = ULONG_MAX, valid buffer | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative3_moca_GetAssociatedDevicesInto(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative3_moca_GetAssociatedDevicesInto...");
+
+    moca_associated_device_t devices[kMoca_MaxMocaNodes - 1];
+    ULONG count = 0;
+
+    INT ret = moca_GetAssociatedDevicesInto(ULONG_MAX, devices, kMoca_MaxMocaNodes - 1, &count);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative3_moca_GetAssociatedDevicesInto...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/* Straightforward decoder of the skeleton's mask rule, the reference for the equivalence test */
+static INT moca_naive_FreqMaskToValue(const UCHAR *mask)
+{
+    const char *pDigits = "0123456789abcdef";
+    uint64_t value = 0;
+    size_t length;
+    size_t i;
+    int bit;
+
+    if (mask == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    length = strlen((const char *)mask);
+    if (length != 16)
+    {
+        return STATUS_FAILURE;
+    }
+    for (i = 0; i < length; i++)
+    {
+        int c = mask[i];
+        const char *pDigit;
+
+        if (c >= 'A' && c <= 'F')
+        {
+            c = c - 'A' + 'a';
+        }
+        pDigit = (c != 0) ? strchr(pDigits, c) : NULL;
+        if (pDigit == NULL)
+        {
+            return STATUS_FAILURE;
+        }
+        value = value * 16 + (uint64_t)(pDigit - pDigits);
+    }
+    if (value == 0)
+    {
+        return STATUS_FAILURE;
+    }
+    for (bit = 0; bit < 64; bit++)
+    {
+        if (value & (1ULL << bit))
+        {
+            break;
+        }
+    }
+    return 800 + bit * 25;
+}
+
+/* Compares one mask against the reference, returns the number of mismatches */
+static int moca_check_FreqMaskToValue(UCHAR *mask)
+{
+    INT expected = moca_naive_FreqMaskToValue(mask);
+    INT result = moca_FreqMaskToValue(mask);
+
+    if (result != expected)
+    {
+        UT_LOG("Mismatch for mask \"%s\": got %d, expected %d", (const char *)mask, result, expected);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+* @brief This test checks moca_FreqMaskToValue against a straightforward reference decoder.
+*
+* Covers every single channel mask, every byte value at every position of a valid mask, every length from 0 to 24,
+* mixed case digits and a large set of pseudo random masks.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 050
+* **Priority:** High
+*
+* **Pre-Conditions:** Built against the skeleton, the decoding rule checked is the skeleton's
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Every mask with a single channel and with all channels above it | 64 x 2 masks | Same result as the reference | Should be successful |
+* | 02 | Every byte value substituted at every position of a valid mask | 16 x 256 masks | Same result as the reference | Should be successful |
+* | 03 | Valid digits of every length from 0 to 24 | 25 masks | Same result as the reference | Should be successful |
+* | 04 | Pseudo random masks drawn from hex digits and invalid characters | 200000 masks | Same result as the reference | Should be successful |
+*/
+void test_l1_moca_hal_positive2_moca_FreqMaskToValue(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive2_moca_FreqMaskToValue...");
+
+    static const char alphabet[] = "0123456789abcdefABCDEFgG /:@`xX";
+    UCHAR mask[32];
+    uint32_t rng = 0x12345678;
+    int mismatches = 0;
+    int checked = 0;
+    int bit, position, value, length, i;
+
+    for (bit = 0; bit < 64; bit++)
+    {
+        snprintf((char *)mask, sizeof(mask), "%016llx", 1ULL << bit);
+        mismatches += moca_check_FreqMaskToValue(mask);
+        snprintf((char *)mask, sizeof(mask), "%016llX", ~0ULL << bit);
+        mismatches += moca_check_FreqMaskToValue(mask);
+        checked += 2;
+    }
+    for (position = 0; position < 16; position++)
+    {
+        for (value = 0; value < 256; value++)
+        {
+            memcpy(mask, "00000000000040000000", 21);
+            mask[position] = (UCHAR)value;
+            mismatches += moca_check_FreqMaskToValue(mask);
+            checked++;
+        }
+    }
+    for (length = 0; length <= 24; length++)
+    {
+        memset(mask, '8', length);
+        mask[length] = '\0';
+        mismatches += moca_check_FreqMaskToValue(mask);
+        checked++;
+    }
+    for (i = 0; i < 200000; i++)
+    {
+        // Mostly 16 characters, some one shorter or longer, rarely an invalid character
+        length = 15 + (int)(rng % 3);
+        for (position = 0; position < length; position++)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            mask[position] = (UCHAR)alphabet[(rng & 0xFF) < 250 ? (rng >> 8) % 22 : (rng >> 8) % (sizeof(alphabet) - 1)];
+        }
+        mask[length] = '\0';
+        mismatches += moca_check_FreqMaskToValue(mask);
+        checked++;
+    }
+    UT_LOG("Masks checked: %d, mismatches: %d", checked, mismatches);
+    UT_ASSERT_EQUAL(mismatches, 0);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive2_moca_FreqMaskToValue...");
+}
+#endif
+
+/**
+* @brief This test verifies that moca_FreqMaskToValue rejects a 16 character mask holding a character that is not a hex digit.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 051
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_FreqMaskToValue with a non hex character in the first, a middle and the last position | "g000000000004000", "00000000z0004000", "000000000000400-" | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative4_moca_FreqMaskToValue(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative4_moca_FreqMaskToValue...");
+
+    UCHAR first[] = "g000000000004000";
+    UCHAR middle[] = "00000000z0004000";
+    UCHAR last[] = "000000000000400-";
+
+    UT_ASSERT_EQUAL(moca_FreqMaskToValue(first), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_FreqMaskToValue(middle), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_FreqMaskToValue(last), STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative4_moca_FreqMaskToValue...");
+}
+
+/* Copies the counters set in pDelta->changedMask into pStats */
+static void moca_apply_stats_delta(moca_stats_t *pStats, const moca_stats_delta_t *pDelta)
+{
+    ULONG *pValues = (ULONG *)pStats;
+    const ULONG *pChanged = (const ULONG *)&pDelta->stats;
+    int field;
+
+    // moca_stats_t is MOCA_STATS_FIELD_COUNT ULONG counters in moca_stats_field_t order
+    for (field = 0; field < MOCA_STATS_FIELD_COUNT; field++)
+    {
+        if (pDelta->changedMask & MOCA_STATS_FIELD_BIT(field))
+        {
+            pValues[field] = pChanged[field];
+        }
+    }
+}
+
+/**
+* @brief This test verifies that moca_IfGetStatsChangedSince returns every counter for generation 0 and that applied deltas track moca_IfGetStats.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 052
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_IfGetStatsChangedSince with generation 0 | ifIndex = 0, generation = 0 | STATUS_SUCCESS, changedMask = MOCA_STATS_ALL_FIELDS, generation != 0 | Should be successful |
+* | 02 | Poll 100 times, applying every delta to a copy, bracketed by moca_IfGetStats | ifIndex = 0, previous generation | Generation never decreases, copy between the two full reads | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_IfGetStatsChangedSince(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_IfGetStatsChangedSince...");
+
+    ULONG ifIndex = 0;
+    moca_stats_delta_t delta;
+    moca_stats_t copy, before, after;
+    uint64_t generation;
+    int i;
+
+    INT ret = moca_IfGetStatsChangedSince(ifIndex, 0, &delta);
+    UT_LOG("Return Value: %d, generation: %llu, changedMask: 0x%lx", ret, (unsigned long long)delta.generation, delta.changedMask);
+    UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(delta.changedMask, MOCA_STATS_ALL_FIELDS);
+    UT_ASSERT_TRUE(delta.generation != 0);
+    copy = delta.stats;
+    generation = delta.generation;
+
+    for (i = 0; i < 100; i++)
+    {
+        UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &before), STATUS_SUCCESS);
+        UT_ASSERT_EQUAL(moca_IfGetStatsChangedSince(ifIndex, generation, &delta), STATUS_SUCCESS);
+        UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &after), STATUS_SUCCESS);
+        UT_ASSERT_TRUE(delta.generation >= generation);
+        moca_apply_stats_delta(&copy, &delta);
+        generation = delta.generation;
+
+        // Counters are 32 bit and may wrap, compare the distances from the first full read
+        UT_ASSERT_TRUE((uint32_t)(copy.BytesSent - before.BytesSent) <= (uint32_t)(after.BytesSent - before.BytesSent));
+        UT_ASSERT_TRUE((uint32_t)(copy.BytesReceived - before.BytesReceived) <= (uint32_t)(after.BytesReceived - before.BytesReceived));
+        UT_ASSERT_TRUE((uint32_t)(copy.PacketsReceived - before.PacketsReceived) <= (uint32_t)(after.PacketsReceived - before.PacketsReceived));
+    }
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_IfGetStatsChangedSince...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/**
+* @brief This test verifies moca_IfGetStatsChangedSince against exact moca_IfGetStats snapshots on an idle and a loaded link.
+*
+* The simulator traffic is stopped so the counters stand still, then restarted.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 053
+* **Priority:** High
+*
+* **Pre-Conditions:** Built against the skeleton
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Stop the traffic, read a full snapshot and a delta from generation 0 | moca_sim_SetTraffic(0, 0, 0) | Applied copy equals moca_IfGetStats | Should be successful |
+* | 02 | Poll again with the returned generation | Idle link | changedMask = 0, same generation | Should be successful |
+* | 03 | Restart the traffic, wait and poll | Configured rates | changedMask != 0, generation increased, copy equals moca_IfGetStats after stopping the traffic again | Should be successful |
+*/
+void test_l1_moca_hal_positive2_moca_IfGetStatsChangedSince(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive2_moca_IfGetStatsChangedSince...");
+
+    ULONG ifIndex = 0;
+    moca_sim_config_t config;
+    moca_stats_delta_t delta;
+    moca_stats_t copy, full;
+    uint64_t generation;
+    struct timespec wait = { 0, 20000000 };
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(ifIndex, 0, 0), STATUS_SUCCESS);
+
+    memset(&copy, 0, sizeof(copy));
+    UT_ASSERT_EQUAL(moca_IfGetStatsChangedSince(ifIndex, 0, &delta), STATUS_SUCCESS);
+    moca_apply_stats_delta(&copy, &delta);
+    UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &full), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(memcmp(&copy, &full, sizeof(full)) == 0);
+    generation = delta.generation;
+
+    UT_ASSERT_EQUAL(moca_IfGetStatsChangedSince(ifIndex, generation, &delta), STATUS_SUCCESS);
+    UT_LOG("Idle poll: generation %llu -> %llu, changedMask 0x%lx",
+           (unsigned long long)generation, (unsigned long long)delta.generation, delta.changedMask);
+    UT_ASSERT_EQUAL(delta.changedMask, 0);
+    UT_ASSERT_TRUE(delta.generation == generation);
+
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(ifIndex, config.txBytesPerSec, config.rxBytesPerSec), STATUS_SUCCESS);
+    nanosleep(&wait, NULL);
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(ifIndex, 0, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_IfGetStatsChangedSince(ifIndex, generation, &delta), STATUS_SUCCESS);
+    UT_LOG("Loaded poll: generation %llu -> %llu, changedMask 0x%lx",
+           (unsigned long long)generation, (unsigned long long)delta.generation, delta.changedMask);
+    UT_ASSERT_TRUE(delta.changedMask != 0);
+    UT_ASSERT_TRUE(delta.generation > generation);
+    moca_apply_stats_delta(&copy, &delta);
+    UT_ASSERT_EQUAL(moca_IfGetStats(ifIndex, &full), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(memcmp(&copy, &full, sizeof(full)) == 0);
+
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(ifIndex, config.txBytesPerSec, config.rxBytesPerSec), STATUS_SUCCESS);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive2_moca_IfGetStatsChangedSince...");
+}
+#endif
+
+/**
+* @brief This test verifies that moca_IfGetStatsChangedSince rejects a NULL delta pointer.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 054
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_IfGetStatsChangedSince with pDelta = NULL | ifIndex = 0, generation = 0 | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_IfGetStatsChangedSince(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_IfGetStatsChangedSince...");
+
+    INT ret = moca_IfGetStatsChangedSince(0, 0, NULL);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_IfGetStatsChangedSince...");
+}
+
+/**
+* @brief This test verifies that moca_IfGetStatsChangedSince rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 055
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_IfGetStatsChangedSince with an out of range index | ifIndex = ULONG_MAX, valid pointer | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative2_moca_IfGetStatsChangedSince(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative2_moca_IfGetStatsChangedSince...");
+
+    moca_stats_delta_t delta;
+    INT ret = moca_IfGetStatsChangedSince(ULONG_MAX, 0, &delta);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative2_moca_IfGetStatsChangedSince...");
+}
+
+static INT moca_l1_associated_device_callback(ULONG ifIndex, moca_associated_device_t *pDevice)
+{
+    (void)ifIndex;
+    (void)pDevice;
+    return STATUS_SUCCESS;
+}
+
+/**
+* @brief This test verifies that a callback can be registered and unregistered with moca_associatedDevice_callback_register.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 056
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_associatedDevice_callback_register with a callback | callback_proc = valid function | Returns without error | Should be successful |
+* | 02 | Invoke moca_associatedDevice_callback_register again to replace it | callback_proc = valid function | Returns without error | Should be successful |
+* | 03 | Invoke moca_associatedDevice_callback_register with NULL to unregister | callback_proc = NULL | Returns without error | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_associatedDevice_callback_register(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_associatedDevice_callback_register...");
+
+    UT_LOG("Invoking moca_associatedDevice_callback_register with a callback");
+    moca_associatedDevice_callback_register(moca_l1_associated_device_callback);
+    UT_LOG("Invoking moca_associatedDevice_callback_register with the same callback again");
+    moca_associatedDevice_callback_register(moca_l1_associated_device_callback);
+    UT_LOG("Invoking moca_associatedDevice_callback_register with NULL");
+    moca_associatedDevice_callback_register(NULL);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_associatedDevice_callback_register...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/**
+* @brief This test verifies that moca_GetFullMeshRates reflects a PHY rate change of a single node pair.
+*
+* The simulator caches the mesh table and rebuilds only the pairs whose rate changed, so the table is read before and
+* after changing one pair, and after forcing a full rebuild.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 057
+* **Priority:** High
+*
+* **Pre-Conditions:** Built against the skeleton, at least two nodes on the network
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Read the mesh table twice | ifIndex = 0 | Both reads identical | Should be successful |
+* | 02 | Change the rate of the last pair and read the table | moca_sim_SetPhyRate(0, tx, rx, rate + 1) | Only that entry changed, TxRate = rate + 1 | Should be successful |
+* | 03 | Restore the rate, force a full rebuild and read the table | moca_sim_InvalidateFullMesh(0) | Table identical to step 01 | Should be successful |
+*/
+void test_l1_moca_hal_positive2_moca_GetFullMeshRates(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive2_moca_GetFullMeshRates...");
+
+    static moca_mesh_table_t before[kMoca_MaxMocaNodes * kMoca_MaxMocaNodes];
+    static moca_mesh_table_t after[kMoca_MaxMocaNodes * kMoca_MaxMocaNodes];
+    ULONG countBefore = 0, countAfter = 0, i;
+    moca_mesh_table_t *pLast;
+
+    UT_ASSERT_EQUAL(moca_GetFullMeshRates(0, before, &countBefore), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetFullMeshRates(0, after, &countAfter), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(countAfter, countBefore);
+    UT_ASSERT_TRUE(memcmp(before, after, countBefore * sizeof(moca_mesh_table_t)) == 0);
+    if (countBefore == 0)
+    {
+        UT_LOG("Single node network, no pair to change");
+        UT_LOG("Exiting test_l1_moca_hal_positive2_moca_GetFullMeshRates...");
+        return;
+    }
+
+    pLast = &before[countBefore - 1];
+    UT_LOG("Changing the rate of pair %lu -> %lu from %lu", pLast->TxNodeID, pLast->RxNodeID, pLast->TxRate);
+    UT_ASSERT_EQUAL(moca_sim_SetPhyRate(0, pLast->TxNodeID, pLast->RxNodeID, pLast->TxRate + 1), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetFullMeshRates(0, after, &countAfter), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(countAfter, countBefore);
+    for (i = 0; i + 1 < countBefore; i++)
+    {
+        UT_ASSERT_TRUE(memcmp(&before[i], &after[i], sizeof(moca_mesh_table_t)) == 0);
+    }
+    UT_ASSERT_EQUAL(after[countBefore - 1].TxNodeID, pLast->TxNodeID);
+    UT_ASSERT_EQUAL(after[countBefore - 1].RxNodeID, pLast->RxNodeID);
+    UT_ASSERT_EQUAL(after[countBefore - 1].TxRate, pLast->TxRate + 1);
+
+    UT_ASSERT_EQUAL(moca_sim_SetPhyRate(0, pLast->TxNodeID, pLast->RxNodeID, pLast->TxRate), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_InvalidateFullMesh(0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetFullMeshRates(0, after, &countAfter), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(countAfter, countBefore);
+    UT_ASSERT_TRUE(memcmp(before, after, countBefore * sizeof(moca_mesh_table_t)) == 0);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive2_moca_GetFullMeshRates...");
+}
+#endif
+
+/**
+* @brief This test verifies that paging through moca_GetFlowStatisticsPage returns the same flows as moca_GetFlowStatistics.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 058
+* **Priority:** High
+*
+* **Pre-Conditions:** The flow table holds at most kMoca_MaxCpeList flows
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Read the whole table with moca_GetFlowStatistics | ifIndex = 0, kMoca_MaxCpeList entries | STATUS_SUCCESS | Should be successful |
+* | 02 | Page through the table with moca_GetFlowStatisticsPage | ifIndex = 0, capacity = 3 | STATUS_SUCCESS, at most 3 flows per page, FlowIDs increasing, same flows as step 01, ends with MOCA_FLOW_CURSOR_END | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_GetFlowStatisticsPage...");
+
+    static moca_flow_table_t table[kMoca_MaxCpeList];
+    moca_flow_table_t page[3];
+    ULONG tableCount = 0, pagedCount = 0, count = 0, pages = 0, i, j;
+    ULONG cursor = MOCA_FLOW_CURSOR_START;
+    BOOL haveLast = FALSE;
+    ULONG lastFlowId = 0;
+    INT ret;
+
+    ret = moca_GetFlowStatistics(0, table, &tableCount);
+    UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+    UT_LOG("moca_GetFlowStatistics returned %lu flows", tableCount);
+
+    do
+    {
+        ret = moca_GetFlowStatisticsPage(0, cursor, page, 3, &count, &cursor);
+        UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+        if (ret != STATUS_SUCCESS)
+        {
+            break;
+        }
+        UT_ASSERT_TRUE(count <= 3);
+        for (i = 0; i < count; i++)
+        {
+            BOOL found = FALSE;
+
+            UT_ASSERT_TRUE(haveLast == FALSE || page[i].FlowID > lastFlowId);
+            lastFlowId = page[i].FlowID;
+            haveLast = TRUE;
+            for (j = 0; j < tableCount && found == FALSE; j++)
+            {
+                found = (table[j].FlowID == page[i].FlowID &&
+                         table[j].IngressNodeID == page[i].IngressNodeID &&
+                         table[j].EgressNodeID == page[i].EgressNodeID) ? TRUE : FALSE;
+            }
+            UT_ASSERT_TRUE(found);
+        }
+        pagedCount += count;
+        pages++;
+    } while (cursor != MOCA_FLOW_CURSOR_END && pages <= kMoca_MaxCpeList);
+
+    UT_LOG("%lu flows read in %lu pages", pagedCount, pages);
+    UT_ASSERT_EQUAL(cursor, MOCA_FLOW_CURSOR_END);
+    UT_ASSERT_EQUAL(pagedCount, tableCount);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_GetFlowStatisticsPage...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/**
+* @brief This test verifies that moca_GetFlowStatisticsPage enumerates a table of tens of thousands of flows.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 059
+* **Priority:** High
+*
+* **Pre-Conditions:** Built against the skeleton
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Reconfigure the simulator with a large flow table | 16 nodes, 2048 flows per node | STATUS_SUCCESS | Should be successful |
+* | 02 | Page through the table | capacity = 256 | Every flow exactly once, FlowIDs increasing, ends with MOCA_FLOW_CURSOR_END | Should be successful |
+* | 03 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Should be successful |
+*/
+void test_l1_moca_hal_positive2_moca_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive2_moca_GetFlowStatisticsPage...");
+
+    static moca_flow_table_t page[256];
+    moca_sim_config_t saved, large;
+    ULONG expected, total = 0, count = 0, outOfOrder = 0, i;
+    ULONG cursor = MOCA_FLOW_CURSOR_START;
+    ULONG lastFlowId = 0;
+    INT ret;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    large = saved;
+    large.numNodes = kMoca_MaxMocaNodes;
+    large.cpesPerNode = 1;
+    large.flowsPerNode = 2048;
+    expected = large.numNodes * large.flowsPerNode;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&large), STATUS_SUCCESS);
+
+    do
+    {
+        ret = moca_GetFlowStatisticsPage(0, cursor, page, 256, &count, &cursor);
+        UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+        if (ret != STATUS_SUCCESS)
+        {
+            break;
+        }
+        for (i = 0; i < count; i++)
+        {
+            outOfOrder += (page[i].FlowID <= lastFlowId) ? 1 : 0;
+            lastFlowId = page[i].FlowID;
+        }
+        total += count;
+    } while (cursor != MOCA_FLOW_CURSOR_END && total <= expected);
+
+    UT_LOG("%lu flows read, %lu expected, %lu out of order", total, expected, outOfOrder);
+    UT_ASSERT_EQUAL(total, expected);
+    UT_ASSERT_EQUAL(outOfOrder, 0);
+    UT_ASSERT_EQUAL(cursor, MOCA_FLOW_CURSOR_END);
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive2_moca_GetFlowStatisticsPage...");
+}
+#endif
+
+/**
+* @brief This test verifies that moca_GetFlowStatisticsPage rejects NULL pointers.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 060
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetFlowStatisticsPage with pFlows = NULL | ifIndex = 0, capacity = 1 | STATUS_FAILURE | Should fail |
+* | 02 | Invoke moca_GetFlowStatisticsPage with pCount = NULL | ifIndex = 0, capacity = 1 | STATUS_FAILURE | Should fail |
+* | 03 | Invoke moca_GetFlowStatisticsPage with pNextCursor = NULL | ifIndex = 0, capacity = 1 | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_GetFlowStatisticsPage...");
+
+    moca_flow_table_t flow;
+    ULONG count = 0, cursor = 0;
+
+    UT_ASSERT_EQUAL(moca_GetFlowStatisticsPage(0, MOCA_FLOW_CURSOR_START, NULL, 1, &count, &cursor), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_GetFlowStatisticsPage(0, MOCA_FLOW_CURSOR_START, &flow, 1, NULL, &cursor), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_GetFlowStatisticsPage(0, MOCA_FLOW_CURSOR_START, &flow, 1, &count, NULL), STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_GetFlowStatisticsPage...");
+}
+
+/**
+* @brief This test verifies that moca_GetFlowStatisticsPage rejects a capacity of 0 and the end cursor.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 061
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetFlowStatisticsPage with capacity = 0 | ifIndex = 0, valid pointers | STATUS_FAILURE | Should fail |
+* | 02 | Invoke moca_GetFlowStatisticsPage with cursor = MOCA_FLOW_CURSOR_END | ifIndex = 0, capacity = 1 | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative2_moca_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative2_moca_GetFlowStatisticsPage...");
+
+    moca_flow_table_t flow;
+    ULONG count = 0, cursor = 0;
+
+    UT_ASSERT_EQUAL(moca_GetFlowStatisticsPage(0, MOCA_FLOW_CURSOR_START, &flow, 0, &count, &cursor), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_GetFlowStatisticsPage(0, MOCA_FLOW_CURSOR_END, &flow, 1, &count, &cursor), STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative2_moca_GetFlowStatisticsPage...");
+}
+
+/**
+* @brief This test verifies that moca_GetFlowStatisticsPage rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 062
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_GetFlowStatisticsPage with an out of range index | ifIndex = ULONG_MAX, valid pointers | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative3_moca_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative3_moca_GetFlowStatisticsPage...");
+
+    moca_flow_table_t flow;
+    ULONG count = 0, cursor = 0;
+    INT ret = moca_GetFlowStatisticsPage(ULONG_MAX, MOCA_FLOW_CURSOR_START, &flow, 1, &count, &cursor);
+    UT_LOG("Return Value: %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative3_moca_GetFlowStatisticsPage...");
+}
+
+#define MOCA_L1_ACA_TIMEOUT_MS    30000   /**< Longest wait for one ACA */
+#define MOCA_L1_ACA_SIM_MS        20      /**< Simulated ACA run time */
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int calls;
+    int interfaceIndex;
+    moca_aca_stat_t status;
+} moca_l1_aca_wait_t;
+
+static moca_l1_aca_wait_t gAcaWait = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, -1, { 0 } };
+
+static void moca_l1_aca_complete(int interfaceIndex, const moca_aca_stat_t *pacaStat, void *pContext)
+{
+    moca_l1_aca_wait_t *pWait = (moca_l1_aca_wait_t *)pContext;
+
+    pthread_mutex_lock(&pWait->mutex);
+    pWait->calls++;
+    pWait->interfaceIndex = interfaceIndex;
+    pWait->status = *pacaStat;
+    pthread_cond_broadcast(&pWait->cond);
+    pthread_mutex_unlock(&pWait->mutex);
+}
+
+/* Waits for the callback of the ACA started last, returns the number of callbacks received */
+static int moca_l1_aca_wait(void)
+{
+    struct timespec deadline;
+    int calls;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += MOCA_L1_ACA_TIMEOUT_MS / 1000;
+    pthread_mutex_lock(&gAcaWait.mutex);
+    while (gAcaWait.calls == 0 && pthread_cond_timedwait(&gAcaWait.cond, &gAcaWait.mutex, &deadline) == 0)
+    {
+    }
+    calls = gAcaWait.calls;
+    pthread_mutex_unlock(&gAcaWait.mutex);
+    return calls;
+}
+
+static void moca_l1_aca_reset(void)
+{
+    pthread_mutex_lock(&gAcaWait.mutex);
+    gAcaWait.calls = 0;
+    gAcaWait.interfaceIndex = -1;
+    memset(&gAcaWait.status, 0, sizeof(gAcaWait.status));
+    pthread_mutex_unlock(&gAcaWait.mutex);
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/* Shortens the simulated ACA so the tests wait milliseconds, not the default half second */
+static void moca_l1_aca_shorten(moca_sim_config_t *pSaved)
+{
+    moca_sim_config_t shortAca;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(pSaved), STATUS_SUCCESS);
+    shortAca = *pSaved;
+    shortAca.acaDurationMs = MOCA_L1_ACA_SIM_MS;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&shortAca), STATUS_SUCCESS);
+}
+#endif
+
+/**
+* @brief This test verifies that moca_startIfAcaAsync runs an ACA and reports its end once through the callback.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 063
+* **Priority:** High
+*
+* **Pre-Conditions:** No other ACA runs on the interface
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_startIfAcaAsync with the current ACA configuration | interfaceIndex = 0, callback | STATUS_SUCCESS | Should be successful |
+* | 02 | Wait for the callback | Up to 30 s | Called once for interface 0 with a final status | Should be successful |
+* | 03 | Invoke moca_getIfAcaStatus | interfaceIndex = 0 | STATUS_SUCCESS, the status the callback reported | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_startIfAcaAsync(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_startIfAcaAsync...");
+
+    moca_aca_cfg_t config;
+    moca_aca_stat_t status;
+    struct timespec settle = { 0, 50000000 };
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved;
+
+    moca_l1_aca_shorten(&saved);
+#endif
+
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig(0, &config), STATUS_SUCCESS);
+    moca_l1_aca_reset();
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(0, config, moca_l1_aca_complete, &gAcaWait), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_l1_aca_wait(), 1);
+    /* A second callback would be a bug, give it the chance to show */
+    nanosleep(&settle, NULL);
+    UT_LOG("Callbacks: %d, acaStatus: %d, acaPower: %d", gAcaWait.calls, gAcaWait.status.acaStatus, gAcaWait.status.acaPower);
+    UT_ASSERT_EQUAL(gAcaWait.calls, 1);
+    UT_ASSERT_EQUAL(gAcaWait.interfaceIndex, 0);
+    UT_ASSERT_TRUE(gAcaWait.status.acaStatus != MOCA_ACA_STATUS_INPROGRESS);
+    UT_ASSERT_EQUAL(moca_getIfAcaStatus(0, &status), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(status.acaStatus, gAcaWait.status.acaStatus);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_startIfAcaAsync...");
+}
+
+/**
+* @brief This test verifies that cancelling an ACA started by moca_startIfAcaAsync still calls the callback once.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 064
+* **Priority:** High
+*
+* **Pre-Conditions:** No other ACA runs on the interface
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_startIfAcaAsync | interfaceIndex = 0, callback | STATUS_SUCCESS | Should be successful |
+* | 02 | Invoke moca_cancelIfAca straight away | interfaceIndex = 0 | STATUS_SUCCESS | Should be successful |
+* | 03 | Wait for the callback | Up to 30 s | Called once with a final status, MOCA_ACA_STATUS_FAIL on the simulator | Should be successful |
+*/
+void test_l1_moca_hal_positive2_moca_startIfAcaAsync(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive2_moca_startIfAcaAsync...");
+
+    moca_aca_cfg_t config;
+
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig(0, &config), STATUS_SUCCESS);
+    moca_l1_aca_reset();
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(0, config, moca_l1_aca_complete, &gAcaWait), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_cancelIfAca(0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_l1_aca_wait(), 1);
+    UT_LOG("Callbacks: %d, acaStatus: %d", gAcaWait.calls, gAcaWait.status.acaStatus);
+    UT_ASSERT_TRUE(gAcaWait.status.acaStatus != MOCA_ACA_STATUS_INPROGRESS);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(gAcaWait.status.acaStatus, MOCA_ACA_STATUS_FAIL);
+#endif
+
+    UT_LOG("Exiting test_l1_moca_hal_positive2_moca_startIfAcaAsync...");
+}
+
+/**
+* @brief This test verifies that moca_startIfAcaAsync rejects an invalid interface, an invalid type and a second ACA.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 065
+* **Priority:** High
+*
+* **Pre-Conditions:** No other ACA runs on the interface
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_startIfAcaAsync with an invalid interface | interfaceIndex = -1 | STATUS_FAILURE | Should fail |
+* | 02 | Invoke moca_startIfAcaAsync with an invalid ACA type | type = MOCA_ACA_TYPE_QUIET + 1 | STATUS_FAILURE | Should fail |
+* | 03 | Start an ACA, then invoke moca_startIfAcaAsync again | interfaceIndex = 0 | STATUS_SUCCESS, then STATUS_FAILURE | Should fail |
+* | 04 | Cancel the ACA and wait for the callback | interfaceIndex = 0 | Called once, only for the first ACA | Should be successful |
+*/
+void test_l1_moca_hal_negative1_moca_startIfAcaAsync(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_startIfAcaAsync...");
+
+    moca_aca_cfg_t config, invalid;
+    struct timespec settle = { 0, 50000000 };
+
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig(0, &config), STATUS_SUCCESS);
+    moca_l1_aca_reset();
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(-1, config, moca_l1_aca_complete, &gAcaWait), STATUS_FAILURE);
+    invalid = config;
+    invalid.type = (MOCA_ACA_TYPE)(MOCA_ACA_TYPE_QUIET + 1);
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(0, invalid, moca_l1_aca_complete, &gAcaWait), STATUS_FAILURE);
+
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(0, config, moca_l1_aca_complete, &gAcaWait), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_startIfAcaAsync(0, config, moca_l1_aca_complete, &gAcaWait), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_cancelIfAca(0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_l1_aca_wait(), 1);
+    nanosleep(&settle, NULL);
+    UT_LOG("Callbacks: %d", gAcaWait.calls);
+    UT_ASSERT_EQUAL(gAcaWait.calls, 1);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_startIfAcaAsync...");
+}
+
+/**
+* @brief This test verifies that the descriptor of moca_getIfAcaEventFd becomes readable when an ACA ends.
+*
+* A HAL that does not support notification returns -1 and the test only logs it.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 066
+* **Priority:** High
+*
+* **Pre-Conditions:** No other ACA runs on the interface
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_getIfAcaEventFd twice | interfaceIndex = 0 | The same descriptor both times | Should be successful |
+* | 02 | Start an ACA with moca_setIfAcaConfig and poll(2) the descriptor | ACAStart = TRUE, up to 30 s | Readable, reads a count of at least 1 | Should be successful |
+* | 03 | Invoke moca_getIfAcaStatus | interfaceIndex = 0 | STATUS_SUCCESS, not MOCA_ACA_STATUS_INPROGRESS | Should be successful |
+*/
+void test_l1_moca_hal_positive1_moca_getIfAcaEventFd(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_getIfAcaEventFd...");
+
+    moca_aca_cfg_t config;
+    moca_aca_stat_t status;
+    uint64_t count = 0;
+    struct pollfd pfd;
+    int eventFd = moca_getIfAcaEventFd(0);
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved;
+#endif
+
+    UT_LOG("moca_getIfAcaEventFd returned %d", eventFd);
+    if (eventFd < 0)
+    {
+        UT_LOG("ACA notification not supported by the HAL");
+        UT_LOG("Exiting test_l1_moca_hal_positive1_moca_getIfAcaEventFd...");
+        return;
+    }
+    UT_ASSERT_EQUAL(moca_getIfAcaEventFd(0), eventFd);
+#ifdef MOCA_HAL_SIMULATOR
+    moca_l1_aca_shorten(&saved);
+#endif
+    /* Drop notifications of earlier ACAs */
+    while (read(eventFd, &count, sizeof(count)) == (ssize_t)sizeof(count))
+    {
+    }
+
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig(0, &config), STATUS_SUCCESS);
+    config.ACAStart = TRUE;
+    UT_ASSERT_EQUAL(moca_setIfAcaConfig(0, config), STATUS_SUCCESS);
+    pfd.fd = eventFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    UT_ASSERT_EQUAL(poll(&pfd, 1, MOCA_L1_ACA_TIMEOUT_MS), 1);
+    count = 0;
+    UT_ASSERT_EQUAL(read(eventFd, &count, sizeof(count)), (ssize_t)sizeof(count));
+    UT_LOG("ACAs ended: %llu", (unsigned long long)count);
+    UT_ASSERT_TRUE(count >= 1);
+    UT_ASSERT_EQUAL(moca_getIfAcaStatus(0, &status), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(status.acaStatus != MOCA_ACA_STATUS_INPROGRESS);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_getIfAcaEventFd...");
+}
+
+/**
+* @brief This test verifies that moca_getIfAcaEventFd rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 067
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_getIfAcaEventFd with an invalid interface | interfaceIndex = -1 | -1 | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_getIfAcaEventFd(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_getIfAcaEventFd...");
+
+    int eventFd = moca_getIfAcaEventFd(-1);
+    UT_LOG("Return Value: %d", eventFd);
+    UT_ASSERT_EQUAL(eventFd, -1);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_getIfAcaEventFd...");
+}
+
+/**
+* @brief This test verifies that moca_SetIfConfigFields applies nothing, and resets nothing, when given the current configuration.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 068
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Read the current configuration and reset count | ifIndex = 0 | STATUS_SUCCESS | Should be successful |
+* | 02 | Apply the current configuration | fieldMask = MOCA_CFG_ALL_FIELDS | STATUS_SUCCESS, changedMask = 0, reformMask = 0 | Should be successful |
+* | 03 | Read the reset count again | None | Unchanged | Nothing was applied |
+*/
+void test_l1_moca_hal_positive1_moca_SetIfConfigFields(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_positive1_moca_SetIfConfigFields...");
+
+    moca_cfg_t config;
+    moca_cfg_apply_result_t result;
+    ULONG before = 0, after = 0;
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(0, &config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    memset(&result, 0xff, sizeof(result));
+    INT ret = moca_SetIfConfigFields(0, &config, MOCA_CFG_ALL_FIELDS, &result);
+    UT_LOG("Return: ret = %d, changedMask = 0x%lx, reformMask = 0x%lx", ret, result.changedMask, result.reformMask);
+    UT_ASSERT_EQUAL(ret, STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.changedMask, 0);
+    UT_ASSERT_EQUAL(result.reformMask, 0);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("Reset count %lu before, %lu after", before, after);
+    UT_ASSERT_EQUAL(after, before);
+
+    UT_LOG("Exiting test_l1_moca_hal_positive1_moca_SetIfConfigFields...");
+}
+
+/**
+* @brief This test verifies that moca_SetIfConfigFields rejects a NULL configuration.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 069
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_SetIfConfigFields without a configuration | ifIndex = 0, pConfig = NULL | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative1_moca_SetIfConfigFields(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative1_moca_SetIfConfigFields...");
+
+    moca_cfg_apply_result_t result;
+
+    INT ret = moca_SetIfConfigFields(0, NULL, MOCA_CFG_ALL_FIELDS, &result);
+    UT_LOG("Return: ret = %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative1_moca_SetIfConfigFields...");
+}
+
+/**
+* @brief This test verifies that moca_SetIfConfigFields rejects an invalid interface index.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 070
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Invoke moca_SetIfConfigFields with an invalid interface | ifIndex = ULONG_MAX | STATUS_FAILURE | Should fail |
+*/
+void test_l1_moca_hal_negative2_moca_SetIfConfigFields(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative2_moca_SetIfConfigFields...");
+
+    moca_cfg_t config;
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(0, &config), STATUS_SUCCESS);
+    INT ret = moca_SetIfConfigFields(ULONG_MAX, &config, MOCA_CFG_ALL_FIELDS, NULL);
+    UT_LOG("Return: ret = %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative2_moca_SetIfConfigFields...");
+}
+
+/**
+* @brief This test verifies that moca_SetIfConfigFields applies nothing when a changed field is out of range.
+*
+* **Test Group ID:** Basic: 01
+* **Test Case ID:** 071
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- | -------------- | ----- |
+* | 01 | Change the alias along with an out of range TxPowerLimit | TxPowerLimit = INT_MAX | STATUS_FAILURE | Should fail |
+* | 02 | Read the configuration and reset count | ifIndex = 0 | Unchanged | Nothing was applied |
+*/
+void test_l1_moca_hal_negative3_moca_SetIfConfigFields(void)
+{
+    UT_LOG("Entering test_l1_moca_hal_negative3_moca_SetIfConfigFields...");
+
+    moca_cfg_t config, invalid, current;
+    ULONG before = 0, after = 0;
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(0, &config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    invalid = config;
+    snprintf(invalid.Alias, sizeof(invalid.Alias), "%s", (strcmp(config.Alias, "l1-invalid") == 0) ? "l1-other" : "l1-invalid");
+    invalid.TxPowerLimit = INT_MAX;
+    INT ret = moca_SetIfConfigFields(0, &invalid,
+                                     MOCA_CFG_FIELD_BIT(MOCA_CFG_ALIAS) | MOCA_CFG_FIELD_BIT(MOCA_CFG_TX_POWER_LIMIT), NULL);
+    UT_LOG("Return: ret = %d", ret);
+    UT_ASSERT_EQUAL(ret, STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(0, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(current.Alias, config.Alias), 0);
+    UT_ASSERT_EQUAL(current.TxPowerLimit, config.TxPowerLimit);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(after, before);
+
+    UT_LOG("Exiting test_l1_moca_hal_negative3_moca_SetIfConfigFields...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+/* Tests that change the interface configuration or run an ACA, they never run alongside another test */
+static const char *gSerialTests[] =
+{
+    "l1_moca_hal_positive1_moca_SetIfConfig",
+    "l1_moca_hal_negative1_moca_SetIfConfig",
+    "l1_moca_hal_negative2_moca_SetIfConfig",
+    "l1_moca_hal_positive1_moca_cancelIfAca",
+    "l1_moca_hal_positive1_moca_setIfAcaConfig",
+    "l1_moca_hal_positive1_moca_associatedDevice_callback_register",
+    "l1_moca_hal_positive1_moca_startIfAcaAsync",
+    "l1_moca_hal_positive2_moca_startIfAcaAsync",
+    "l1_moca_hal_negative1_moca_startIfAcaAsync",
+    "l1_moca_hal_positive1_moca_getIfAcaEventFd",
+    "l1_moca_hal_negative1_moca_getIfAcaEventFd",
+    "l1_moca_hal_positive1_moca_SetIfConfigFields",
+    "l1_moca_hal_negative3_moca_SetIfConfigFields",
+};
+
+/**
+ * @brief Register the main tests for this module
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_moca_hal_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L1 moca_hal]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // Read only tests run in parallel worker processes when MOCA_TEST_JOBS is set
+    moca_test_parallel_suite(pSuite);
+    for (size_t i = 0; i < sizeof(gSerialTests) / sizeof(gSerialTests[0]); i++) {
+        moca_test_parallel_serial(gSerialTests[i]);
     }
     // List of test function names and strings
     UT_add_test(pSuite, "l1_moca_hal_positive1_moca_GetIfConfig", test_l1_moca_hal_positive1_moca_GetIfConfig);
@@ -1577,6 +3016,43 @@ int test_moca_hal_register(void)
     UT_add_test(pSuite, "l1_moca_hal_negative1_moca_FreqMaskToValue", test_l1_moca_hal_negative1_moca_FreqMaskToValue);
     UT_add_test(pSuite, "l1_moca_hal_negative2_moca_FreqMaskToValue", test_l1_moca_hal_negative2_moca_FreqMaskToValue);
     UT_add_test(pSuite, "l1_moca_hal_negative3_moca_FreqMaskToValue", test_l1_moca_hal_negative3_moca_FreqMaskToValue);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_IfGetTelemetrySnapshot", test_l1_moca_hal_positive1_moca_IfGetTelemetrySnapshot);
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_IfGetTelemetrySnapshot", test_l1_moca_hal_negative1_moca_IfGetTelemetrySnapshot);
+    UT_add_test(pSuite, "l1_moca_hal_negative2_moca_IfGetTelemetrySnapshot", test_l1_moca_hal_negative2_moca_IfGetTelemetrySnapshot);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_GetAssociatedDevicesInto", test_l1_moca_hal_positive1_moca_GetAssociatedDevicesInto);
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_GetAssociatedDevicesInto", test_l1_moca_hal_negative1_moca_GetAssociatedDevicesInto);
+    UT_add_test(pSuite, "l1_moca_hal_negative2_moca_GetAssociatedDevicesInto", test_l1_moca_hal_negative2_moca_GetAssociatedDevicesInto);
+    UT_add_test(pSuite, "l1_moca_hal_negative3_moca_GetAssociatedDevicesInto", test_l1_moca_hal_negative3_moca_GetAssociatedDevicesInto);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l1_moca_hal_positive2_moca_FreqMaskToValue", test_l1_moca_hal_positive2_moca_FreqMaskToValue);
+#endif
+    UT_add_test(pSuite, "l1_moca_hal_negative4_moca_FreqMaskToValue", test_l1_moca_hal_negative4_moca_FreqMaskToValue);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_IfGetStatsChangedSince", test_l1_moca_hal_positive1_moca_IfGetStatsChangedSince);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l1_moca_hal_positive2_moca_IfGetStatsChangedSince", test_l1_moca_hal_positive2_moca_IfGetStatsChangedSince);
+#endif
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_IfGetStatsChangedSince", test_l1_moca_hal_negative1_moca_IfGetStatsChangedSince);
+    UT_add_test(pSuite, "l1_moca_hal_negative2_moca_IfGetStatsChangedSince", test_l1_moca_hal_negative2_moca_IfGetStatsChangedSince);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_associatedDevice_callback_register", test_l1_moca_hal_positive1_moca_associatedDevice_callback_register);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l1_moca_hal_positive2_moca_GetFullMeshRates", test_l1_moca_hal_positive2_moca_GetFullMeshRates);
+#endif
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_GetFlowStatisticsPage", test_l1_moca_hal_positive1_moca_GetFlowStatisticsPage);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l1_moca_hal_positive2_moca_GetFlowStatisticsPage", test_l1_moca_hal_positive2_moca_GetFlowStatisticsPage);
+#endif
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_GetFlowStatisticsPage", test_l1_moca_hal_negative1_moca_GetFlowStatisticsPage);
+    UT_add_test(pSuite, "l1_moca_hal_negative2_moca_GetFlowStatisticsPage", test_l1_moca_hal_negative2_moca_GetFlowStatisticsPage);
+    UT_add_test(pSuite, "l1_moca_hal_negative3_moca_GetFlowStatisticsPage", test_l1_moca_hal_negative3_moca_GetFlowStatisticsPage);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_startIfAcaAsync", test_l1_moca_hal_positive1_moca_startIfAcaAsync);
+    UT_add_test(pSuite, "l1_moca_hal_positive2_moca_startIfAcaAsync", test_l1_moca_hal_positive2_moca_startIfAcaAsync);
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_startIfAcaAsync", test_l1_moca_hal_negative1_moca_startIfAcaAsync);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_getIfAcaEventFd", test_l1_moca_hal_positive1_moca_getIfAcaEventFd);
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_getIfAcaEventFd", test_l1_moca_hal_negative1_moca_getIfAcaEventFd);
+    UT_add_test(pSuite, "l1_moca_hal_positive1_moca_SetIfConfigFields", test_l1_moca_hal_positive1_moca_SetIfConfigFields);
+    UT_add_test(pSuite, "l1_moca_hal_negative1_moca_SetIfConfigFields", test_l1_moca_hal_negative1_moca_SetIfConfigFields);
+    UT_add_test(pSuite, "l1_moca_hal_negative2_moca_SetIfConfigFields", test_l1_moca_hal_negative2_moca_SetIfConfigFields);
+    UT_add_test(pSuite, "l1_moca_hal_negative3_moca_SetIfConfigFields", test_l1_moca_hal_negative3_moca_SetIfConfigFields);
 
     return 0;
 }
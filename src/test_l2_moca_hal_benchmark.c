@@ -0,0 +1,1711 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_benchmark.c
+* @page moca_hal_benchmark Level 2 Benchmark Tests
+*
+* ## Module's Role
+* This module measures the latency of each read-side moca_hal API. Every API is called
+* MOCA_BENCH_ITERATIONS times (5000 by default) after a short warm up and the
+* p50 / p99 / p99.9 latencies are logged, so that expensive calls and regressions
+* between vendor drops can be identified.
+*
+* State-changing APIs (moca_SetIfConfig, moca_setIfAcaConfig, moca_cancelIfAca) are not
+* timed here as they disturb the link, except for the ACA completion comparison, which runs
+* complete ACAs on purpose.
+*
+* **Pre-Conditions:**  None
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "moca_bench.h"
+#include "moca_alloc.h"
+#include "moca_scmod.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_BENCH_MAX_FLOWS    kMoca_MaxCpeList
+#define MOCA_BENCH_FREQ_MASK_SET        4096    /**< Distinct masks cycled through by the throughput test */
+#define MOCA_BENCH_FREQ_MASKS_PER_ITER  800     /**< Decoded masks per MOCA_BENCH_ITERATIONS, 4 million by default */
+#define MOCA_BENCH_FLOW_PAGE            256     /**< Flows per moca_GetFlowStatisticsPage() call */
+#define MOCA_BENCH_FLOW_ENUM_DIVISOR    50      /**< Full enumerations per MOCA_BENCH_ITERATIONS, 100 by default */
+#define MOCA_BENCH_LARGE_FLOWS_PER_NODE 2048    /**< 32768 flows on a 16 node network */
+#define MOCA_BENCH_ACA_RUN_DIVISOR      250     /**< ACAs per mode per MOCA_BENCH_ITERATIONS, 20 by default */
+#define MOCA_BENCH_ACA_MIN_RUNS         4
+#define MOCA_BENCH_ACA_SIM_MS           20      /**< Simulated ACA run time, keeps the comparison short */
+#define MOCA_BENCH_ACA_TIMEOUT_MS       30000   /**< Longest wait for one ACA */
+#define MOCA_BENCH_SCMOD_CHANGE_ONE_IN  8       /**< Subcarriers moved by one bit between the two dumps */
+
+extern int init_moca_hal_init(void);
+
+static ULONG gBenchIfIndex = 0;
+static moca_cpe_t gBenchCpes[kMoca_MaxCpeList];
+static moca_mesh_table_t gBenchMesh[kMoca_MaxMocaNodes * kMoca_MaxMocaNodes];
+static moca_flow_table_t gBenchFlows[MOCA_BENCH_MAX_FLOWS];
+static moca_associated_device_t gBenchDevices[kMoca_MaxMocaNodes - 1];
+static UCHAR gBenchFreqMask[] = "0000000000004000";
+static UCHAR gBenchFreqMasks[MOCA_BENCH_FREQ_MASK_SET][17];
+static moca_scmod_stat_t gBenchScmod[MOCA_SCMOD_MAX_LINKS];
+static moca_scmod_stat_t gBenchScmodPrevious[MOCA_SCMOD_MAX_LINKS];
+static moca_scmod_analysis_t gBenchScmodReference;
+static moca_scmod_analysis_t gBenchScmodAnalysis;
+static moca_bench_histogram_t gBenchHistogram;
+static moca_bench_histogram_t gBenchBaselineHistogram;
+
+static int moca_bench_op_GetIfConfig(void *pContext)
+{
+    (void)pContext;
+    moca_cfg_t config;
+
+    return moca_GetIfConfig(gBenchIfIndex, &config);
+}
+
+static int moca_bench_op_IfGetStaticInfo(void *pContext)
+{
+    (void)pContext;
+    moca_static_info_t staticInfo;
+
+    return moca_IfGetStaticInfo(gBenchIfIndex, &staticInfo);
+}
+
+static int moca_bench_op_IfGetDynamicInfo(void *pContext)
+{
+    (void)pContext;
+    moca_dynamic_info_t dynamicInfo;
+
+    return moca_IfGetDynamicInfo(gBenchIfIndex, &dynamicInfo);
+}
+
+static int moca_bench_op_IfGetStats(void *pContext)
+{
+    (void)pContext;
+    moca_stats_t stats;
+
+    return moca_IfGetStats(gBenchIfIndex, &stats);
+}
+
+static int moca_bench_op_IfGetExtCounter(void *pContext)
+{
+    (void)pContext;
+    moca_mac_counters_t counters;
+
+    return moca_IfGetExtCounter(gBenchIfIndex, &counters);
+}
+
+static int moca_bench_op_IfGetExtAggrCounter(void *pContext)
+{
+    (void)pContext;
+    moca_aggregate_counters_t counters;
+
+    return moca_IfGetExtAggrCounter(gBenchIfIndex, &counters);
+}
+
+static int moca_bench_op_GetNumAssociatedDevices(void *pContext)
+{
+    (void)pContext;
+    ULONG count;
+
+    return moca_GetNumAssociatedDevices(gBenchIfIndex, &count);
+}
+
+static int moca_bench_op_GetAssociatedDevices(void *pContext)
+{
+    (void)pContext;
+    moca_associated_device_t *pDevices = NULL;
+    INT status = moca_GetAssociatedDevices(gBenchIfIndex, &pDevices);
+
+    // Freeing is part of the cost the caller pays for this API
+    free(pDevices);
+    return status;
+}
+
+static int moca_bench_op_GetAssociatedDevicesInto(void *pContext)
+{
+    (void)pContext;
+    ULONG count = 0;
+
+    return moca_GetAssociatedDevicesInto(gBenchIfIndex, gBenchDevices, kMoca_MaxMocaNodes - 1, &count);
+}
+
+static int moca_bench_op_GetMocaCPEs(void *pContext)
+{
+    (void)pContext;
+    INT numCpes = 0;
+
+    return moca_GetMocaCPEs(gBenchIfIndex, gBenchCpes, &numCpes);
+}
+
+static int moca_bench_op_GetFullMeshRates(void *pContext)
+{
+    (void)pContext;
+    ULONG count = 0;
+
+    return moca_GetFullMeshRates(gBenchIfIndex, gBenchMesh, &count);
+}
+
+static int moca_bench_op_GetFlowStatistics(void *pContext)
+{
+    (void)pContext;
+    ULONG count = 0;
+
+    return moca_GetFlowStatistics(gBenchIfIndex, gBenchFlows, &count);
+}
+
+static int moca_bench_op_GetResetCount(void *pContext)
+{
+    (void)pContext;
+    ULONG resetCount;
+
+    return moca_GetResetCount(&resetCount);
+}
+
+static int moca_bench_op_getIfAcaConfig(void *pContext)
+{
+    (void)pContext;
+    moca_aca_cfg_t acaConfig;
+
+    return moca_getIfAcaConfig((int)gBenchIfIndex, &acaConfig);
+}
+
+static int moca_bench_op_getIfAcaStatus(void *pContext)
+{
+    (void)pContext;
+    moca_aca_stat_t acaStatus;
+
+    return moca_getIfAcaStatus((int)gBenchIfIndex, &acaStatus);
+}
+
+static int moca_bench_op_getIfScmod(void *pContext)
+{
+    (void)pContext;
+    moca_scmod_stat_t *pScmod = NULL;
+    int numEntries = 0;
+    int status = moca_getIfScmod((int)gBenchIfIndex, &numEntries, &pScmod);
+
+    // Freeing is part of the cost the caller pays for this API
+    free(pScmod);
+    return status;
+}
+
+static int moca_bench_op_FreqMaskToValue(void *pContext)
+{
+    (void)pContext;
+    return (moca_FreqMaskToValue(gBenchFreqMask) > 0) ? STATUS_SUCCESS : STATUS_FAILURE;
+}
+
+static int moca_bench_op_HardwareEquipped(void *pContext)
+{
+    (void)pContext;
+    (void)moca_HardwareEquipped();
+    return STATUS_SUCCESS;
+}
+
+static int moca_bench_op_TelemetrySequence(void *pContext)
+{
+    (void)pContext;
+    moca_telemetry_snapshot_t snapshot;
+
+    // The four calls a telemetry collector makes without moca_IfGetTelemetrySnapshot
+    if (moca_IfGetStats(gBenchIfIndex, &snapshot.stats) != STATUS_SUCCESS ||
+        moca_IfGetExtCounter(gBenchIfIndex, &snapshot.macCounters) != STATUS_SUCCESS ||
+        moca_IfGetExtAggrCounter(gBenchIfIndex, &snapshot.aggregateCounters) != STATUS_SUCCESS ||
+        moca_IfGetDynamicInfo(gBenchIfIndex, &snapshot.dynamicInfo) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    return STATUS_SUCCESS;
+}
+
+static int moca_bench_op_IfGetTelemetrySnapshot(void *pContext)
+{
+    (void)pContext;
+    moca_telemetry_snapshot_t snapshot;
+
+    return moca_IfGetTelemetrySnapshot(gBenchIfIndex, &snapshot);
+}
+
+typedef struct
+{
+    moca_stats_t stats;         /**< Poller's copy of the counters */
+    uint64_t generation;
+    uint64_t polls;
+    uint64_t changedFields;     /**< Counters copied over all polls */
+} moca_bench_stats_poller_t;
+
+static int moca_bench_op_PollFullStats(void *pContext)
+{
+    moca_bench_stats_poller_t *pPoller = (moca_bench_stats_poller_t *)pContext;
+    moca_stats_t stats;
+    INT status = moca_IfGetStats(gBenchIfIndex, &stats);
+
+    // A full poller compares every counter against its copy to find what to publish
+    pPoller->changedFields += (memcmp(&stats, &pPoller->stats, sizeof(stats)) != 0) ? MOCA_STATS_FIELD_COUNT : 0;
+    pPoller->stats = stats;
+    pPoller->polls++;
+    return status;
+}
+
+static int moca_bench_op_PollStatsChangedSince(void *pContext)
+{
+    moca_bench_stats_poller_t *pPoller = (moca_bench_stats_poller_t *)pContext;
+    moca_stats_delta_t delta;
+    ULONG *pValues = (ULONG *)&pPoller->stats;
+    const ULONG *pChanged = (const ULONG *)&delta.stats;
+    INT status = moca_IfGetStatsChangedSince(gBenchIfIndex, pPoller->generation, &delta);
+    int field;
+
+    if (delta.changedMask != 0)
+    {
+        for (field = 0; field < MOCA_STATS_FIELD_COUNT; field++)
+        {
+            if (delta.changedMask & MOCA_STATS_FIELD_BIT(field))
+            {
+                pValues[field] = pChanged[field];
+                pPoller->changedFields++;
+            }
+        }
+    }
+    pPoller->generation = delta.generation;
+    pPoller->polls++;
+    return status;
+}
+
+typedef struct
+{
+    ULONG tableSize;    /**< Entries the single shot caller must allocate */
+    ULONG flows;        /**< Flows seen by the last enumeration */
+} moca_bench_flow_enum_t;
+
+static int moca_bench_op_EnumerateFlowsSingleShot(void *pContext)
+{
+    moca_bench_flow_enum_t *pEnum = (moca_bench_flow_enum_t *)pContext;
+    moca_flow_table_t *pFlows = malloc(pEnum->tableSize * sizeof(moca_flow_table_t));
+    ULONG count = 0;
+    INT status;
+
+    if (pFlows == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    status = moca_GetFlowStatistics(gBenchIfIndex, pFlows, &count);
+    pEnum->flows = count;
+    free(pFlows);
+    return status;
+}
+
+static int moca_bench_op_EnumerateFlowsPaged(void *pContext)
+{
+    moca_bench_flow_enum_t *pEnum = (moca_bench_flow_enum_t *)pContext;
+    moca_flow_table_t *pPage = malloc(MOCA_BENCH_FLOW_PAGE * sizeof(moca_flow_table_t));
+    ULONG cursor = MOCA_FLOW_CURSOR_START;
+    ULONG count = 0;
+    INT status = STATUS_SUCCESS;
+
+    if (pPage == NULL)
+    {
+        return STATUS_FAILURE;
+    }
+    pEnum->flows = 0;
+    while (cursor != MOCA_FLOW_CURSOR_END && status == STATUS_SUCCESS)
+    {
+        status = moca_GetFlowStatisticsPage(gBenchIfIndex, cursor, pPage, MOCA_BENCH_FLOW_PAGE, &count, &cursor);
+        pEnum->flows += count;
+    }
+    free(pPage);
+    return status;
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+static int moca_bench_op_GetFullMeshRatesCold(void *pContext)
+{
+    (void)pContext;
+    ULONG count = 0;
+
+    // Every pair changed, as on the first read after a topology change
+    if (moca_sim_InvalidateFullMesh(gBenchIfIndex) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    return moca_GetFullMeshRates(gBenchIfIndex, gBenchMesh, &count);
+}
+
+static int moca_bench_op_GetFullMeshRatesOnePair(void *pContext)
+{
+    (void)pContext;
+    static ULONG flip = 0;
+    ULONG count = 0;
+    const moca_mesh_table_t *pEntry = &gBenchMesh[0];
+
+    // A link event moves the rate of one pair up and down by 1 Mbps
+    flip ^= 1;
+    if (moca_sim_SetPhyRate(gBenchIfIndex, pEntry->TxNodeID, pEntry->RxNodeID, pEntry->TxRate + (flip ? 1 : -1)) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    return moca_GetFullMeshRates(gBenchIfIndex, gBenchMesh, &count);
+}
+#endif
+
+typedef struct
+{
+    moca_scmod_kernel_t kernel;
+    moca_scmod_analysis_t *pAnalysis;
+} moca_bench_scmod_t;
+
+static int moca_bench_op_ScmodAnalyze(void *pContext)
+{
+    moca_bench_scmod_t *pScmod = (moca_bench_scmod_t *)pContext;
+
+    return moca_scmod_analyze(pScmod->kernel, gBenchScmod, MOCA_SCMOD_MAX_LINKS,
+                              gBenchScmodPrevious, MOCA_SCMOD_MAX_LINKS, pScmod->pAnalysis);
+}
+
+typedef enum
+{
+    MOCA_BENCH_ACA_POLL = 0,
+    MOCA_BENCH_ACA_CALLBACK,
+    MOCA_BENCH_ACA_EVENTFD
+} moca_bench_aca_mode_t;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    BOOL done;
+    moca_aca_stat_t status;
+} moca_bench_aca_wait_t;
+
+static moca_bench_aca_wait_t gBenchAcaWait = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, FALSE, { 0 } };
+
+static void moca_bench_aca_complete(int interfaceIndex, const moca_aca_stat_t *pacaStat, void *pContext)
+{
+    moca_bench_aca_wait_t *pWait = (moca_bench_aca_wait_t *)pContext;
+
+    (void)interfaceIndex;
+    pthread_mutex_lock(&pWait->mutex);
+    pWait->status = *pacaStat;
+    pWait->done = TRUE;
+    pthread_cond_signal(&pWait->cond);
+    pthread_mutex_unlock(&pWait->mutex);
+}
+
+static uint64_t moca_bench_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Runs one ACA and waits for its result the way mode says, returns 0 once a final status was seen */
+static int moca_bench_aca_once(moca_bench_aca_mode_t mode, const moca_aca_cfg_t *pConfig, ULONG pollMs, int eventFd,
+                               uint64_t *pStatusPolls)
+{
+    struct timespec interval = { (time_t)(pollMs / 1000), (long)(pollMs % 1000) * 1000000L };
+    struct timespec deadline;
+    struct pollfd pfd = { eventFd, POLLIN, 0 };
+    uint64_t start = moca_bench_now_ns();
+    uint64_t count;
+    moca_aca_stat_t status;
+    int ret = 0;
+
+    switch (mode)
+    {
+    case MOCA_BENCH_ACA_POLL:
+        if (moca_setIfAcaConfig((int)gBenchIfIndex, *pConfig) != STATUS_SUCCESS)
+        {
+            return -1;
+        }
+        for (;;)
+        {
+            (*pStatusPolls)++;
+            if (moca_getIfAcaStatus((int)gBenchIfIndex, &status) != STATUS_SUCCESS)
+            {
+                return -1;
+            }
+            if (status.acaStatus != MOCA_ACA_STATUS_INPROGRESS)
+            {
+                return 0;
+            }
+            if (moca_bench_now_ns() - start > (uint64_t)MOCA_BENCH_ACA_TIMEOUT_MS * 1000000ULL)
+            {
+                return -1;
+            }
+            nanosleep(&interval, NULL);
+        }
+    case MOCA_BENCH_ACA_CALLBACK:
+        gBenchAcaWait.done = FALSE;
+        if (moca_startIfAcaAsync((int)gBenchIfIndex, *pConfig, moca_bench_aca_complete, &gBenchAcaWait) != STATUS_SUCCESS)
+        {
+            return -1;
+        }
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += MOCA_BENCH_ACA_TIMEOUT_MS / 1000;
+        pthread_mutex_lock(&gBenchAcaWait.mutex);
+        while (gBenchAcaWait.done == FALSE && ret == 0)
+        {
+            ret = pthread_cond_timedwait(&gBenchAcaWait.cond, &gBenchAcaWait.mutex, &deadline);
+        }
+        pthread_mutex_unlock(&gBenchAcaWait.mutex);
+        return (gBenchAcaWait.done == TRUE) ? 0 : -1;
+    case MOCA_BENCH_ACA_EVENTFD:
+        /* Drop notifications of ACAs the other modes ran */
+        while (read(eventFd, &count, sizeof(count)) == (ssize_t)sizeof(count))
+        {
+        }
+        if (moca_setIfAcaConfig((int)gBenchIfIndex, *pConfig) != STATUS_SUCCESS)
+        {
+            return -1;
+        }
+        if (poll(&pfd, 1, MOCA_BENCH_ACA_TIMEOUT_MS) != 1 || read(eventFd, &count, sizeof(count)) != (ssize_t)sizeof(count))
+        {
+            return -1;
+        }
+        (*pStatusPolls)++;
+        if (moca_getIfAcaStatus((int)gBenchIfIndex, &status) != STATUS_SUCCESS || status.acaStatus == MOCA_ACA_STATUS_INPROGRESS)
+        {
+            return -1;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/* Times runs ACAs from start to result, logs the CPU time and status polls each one cost, returns the mean time to result */
+static uint64_t moca_benchmark_aca(const char *pName, moca_bench_aca_mode_t mode, ULONG pollMs, int eventFd, uint32_t runs)
+{
+    moca_aca_cfg_t config;
+    uint64_t statusPolls = 0;
+    uint64_t cpuStart;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    UT_ASSERT_EQUAL(moca_getIfAcaConfig((int)gBenchIfIndex, &config), STATUS_SUCCESS);
+    config.ACAStart = TRUE;
+    moca_bench_histogram_reset(&gBenchHistogram);
+    UT_LOG("Running %u ACAs, %s", runs, pName);
+    cpuStart = moca_bench_cpu_ns();
+    for (i = 0; i < runs; i++)
+    {
+        uint64_t start = moca_bench_now_ns();
+
+        if (moca_bench_aca_once(mode, &config, pollMs, eventFd, &statusPolls) != 0)
+        {
+            failures++;
+            moca_cancelIfAca((int)gBenchIfIndex);
+            continue;
+        }
+        moca_bench_histogram_record(&gBenchHistogram, moca_bench_now_ns() - start);
+    }
+    UT_LOG("%s: %.1f us CPU and %.1f status reads per ACA", pName,
+           (double)(moca_bench_cpu_ns() - cpuStart) / 1000.0 / runs, (double)statusPolls / runs);
+    moca_bench_report(pName, &gBenchHistogram);
+    UT_ASSERT_EQUAL(failures, 0);
+    return (gBenchHistogram.count > 0) ? gBenchHistogram.sum / gBenchHistogram.count : 0;
+}
+
+/*
+ * Fills gBenchScmod with a full 16 node dump and gBenchScmodPrevious with the same dump one bit off on one in
+ * MOCA_BENCH_SCMOD_CHANGE_ONE_IN subcarriers. Pairs missing from the interface's dump reuse the loading of one
+ * that is there. Returns the number of entries the HAL reported.
+ */
+static int moca_benchmark_scmod_dumps(void)
+{
+    moca_scmod_stat_t *pDump = NULL;
+    int numEntries = 0;
+    UINT tx, rx;
+    int entry = 0;
+    int i;
+    size_t sc;
+
+    UT_ASSERT_EQUAL(moca_getIfScmod((int)gBenchIfIndex, &numEntries, &pDump), STATUS_SUCCESS);
+    for (tx = 0; tx < kMoca_MaxMocaNodes; tx++)
+    {
+        for (rx = 0; rx < kMoca_MaxMocaNodes; rx++)
+        {
+            moca_scmod_stat_t *pEntry;
+            const moca_scmod_stat_t *pSource = NULL;
+
+            if (tx == rx)
+            {
+                continue;
+            }
+            pEntry = &gBenchScmod[entry];
+            for (i = 0; i < numEntries && pSource == NULL; i++)
+            {
+                if (pDump[i].txNode == tx && pDump[i].rxNode == rx)
+                {
+                    pSource = &pDump[i];
+                }
+            }
+            if (pSource == NULL && numEntries > 0)
+            {
+                pSource = &pDump[entry % numEntries];
+            }
+            if (pSource != NULL)
+            {
+                *pEntry = *pSource;
+            }
+            else
+            {
+                // A network of one node has no links, load every subcarrier with 4 to 10 bits
+                memset(pEntry, 0, sizeof(*pEntry));
+                for (sc = 0; sc < MOCA_SCMOD_SUBCARRIERS; sc++)
+                {
+                    pEntry->bitLoading[sc] = (UCHAR)(4 + (sc + (size_t)entry) % 7);
+                }
+            }
+            pEntry->txNode = tx;
+            pEntry->rxNode = rx;
+
+            gBenchScmodPrevious[entry] = *pEntry;
+            for (sc = (size_t)entry % MOCA_BENCH_SCMOD_CHANGE_ONE_IN; sc < MOCA_SCMOD_SUBCARRIERS;
+                 sc += MOCA_BENCH_SCMOD_CHANGE_ONE_IN)
+            {
+                UCHAR *pBits = &gBenchScmodPrevious[entry].bitLoading[sc];
+
+                *pBits = (*pBits > 0) ? *pBits - 1 : 1;
+            }
+            entry++;
+        }
+    }
+    free(pDump);
+    return numEntries;
+}
+
+/* Times one API, logs its percentiles and checks every call succeeded */
+static void moca_benchmark_api(const char *pApi, moca_bench_op_t op)
+{
+    uint32_t iterations = moca_bench_iterations();
+    uint32_t failures;
+
+    UT_LOG("Invoking %s %u times", pApi, iterations);
+    failures = moca_bench_run(op, NULL, iterations, &gBenchHistogram);
+    moca_bench_report(pApi, &gBenchHistogram);
+    UT_LOG("Failed calls: %u", failures);
+
+    UT_ASSERT_EQUAL(failures, 0);
+}
+
+/* Runs op iterations times after the warm up and returns the heap allocations made per call */
+static double moca_benchmark_allocations(moca_bench_op_t op, uint32_t iterations)
+{
+    moca_alloc_stats_t before, after;
+    uint32_t i;
+
+    (void)op(NULL);
+    moca_alloc_get_stats(&before);
+    for (i = 0; i < iterations; i++)
+    {
+        (void)op(NULL);
+    }
+    moca_alloc_get_stats(&after);
+    return (double)(after.allocations - before.allocations) / (double)iterations;
+}
+
+/* Times iterations enumerations of the flow table and returns the heap high-water mark above the starting point */
+static uint64_t moca_benchmark_flow_enumeration(const char *pName, moca_bench_op_t op, moca_bench_flow_enum_t *pEnum,
+                                                uint32_t iterations, moca_bench_histogram_t *pHistogram)
+{
+    moca_alloc_stats_t before, after;
+
+    /* Right after the reset the peak is the live byte count, the baseline of the high-water mark */
+    moca_alloc_reset_peak();
+    moca_alloc_get_stats(&before);
+    UT_LOG("Enumerating the flow table %u times with %s", iterations, pName);
+    UT_ASSERT_EQUAL(moca_bench_run(op, pEnum, iterations, pHistogram), 0);
+    moca_alloc_get_stats(&after);
+    moca_bench_report(pName, pHistogram);
+    UT_LOG("%s: %lu flows per enumeration, heap high-water mark %llu bytes", pName, pEnum->flows,
+           (unsigned long long)(after.peakBytes - before.peakBytes));
+    return after.peakBytes - before.peakBytes;
+}
+
+/* Times a full and an incremental stats poller on the current link and logs the CPU saved per poll */
+static void moca_benchmark_stats_pollers(const char *pLoad)
+{
+    moca_bench_stats_poller_t fullPoller, deltaPoller;
+    uint32_t iterations = moca_bench_iterations();
+    double fullMean, deltaMean;
+    char name[64];
+
+    memset(&fullPoller, 0, sizeof(fullPoller));
+    memset(&deltaPoller, 0, sizeof(deltaPoller));
+    UT_LOG("Polling the statistics %u times on %s link", iterations, pLoad);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_PollFullStats, &fullPoller, iterations, &gBenchBaselineHistogram), 0);
+    snprintf(name, sizeof(name), "moca_IfGetStats poller on %s link", pLoad);
+    moca_bench_report(name, &gBenchBaselineHistogram);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_PollStatsChangedSince, &deltaPoller, iterations, &gBenchHistogram), 0);
+    snprintf(name, sizeof(name), "moca_IfGetStatsChangedSince poller on %s link", pLoad);
+    moca_bench_report(name, &gBenchHistogram);
+
+    fullMean = (double)gBenchBaselineHistogram.sum / (double)gBenchBaselineHistogram.count;
+    deltaMean = (double)gBenchHistogram.sum / (double)gBenchHistogram.count;
+    UT_LOG("%s link: counters copied per poll %.2f full, %.2f incremental, mean CPU per poll saved %.0f ns (%.1f%%)",
+           pLoad,
+           (double)fullPoller.changedFields / (double)fullPoller.polls,
+           (double)deltaPoller.changedFields / (double)deltaPoller.polls,
+           fullMean - deltaMean, (fullMean > 0.0) ? 100.0 * (fullMean - deltaMean) / fullMean : 0.0);
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetIfConfig.
+*
+* Times the interface configuration read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetIfConfig MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_config = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetIfConfig(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetIfConfig...");
+
+    moca_benchmark_api("moca_GetIfConfig", moca_bench_op_GetIfConfig);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetIfConfig...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_IfGetStaticInfo.
+*
+* Times the static interface information read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_IfGetStaticInfo MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_static_info = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetStaticInfo(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetStaticInfo...");
+
+    moca_benchmark_api("moca_IfGetStaticInfo", moca_bench_op_IfGetStaticInfo);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetStaticInfo...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_IfGetDynamicInfo.
+*
+* Times the dynamic interface information read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_IfGetDynamicInfo MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_dynamic_info = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetDynamicInfo(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetDynamicInfo...");
+
+    moca_benchmark_api("moca_IfGetDynamicInfo", moca_bench_op_IfGetDynamicInfo);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetDynamicInfo...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_IfGetStats.
+*
+* Times the interface statistics read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_IfGetStats MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_stats = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetStats(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetStats...");
+
+    moca_benchmark_api("moca_IfGetStats", moca_bench_op_IfGetStats);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetStats...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_IfGetExtCounter.
+*
+* Times the MAC counter read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 005
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_IfGetExtCounter MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_mac_counters = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetExtCounter(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetExtCounter...");
+
+    moca_benchmark_api("moca_IfGetExtCounter", moca_bench_op_IfGetExtCounter);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetExtCounter...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_IfGetExtAggrCounter.
+*
+* Times the aggregate counter read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 006
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_IfGetExtAggrCounter MOCA_BENCH_ITERATIONS times | ifIndex = 0, pmoca_aggregate_counts = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetExtAggrCounter(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetExtAggrCounter...");
+
+    moca_benchmark_api("moca_IfGetExtAggrCounter", moca_bench_op_IfGetExtAggrCounter);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetExtAggrCounter...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetNumAssociatedDevices.
+*
+* Times the associated device count read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 007
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetNumAssociatedDevices MOCA_BENCH_ITERATIONS times | ifIndex = 0, pulCount = valid pointer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetNumAssociatedDevices(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetNumAssociatedDevices...");
+
+    moca_benchmark_api("moca_GetNumAssociatedDevices", moca_bench_op_GetNumAssociatedDevices);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetNumAssociatedDevices...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetAssociatedDevices.
+*
+* Times the associated device table read, including freeing the HAL allocated array over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 008
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetAssociatedDevices MOCA_BENCH_ITERATIONS times | ifIndex = 0, ppdevice_array = valid pointer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetAssociatedDevices(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetAssociatedDevices...");
+
+    moca_benchmark_api("moca_GetAssociatedDevices", moca_bench_op_GetAssociatedDevices);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetAssociatedDevices...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetMocaCPEs.
+*
+* Times the CPE table read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 009
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetMocaCPEs MOCA_BENCH_ITERATIONS times | ifIndex = 0, cpes = kMoca_MaxCpeList entries | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetMocaCPEs(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetMocaCPEs...");
+
+    moca_benchmark_api("moca_GetMocaCPEs", moca_bench_op_GetMocaCPEs);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetMocaCPEs...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetFullMeshRates.
+*
+* Times the full mesh PHY rate table read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 010
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetFullMeshRates MOCA_BENCH_ITERATIONS times | ifIndex = 0, pDeviceArray = kMoca_MaxMocaNodes^2 entries | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetFullMeshRates(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetFullMeshRates...");
+
+    moca_benchmark_api("moca_GetFullMeshRates", moca_bench_op_GetFullMeshRates);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetFullMeshRates...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetFlowStatistics.
+*
+* Times the PQoS flow table read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 011
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetFlowStatistics MOCA_BENCH_ITERATIONS times | ifIndex = 0, pDeviceArray = MOCA_BENCH_MAX_FLOWS entries | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetFlowStatistics(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetFlowStatistics...");
+
+    moca_benchmark_api("moca_GetFlowStatistics", moca_bench_op_GetFlowStatistics);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetFlowStatistics...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_GetResetCount.
+*
+* Times the reset count read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 012
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetResetCount MOCA_BENCH_ITERATIONS times | resetcnt = valid pointer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetResetCount(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetResetCount...");
+
+    moca_benchmark_api("moca_GetResetCount", moca_bench_op_GetResetCount);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetResetCount...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_getIfAcaConfig.
+*
+* Times the ACA configuration read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 013
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_getIfAcaConfig MOCA_BENCH_ITERATIONS times | interfaceIndex = 0, acaCfg = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_getIfAcaConfig(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_getIfAcaConfig...");
+
+    moca_benchmark_api("moca_getIfAcaConfig", moca_bench_op_getIfAcaConfig);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_getIfAcaConfig...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_getIfAcaStatus.
+*
+* Times the ACA status read over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 014
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_getIfAcaStatus MOCA_BENCH_ITERATIONS times | interfaceIndex = 0, pacaStat = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_getIfAcaStatus(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_getIfAcaStatus...");
+
+    moca_benchmark_api("moca_getIfAcaStatus", moca_bench_op_getIfAcaStatus);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_getIfAcaStatus...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_getIfScmod.
+*
+* Times the subcarrier modulation read, including freeing the HAL allocated array over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 015
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_getIfScmod MOCA_BENCH_ITERATIONS times | interfaceIndex = 0, pnumOfEntries and ppscmodStat = valid pointers | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_getIfScmod(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_getIfScmod...");
+
+    moca_benchmark_api("moca_getIfScmod", moca_bench_op_getIfScmod);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_getIfScmod...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_FreqMaskToValue.
+*
+* Times the frequency mask conversion over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 016
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_FreqMaskToValue MOCA_BENCH_ITERATIONS times | mask = "0000000000004000" | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_FreqMaskToValue(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_FreqMaskToValue...");
+
+    moca_benchmark_api("moca_FreqMaskToValue", moca_bench_op_FreqMaskToValue);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_FreqMaskToValue...");
+}
+
+/**
+* @brief Measures the latency distribution of moca_HardwareEquipped.
+*
+* Times the hardware presence check over the configured number of iterations and reports p50, p99 and p99.9.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 017
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_HardwareEquipped MOCA_BENCH_ITERATIONS times | None | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_HardwareEquipped(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_HardwareEquipped...");
+
+    moca_benchmark_api("moca_HardwareEquipped", moca_bench_op_HardwareEquipped);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_HardwareEquipped...");
+}
+
+/**
+* @brief Compares moca_IfGetTelemetrySnapshot against the four calls it replaces.
+*
+* Times the sequence moca_IfGetStats, moca_IfGetExtCounter, moca_IfGetExtAggrCounter, moca_IfGetDynamicInfo and then the
+* single snapshot call, and logs the p50 and p99 saving of the snapshot.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 018
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the four call sequence MOCA_BENCH_ITERATIONS times | ifIndex = 0 | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+* | 02 | Invoke moca_IfGetTelemetrySnapshot MOCA_BENCH_ITERATIONS times | ifIndex = 0, pSnapshot = valid buffer | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+* | 03 | Log the saving at p50 and p99 | None | None | Informational |
+*/
+void test_l2_moca_hal_benchmark_IfGetTelemetrySnapshot(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetTelemetrySnapshot...");
+
+    uint32_t iterations = moca_bench_iterations();
+    uint32_t failures;
+    uint64_t sequenceP50, sequenceP99, snapshotP50, snapshotP99;
+
+    UT_LOG("Invoking the four call telemetry sequence %u times", iterations);
+    failures = moca_bench_run(moca_bench_op_TelemetrySequence, NULL, iterations, &gBenchBaselineHistogram);
+    moca_bench_report("four call sequence", &gBenchBaselineHistogram);
+    UT_ASSERT_EQUAL(failures, 0);
+
+    moca_benchmark_api("moca_IfGetTelemetrySnapshot", moca_bench_op_IfGetTelemetrySnapshot);
+
+    sequenceP50 = moca_bench_histogram_percentile(&gBenchBaselineHistogram, 50.0);
+    sequenceP99 = moca_bench_histogram_percentile(&gBenchBaselineHistogram, 99.0);
+    snapshotP50 = moca_bench_histogram_percentile(&gBenchHistogram, 50.0);
+    snapshotP99 = moca_bench_histogram_percentile(&gBenchHistogram, 99.0);
+    if (sequenceP50 > 0 && sequenceP99 > 0)
+    {
+        UT_LOG("Snapshot saving: p50 %lld ns (%.1f%%), p99 %lld ns (%.1f%%)",
+               (long long)sequenceP50 - (long long)snapshotP50,
+               100.0 * ((double)sequenceP50 - (double)snapshotP50) / (double)sequenceP50,
+               (long long)sequenceP99 - (long long)snapshotP99,
+               100.0 * ((double)sequenceP99 - (double)snapshotP99) / (double)sequenceP99);
+    }
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetTelemetrySnapshot...");
+}
+
+/**
+* @brief Compares moca_GetAssociatedDevicesInto against moca_GetAssociatedDevices, latency and heap allocations per call.
+*
+* The caller owned buffer variant is expected to make no heap allocation at all once warmed up. The allocation
+* check needs the counting allocator of moca_alloc.c and is skipped where it is not supported.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 019
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke moca_GetAssociatedDevicesInto MOCA_BENCH_ITERATIONS times | ifIndex = 0, buffer of kMoca_MaxMocaNodes - 1 entries | Every call returns STATUS_SUCCESS, latency percentiles logged | Should be successful |
+* | 02 | Count the heap allocations of moca_GetAssociatedDevices per call | ifIndex = 0 | Logged | Informational |
+* | 03 | Count the heap allocations of moca_GetAssociatedDevicesInto per call | ifIndex = 0 | 0 allocations | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_GetAssociatedDevicesInto(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetAssociatedDevicesInto...");
+
+    uint32_t iterations = moca_bench_iterations();
+    double allocatingPerCall, intoPerCall;
+
+    moca_benchmark_api("moca_GetAssociatedDevicesInto", moca_bench_op_GetAssociatedDevicesInto);
+
+    if (!moca_alloc_supported())
+    {
+        UT_LOG("Allocation counting not supported by this C library, skipping the allocation check");
+        UT_LOG("Exiting test_l2_moca_hal_benchmark_GetAssociatedDevicesInto...");
+        return;
+    }
+    allocatingPerCall = moca_benchmark_allocations(moca_bench_op_GetAssociatedDevices, iterations);
+    intoPerCall = moca_benchmark_allocations(moca_bench_op_GetAssociatedDevicesInto, iterations);
+    UT_LOG("Heap allocations per call: moca_GetAssociatedDevices %.2f, moca_GetAssociatedDevicesInto %.2f",
+           allocatingPerCall, intoPerCall);
+    UT_ASSERT_TRUE(intoPerCall == 0.0);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetAssociatedDevicesInto...");
+}
+
+/**
+* @brief Measures the throughput of moca_FreqMaskToValue over millions of distinct masks.
+*
+* Channel planning decodes masks in tight loops, so the decoder is timed over a set of MOCA_BENCH_FREQ_MASK_SET
+* pseudo random masks, one in 16 of them invalid, cycled MOCA_BENCH_ITERATIONS x MOCA_BENCH_FREQ_MASKS_PER_ITER times.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 020
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Generate the mask set | 4096 masks, 1 in 16 with an invalid character | None | None |
+* | 02 | Decode every mask of the set repeatedly | 4 million masks by default | Every invalid mask and only those fail, masks per second logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_FreqMaskToValueThroughput(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_FreqMaskToValueThroughput...");
+
+    uint64_t total = (uint64_t)moca_bench_iterations() * MOCA_BENCH_FREQ_MASKS_PER_ITER;
+    uint64_t expectedFailures = 0;
+    uint64_t failures = 0;
+    uint64_t checksum = 0;
+    uint64_t start, elapsed, n;
+    uint32_t rng = 0x9E3779B9;
+    uint32_t i;
+
+    for (i = 0; i < MOCA_BENCH_FREQ_MASK_SET; i++)
+    {
+        uint64_t mask = 0;
+
+        while (mask == 0)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            // Realistic masks select a few adjacent channels
+            mask = (uint64_t)(rng & 0xF) << ((rng >> 4) % 60);
+        }
+        snprintf((char *)gBenchFreqMasks[i], sizeof(gBenchFreqMasks[i]), "%016llx", (unsigned long long)mask);
+        if ((i & 0xF) == 0xF)
+        {
+            gBenchFreqMasks[i][(rng >> 10) % 16] = 'x';
+        }
+    }
+    for (n = 0; n < total; n++)
+    {
+        expectedFailures += ((n % MOCA_BENCH_FREQ_MASK_SET) & 0xF) == 0xF;
+    }
+
+    UT_LOG("Invoking moca_FreqMaskToValue %llu times", (unsigned long long)total);
+    start = moca_bench_now_ns();
+    for (n = 0; n < total; n++)
+    {
+        INT value = moca_FreqMaskToValue(gBenchFreqMasks[n % MOCA_BENCH_FREQ_MASK_SET]);
+
+        if (value == STATUS_FAILURE)
+        {
+            failures++;
+        }
+        else
+        {
+            checksum += (uint64_t)value;
+        }
+    }
+    elapsed = moca_bench_now_ns() - start;
+
+    UT_LOG("moca_FreqMaskToValue: %llu masks in %llu us, %.2f ns/mask, %.1f million masks/s, checksum %llu",
+           (unsigned long long)total, (unsigned long long)(elapsed / 1000),
+           (double)elapsed / (double)total, (elapsed > 0) ? (double)total * 1000.0 / (double)elapsed : 0.0,
+           (unsigned long long)checksum);
+    UT_LOG("Failed decodes: %llu, expected: %llu", (unsigned long long)failures, (unsigned long long)expectedFailures);
+    UT_ASSERT_EQUAL(failures, expectedFailures);
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_FreqMaskToValueThroughput...");
+}
+
+/**
+* @brief Compares polling moca_IfGetStatsChangedSince against polling moca_IfGetStats, on an idle and a loaded link.
+*
+* Each poller keeps a copy of the counters as a management agent would. The full poller compares the whole structure
+* on every tick, the incremental one copies only what the HAL reports as changed. The idle case needs the simulator
+* to stop the traffic, against a vendor HAL only the current link load is measured.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 021
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Stop the simulated traffic and run both pollers MOCA_BENCH_ITERATIONS times | moca_sim_SetTraffic(0, 0, 0) | Every call returns STATUS_SUCCESS, saving logged | Simulator only |
+* | 02 | Restore the traffic and run both pollers MOCA_BENCH_ITERATIONS times | Configured rates | Every call returns STATUS_SUCCESS, saving logged | Should be successful |
+*/
+void test_l2_moca_hal_benchmark_IfGetStatsChangedSince(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_IfGetStatsChangedSince...");
+
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t config;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gBenchIfIndex, 0, 0), STATUS_SUCCESS);
+    moca_benchmark_stats_pollers("an idle");
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gBenchIfIndex, config.txBytesPerSec, config.rxBytesPerSec), STATUS_SUCCESS);
+#endif
+    moca_benchmark_stats_pollers("a loaded");
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_IfGetStatsChangedSince...");
+}
+
+/**
+* @brief Compares cold, partially refreshed and cached moca_GetFullMeshRates reads on a fully populated 16 node network.
+*
+* Rates only change on link events, so a HAL that caches the table answers repeat reads with a copy. The simulator is
+* reconfigured to kMoca_MaxMocaNodes nodes and the table is read with every pair invalidated, with one pair changed
+* per read, and unchanged. Against a vendor HAL only the repeat read of the current network is timed.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 022
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Reconfigure the simulator to a full network | numNodes = kMoca_MaxMocaNodes | STATUS_SUCCESS, 240 entries | Simulator only |
+* | 02 | Invalidate every pair and read the table MOCA_BENCH_ITERATIONS times | moca_sim_InvalidateFullMesh(0) | Every call returns STATUS_SUCCESS, latency percentiles logged | Simulator only |
+* | 03 | Change one pair and read the table MOCA_BENCH_ITERATIONS times | moca_sim_SetPhyRate(0, tx, rx, rate +/- 1) | Every call returns STATUS_SUCCESS, latency percentiles logged | Simulator only |
+* | 04 | Read the unchanged table MOCA_BENCH_ITERATIONS times | ifIndex = 0 | Every call returns STATUS_SUCCESS, latency percentiles and saving logged | Should be successful |
+* | 05 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_benchmark_GetFullMeshRatesCached(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetFullMeshRatesCached...");
+
+#ifdef MOCA_HAL_SIMULATOR
+    uint32_t iterations = moca_bench_iterations();
+    moca_bench_histogram_t onePair;
+    moca_sim_config_t saved, full;
+    uint64_t coldP50, cachedP50;
+    ULONG count = 0;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    full = saved;
+    full.numNodes = kMoca_MaxMocaNodes;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&full), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetFullMeshRates(gBenchIfIndex, gBenchMesh, &count), STATUS_SUCCESS);
+    UT_LOG("Mesh table of %lu entries", count);
+    UT_ASSERT_EQUAL(count, kMoca_MaxMocaNodes * (kMoca_MaxMocaNodes - 1));
+
+    UT_LOG("Invoking moca_GetFullMeshRates %u times with every pair invalidated", iterations);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_GetFullMeshRatesCold, NULL, iterations, &gBenchBaselineHistogram), 0);
+    moca_bench_report("cold moca_GetFullMeshRates", &gBenchBaselineHistogram);
+    UT_LOG("Invoking moca_GetFullMeshRates %u times with one pair changed", iterations);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_GetFullMeshRatesOnePair, NULL, iterations, &onePair), 0);
+    moca_bench_report("one pair changed moca_GetFullMeshRates", &onePair);
+#endif
+    moca_benchmark_api("cached moca_GetFullMeshRates", moca_bench_op_GetFullMeshRates);
+#ifdef MOCA_HAL_SIMULATOR
+    coldP50 = moca_bench_histogram_percentile(&gBenchBaselineHistogram, 50.0);
+    cachedP50 = moca_bench_histogram_percentile(&gBenchHistogram, 50.0);
+    if (coldP50 > 0 && cachedP50 > 0)
+    {
+        UT_LOG("Cached read saving: p50 %lld ns (%.1fx faster)",
+               (long long)coldP50 - (long long)cachedP50, (double)coldP50 / (double)cachedP50);
+    }
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetFullMeshRatesCached...");
+}
+
+/**
+* @brief Compares full enumeration of a large PQoS flow table with moca_GetFlowStatistics and moca_GetFlowStatisticsPage.
+*
+* The single shot call has no capacity, so its caller allocates room for the whole table, while the paged caller
+* reuses a buffer of MOCA_BENCH_FLOW_PAGE flows. The simulator is reconfigured to 16 nodes with 2048 flows each,
+* against a vendor HAL the current table is enumerated and must fit kMoca_MaxCpeList entries. The latency of a full
+* enumeration and the heap high-water mark of each caller are logged; the memory figure needs the counting
+* allocator of moca_alloc.c.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 023
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Reconfigure the simulator with a large flow table | 16 nodes, 2048 flows per node | STATUS_SUCCESS | Simulator only |
+* | 02 | Enumerate the table with moca_GetFlowStatistics | Caller buffer of the whole table | Every call returns STATUS_SUCCESS, latency and high-water mark logged | Should be successful |
+* | 03 | Enumerate the table with moca_GetFlowStatisticsPage | Caller buffer of MOCA_BENCH_FLOW_PAGE flows | Same flow count, latency and high-water mark logged, high-water mark below step 02 | Should be successful |
+* | 04 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_benchmark_GetFlowStatisticsPage(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_GetFlowStatisticsPage...");
+
+    uint32_t iterations = moca_bench_iterations() / MOCA_BENCH_FLOW_ENUM_DIVISOR;
+    moca_bench_flow_enum_t singleShot = { kMoca_MaxCpeList, 0 };
+    moca_bench_flow_enum_t paged = { 0, 0 };
+    uint64_t singleShotPeak, pagedPeak;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved, large;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    large = saved;
+    large.numNodes = kMoca_MaxMocaNodes;
+    large.cpesPerNode = 1;
+    large.flowsPerNode = MOCA_BENCH_LARGE_FLOWS_PER_NODE;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&large), STATUS_SUCCESS);
+    singleShot.tableSize = large.numNodes * large.flowsPerNode;
+#endif
+    if (iterations == 0)
+    {
+        iterations = 1;
+    }
+
+    singleShotPeak = moca_benchmark_flow_enumeration("moca_GetFlowStatistics", moca_bench_op_EnumerateFlowsSingleShot,
+                                                     &singleShot, iterations, &gBenchBaselineHistogram);
+    pagedPeak = moca_benchmark_flow_enumeration("moca_GetFlowStatisticsPage", moca_bench_op_EnumerateFlowsPaged,
+                                                &paged, iterations, &gBenchHistogram);
+    UT_ASSERT_EQUAL(paged.flows, singleShot.flows);
+    if (moca_alloc_supported())
+    {
+        UT_LOG("Paged enumeration high-water mark: %llu bytes against %llu bytes",
+               (unsigned long long)pagedPeak, (unsigned long long)singleShotPeak);
+        if (singleShot.flows > MOCA_BENCH_FLOW_PAGE)
+        {
+            UT_ASSERT_TRUE(pagedPeak < singleShotPeak);
+        }
+    }
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_GetFlowStatisticsPage...");
+}
+
+/**
+* @brief Compares the time to result and CPU cost of an ACA polled with moca_getIfAcaStatus, notified by callback and notified by eventfd.
+*
+* A poll loop finds the result up to one poll interval late and pays a status read per interval, a tight loop
+* finds it sooner at a higher CPU cost. moca_startIfAcaAsync and moca_getIfAcaEventFd deliver the result as the ACA
+* ends. Complete ACAs are run back to back in each mode, on the simulator shortened to MOCA_BENCH_ACA_SIM_MS.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 024
+* **Priority:** Medium
+*
+* **Pre-Conditions:** No other ACA runs on the interface
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Shorten the simulated ACA | acaDurationMs = MOCA_BENCH_ACA_SIM_MS | STATUS_SUCCESS | Simulator only |
+* | 02 | Start ACAs with moca_setIfAcaConfig and poll moca_getIfAcaStatus every 10 ms, then every 1 ms | ACAStart = TRUE | Every ACA ends, time to result, CPU and status reads per ACA logged | Should be successful |
+* | 03 | Start ACAs with moca_startIfAcaAsync and wait for the callback | Completion callback | Every ACA ends, time to result and CPU per ACA logged | Should be successful |
+* | 04 | Start ACAs with moca_setIfAcaConfig and wait on moca_getIfAcaEventFd | poll(2) on the eventfd | Every ACA ends, time to result and CPU per ACA logged | Skipped if the HAL returns -1 |
+* | 05 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_benchmark_AcaCompletion(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_AcaCompletion...");
+
+    uint32_t runs = moca_bench_iterations() / MOCA_BENCH_ACA_RUN_DIVISOR;
+    uint64_t poll10Ms, poll1Ms, callback;
+    int eventFd;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved, shortAca;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    shortAca = saved;
+    shortAca.acaDurationMs = MOCA_BENCH_ACA_SIM_MS;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&shortAca), STATUS_SUCCESS);
+#endif
+    if (runs < MOCA_BENCH_ACA_MIN_RUNS)
+    {
+        runs = MOCA_BENCH_ACA_MIN_RUNS;
+    }
+
+    poll10Ms = moca_benchmark_aca("10 ms moca_getIfAcaStatus poll", MOCA_BENCH_ACA_POLL, 10, -1, runs);
+    poll1Ms = moca_benchmark_aca("1 ms moca_getIfAcaStatus poll", MOCA_BENCH_ACA_POLL, 1, -1, runs);
+    callback = moca_benchmark_aca("moca_startIfAcaAsync callback", MOCA_BENCH_ACA_CALLBACK, 0, -1, runs);
+    UT_LOG("Callback result sooner by %.2f ms than a 10 ms poll and by %.2f ms than a 1 ms poll",
+           ((double)poll10Ms - (double)callback) / 1e6, ((double)poll1Ms - (double)callback) / 1e6);
+    eventFd = moca_getIfAcaEventFd((int)gBenchIfIndex);
+    if (eventFd >= 0)
+    {
+        moca_benchmark_aca("moca_getIfAcaEventFd poll(2)", MOCA_BENCH_ACA_EVENTFD, 0, eventFd, runs);
+    }
+    else
+    {
+        UT_LOG("moca_getIfAcaEventFd not supported by the HAL, eventfd run skipped");
+    }
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_AcaCompletion...");
+}
+
+/**
+* @brief Compares the scalar and SIMD kernels of moca_scmod_analyze on a full 16 node SCMOD dump.
+*
+* A diagnostics sweep reduces every entry of moca_getIfScmod to a bit loading histogram, its average, minimum and
+* maximum and the change since the previous sweep. The simulator is reconfigured to kMoca_MaxMocaNodes nodes, against
+* a vendor HAL the pairs missing from the current network reuse the loading of those present. Every kernel the CPU
+* supports must give the scalar result exactly, then the scalar and the fastest kernel are timed.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 025
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Reconfigure the simulator to a full network | numNodes = kMoca_MaxMocaNodes | STATUS_SUCCESS | Simulator only |
+* | 02 | Read the SCMOD dump and derive a previous one | One in MOCA_BENCH_SCMOD_CHANGE_ONE_IN subcarriers one bit off | STATUS_SUCCESS, 240 entries | Should be successful |
+* | 03 | Analyse both dumps with the scalar kernel | MOCA_SCMOD_KERNEL_SCALAR | STATUS_SUCCESS, every histogram covers MOCA_SCMOD_SUBCARRIERS, every entry changed | Should be successful |
+* | 04 | Analyse both dumps with every supported SIMD kernel | SSE2, AVX2, NEON | STATUS_SUCCESS, identical to the scalar result | Should be successful |
+* | 05 | Time the scalar and the fastest kernel MOCA_BENCH_ITERATIONS times | MOCA_SCMOD_KERNEL_AUTO | Every call returns STATUS_SUCCESS, latency percentiles and speed up logged | Should be successful |
+* | 06 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_benchmark_ScmodAnalysis(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_benchmark_ScmodAnalysis...");
+
+    moca_bench_scmod_t scalar = { MOCA_SCMOD_KERNEL_SCALAR, &gBenchScmodReference };
+    moca_bench_scmod_t fastest = { MOCA_SCMOD_KERNEL_AUTO, &gBenchScmodAnalysis };
+    uint32_t iterations = moca_bench_iterations();
+    uint64_t scalarP50, fastestP50;
+    moca_scmod_kernel_t kernel;
+    char name[64];
+    uint32_t i;
+    int bin, numEntries;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved, full;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    full = saved;
+    full.numNodes = kMoca_MaxMocaNodes;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&full), STATUS_SUCCESS);
+#endif
+    numEntries = moca_benchmark_scmod_dumps();
+    UT_LOG("SCMOD dump of %d entries, analysed as %u", numEntries, (unsigned)MOCA_SCMOD_MAX_LINKS);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+
+    UT_ASSERT_EQUAL(moca_bench_op_ScmodAnalyze(&scalar), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(gBenchScmodReference.numLinks, MOCA_SCMOD_MAX_LINKS);
+    for (i = 0; i < gBenchScmodReference.numLinks; i++)
+    {
+        const moca_scmod_link_t *pLink = &gBenchScmodReference.links[i];
+        uint32_t subcarriers = 0;
+
+        for (bin = 0; bin < MOCA_SCMOD_HISTOGRAM_BINS; bin++)
+        {
+            subcarriers += pLink->histogram[bin];
+        }
+        UT_ASSERT_EQUAL(subcarriers, MOCA_SCMOD_SUBCARRIERS);
+        UT_ASSERT_TRUE(pLink->hasPrevious);
+        UT_ASSERT_TRUE(pLink->changedSubcarriers > 0);
+        UT_ASSERT_TRUE(pLink->minBits <= pLink->maxBits);
+    }
+    UT_LOG("Node 0 receives %.2f bits per subcarrier on average, %u to %u, %u subcarriers changed",
+           gBenchScmodReference.nodes[0].averageBits, gBenchScmodReference.nodes[0].minBits,
+           gBenchScmodReference.nodes[0].maxBits, gBenchScmodReference.nodes[0].changedSubcarriers);
+
+    for (kernel = MOCA_SCMOD_KERNEL_SSE2; kernel < MOCA_SCMOD_KERNEL_COUNT; kernel++)
+    {
+        moca_bench_scmod_t simd = { kernel, &gBenchScmodAnalysis };
+
+        if (!moca_scmod_kernel_supported(kernel))
+        {
+            UT_LOG("Kernel %s not supported on this CPU", moca_scmod_kernel_name(kernel));
+            continue;
+        }
+        UT_ASSERT_EQUAL(moca_bench_op_ScmodAnalyze(&simd), STATUS_SUCCESS);
+        UT_ASSERT_EQUAL(gBenchScmodAnalysis.kernel, kernel);
+        UT_ASSERT_EQUAL(gBenchScmodAnalysis.numLinks, gBenchScmodReference.numLinks);
+        UT_ASSERT_EQUAL(memcmp(gBenchScmodAnalysis.links, gBenchScmodReference.links, sizeof(gBenchScmodReference.links)), 0);
+        UT_ASSERT_EQUAL(memcmp(gBenchScmodAnalysis.nodes, gBenchScmodReference.nodes, sizeof(gBenchScmodReference.nodes)), 0);
+        UT_LOG("Kernel %s matches the scalar kernel", moca_scmod_kernel_name(kernel));
+    }
+
+    UT_LOG("Invoking moca_scmod_analyze %u times with the scalar kernel", iterations);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_ScmodAnalyze, &scalar, iterations, &gBenchBaselineHistogram), 0);
+    moca_bench_report("scalar moca_scmod_analyze", &gBenchBaselineHistogram);
+    kernel = moca_scmod_best_kernel();
+    if (kernel != MOCA_SCMOD_KERNEL_SCALAR)
+    {
+        UT_LOG("Invoking moca_scmod_analyze %u times with the %s kernel", iterations, moca_scmod_kernel_name(kernel));
+        UT_ASSERT_EQUAL(moca_bench_run(moca_bench_op_ScmodAnalyze, &fastest, iterations, &gBenchHistogram), 0);
+        snprintf(name, sizeof(name), "%s moca_scmod_analyze", moca_scmod_kernel_name(kernel));
+        moca_bench_report(name, &gBenchHistogram);
+        scalarP50 = moca_bench_histogram_percentile(&gBenchBaselineHistogram, 50.0);
+        fastestP50 = moca_bench_histogram_percentile(&gBenchHistogram, 50.0);
+        if (fastestP50 > 0)
+        {
+            UT_LOG("%s kernel: p50 %.1fx the scalar kernel, %.2f GB/s of bit loading",
+                   moca_scmod_kernel_name(kernel), (double)scalarP50 / (double)fastestP50,
+                   2.0 * MOCA_SCMOD_MAX_LINKS * MOCA_SCMOD_SUBCARRIERS / (double)fastestP50);
+        }
+    }
+    else
+    {
+        UT_LOG("No SIMD kernel on this CPU, only the scalar kernel was timed");
+    }
+
+    UT_LOG("Exiting test_l2_moca_hal_benchmark_ScmodAnalysis...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_benchmark_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal benchmark]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetIfConfig", test_l2_moca_hal_benchmark_GetIfConfig);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetStaticInfo", test_l2_moca_hal_benchmark_IfGetStaticInfo);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetDynamicInfo", test_l2_moca_hal_benchmark_IfGetDynamicInfo);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetStats", test_l2_moca_hal_benchmark_IfGetStats);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetExtCounter", test_l2_moca_hal_benchmark_IfGetExtCounter);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetExtAggrCounter", test_l2_moca_hal_benchmark_IfGetExtAggrCounter);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetNumAssociatedDevices", test_l2_moca_hal_benchmark_GetNumAssociatedDevices);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetAssociatedDevices", test_l2_moca_hal_benchmark_GetAssociatedDevices);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetMocaCPEs", test_l2_moca_hal_benchmark_GetMocaCPEs);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetFullMeshRates", test_l2_moca_hal_benchmark_GetFullMeshRates);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetFlowStatistics", test_l2_moca_hal_benchmark_GetFlowStatistics);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetResetCount", test_l2_moca_hal_benchmark_GetResetCount);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_getIfAcaConfig", test_l2_moca_hal_benchmark_getIfAcaConfig);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_getIfAcaStatus", test_l2_moca_hal_benchmark_getIfAcaStatus);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_getIfScmod", test_l2_moca_hal_benchmark_getIfScmod);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_FreqMaskToValue", test_l2_moca_hal_benchmark_FreqMaskToValue);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_HardwareEquipped", test_l2_moca_hal_benchmark_HardwareEquipped);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetTelemetrySnapshot", test_l2_moca_hal_benchmark_IfGetTelemetrySnapshot);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetAssociatedDevicesInto", test_l2_moca_hal_benchmark_GetAssociatedDevicesInto);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_FreqMaskToValueThroughput", test_l2_moca_hal_benchmark_FreqMaskToValueThroughput);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_IfGetStatsChangedSince", test_l2_moca_hal_benchmark_IfGetStatsChangedSince);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetFullMeshRatesCached", test_l2_moca_hal_benchmark_GetFullMeshRatesCached);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_GetFlowStatisticsPage", test_l2_moca_hal_benchmark_GetFlowStatisticsPage);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_AcaCompletion", test_l2_moca_hal_benchmark_AcaCompletion);
+    UT_add_test(pSuite, "l2_moca_hal_benchmark_ScmodAnalysis", test_l2_moca_hal_benchmark_ScmodAnalysis);
+
+    return 0;
+}
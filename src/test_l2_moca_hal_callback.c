@@ -0,0 +1,492 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_callback.c
+* @page moca_hal_callback Level 2 Associated Device Callback Tests
+*
+* ## Module's Role
+* This module drives the callback registered with moca_associatedDevice_callback_register()
+* with storms of node join and leave events, thousands per second, produced by the
+* simulator. It measures the time from an event being generated to the callback being
+* entered, checks that events are delivered in order, and checks that a slow or re-entrant
+* callback neither blocks the event source nor the other HAL calls.
+*
+* The events can only be generated on demand by the simulator, so the suite is only
+* registered when built with MOCA_HAL_SIMULATOR.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_CALLBACK_STORM_MS | Length of each event storm | 1000 |
+*
+* **Pre-Conditions:**  At least one remote node is associated on interface 0.
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "moca_bench.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#ifdef MOCA_HAL_SIMULATOR
+
+#define MOCA_CALLBACK_DEFAULT_STORM_MS    1000
+#define MOCA_CALLBACK_MAX_STORM_MS        60000
+#define MOCA_CALLBACK_WAIT_MS             30000
+#define MOCA_CALLBACK_SLOW_SLEEP_NS       2000000ULL    /**< Time the slow callback spends in every call */
+#define MOCA_CALLBACK_SLOW_RATE           2000
+#define MOCA_CALLBACK_HAL_P99_LIMIT_NS    1000000ULL    /**< Below MOCA_CALLBACK_SLOW_SLEEP_NS, so a HAL lock held across the callback shows */
+#define MOCA_CALLBACK_ORDERING_EVENTS     10000
+#define MOCA_CALLBACK_REENTRANT_EVENTS    2000
+
+extern int init_moca_hal_init(void);
+
+/* Written by the dispatcher thread inside the callback, read once moca_sim_WaitDeviceEvents() returns */
+typedef struct
+{
+    uint64_t sleepNs;
+    BOOL reenter;
+    uint64_t calls;
+    uint64_t unidentified;
+    uint64_t outOfOrder;
+    uint64_t badNode;
+    uint64_t reentrantFailures;
+    uint64_t transitionsChecked;
+    uint64_t lastSequence;
+    uint64_t nodeSequence[kMoca_MaxMocaNodes];
+    BOOL nodeActive[kMoca_MaxMocaNodes];
+    moca_bench_histogram_t latency;
+} moca_callback_state_t;
+
+static ULONG gCallbackIfIndex = 0;
+static ULONG gCallbackRemoteNodes = 0;
+static moca_callback_state_t gCallbackState;
+static moca_associated_device_t gCallbackDevices[kMoca_MaxMocaNodes - 1];
+
+/*
+ * Nodes are flapped in turn, so two events of the same node are a multiple of the
+ * number of remote nodes apart, and consecutive ones must change the Active state.
+ */
+static INT moca_callback_on_device(ULONG ifIndex, moca_associated_device_t *pDevice)
+{
+    moca_callback_state_t *pState = &gCallbackState;
+    moca_sim_event_info_t event;
+    uint64_t now = moca_bench_now_ns();
+
+    pState->calls++;
+    if (moca_sim_GetCurrentEvent(&event) != STATUS_SUCCESS)
+    {
+        pState->unidentified++;
+        return STATUS_FAILURE;
+    }
+    moca_bench_histogram_record(&pState->latency, now - event.timestampNs);
+    if (event.sequence <= pState->lastSequence)
+    {
+        pState->outOfOrder++;
+    }
+    pState->lastSequence = event.sequence;
+
+    if (ifIndex != gCallbackIfIndex || pDevice == NULL || pDevice->NodeID == 0 || pDevice->NodeID >= kMoca_MaxMocaNodes)
+    {
+        pState->badNode++;
+    }
+    else
+    {
+        uint64_t previous = pState->nodeSequence[pDevice->NodeID];
+
+        if (previous != 0)
+        {
+            uint64_t gap = event.sequence - previous;
+
+            if (gap % gCallbackRemoteNodes != 0)
+            {
+                pState->badNode++;
+            }
+            else if (gap == gCallbackRemoteNodes)
+            {
+                pState->transitionsChecked++;
+                if (pDevice->Active == pState->nodeActive[pDevice->NodeID])
+                {
+                    pState->outOfOrder++;
+                }
+            }
+        }
+        pState->nodeSequence[pDevice->NodeID] = event.sequence;
+        pState->nodeActive[pDevice->NodeID] = pDevice->Active;
+    }
+
+    if (pState->reenter == TRUE)
+    {
+        moca_stats_t stats;
+        ULONG count = 0;
+
+        if (moca_GetAssociatedDevicesInto(ifIndex, gCallbackDevices, kMoca_MaxMocaNodes - 1, &count) != STATUS_SUCCESS ||
+            count != gCallbackRemoteNodes ||
+            moca_IfGetStats(ifIndex, &stats) != STATUS_SUCCESS)
+        {
+            pState->reentrantFailures++;
+        }
+    }
+    if (pState->sleepNs > 0)
+    {
+        moca_bench_sleep_ns(pState->sleepNs);
+    }
+    return STATUS_SUCCESS;
+}
+
+static void moca_callback_reset(uint64_t sleepNs, BOOL reenter)
+{
+    memset(&gCallbackState, 0, sizeof(gCallbackState));
+    gCallbackState.sleepNs = sleepNs;
+    gCallbackState.reenter = reenter;
+    moca_bench_histogram_reset(&gCallbackState.latency);
+}
+
+static BOOL moca_callback_prepare(void)
+{
+    ULONG numDevices = 0;
+
+    if (moca_GetNumAssociatedDevices(gCallbackIfIndex, &numDevices) != STATUS_SUCCESS || numDevices == 0)
+    {
+        UT_LOG("No remote node on interface %lu, cannot generate device events", gCallbackIfIndex);
+        return FALSE;
+    }
+    gCallbackRemoteNodes = numDevices;
+    return TRUE;
+}
+
+/* Runs one storm to completion and returns the change in the generator counters */
+static INT moca_callback_storm(ULONG count, ULONG eventsPerSec, moca_sim_event_stats_t *pDelta)
+{
+    moca_sim_event_stats_t before;
+    moca_sim_event_stats_t after;
+
+    if (moca_sim_GetEventStats(&before) != STATUS_SUCCESS ||
+        moca_sim_GenerateDeviceEvents(gCallbackIfIndex, count, eventsPerSec) != STATUS_SUCCESS ||
+        moca_sim_WaitDeviceEvents(MOCA_CALLBACK_WAIT_MS) != STATUS_SUCCESS ||
+        moca_sim_GetEventStats(&after) != STATUS_SUCCESS)
+    {
+        return STATUS_FAILURE;
+    }
+    pDelta->generated = after.generated - before.generated;
+    pDelta->dispatched = after.dispatched - before.dispatched;
+    pDelta->undelivered = after.undelivered - before.undelivered;
+    pDelta->dropped = after.dropped - before.dropped;
+    pDelta->maxQueueDepth = after.maxQueueDepth;
+    return STATUS_SUCCESS;
+}
+
+static void moca_callback_check_delivery(ULONG count, const moca_sim_event_stats_t *pDelta)
+{
+    UT_LOG("generated=%llu dispatched=%llu dropped=%llu undelivered=%llu maxQueueDepth=%llu",
+           (unsigned long long)pDelta->generated, (unsigned long long)pDelta->dispatched,
+           (unsigned long long)pDelta->dropped, (unsigned long long)pDelta->undelivered,
+           (unsigned long long)pDelta->maxQueueDepth);
+    UT_ASSERT_EQUAL(pDelta->generated, count);
+    UT_ASSERT_EQUAL(pDelta->dispatched + pDelta->dropped, count);
+    UT_ASSERT_EQUAL(pDelta->undelivered, 0);
+    UT_ASSERT_EQUAL(gCallbackState.calls, pDelta->dispatched);
+    UT_ASSERT_EQUAL(gCallbackState.unidentified, 0);
+    UT_ASSERT_EQUAL(gCallbackState.outOfOrder, 0);
+    UT_ASSERT_EQUAL(gCallbackState.badNode, 0);
+}
+
+/**
+* @brief Measures the latency from an associated device event being generated to the callback being entered.
+*
+* Storms of 1000, 5000 and 20000 events per second are run for MOCA_CALLBACK_STORM_MS each with a
+* callback that returns at once. The latency histogram and the number of dropped events are logged
+* for every rate.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** At least one remote node is associated
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Register the callback with moca_associatedDevice_callback_register | callback_proc = valid function | Returns | Should be successful |
+* | 02 | Generate a storm of events and wait for delivery | 1000, 5000 and 20000 events per second | Every event delivered or dropped, in order, none dropped at 1000 per second | Latency logged |
+* | 03 | Unregister the callback | callback_proc = NULL | Returns | Should be successful |
+*/
+void test_l2_moca_hal_callback_DispatchLatency(void)
+{
+    BOOL ready;
+    static const ULONG rates[] = { 1000, 5000, 20000 };
+    uint32_t stormMs = moca_bench_env_u32("MOCA_CALLBACK_STORM_MS", MOCA_CALLBACK_DEFAULT_STORM_MS, MOCA_CALLBACK_MAX_STORM_MS);
+    char name[64];
+    size_t i;
+
+    UT_LOG("Entering test_l2_moca_hal_callback_DispatchLatency...");
+
+    ready = moca_callback_prepare();
+    UT_ASSERT_TRUE(ready);
+    if (ready == FALSE)
+    {
+        return;
+    }
+    moca_associatedDevice_callback_register(moca_callback_on_device);
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        ULONG count = (ULONG)((uint64_t)rates[i] * stormMs / 1000);
+        moca_sim_event_stats_t delta;
+        INT status;
+
+        moca_callback_reset(0, FALSE);
+        status = moca_callback_storm(count, rates[i], &delta);
+        UT_ASSERT_EQUAL(status, STATUS_SUCCESS);
+        if (status != STATUS_SUCCESS)
+        {
+            break;
+        }
+        snprintf(name, sizeof(name), "event to callback @ %lu/s", rates[i]);
+        moca_bench_report(name, &gCallbackState.latency);
+        moca_callback_check_delivery(count, &delta);
+        if (rates[i] == rates[0])
+        {
+            UT_ASSERT_EQUAL(delta.dropped, 0);
+        }
+    }
+    moca_associatedDevice_callback_register(NULL);
+
+    UT_LOG("Exiting test_l2_moca_hal_callback_DispatchLatency...");
+}
+
+/**
+* @brief Checks that associated device events reach the callback in the order they were generated.
+*
+* A storm is generated as fast as possible, so the queue overflows and events are dropped. The
+* events that are delivered must still arrive with increasing sequence numbers, and two consecutive
+* events of the same node must change its Active state.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** High
+*
+* **Pre-Conditions:** At least one remote node is associated
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Register the callback with moca_associatedDevice_callback_register | callback_proc = valid function | Returns | Should be successful |
+* | 02 | Generate an unpaced storm and wait for delivery | 10000 events | Sequence numbers increasing, every node alternates leave and join | Drops logged |
+* | 03 | Unregister the callback | callback_proc = NULL | Returns | Should be successful |
+*/
+void test_l2_moca_hal_callback_Ordering(void)
+{
+    BOOL ready;
+    moca_sim_event_stats_t delta;
+    INT status;
+
+    UT_LOG("Entering test_l2_moca_hal_callback_Ordering...");
+
+    ready = moca_callback_prepare();
+    UT_ASSERT_TRUE(ready);
+    if (ready == FALSE)
+    {
+        return;
+    }
+    moca_associatedDevice_callback_register(moca_callback_on_device);
+    moca_callback_reset(0, FALSE);
+    status = moca_callback_storm(MOCA_CALLBACK_ORDERING_EVENTS, 0, &delta);
+    moca_associatedDevice_callback_register(NULL);
+
+    UT_ASSERT_EQUAL(status, STATUS_SUCCESS);
+    if (status == STATUS_SUCCESS)
+    {
+        UT_LOG("Leave / join transitions checked: %llu", (unsigned long long)gCallbackState.transitionsChecked);
+        moca_callback_check_delivery(MOCA_CALLBACK_ORDERING_EVENTS, &delta);
+        UT_ASSERT_TRUE(gCallbackState.transitionsChecked > 0);
+    }
+
+    UT_LOG("Exiting test_l2_moca_hal_callback_Ordering...");
+}
+
+/**
+* @brief Checks that a slow callback blocks neither the event source nor the other HAL calls.
+*
+* The callback sleeps for 2 ms per event while events arrive at 2000 per second, four times faster
+* than it can consume them. The generator must still finish on schedule, moca_IfGetStats called
+* from the test thread during the storm must keep a p99 latency below 1 ms, and the excess events
+* must be dropped rather than queued without bound.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** High
+*
+* **Pre-Conditions:** At least one remote node is associated
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Register a callback that sleeps 2 ms | callback_proc = valid function | Returns | Should be successful |
+* | 02 | Generate a storm and poll moca_IfGetStats until it is generated | 2000 events per second | Generation not slowed down, moca_IfGetStats p99 below 1 ms | Latency and drops logged |
+* | 03 | Wait for delivery | None | Every event delivered or dropped, queue depth bounded | Should be successful |
+* | 04 | Unregister the callback | callback_proc = NULL | Returns | Should be successful |
+*/
+void test_l2_moca_hal_callback_SlowCallback(void)
+{
+    BOOL ready;
+    uint32_t stormMs = moca_bench_env_u32("MOCA_CALLBACK_STORM_MS", MOCA_CALLBACK_DEFAULT_STORM_MS, MOCA_CALLBACK_MAX_STORM_MS);
+    ULONG count = (ULONG)((uint64_t)MOCA_CALLBACK_SLOW_RATE * stormMs / 1000);
+    uint64_t expectedNs = (uint64_t)count * 1000000000ULL / MOCA_CALLBACK_SLOW_RATE;
+    moca_bench_histogram_t halLatency;
+    moca_sim_event_stats_t before;
+    moca_sim_event_stats_t after;
+    moca_sim_event_stats_t delta;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t p99;
+
+    UT_LOG("Entering test_l2_moca_hal_callback_SlowCallback...");
+
+    ready = moca_callback_prepare();
+    UT_ASSERT_TRUE(ready);
+    if (ready == FALSE)
+    {
+        return;
+    }
+    moca_associatedDevice_callback_register(moca_callback_on_device);
+    moca_callback_reset(MOCA_CALLBACK_SLOW_SLEEP_NS, FALSE);
+    moca_bench_histogram_reset(&halLatency);
+    UT_ASSERT_EQUAL(moca_sim_GetEventStats(&before), STATUS_SUCCESS);
+
+    start = moca_bench_now_ns();
+    UT_ASSERT_EQUAL(moca_sim_GenerateDeviceEvents(gCallbackIfIndex, count, MOCA_CALLBACK_SLOW_RATE), STATUS_SUCCESS);
+    do
+    {
+        moca_stats_t stats;
+        uint64_t callStart = moca_bench_now_ns();
+
+        UT_ASSERT_EQUAL(moca_IfGetStats(gCallbackIfIndex, &stats), STATUS_SUCCESS);
+        moca_bench_histogram_record(&halLatency, moca_bench_now_ns() - callStart);
+        moca_bench_sleep_ns(100000);
+        UT_ASSERT_EQUAL(moca_sim_GetEventStats(&after), STATUS_SUCCESS);
+        elapsed = moca_bench_now_ns() - start;
+    } while (after.generated - before.generated < count && elapsed < 4 * expectedNs);
+
+    UT_LOG("%lu events generated in %llu ms, %llu ms expected", count,
+           (unsigned long long)(elapsed / 1000000), (unsigned long long)(expectedNs / 1000000));
+    moca_bench_report("moca_IfGetStats during the storm", &halLatency);
+    UT_ASSERT_TRUE(elapsed < 2 * expectedNs);
+    p99 = moca_bench_histogram_percentile(&halLatency, 99.0);
+    UT_ASSERT_TRUE(p99 < MOCA_CALLBACK_HAL_P99_LIMIT_NS);
+
+    UT_ASSERT_EQUAL(moca_sim_WaitDeviceEvents(MOCA_CALLBACK_WAIT_MS), STATUS_SUCCESS);
+    moca_associatedDevice_callback_register(NULL);
+    UT_ASSERT_EQUAL(moca_sim_GetEventStats(&after), STATUS_SUCCESS);
+    delta.generated = after.generated - before.generated;
+    delta.dispatched = after.dispatched - before.dispatched;
+    delta.undelivered = after.undelivered - before.undelivered;
+    delta.dropped = after.dropped - before.dropped;
+    delta.maxQueueDepth = after.maxQueueDepth;
+    moca_callback_check_delivery(count, &delta);
+    UT_ASSERT_TRUE(delta.maxQueueDepth <= MOCA_SIM_EVENT_QUEUE_DEPTH);
+
+    UT_LOG("Exiting test_l2_moca_hal_callback_SlowCallback...");
+}
+
+/**
+* @brief Checks that the callback can call back into the HAL.
+*
+* Every callback reads the associated devices with moca_GetAssociatedDevicesInto and the
+* interface counters with moca_IfGetStats. A HAL that holds its lock while calling the
+* callback deadlocks here, which shows as a delivery timeout.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** High
+*
+* **Pre-Conditions:** At least one remote node is associated
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Register a callback that calls moca_GetAssociatedDevicesInto and moca_IfGetStats | callback_proc = valid function | Returns | Should be successful |
+* | 02 | Generate an unpaced storm and wait for delivery | 2000 events | Delivered without timeout, every nested call returns STATUS_SUCCESS | Should be successful |
+* | 03 | Unregister the callback | callback_proc = NULL | Returns | Should be successful |
+*/
+void test_l2_moca_hal_callback_ReentrantCallback(void)
+{
+    BOOL ready;
+    moca_sim_event_stats_t delta;
+    INT status;
+
+    UT_LOG("Entering test_l2_moca_hal_callback_ReentrantCallback...");
+
+    ready = moca_callback_prepare();
+    UT_ASSERT_TRUE(ready);
+    if (ready == FALSE)
+    {
+        return;
+    }
+    moca_associatedDevice_callback_register(moca_callback_on_device);
+    moca_callback_reset(0, TRUE);
+    status = moca_callback_storm(MOCA_CALLBACK_REENTRANT_EVENTS, 0, &delta);
+    moca_associatedDevice_callback_register(NULL);
+
+    UT_ASSERT_EQUAL(status, STATUS_SUCCESS);
+    if (status == STATUS_SUCCESS)
+    {
+        moca_callback_check_delivery(MOCA_CALLBACK_REENTRANT_EVENTS, &delta);
+        UT_ASSERT_EQUAL(gCallbackState.reentrantFailures, 0);
+    }
+
+    UT_LOG("Exiting test_l2_moca_hal_callback_ReentrantCallback...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+int test_moca_hal_callback_register(void)
+{
+#ifdef MOCA_HAL_SIMULATOR
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal callback]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_callback_DispatchLatency", test_l2_moca_hal_callback_DispatchLatency);
+    UT_add_test(pSuite, "l2_moca_hal_callback_Ordering", test_l2_moca_hal_callback_Ordering);
+    UT_add_test(pSuite, "l2_moca_hal_callback_SlowCallback", test_l2_moca_hal_callback_SlowCallback);
+    UT_add_test(pSuite, "l2_moca_hal_callback_ReentrantCallback", test_l2_moca_hal_callback_ReentrantCallback);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_config.c
+* @page moca_hal_config Level 2 Partial Configuration Tests
+*
+* ## Module's Role
+* This module checks moca_SetIfConfigFields(). Only the selected fields that differ from the
+* current configuration may be applied, a change to a field that takes effect on the running
+* link must leave moca_GetResetCount() where it was, and a change that needs a re-formation must
+* advance it by exactly one. An apply with an invalid field applies nothing.
+*
+* Against the simulator a re-formation keeps the link down for a configurable time, and the
+* latency test measures how long the link is down after a full moca_SetIfConfig() and after a
+* partial apply of the same change, then times both calls.
+*
+* **Pre-Conditions:**  None
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include "moca_hal_ext.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "moca_bench.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_L2_CONFIG_REFORM_MS      100           /**< Downtime the simulator gives a re-formation */
+#define MOCA_L2_CONFIG_POLL_NS        1000000ULL    /**< Interval of the link status polls */
+#define MOCA_L2_CONFIG_TIMEOUT_NS     5000000000ULL /**< Longest wait for the link to come back */
+
+/* Fields every node applies on the running link */
+#define MOCA_L2_CONFIG_LIVE_FIELDS \
+    (MOCA_CFG_FIELD_BIT(MOCA_CFG_ALIAS) | MOCA_CFG_FIELD_BIT(MOCA_CFG_TX_POWER_LIMIT) | \
+     MOCA_CFG_FIELD_BIT(MOCA_CFG_BEACON_POWER_LIMIT) | MOCA_CFG_FIELD_BIT(MOCA_CFG_MAX_INGRESS_BW_THRESHOLD) | \
+     MOCA_CFG_FIELD_BIT(MOCA_CFG_MAX_EGRESS_BW_THRESHOLD))
+
+extern int init_moca_hal_init(void);
+
+typedef struct
+{
+    moca_cfg_t config;
+    INT step;                       /**< Power limit change that stays in range */
+    uint32_t applies;
+} moca_l2_config_bench_t;
+
+static ULONG gConfigIfIndex = 0;
+
+/* Changes every live field of pConfig to a value it did not have */
+static void moca_l2_config_change_live(moca_cfg_t *pConfig)
+{
+    snprintf(pConfig->Alias, sizeof(pConfig->Alias), "%s", (strcmp(pConfig->Alias, "l2-config") == 0) ? "l2-config-other" : "l2-config");
+    pConfig->TxPowerLimit = (pConfig->TxPowerLimit > 0) ? pConfig->TxPowerLimit - 1 : pConfig->TxPowerLimit + 1;
+    pConfig->BeaconPowerLimit = (pConfig->BeaconPowerLimit > 0) ? pConfig->BeaconPowerLimit - 1 : 1;
+    pConfig->MaxIngressBWThreshold += 10;
+    pConfig->MaxEgressBWThreshold += 10;
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+static moca_bench_histogram_t gConfigHistogram;
+
+/* Time from startNs until the link reports up again, polled every MOCA_L2_CONFIG_POLL_NS */
+static uint64_t moca_l2_config_downtime_ns(uint64_t startNs)
+{
+    moca_dynamic_info_t info;
+    uint64_t now;
+
+    for (;;)
+    {
+        now = moca_bench_now_ns();
+        if (moca_IfGetDynamicInfo(gConfigIfIndex, &info) == STATUS_SUCCESS && info.Status == IF_STATUS_Up)
+        {
+            return now - startNs;
+        }
+        if (now - startNs > MOCA_L2_CONFIG_TIMEOUT_NS)
+        {
+            return UINT64_MAX;
+        }
+        moca_bench_sleep_ns(MOCA_L2_CONFIG_POLL_NS);
+    }
+}
+
+/* Alternates the power limit of the configuration and applies all of it */
+static int moca_l2_config_op_Full(void *pContext)
+{
+    moca_l2_config_bench_t *pBench = (moca_l2_config_bench_t *)pContext;
+
+    pBench->config.TxPowerLimit += (pBench->applies++ % 2 == 0) ? pBench->step : -pBench->step;
+    return moca_SetIfConfig(gConfigIfIndex, &pBench->config);
+}
+
+/* Alternates the power limit of the configuration and applies what changed */
+static int moca_l2_config_op_Fields(void *pContext)
+{
+    moca_l2_config_bench_t *pBench = (moca_l2_config_bench_t *)pContext;
+
+    pBench->config.TxPowerLimit += (pBench->applies++ % 2 == 0) ? pBench->step : -pBench->step;
+    return moca_SetIfConfigFields(gConfigIfIndex, &pBench->config, MOCA_CFG_ALL_FIELDS, NULL);
+}
+
+/* Applies a configuration that changes nothing */
+static int moca_l2_config_op_Unchanged(void *pContext)
+{
+    moca_l2_config_bench_t *pBench = (moca_l2_config_bench_t *)pContext;
+
+    return moca_SetIfConfigFields(gConfigIfIndex, &pBench->config, MOCA_CFG_ALL_FIELDS, NULL);
+}
+
+#endif
+
+/**
+* @brief Applies a change to every live field and checks it is applied without a reset.
+*
+* The configuration passed also flips bPreferredNC, which needs a re-formation, outside fieldMask: it must be ignored.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Change the live fields | fieldMask = MOCA_L2_CONFIG_LIVE_FIELDS, bPreferredNC flipped | changedMask = fieldMask, reformMask = 0 | Should be successful |
+* | 02 | Read the configuration and reset count | ifIndex = 0 | New live values, old bPreferredNC, same reset count | Should be successful |
+* | 03 | Restore the configuration | fieldMask = MOCA_CFG_ALL_FIELDS | changedMask = MOCA_L2_CONFIG_LIVE_FIELDS, same reset count | Should be successful |
+*/
+void test_l2_moca_hal_config_LiveFields(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_config_LiveFields...");
+
+    moca_cfg_t original, changed, current;
+    moca_cfg_apply_result_t result;
+    ULONG before = 0, after = 0;
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    changed = original;
+    moca_l2_config_change_live(&changed);
+    changed.bPreferredNC = !original.bPreferredNC;
+
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &changed, MOCA_L2_CONFIG_LIVE_FIELDS, &result), STATUS_SUCCESS);
+    UT_LOG("changedMask 0x%lx, reformMask 0x%lx", result.changedMask, result.reformMask);
+    UT_ASSERT_EQUAL(result.changedMask, MOCA_L2_CONFIG_LIVE_FIELDS);
+    UT_ASSERT_EQUAL(result.reformMask, 0);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(current.Alias, changed.Alias), 0);
+    UT_ASSERT_EQUAL(current.TxPowerLimit, changed.TxPowerLimit);
+    UT_ASSERT_EQUAL(current.BeaconPowerLimit, changed.BeaconPowerLimit);
+    UT_ASSERT_EQUAL(current.MaxIngressBWThreshold, changed.MaxIngressBWThreshold);
+    UT_ASSERT_EQUAL(current.MaxEgressBWThreshold, changed.MaxEgressBWThreshold);
+    UT_ASSERT_EQUAL(current.bPreferredNC, original.bPreferredNC);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("Reset count %lu before, %lu after", before, after);
+    UT_ASSERT_EQUAL(after, before);
+
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &original, MOCA_CFG_ALL_FIELDS, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.changedMask, MOCA_L2_CONFIG_LIVE_FIELDS);
+    UT_ASSERT_EQUAL(result.reformMask, 0);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(after, before);
+
+    UT_LOG("Exiting test_l2_moca_hal_config_LiveFields...");
+}
+
+/**
+* @brief Applies changes that need a re-formation and checks each one resets the link exactly once.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Flip bPreferredNC along with a live field | Alias and bPreferredNC changed | Both changed, bPreferredNC re-formed, reset count + 1 | Should be successful |
+* | 02 | Request a reset | Reset = TRUE | Reset re-formed, reset count + 1, Reset reads FALSE | Should be successful |
+* | 03 | Restore the configuration | fieldMask = MOCA_CFG_ALL_FIELDS | reset count + 1 | Should be successful |
+*/
+void test_l2_moca_hal_config_Reform(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_config_Reform...");
+
+    moca_cfg_t original, changed, current;
+    moca_cfg_apply_result_t result;
+    ULONG before = 0, after = 0;
+    ULONG preferredNC = MOCA_CFG_FIELD_BIT(MOCA_CFG_PREFERRED_NC);
+    ULONG alias = MOCA_CFG_FIELD_BIT(MOCA_CFG_ALIAS);
+    ULONG reset = MOCA_CFG_FIELD_BIT(MOCA_CFG_RESET);
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    changed = original;
+    moca_l2_config_change_live(&changed);
+    changed.bPreferredNC = !original.bPreferredNC;
+
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &changed, preferredNC | alias, &result), STATUS_SUCCESS);
+    UT_LOG("changedMask 0x%lx, reformMask 0x%lx", result.changedMask, result.reformMask);
+    UT_ASSERT_EQUAL(result.changedMask, preferredNC | alias);
+    UT_ASSERT_TRUE((result.reformMask & preferredNC) != 0);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("Reset count %lu before, %lu after", before, after);
+    UT_ASSERT_EQUAL(after, before + 1);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(current.bPreferredNC, changed.bPreferredNC);
+    UT_ASSERT_EQUAL(strcmp(current.Alias, changed.Alias), 0);
+
+    current.Reset = TRUE;
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &current, reset, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.changedMask, reset);
+    UT_ASSERT_EQUAL(result.reformMask, reset);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(after, before + 2);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(current.Reset, FALSE);
+
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &original, MOCA_CFG_ALL_FIELDS, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.changedMask, preferredNC | alias);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(after, before + 3);
+
+    UT_LOG("Exiting test_l2_moca_hal_config_Reform...");
+}
+
+/**
+* @brief Applies valid changes along with an invalid one and checks none of them is applied.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Change live fields and bPreferredNC with TxPowerLimit out of range | TxPowerLimit = INT_MAX | STATUS_FAILURE | Should fail |
+* | 02 | Read the configuration and reset count | ifIndex = 0 | Unchanged | Nothing was applied |
+* | 03 | Apply the same changes with TxPowerLimit left out of fieldMask | fieldMask without TxPowerLimit | STATUS_SUCCESS | Should be successful |
+* | 04 | Restore the configuration | fieldMask = MOCA_CFG_ALL_FIELDS | STATUS_SUCCESS | Should be successful |
+*/
+void test_l2_moca_hal_config_Transaction(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_config_Transaction...");
+
+    moca_cfg_t original, invalid, current;
+    moca_cfg_apply_result_t result;
+    ULONG before = 0, after = 0;
+    ULONG fieldMask = MOCA_L2_CONFIG_LIVE_FIELDS | MOCA_CFG_FIELD_BIT(MOCA_CFG_PREFERRED_NC);
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    invalid = original;
+    moca_l2_config_change_live(&invalid);
+    invalid.bPreferredNC = !original.bPreferredNC;
+    invalid.TxPowerLimit = INT32_MAX;
+
+    memset(&result, 0, sizeof(result));
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &invalid, fieldMask, &result), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&current, &original, sizeof(current)), 0);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("Reset count %lu before, %lu after", before, after);
+    UT_ASSERT_EQUAL(after, before);
+
+    fieldMask &= ~MOCA_CFG_FIELD_BIT(MOCA_CFG_TX_POWER_LIMIT);
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &invalid, fieldMask, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.changedMask, fieldMask);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(current.TxPowerLimit, original.TxPowerLimit);
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &original, MOCA_CFG_ALL_FIELDS, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &current), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&current, &original, sizeof(current)), 0);
+
+    UT_LOG("Exiting test_l2_moca_hal_config_Transaction...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+/**
+* @brief Measures the downtime and call latency of a full and of a partial configuration apply.
+*
+* The simulator keeps a re-formed link down for MOCA_L2_CONFIG_REFORM_MS. The same TxPowerLimit change is applied
+* with moca_SetIfConfig(), which re-forms the link, and with moca_SetIfConfigFields(), which must not, and the time
+* until moca_IfGetDynamicInfo() reports the link up is logged for both. The calls are then timed with no downtime.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Change TxPowerLimit with moca_SetIfConfig | reformMs = MOCA_L2_CONFIG_REFORM_MS | Link down for at least reformMs, one reset | Simulator only |
+* | 02 | Restore TxPowerLimit with moca_SetIfConfigFields | reformMs = MOCA_L2_CONFIG_REFORM_MS | Link up at once, no reset | Simulator only |
+* | 03 | Time moca_SetIfConfig, moca_SetIfConfigFields and an unchanged apply | reformMs = 0 | STATUS_SUCCESS, resets only from moca_SetIfConfig | Percentiles logged |
+* | 04 | Restore the simulator and the configuration | Saved configurations | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_config_Latency(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_config_Latency...");
+
+    moca_sim_config_t saved, reforming;
+    moca_cfg_t original, lowered;
+    moca_l2_config_bench_t bench;
+    uint32_t iterations = moca_bench_iterations();
+    ULONG before = 0, after = 0;
+    uint64_t startNs, fullNs, fieldsNs;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    reforming = saved;
+    reforming.reformMs = MOCA_L2_CONFIG_REFORM_MS;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&reforming), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    memset(&bench, 0, sizeof(bench));
+    bench.step = (original.TxPowerLimit > 0) ? -1 : 1;
+    lowered = original;
+    lowered.TxPowerLimit += bench.step;
+
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    startNs = moca_bench_now_ns();
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gConfigIfIndex, &lowered), STATUS_SUCCESS);
+    fullNs = moca_l2_config_downtime_ns(startNs);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("moca_SetIfConfig: link down %llu us, %lu resets", (unsigned long long)(fullNs / 1000), after - before);
+    UT_ASSERT_TRUE(fullNs != UINT64_MAX);
+    UT_ASSERT_TRUE(fullNs >= MOCA_L2_CONFIG_REFORM_MS * 1000000ULL);
+    UT_ASSERT_EQUAL(after, before + 1);
+
+    before = after;
+    startNs = moca_bench_now_ns();
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gConfigIfIndex, &original, MOCA_CFG_ALL_FIELDS, NULL), STATUS_SUCCESS);
+    fieldsNs = moca_l2_config_downtime_ns(startNs);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("moca_SetIfConfigFields: link up after %llu us, %lu resets", (unsigned long long)(fieldsNs / 1000), after - before);
+    UT_ASSERT_TRUE(fieldsNs < MOCA_L2_CONFIG_REFORM_MS * 1000000ULL);
+    UT_ASSERT_EQUAL(after, before);
+
+    /* Without downtime the call latency alone is compared */
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+    bench.config = original;
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_l2_config_op_Full, &bench, iterations, &gConfigHistogram), 0);
+    moca_bench_report("moca_SetIfConfig", &gConfigHistogram);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_LOG("%lu resets, one per apply including the warm up", after - before);
+    UT_ASSERT_TRUE(after > before);
+
+    /* A TxPowerLimit change never re-forms the link */
+    bench.config = original;
+    bench.applies = 0;
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&before), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_l2_config_op_Fields, &bench, iterations, &gConfigHistogram), 0);
+    moca_bench_report("moca_SetIfConfigFields", &gConfigHistogram);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_l2_config_op_Unchanged, &bench, iterations, &gConfigHistogram), 0);
+    moca_bench_report("moca_SetIfConfigFields unchanged", &gConfigHistogram);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&after), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(after, before);
+
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gConfigIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+
+    UT_LOG("Exiting test_l2_moca_hal_config_Latency...");
+}
+
+#endif
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_config_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal config]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_config_LiveFields", test_l2_moca_hal_config_LiveFields);
+    UT_add_test(pSuite, "l2_moca_hal_config_Reform", test_l2_moca_hal_config_Reform);
+    UT_add_test(pSuite, "l2_moca_hal_config_Transaction", test_l2_moca_hal_config_Transaction);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_config_Latency", test_l2_moca_hal_config_Latency);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,402 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_counters.c
+* @page moca_hal_counters Level 2 Counter Extension Tests
+*
+* ## Module's Role
+* This module checks the 64 bit counter extension of moca_counters.h. The wrap and reset
+* handling is first checked on values fed in directly, then, against the simulator, on the
+* counters of a live interface that moca_sim_AdvanceCounters() makes wrap and that an interface
+* reset through moca_SetIfConfig() restarts from zero. The cost of a sample, with and without
+* the HAL calls, is benchmarked.
+*
+* **Pre-Conditions:**  None
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "moca_bench.h"
+#include "moca_counters.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_COUNTERS_TEST_ADVANCE_BYTES    0xC0000000ULL     /**< Three quarters of a 32 bit wrap per interval */
+#define MOCA_COUNTERS_TEST_ADVANCE_MS       0xC0000000ULL
+#define MOCA_COUNTERS_TEST_INTERVALS        4
+#define MOCA_COUNTERS_TEST_SLACK_MS         1000              /**< Real time passing during the test, added to Map */
+
+extern int init_moca_hal_init(void);
+
+static ULONG gCountersIfIndex = 0;
+static moca_counters_t gCountersBench;
+static moca_stats_t gCountersBenchStats;
+static moca_mac_counters_t gCountersBenchMac;
+static uint64_t gCountersBenchNs;
+static moca_bench_histogram_t gCountersHistogram;
+
+/* Every counter moves by step, so 32 bit counters wrap every few thousand updates */
+static int moca_counters_op_Update(void *pContext)
+{
+    (void)pContext;
+    ULONG *pStats = (ULONG *)&gCountersBenchStats;
+    ULONG *pMac = (ULONG *)&gCountersBenchMac;
+    const ULONG step = 0x00100001UL;
+    size_t i;
+
+    for (i = 0; i < sizeof(gCountersBenchStats) / sizeof(ULONG); i++)
+    {
+        pStats[i] = (ULONG)((pStats[i] + step) & 0xFFFFFFFFUL);
+    }
+    for (i = 0; i < sizeof(gCountersBenchMac) / sizeof(ULONG); i++)
+    {
+        pMac[i] = (ULONG)((pMac[i] + step) & 0xFFFFFFFFUL);
+    }
+    gCountersBenchNs += 1000000ULL;
+    return moca_counters_update(&gCountersBench, 0, &gCountersBenchStats, &gCountersBenchMac, gCountersBenchNs);
+}
+
+static int moca_counters_op_Sample(void *pContext)
+{
+    (void)pContext;
+
+    return moca_counters_sample(&gCountersBench);
+}
+
+static int moca_counters_op_HalReads(void *pContext)
+{
+    (void)pContext;
+    moca_stats_t stats;
+    moca_mac_counters_t macCounters;
+    ULONG resetCount;
+
+    return moca_IfGetStats(gCountersIfIndex, &stats) | moca_IfGetExtCounter(gCountersIfIndex, &macCounters) |
+           moca_GetResetCount(&resetCount);
+}
+
+/**
+* @brief Checks the wrap, reset and rate handling on values fed in directly.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Initialise with invalid widths | counterBits = 0, bits of ULONG + 1 | STATUS_FAILURE | Should be successful |
+* | 02 | First sample | BytesSent = 0xFFFFFF00 | Total 0xFFFFFF00, delta 0 | Should be successful |
+* | 03 | Counter wraps, 500 ms later | BytesSent = 0x100 | Delta 0x200, one wrap, 1024 bytes/s | Should be successful |
+* | 04 | Reset count changes | BytesSent = 50 | Delta 50, one reset, no further wrap | Should be successful |
+* | 05 | MAC counters missing, then present | pMacCounters = NULL, then Map = 7 | MAC totals start from 7 | Should be successful |
+* | 06 | 16 bit counters | 0xFFF0 then 0x10 | Delta 0x20 | Should be successful |
+*/
+void test_l2_moca_hal_counters_Update(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_counters_Update...");
+
+    moca_counters_t counters;
+    moca_stats_t stats;
+    moca_mac_counters_t macCounters;
+
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, 0, 0), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, 0, sizeof(ULONG) * 8 + 1), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, 0, MOCA_COUNTERS_DEFAULT_BITS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(moca_counters_name(MOCA_COUNTER_BytesReceived), "BytesReceived"), 0);
+    UT_ASSERT_EQUAL(strcmp(moca_counters_name(MOCA_COUNTER_Async), "Async"), 0);
+    UT_ASSERT_PTR_NULL(moca_counters_name(MOCA_COUNTER_COUNT));
+
+    memset(&stats, 0, sizeof(stats));
+    stats.BytesSent = 0xFFFFFF00UL;
+    stats.PacketsSent = 10;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 3, &stats, NULL, 1000000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_BytesSent], 0xFFFFFF00ULL);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesSent], 0);
+    UT_ASSERT_FALSE(counters.haveMacCounters);
+
+    stats.BytesSent = 0x100;
+    stats.PacketsSent = 20;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 3, &stats, NULL, 1500000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesSent], 0x200);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_BytesSent], 0x100000100ULL);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_BytesSent], 1);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_PacketsSent], 0);
+    UT_ASSERT_EQUAL(counters.intervalNs, 500000000ULL);
+    UT_ASSERT_TRUE(counters.rate[MOCA_COUNTER_BytesSent] > 1023.9 && counters.rate[MOCA_COUNTER_BytesSent] < 1024.1);
+    UT_ASSERT_TRUE(counters.rate[MOCA_COUNTER_PacketsSent] > 19.9 && counters.rate[MOCA_COUNTER_PacketsSent] < 20.1);
+
+    stats.BytesSent = 50;
+    stats.PacketsSent = 1;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 4, &stats, NULL, 2000000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(counters.resets, 1);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesSent], 50);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_BytesSent], 0x100000100ULL + 50);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_BytesSent], 1);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_PacketsSent], 21);
+
+    memset(&macCounters, 0, sizeof(macCounters));
+    macCounters.Map = 7;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 4, &stats, &macCounters, 3000000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(counters.haveMacCounters);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_Map], 7);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_Map], 0);
+    macCounters.Map = 9;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 4, &stats, &macCounters, 4000000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_Map], 2);
+    UT_ASSERT_EQUAL(counters.samples, 5);
+
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, 0, 16), STATUS_SUCCESS);
+    memset(&stats, 0, sizeof(stats));
+    stats.BytesReceived = 0xFFF0;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 0, &stats, NULL, 0), STATUS_SUCCESS);
+    stats.BytesReceived = 0x10;
+    UT_ASSERT_EQUAL(moca_counters_update(&counters, 0, &stats, NULL, 1000000ULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesReceived], 0x20);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_BytesReceived], 1);
+
+    UT_LOG("Exiting test_l2_moca_hal_counters_Update...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+/**
+* @brief Makes the 32 bit counters of a live interface wrap and checks the 64 bit totals.
+*
+* Traffic is stopped, then the byte counters are advanced by three quarters of a wrap and the link up time by
+* 0xC0000000 ms between samples, so BytesSent, BytesReceived and Map wrap without waiting. The tracked totals must
+* move by exactly the traffic added, while the raw difference a naive rate calculation would use is logged.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Stop the traffic and take a first sample | moca_sim_SetTraffic(0, 0, 0) | STATUS_SUCCESS | Simulator only |
+* | 02 | Advance the counters and sample, MOCA_COUNTERS_TEST_INTERVALS times | 0xC0000000 bytes, 0xC0000000 ms | Byte totals up by exactly the bytes added, wraps counted | Simulator only |
+* | 03 | Check the MAC counters | Map | Total up by the time added plus the real time elapsed | Simulator only |
+* | 04 | Restore the traffic | Configured rates | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_counters_ForcedWraps(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_counters_ForcedWraps...");
+
+    moca_counters_t counters;
+    moca_sim_config_t config;
+    uint64_t firstTx, firstRx, firstMap, naive;
+    uint32_t i;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gCountersIfIndex, 0, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, gCountersIfIndex, MOCA_COUNTERS_DEFAULT_BITS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(counters.haveMacCounters);
+    firstTx = counters.total[MOCA_COUNTER_BytesSent];
+    firstRx = counters.total[MOCA_COUNTER_BytesReceived];
+    firstMap = counters.total[MOCA_COUNTER_Map];
+
+    for (i = 0; i < MOCA_COUNTERS_TEST_INTERVALS; i++)
+    {
+        ULONG previous = counters.raw[MOCA_COUNTER_BytesReceived];
+
+        UT_ASSERT_EQUAL(moca_sim_AdvanceCounters(gCountersIfIndex, MOCA_COUNTERS_TEST_ADVANCE_BYTES, MOCA_COUNTERS_TEST_ADVANCE_BYTES,
+                                                 MOCA_COUNTERS_TEST_ADVANCE_MS), STATUS_SUCCESS);
+        UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+        naive = (uint64_t)counters.raw[MOCA_COUNTER_BytesReceived] - (uint64_t)previous;
+        UT_LOG("interval %u: BytesReceived raw=0x%08lx delta=%llu wraps=%llu, naive delta=%llu", i,
+               counters.raw[MOCA_COUNTER_BytesReceived], (unsigned long long)counters.delta[MOCA_COUNTER_BytesReceived],
+               (unsigned long long)counters.wraps[MOCA_COUNTER_BytesReceived], (unsigned long long)naive);
+        UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesSent], MOCA_COUNTERS_TEST_ADVANCE_BYTES);
+        UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesReceived], MOCA_COUNTERS_TEST_ADVANCE_BYTES);
+    }
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gCountersIfIndex, config.txBytesPerSec, config.rxBytesPerSec), STATUS_SUCCESS);
+
+    UT_LOG("BytesSent total +%llu wraps=%llu, Map total +%llu wraps=%llu, resets=%llu",
+           (unsigned long long)(counters.total[MOCA_COUNTER_BytesSent] - firstTx),
+           (unsigned long long)counters.wraps[MOCA_COUNTER_BytesSent],
+           (unsigned long long)(counters.total[MOCA_COUNTER_Map] - firstMap),
+           (unsigned long long)counters.wraps[MOCA_COUNTER_Map], (unsigned long long)counters.resets);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_BytesSent] - firstTx, MOCA_COUNTERS_TEST_INTERVALS * MOCA_COUNTERS_TEST_ADVANCE_BYTES);
+    UT_ASSERT_EQUAL(counters.total[MOCA_COUNTER_BytesReceived] - firstRx, MOCA_COUNTERS_TEST_INTERVALS * MOCA_COUNTERS_TEST_ADVANCE_BYTES);
+    UT_ASSERT_TRUE(counters.wraps[MOCA_COUNTER_BytesSent] >= MOCA_COUNTERS_TEST_INTERVALS * 3 / 4);
+    UT_ASSERT_TRUE(counters.total[MOCA_COUNTER_Map] - firstMap >= MOCA_COUNTERS_TEST_INTERVALS * MOCA_COUNTERS_TEST_ADVANCE_MS);
+    UT_ASSERT_TRUE(counters.total[MOCA_COUNTER_Map] - firstMap <=
+                   MOCA_COUNTERS_TEST_INTERVALS * MOCA_COUNTERS_TEST_ADVANCE_MS + MOCA_COUNTERS_TEST_SLACK_MS);
+    UT_ASSERT_TRUE(counters.wraps[MOCA_COUNTER_Map] >= MOCA_COUNTERS_TEST_INTERVALS * 3 / 4);
+    UT_ASSERT_EQUAL(counters.resets, 0);
+    UT_ASSERT_EQUAL(counters.failures, 0);
+
+    UT_LOG("Exiting test_l2_moca_hal_counters_ForcedWraps...");
+}
+
+/**
+* @brief Resets the interface between two samples and checks the totals carry on from the reset.
+*
+* Reapplying the configuration with moca_SetIfConfig() re-forms the link, which restarts every counter from zero and
+* increments moca_GetResetCount(). Rebuilding the simulated network with moca_sim_Configure() must do the same. The
+* counters are advanced first so that the drop is not mistaken for a wrap.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Stop the traffic, advance the counters and sample | 0xC0000000 bytes | STATUS_SUCCESS | Simulator only |
+* | 02 | Reapply the configuration and sample | moca_GetIfConfig, moca_SetIfConfig | One reset, no wrap, totals not lower | Simulator only |
+* | 03 | Advance the counters again, rebuild the simulator and sample | moca_sim_Configure, current configuration | Two resets, no wrap, totals not lower | Simulator only |
+* | 04 | Restore the traffic | Configured rates | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_counters_Reset(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_counters_Reset...");
+
+    moca_counters_t counters;
+    moca_sim_config_t config;
+    moca_cfg_t ifConfig;
+    uint64_t totalBefore;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gCountersIfIndex, 0, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_AdvanceCounters(gCountersIfIndex, MOCA_COUNTERS_TEST_ADVANCE_BYTES, MOCA_COUNTERS_TEST_ADVANCE_BYTES, 0),
+                    STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_init(&counters, gCountersIfIndex, MOCA_COUNTERS_DEFAULT_BITS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+    totalBefore = counters.total[MOCA_COUNTER_BytesReceived];
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gCountersIfIndex, &ifConfig), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gCountersIfIndex, &ifConfig), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+    UT_LOG("BytesReceived raw=%lu total=%llu, resets=%llu wraps=%llu", counters.raw[MOCA_COUNTER_BytesReceived],
+           (unsigned long long)counters.total[MOCA_COUNTER_BytesReceived], (unsigned long long)counters.resets,
+           (unsigned long long)counters.wraps[MOCA_COUNTER_BytesReceived]);
+    UT_ASSERT_EQUAL(counters.resets, 1);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_BytesReceived], 0);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_Map], 0);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesReceived], counters.raw[MOCA_COUNTER_BytesReceived]);
+    UT_ASSERT_TRUE(counters.total[MOCA_COUNTER_BytesReceived] >= totalBefore);
+
+    UT_ASSERT_EQUAL(moca_sim_AdvanceCounters(gCountersIfIndex, MOCA_COUNTERS_TEST_ADVANCE_BYTES, MOCA_COUNTERS_TEST_ADVANCE_BYTES, 0),
+                    STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+    totalBefore = counters.total[MOCA_COUNTER_BytesReceived];
+    UT_ASSERT_EQUAL(moca_sim_Configure(&config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_counters_sample(&counters), STATUS_SUCCESS);
+    UT_LOG("After moca_sim_Configure: BytesReceived raw=%lu total=%llu, resets=%llu wraps=%llu",
+           counters.raw[MOCA_COUNTER_BytesReceived], (unsigned long long)counters.total[MOCA_COUNTER_BytesReceived],
+           (unsigned long long)counters.resets, (unsigned long long)counters.wraps[MOCA_COUNTER_BytesReceived]);
+    UT_ASSERT_EQUAL(counters.resets, 2);
+    UT_ASSERT_EQUAL(counters.wraps[MOCA_COUNTER_BytesReceived], 0);
+    UT_ASSERT_EQUAL(counters.delta[MOCA_COUNTER_BytesReceived], counters.raw[MOCA_COUNTER_BytesReceived]);
+    UT_ASSERT_TRUE(counters.total[MOCA_COUNTER_BytesReceived] >= totalBefore);
+
+    UT_ASSERT_EQUAL(moca_sim_SetTraffic(gCountersIfIndex, config.txBytesPerSec, config.rxBytesPerSec), STATUS_SUCCESS);
+    UT_LOG("Exiting test_l2_moca_hal_counters_Reset...");
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+/**
+* @brief Measures the cost of a sample.
+*
+* moca_counters_update() is timed on values that wrap regularly, moca_counters_sample() on the HAL, and the HAL reads
+* it makes on their own, so the tracking overhead on top of the driver shows.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Time moca_counters_update | Every counter + 0x00100001 per update | STATUS_SUCCESS | Percentiles logged |
+* | 02 | Time moca_IfGetStats, moca_IfGetExtCounter and moca_GetResetCount | ifIndex = 0 | STATUS_SUCCESS | Percentiles logged |
+* | 03 | Time moca_counters_sample | ifIndex = 0 | STATUS_SUCCESS | Percentiles logged |
+*/
+void test_l2_moca_hal_counters_Benchmark(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_counters_Benchmark...");
+
+    uint32_t iterations = moca_bench_iterations();
+
+    UT_ASSERT_EQUAL(moca_counters_init(&gCountersBench, gCountersIfIndex, MOCA_COUNTERS_DEFAULT_BITS), STATUS_SUCCESS);
+    memset(&gCountersBenchStats, 0, sizeof(gCountersBenchStats));
+    memset(&gCountersBenchMac, 0, sizeof(gCountersBenchMac));
+    gCountersBenchNs = 0;
+    UT_ASSERT_EQUAL(moca_bench_run(moca_counters_op_Update, NULL, iterations, &gCountersHistogram), 0);
+    moca_bench_report("moca_counters_update", &gCountersHistogram);
+    UT_LOG("Wraps of BytesSent over %llu updates: %llu", (unsigned long long)gCountersBench.samples,
+           (unsigned long long)gCountersBench.wraps[MOCA_COUNTER_BytesSent]);
+    UT_ASSERT_TRUE(gCountersBench.wraps[MOCA_COUNTER_BytesSent] > 0 || gCountersBench.samples < 4096);
+
+    UT_ASSERT_EQUAL(moca_bench_run(moca_counters_op_HalReads, NULL, iterations, &gCountersHistogram), 0);
+    moca_bench_report("moca_IfGetStats+moca_IfGetExtCounter+moca_GetResetCount", &gCountersHistogram);
+
+    UT_ASSERT_EQUAL(moca_counters_init(&gCountersBench, gCountersIfIndex, MOCA_COUNTERS_DEFAULT_BITS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_counters_op_Sample, NULL, iterations, &gCountersHistogram), 0);
+    moca_bench_report("moca_counters_sample", &gCountersHistogram);
+
+    UT_LOG("Exiting test_l2_moca_hal_counters_Benchmark...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_counters_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal counters]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_counters_Update", test_l2_moca_hal_counters_Update);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_counters_ForcedWraps", test_l2_moca_hal_counters_ForcedWraps);
+    UT_add_test(pSuite, "l2_moca_hal_counters_Reset", test_l2_moca_hal_counters_Reset);
+#endif
+    UT_add_test(pSuite, "l2_moca_hal_counters_Benchmark", test_l2_moca_hal_counters_Benchmark);
+
+    return 0;
+}
@@ -0,0 +1,532 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_event_ring.c
+* @page moca_hal_event_ring Level 2 Associated Device Event Ring Tests
+*
+* ## Module's Role
+* This module checks the lock-free event ring of moca_event_ring.h, which takes associated device
+* events out of the notification context of the driver. It checks ordering, batching, overflow
+* accounting and the consumer wake up, measures the throughput and the push to pop latency with
+* one producer and with several, and, against the simulator, attaches the ring to the callback
+* registered with moca_associatedDevice_callback_register() and drives it with join and leave
+* storms while a slow consumer drains it.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_RING_PRODUCERS | Producer threads of the multi producer run | 4 |
+* | MOCA_RING_EVENTS | Events pushed per throughput run | 200000 |
+* | MOCA_RING_STORM_MS | Length of each event storm | 500 |
+*
+* **Pre-Conditions:**  At least one remote node is associated on interface 0 for the storms.
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include "moca_bench.h"
+#include "moca_event_ring.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_RING_DEFAULT_PRODUCERS     4
+#define MOCA_RING_MAX_PRODUCERS         64
+#define MOCA_RING_DEFAULT_EVENTS        200000
+#define MOCA_RING_DEFAULT_STORM_MS      500
+#define MOCA_RING_CAPACITY              1024
+#define MOCA_RING_BATCH                 64
+#define MOCA_RING_WAIT_MS               10
+#define MOCA_RING_STORM_WAIT_MS         30000
+#define MOCA_RING_SLOW_BATCH_NS         1000000ULL    /**< Time the slow consumer spends on every batch */
+#define MOCA_RING_OVERFLOW_CAPACITY     16
+#define MOCA_RING_OVERFLOW_BATCH        8
+#define MOCA_RING_OVERFLOW_BATCH_NS     5000000ULL
+#define MOCA_RING_OVERFLOW_EVENTS       2000
+#define MOCA_RING_OVERFLOW_RATE         20000
+
+extern int init_moca_hal_init(void);
+
+typedef struct
+{
+    pthread_t thread;
+    moca_event_ring_t *pRing;
+    ULONG id;
+    uint64_t events;
+    uint64_t full;                  /**< Pushes that found the ring full and were retried */
+} moca_ring_producer_t;
+
+/* Written by the consumer thread, read once it is joined */
+typedef struct
+{
+    pthread_t thread;
+    moca_event_ring_t *pRing;
+    uint32_t batch;
+    uint64_t batchNs;
+    int stop;
+    uint64_t received;
+    uint64_t reportedDrops;
+    uint64_t batches;
+    uint64_t outOfOrder;
+    uint64_t lastSequence[MOCA_RING_MAX_PRODUCERS];
+    moca_bench_histogram_t latency;
+} moca_ring_consumer_t;
+
+static int gRingGo = 0;
+static moca_ring_consumer_t gRingConsumer;
+
+/* Pushes events numbered from 1 in TxPackets, retrying while the ring is full */
+static void *moca_ring_producer_main(void *pArg)
+{
+    moca_ring_producer_t *pProducer = (moca_ring_producer_t *)pArg;
+    moca_associated_device_t device;
+    uint64_t i;
+
+    memset(&device, 0, sizeof(device));
+    device.NodeID = pProducer->id;
+    while (__atomic_load_n(&gRingGo, __ATOMIC_ACQUIRE) == 0)
+    {
+        sched_yield();
+    }
+    for (i = 1; i <= pProducer->events; i++)
+    {
+        device.TxPackets = (ULONG)i;
+        while (moca_event_ring_push(pProducer->pRing, 0, &device) != STATUS_SUCCESS)
+        {
+            pProducer->full++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* Events of one NodeID must arrive in the order they were pushed, TxPackets counting up */
+static void *moca_ring_consumer_main(void *pArg)
+{
+    moca_ring_consumer_t *pConsumer = (moca_ring_consumer_t *)pArg;
+    moca_device_event_t events[MOCA_RING_BATCH];
+
+    for (;;)
+    {
+        uint64_t dropped = 0;
+        uint32_t count = moca_event_ring_pop(pConsumer->pRing, events, pConsumer->batch, &dropped);
+        uint64_t now = moca_bench_now_ns();
+        uint32_t i;
+
+        pConsumer->reportedDrops += dropped;
+        if (count == 0)
+        {
+            if (__atomic_load_n(&pConsumer->stop, __ATOMIC_ACQUIRE) != 0)
+            {
+                /* Producers are done, one last pop catches a push that completed after the empty one */
+                count = moca_event_ring_pop(pConsumer->pRing, events, pConsumer->batch, &dropped);
+                pConsumer->reportedDrops += dropped;
+                if (count == 0)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                moca_event_ring_wait(pConsumer->pRing, MOCA_RING_WAIT_MS);
+                continue;
+            }
+        }
+        pConsumer->batches++;
+        for (i = 0; i < count; i++)
+        {
+            ULONG id = events[i].device.NodeID % MOCA_RING_MAX_PRODUCERS;
+
+            moca_bench_histogram_record(&pConsumer->latency, now - events[i].timestampNs);
+            if ((uint64_t)events[i].device.TxPackets != pConsumer->lastSequence[id] + 1)
+            {
+                pConsumer->outOfOrder++;
+            }
+            pConsumer->lastSequence[id] = events[i].device.TxPackets;
+        }
+        pConsumer->received += count;
+        if (pConsumer->batchNs > 0)
+        {
+            moca_bench_sleep_ns(pConsumer->batchNs);
+        }
+    }
+    return NULL;
+}
+
+/* Cost of queueing one event and taking it out, without contention */
+static int moca_ring_op_PushPop(void *pContext)
+{
+    moca_event_ring_t *pRing = (moca_event_ring_t *)pContext;
+    moca_associated_device_t device;
+    moca_device_event_t event;
+
+    memset(&device, 0, sizeof(device));
+    if (moca_event_ring_push(pRing, 0, &device) != STATUS_SUCCESS)
+    {
+        return -1;
+    }
+    return (moca_event_ring_pop(pRing, &event, 1, NULL) == 1) ? 0 : -1;
+}
+
+static INT moca_ring_consumer_start(moca_event_ring_t *pRing, uint32_t batch, uint64_t batchNs)
+{
+    memset(&gRingConsumer, 0, sizeof(gRingConsumer));
+    gRingConsumer.pRing = pRing;
+    gRingConsumer.batch = (batch > MOCA_RING_BATCH) ? MOCA_RING_BATCH : batch;
+    gRingConsumer.batchNs = batchNs;
+    moca_bench_histogram_reset(&gRingConsumer.latency);
+    return (pthread_create(&gRingConsumer.thread, NULL, moca_ring_consumer_main, &gRingConsumer) == 0) ? STATUS_SUCCESS : STATUS_FAILURE;
+}
+
+static void moca_ring_consumer_stop(void)
+{
+    __atomic_store_n(&gRingConsumer.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(gRingConsumer.thread, NULL);
+}
+
+/* Runs numProducers producers of eventsPerProducer events each against one consumer, returns events per second */
+static double moca_ring_throughput(const char *pName, uint32_t numProducers, uint32_t flags, uint64_t eventsPerProducer)
+{
+    moca_event_ring_t ring;
+    moca_event_ring_stats_t stats;
+    moca_ring_producer_t *pProducers = calloc(numProducers, sizeof(moca_ring_producer_t));
+    uint64_t full = 0, begin, elapsed;
+    uint32_t started = 0;
+    uint32_t i;
+    double eventsPerSec;
+
+    if (pProducers == NULL || moca_event_ring_create(&ring, MOCA_RING_CAPACITY, flags) != STATUS_SUCCESS)
+    {
+        free(pProducers);
+        UT_FAIL("Cannot create the ring");
+        return 0.0;
+    }
+    __atomic_store_n(&gRingGo, 0, __ATOMIC_RELAXED);
+    for (i = 0; i < numProducers; i++)
+    {
+        pProducers[i].pRing = &ring;
+        pProducers[i].id = i;
+        pProducers[i].events = eventsPerProducer;
+        if (pthread_create(&pProducers[i].thread, NULL, moca_ring_producer_main, &pProducers[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    UT_ASSERT_EQUAL(started, numProducers);
+    UT_ASSERT_EQUAL(moca_ring_consumer_start(&ring, MOCA_RING_BATCH, 0), STATUS_SUCCESS);
+
+    begin = moca_bench_now_ns();
+    __atomic_store_n(&gRingGo, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(pProducers[i].thread, NULL);
+        full += pProducers[i].full;
+    }
+    moca_ring_consumer_stop();
+    elapsed = moca_bench_now_ns() - begin;
+    moca_event_ring_get_stats(&ring, &stats);
+
+    eventsPerSec = (double)gRingConsumer.received * 1e9 / (double)elapsed;
+    UT_LOG("%s: producers=%u events=%llu events/s=%.0f batches=%llu mean batch=%.1f full=%llu wakeups=%llu maxDepth=%llu",
+           pName, started, (unsigned long long)gRingConsumer.received, eventsPerSec, (unsigned long long)stats.batches,
+           (stats.batches > 0) ? (double)stats.popped / (double)stats.batches : 0.0, (unsigned long long)full,
+           (unsigned long long)stats.wakeups, (unsigned long long)stats.maxDepth);
+    moca_bench_report(pName, &gRingConsumer.latency);
+
+    UT_ASSERT_EQUAL(gRingConsumer.received, (uint64_t)started * eventsPerProducer);
+    UT_ASSERT_EQUAL(gRingConsumer.outOfOrder, 0);
+    UT_ASSERT_EQUAL(stats.pushed, gRingConsumer.received);
+    UT_ASSERT_EQUAL(stats.popped, gRingConsumer.received);
+    UT_ASSERT_EQUAL(stats.dropped, full);
+    UT_ASSERT_EQUAL(gRingConsumer.reportedDrops, full);
+
+    moca_event_ring_destroy(&ring);
+    free(pProducers);
+    return eventsPerSec;
+}
+
+/**
+* @brief Checks ordering, batching, overflow accounting and the consumer wake up of a ring.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Create a ring | capacity = 5 | Capacity 8 | Should be successful |
+* | 02 | Push until full and once more | 9 events | 8 STATUS_SUCCESS, then STATUS_FAILURE | Should be successful |
+* | 03 | Pop in two batches | 3, then 8 | Events 0 to 7 in order, 1 drop reported with the first batch only | Should be successful |
+* | 04 | Wait on the empty ring | timeoutMs = 10 | STATUS_FAILURE | Should be successful |
+* | 05 | Arm, push and poll the eventfd | 1 event | Eventfd readable, one wake up, wait returns STATUS_SUCCESS | Should be successful |
+* | 06 | Push and pop one at a time over many laps | Single producer ring, capacity 4 | Every event in order | Should be successful |
+*/
+void test_l2_moca_hal_event_ring_PushPop(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_event_ring_PushPop...");
+
+    moca_event_ring_t ring;
+    moca_event_ring_stats_t stats;
+    moca_device_event_t events[MOCA_RING_BATCH];
+    moca_associated_device_t device;
+    struct pollfd pfd;
+    uint64_t dropped = 0;
+    uint32_t i, count;
+
+    memset(&device, 0, sizeof(device));
+    UT_ASSERT_EQUAL(moca_event_ring_create(NULL, 8, 0), STATUS_FAILURE);
+    if (moca_event_ring_create(&ring, 5, 0) != STATUS_SUCCESS)
+    {
+        UT_FAIL("Cannot create the ring");
+        return;
+    }
+    UT_ASSERT_EQUAL(moca_event_ring_capacity(&ring), 8);
+    UT_ASSERT_EQUAL(moca_event_ring_pop(&ring, events, MOCA_RING_BATCH, &dropped), 0);
+    for (i = 0; i < 8; i++)
+    {
+        device.NodeID = i + 1;
+        UT_ASSERT_EQUAL(moca_event_ring_push(&ring, 1, &device), STATUS_SUCCESS);
+    }
+    UT_ASSERT_EQUAL(moca_event_ring_push(&ring, 1, &device), STATUS_FAILURE);
+
+    count = moca_event_ring_pop(&ring, events, 3, &dropped);
+    UT_ASSERT_EQUAL(count, 3);
+    UT_ASSERT_EQUAL(dropped, 1);
+    count += moca_event_ring_pop(&ring, &events[3], MOCA_RING_BATCH - 3, &dropped);
+    UT_ASSERT_EQUAL(count, 8);
+    UT_ASSERT_EQUAL(dropped, 0);
+    for (i = 0; i < count; i++)
+    {
+        UT_ASSERT_EQUAL(events[i].sequence, i);
+        UT_ASSERT_EQUAL(events[i].ifIndex, 1);
+        UT_ASSERT_EQUAL(events[i].device.NodeID, i + 1);
+    }
+
+    UT_ASSERT_EQUAL(moca_event_ring_wait(&ring, MOCA_RING_WAIT_MS), STATUS_FAILURE);
+    UT_ASSERT_TRUE(moca_event_ring_arm(&ring));
+    UT_ASSERT_EQUAL(moca_event_ring_push(&ring, 1, &device), STATUS_SUCCESS);
+    pfd.fd = moca_event_ring_fd(&ring);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    UT_ASSERT_EQUAL(poll(&pfd, 1, 0), 1);
+    UT_ASSERT_EQUAL(moca_event_ring_wait(&ring, MOCA_RING_WAIT_MS), STATUS_SUCCESS);
+    UT_ASSERT_FALSE(moca_event_ring_arm(&ring));
+    UT_ASSERT_EQUAL(moca_event_ring_pop(&ring, events, MOCA_RING_BATCH, &dropped), 1);
+
+    moca_event_ring_get_stats(&ring, &stats);
+    UT_LOG("pushed=%llu popped=%llu dropped=%llu batches=%llu wakeups=%llu maxDepth=%llu",
+           (unsigned long long)stats.pushed, (unsigned long long)stats.popped, (unsigned long long)stats.dropped,
+           (unsigned long long)stats.batches, (unsigned long long)stats.wakeups, (unsigned long long)stats.maxDepth);
+    UT_ASSERT_EQUAL(stats.pushed, 9);
+    UT_ASSERT_EQUAL(stats.popped, 9);
+    UT_ASSERT_EQUAL(stats.dropped, 1);
+    UT_ASSERT_EQUAL(stats.batches, 3);
+    UT_ASSERT_EQUAL(stats.wakeups, 1);
+    UT_ASSERT_EQUAL(stats.maxDepth, 8);
+    moca_event_ring_destroy(&ring);
+
+    UT_ASSERT_EQUAL(moca_event_ring_create(&ring, 4, MOCA_EVENT_RING_SINGLE_PRODUCER), STATUS_SUCCESS);
+    for (i = 0; i < 1000; i++)
+    {
+        device.TxPackets = i;
+        UT_ASSERT_EQUAL(moca_event_ring_push(&ring, 0, &device), STATUS_SUCCESS);
+        if (moca_event_ring_pop(&ring, events, 1, NULL) != 1 || events[0].sequence != i || events[0].device.TxPackets != i)
+        {
+            UT_FAIL("Event lost or out of order");
+            break;
+        }
+    }
+    moca_event_ring_destroy(&ring);
+
+    UT_LOG("Exiting test_l2_moca_hal_event_ring_PushPop...");
+}
+
+/**
+* @brief Measures the throughput and push to pop latency with one producer and with several.
+*
+* Producers retry a push that finds the ring full, so every event arrives. The events of each producer must arrive in
+* the order it pushed them, and the drops the ring counts must match the full pushes the producers saw.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Time a push and a pop on one thread | Single producer and multi producer rings | Every call succeeds | Percentiles logged |
+* | 02 | One producer on a single producer ring | MOCA_RING_EVENTS events | All received in order | Throughput and latency logged |
+* | 03 | One producer on a multi producer ring | MOCA_RING_EVENTS events | All received in order | Throughput and latency logged |
+* | 04 | MOCA_RING_PRODUCERS producers | MOCA_RING_EVENTS events in total | All received, in order per producer | Throughput and latency logged |
+*/
+void test_l2_moca_hal_event_ring_Throughput(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_event_ring_Throughput...");
+
+    uint32_t numProducers = moca_bench_env_u32("MOCA_RING_PRODUCERS", MOCA_RING_DEFAULT_PRODUCERS, MOCA_RING_MAX_PRODUCERS);
+    uint32_t events = moca_bench_env_u32("MOCA_RING_EVENTS", MOCA_RING_DEFAULT_EVENTS, 100000000);
+    moca_event_ring_t ring;
+    char name[64];
+
+    UT_ASSERT_EQUAL(moca_event_ring_create(&ring, MOCA_RING_CAPACITY, MOCA_EVENT_RING_SINGLE_PRODUCER), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_ring_op_PushPop, &ring, moca_bench_iterations(), &gRingConsumer.latency), 0);
+    moca_bench_report("moca_event_ring spsc push+pop", &gRingConsumer.latency);
+    moca_event_ring_destroy(&ring);
+    UT_ASSERT_EQUAL(moca_event_ring_create(&ring, MOCA_RING_CAPACITY, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_ring_op_PushPop, &ring, moca_bench_iterations(), &gRingConsumer.latency), 0);
+    moca_bench_report("moca_event_ring mpsc push+pop", &gRingConsumer.latency);
+    moca_event_ring_destroy(&ring);
+
+    moca_ring_throughput("moca_event_ring spsc", 1, MOCA_EVENT_RING_SINGLE_PRODUCER, events);
+    moca_ring_throughput("moca_event_ring mpsc producers=1", 1, 0, events);
+    snprintf(name, sizeof(name), "moca_event_ring mpsc producers=%u", numProducers);
+    moca_ring_throughput(name, numProducers, 0, (events + numProducers - 1) / numProducers);
+
+    UT_LOG("Exiting test_l2_moca_hal_event_ring_Throughput...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+/* Runs one storm into the attached ring and checks every dispatched event was queued or counted as dropped */
+static void moca_ring_storm(moca_event_ring_t *pRing, ULONG count, ULONG eventsPerSec, uint32_t batch, uint64_t batchNs)
+{
+    moca_sim_event_stats_t before, after;
+    moca_event_ring_stats_t stats;
+    uint64_t dispatched, simDropped;
+    char name[64];
+
+    UT_ASSERT_EQUAL(moca_sim_GetEventStats(&before), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_ring_consumer_start(pRing, batch, batchNs), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_event_ring_attach(pRing), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_GenerateDeviceEvents(0, count, eventsPerSec), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_WaitDeviceEvents(MOCA_RING_STORM_WAIT_MS), STATUS_SUCCESS);
+    moca_event_ring_detach();
+    moca_ring_consumer_stop();
+    UT_ASSERT_EQUAL(moca_sim_GetEventStats(&after), STATUS_SUCCESS);
+    moca_event_ring_get_stats(pRing, &stats);
+
+    dispatched = after.dispatched - before.dispatched;
+    simDropped = after.dropped - before.dropped;
+    UT_LOG("rate=%lu capacity=%u generated=%llu dispatched=%llu driver drops=%llu received=%llu ring drops=%llu "
+           "batches=%llu wakeups=%llu maxDepth=%llu", eventsPerSec, moca_event_ring_capacity(pRing),
+           (unsigned long long)(after.generated - before.generated), (unsigned long long)dispatched,
+           (unsigned long long)simDropped, (unsigned long long)gRingConsumer.received,
+           (unsigned long long)gRingConsumer.reportedDrops, (unsigned long long)gRingConsumer.batches,
+           (unsigned long long)stats.wakeups, (unsigned long long)stats.maxDepth);
+    snprintf(name, sizeof(name), "moca_event_ring storm rate=%lu capacity=%u", eventsPerSec, moca_event_ring_capacity(pRing));
+    moca_bench_report(name, &gRingConsumer.latency);
+
+    UT_ASSERT_EQUAL(after.generated - before.generated, count);
+    UT_ASSERT_EQUAL(after.undelivered - before.undelivered, 0);
+    UT_ASSERT_EQUAL(gRingConsumer.received + gRingConsumer.reportedDrops, dispatched);
+    UT_ASSERT_EQUAL(stats.pushed, stats.popped);
+}
+
+/**
+* @brief Drains associated device event storms through the ring with a slow consumer.
+*
+* The ring is attached to the callback and storms of 1000, 5000 and 20000 events per second are run for
+* MOCA_RING_STORM_MS each, consumed in batches with MOCA_RING_SLOW_BATCH_NS spent on every batch. A further storm
+* overflows a small ring on purpose. Every dispatched event must be received or reported as dropped to the consumer.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** Medium
+*
+* **Pre-Conditions:** At least one remote node is associated
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Attach a ring and run storms with a slow consumer | 1000, 5000, 20000 events/s, capacity 1024 | Events received + drops reported = events dispatched | Latency and depth logged |
+* | 02 | Overflow a small ring | 20000 events/s, capacity 16, 5 ms per batch of 8 | Drops reported to the consumer, received + drops = dispatched | Should be successful |
+* | 03 | Detach the ring | moca_event_ring_detach | Returns | Should be successful |
+*/
+void test_l2_moca_hal_event_ring_Storm(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_event_ring_Storm...");
+
+    static const ULONG rates[] = { 1000, 5000, 20000 };
+    uint32_t stormMs = moca_bench_env_u32("MOCA_RING_STORM_MS", MOCA_RING_DEFAULT_STORM_MS, 60000);
+    moca_event_ring_t ring;
+    ULONG numDevices = 0;
+    uint32_t i;
+
+    if (moca_GetNumAssociatedDevices(0, &numDevices) != STATUS_SUCCESS || numDevices == 0)
+    {
+        UT_FAIL("No remote node on interface 0, cannot generate device events");
+        return;
+    }
+    UT_ASSERT_EQUAL(moca_event_ring_create(&ring, MOCA_RING_CAPACITY, MOCA_EVENT_RING_SINGLE_PRODUCER), STATUS_SUCCESS);
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        moca_ring_storm(&ring, (ULONG)((uint64_t)rates[i] * stormMs / 1000), rates[i], MOCA_RING_BATCH, MOCA_RING_SLOW_BATCH_NS);
+    }
+    moca_event_ring_destroy(&ring);
+
+    UT_ASSERT_EQUAL(moca_event_ring_create(&ring, MOCA_RING_OVERFLOW_CAPACITY, MOCA_EVENT_RING_SINGLE_PRODUCER), STATUS_SUCCESS);
+    moca_ring_storm(&ring, MOCA_RING_OVERFLOW_EVENTS, MOCA_RING_OVERFLOW_RATE, MOCA_RING_OVERFLOW_BATCH, MOCA_RING_OVERFLOW_BATCH_NS);
+    UT_ASSERT_TRUE(gRingConsumer.reportedDrops > 0);
+    moca_event_ring_destroy(&ring);
+
+    UT_LOG("Exiting test_l2_moca_hal_event_ring_Storm...");
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_event_ring_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal event ring]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_event_ring_PushPop", test_l2_moca_hal_event_ring_PushPop);
+    UT_add_test(pSuite, "l2_moca_hal_event_ring_Throughput", test_l2_moca_hal_event_ring_Throughput);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_event_ring_Storm", test_l2_moca_hal_event_ring_Storm);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,434 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_multi_interface.c
+* @page moca_hal_multi_interface Level 2 Multi Interface Polling Tests
+*
+* ## Module's Role
+* A gateway can carry several MoCA interfaces, and its management agent polls every one of them.
+* This module discovers the valid interfaces by probing ifIndex 0 to MOCA_MULTI_MAX_INTERFACES - 1
+* with moca_IfGetStaticInfo, then polls moca_IfGetStats and moca_IfGetDynamicInfo on 1, 2, 4 ... up
+* to all of them at once, one thread per interface. For every interface count it reports the
+* aggregate calls per second, the scaling efficiency against a single interface and the latency
+* percentiles of each API. Efficiency is measured against the pollers that can run at once, at
+* most one per online CPU. A HAL that serialises every interface on one lock, or one driver
+* channel, shows an efficiency close to 1 / interfaces.
+*
+* The results read are checked as in the stress suite: counters never go backwards on an
+* interface, other than a 32 bit wrap, and the NodeID and NetworkCoordinator of an interface
+* stay the same.
+*
+* Against the skeleton simulator the suite first reconfigures it to MOCA_MULTI_SIM_INTERFACES
+* interfaces, MOCA_SIM_INTERFACES sets the number the other suites see.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_MULTI_DURATION_MS | Run time per interface count | 250 |
+*
+* **Pre-Conditions:**  The network topology must not change while the suite runs.
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "moca_bench.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_MULTI_MAX_INTERFACES         32      /**< ifIndex values probed by the discovery */
+#define MOCA_MULTI_SIM_INTERFACES         8
+#define MOCA_MULTI_DEFAULT_DURATION_MS    250
+#define MOCA_MULTI_LOW_EFFICIENCY         0.5
+#define MOCA_MULTI_WRAP_THRESHOLD         0x80000000UL
+
+extern int init_moca_hal_init(void);
+
+typedef struct
+{
+    char name[sizeof(((moca_static_info_t *)0)->Name)];
+    UCHAR macAddress[6];
+    ULONG ifIndex;
+} moca_multi_interface_t;
+
+typedef struct
+{
+    pthread_t thread;
+    ULONG ifIndex;
+    uint64_t calls;
+    uint64_t failures;
+    uint64_t inconsistencies;
+    moca_bench_histogram_t statsHistogram;
+    moca_bench_histogram_t dynamicInfoHistogram;
+    BOOL haveStats;
+    moca_stats_t lastStats;
+    BOOL haveDynamicInfo;
+    ULONG nodeId;
+    ULONG networkCoordinator;
+} moca_multi_poller_t;
+
+static moca_multi_interface_t gMultiInterfaces[MOCA_MULTI_MAX_INTERFACES];
+static int gMultiGo = 0;
+static int gMultiStop = 0;
+
+/* Probes every ifIndex up to MOCA_MULTI_MAX_INTERFACES, fills gMultiInterfaces and returns how many answered */
+static uint32_t moca_multi_discover(void)
+{
+    moca_static_info_t staticInfo;
+    uint32_t count = 0;
+    ULONG ifIndex;
+
+    for (ifIndex = 0; ifIndex < MOCA_MULTI_MAX_INTERFACES; ifIndex++)
+    {
+        memset(&staticInfo, 0, sizeof(staticInfo));
+        if (moca_IfGetStaticInfo(ifIndex, &staticInfo) != STATUS_SUCCESS)
+        {
+            continue;
+        }
+        gMultiInterfaces[count].ifIndex = ifIndex;
+        memcpy(gMultiInterfaces[count].name, staticInfo.Name, sizeof(gMultiInterfaces[count].name));
+        gMultiInterfaces[count].name[sizeof(gMultiInterfaces[count].name) - 1] = '\0';
+        memcpy(gMultiInterfaces[count].macAddress, staticInfo.MacAddress, sizeof(gMultiInterfaces[count].macAddress));
+        count++;
+    }
+    return count;
+}
+
+/* A counter may only move forward, or wrap from the top half of a 32 bit register */
+static BOOL moca_multi_counter_ok(ULONG previous, ULONG current)
+{
+    return (current >= previous) || (previous >= MOCA_MULTI_WRAP_THRESHOLD && current < MOCA_MULTI_WRAP_THRESHOLD);
+}
+
+static INT moca_multi_read_stats(moca_multi_poller_t *pPoller)
+{
+    moca_stats_t stats;
+    INT status = moca_IfGetStats(pPoller->ifIndex, &stats);
+
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    if (pPoller->haveStats)
+    {
+        const moca_stats_t *pLast = &pPoller->lastStats;
+
+        if (!moca_multi_counter_ok(pLast->BytesSent, stats.BytesSent) ||
+            !moca_multi_counter_ok(pLast->BytesReceived, stats.BytesReceived) ||
+            !moca_multi_counter_ok(pLast->PacketsSent, stats.PacketsSent) ||
+            !moca_multi_counter_ok(pLast->PacketsReceived, stats.PacketsReceived))
+        {
+            pPoller->inconsistencies++;
+        }
+    }
+    pPoller->lastStats = stats;
+    pPoller->haveStats = TRUE;
+    return status;
+}
+
+static INT moca_multi_read_dynamic_info(moca_multi_poller_t *pPoller)
+{
+    moca_dynamic_info_t dynamicInfo;
+    INT status = moca_IfGetDynamicInfo(pPoller->ifIndex, &dynamicInfo);
+
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    if (dynamicInfo.NodeID >= kMoca_MaxMocaNodes || dynamicInfo.NetworkCoordinator >= kMoca_MaxMocaNodes)
+    {
+        pPoller->inconsistencies++;
+    }
+    else if (pPoller->haveDynamicInfo &&
+             (dynamicInfo.NodeID != pPoller->nodeId || dynamicInfo.NetworkCoordinator != pPoller->networkCoordinator))
+    {
+        pPoller->inconsistencies++;
+    }
+    pPoller->nodeId = dynamicInfo.NodeID;
+    pPoller->networkCoordinator = dynamicInfo.NetworkCoordinator;
+    pPoller->haveDynamicInfo = TRUE;
+    return status;
+}
+
+/* Polls the statistics and the dynamic information of one interface in turn, as an agent does every period */
+static void *moca_multi_poller_main(void *pArg)
+{
+    moca_multi_poller_t *pPoller = (moca_multi_poller_t *)pArg;
+
+    /* Spin until every poller exists so they all start together */
+    while (__atomic_load_n(&gMultiGo, __ATOMIC_ACQUIRE) == 0)
+    {
+        sched_yield();
+    }
+    while (__atomic_load_n(&gMultiStop, __ATOMIC_RELAXED) == 0)
+    {
+        uint64_t start = moca_bench_now_ns();
+        INT status = moca_multi_read_stats(pPoller);
+        uint64_t middle = moca_bench_now_ns();
+
+        moca_bench_histogram_record(&pPoller->statsHistogram, middle - start);
+        pPoller->failures += (status != STATUS_SUCCESS);
+        status = moca_multi_read_dynamic_info(pPoller);
+        moca_bench_histogram_record(&pPoller->dynamicInfoHistogram, moca_bench_now_ns() - middle);
+        pPoller->failures += (status != STATUS_SUCCESS);
+        pPoller->calls += 2;
+    }
+    return NULL;
+}
+
+/* Polls the first numInterfaces discovered interfaces for durationMs, returns the aggregate calls per second */
+static double moca_multi_run(uint32_t numInterfaces, uint32_t durationMs, uint64_t *pFailures, uint64_t *pInconsistencies)
+{
+    moca_multi_poller_t *pPollers = calloc(numInterfaces, sizeof(moca_multi_poller_t));
+    moca_bench_histogram_t *pMerged = malloc(2 * sizeof(moca_bench_histogram_t));
+    uint64_t calls = 0;
+    uint64_t begin, elapsed;
+    uint32_t started = 0;
+    uint32_t i;
+    double callsPerSec;
+    char name[64];
+
+    if (pPollers == NULL || pMerged == NULL)
+    {
+        free(pPollers);
+        free(pMerged);
+        UT_FAIL("Out of memory");
+        return 0.0;
+    }
+    moca_bench_histogram_reset(&pMerged[0]);
+    moca_bench_histogram_reset(&pMerged[1]);
+    __atomic_store_n(&gMultiGo, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&gMultiStop, 0, __ATOMIC_RELAXED);
+    for (i = 0; i < numInterfaces; i++)
+    {
+        pPollers[i].ifIndex = gMultiInterfaces[i].ifIndex;
+        moca_bench_histogram_reset(&pPollers[i].statsHistogram);
+        moca_bench_histogram_reset(&pPollers[i].dynamicInfoHistogram);
+        if (pthread_create(&pPollers[i].thread, NULL, moca_multi_poller_main, &pPollers[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started < numInterfaces)
+    {
+        UT_FAIL("pthread_create failed");
+    }
+
+    begin = moca_bench_now_ns();
+    __atomic_store_n(&gMultiGo, 1, __ATOMIC_RELEASE);
+    moca_bench_sleep_ns((uint64_t)durationMs * 1000000ULL);
+    __atomic_store_n(&gMultiStop, 1, __ATOMIC_RELAXED);
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(pPollers[i].thread, NULL);
+        calls += pPollers[i].calls;
+        *pFailures += pPollers[i].failures;
+        *pInconsistencies += pPollers[i].inconsistencies;
+        moca_bench_histogram_merge(&pMerged[0], &pPollers[i].statsHistogram);
+        moca_bench_histogram_merge(&pMerged[1], &pPollers[i].dynamicInfoHistogram);
+    }
+    elapsed = moca_bench_now_ns() - begin;
+
+    callsPerSec = (double)calls * 1e9 / (double)elapsed;
+    UT_LOG("interfaces=%u calls=%llu calls/s=%.0f calls/s per interface=%.0f",
+           numInterfaces, (unsigned long long)calls, callsPerSec, callsPerSec / numInterfaces);
+    snprintf(name, sizeof(name), "moca_IfGetStats interfaces=%u", numInterfaces);
+    moca_bench_report(name, &pMerged[0]);
+    snprintf(name, sizeof(name), "moca_IfGetDynamicInfo interfaces=%u", numInterfaces);
+    moca_bench_report(name, &pMerged[1]);
+
+    free(pMerged);
+    free(pPollers);
+    return callsPerSec;
+}
+
+/**
+* @brief Discovers the valid MoCA interfaces and checks each one reports its own identity.
+*
+* Every ifIndex from 0 to MOCA_MULTI_MAX_INTERFACES - 1 is probed with moca_IfGetStaticInfo. At least one
+* interface must answer, and no two interfaces may report the same name or MAC address. Against the simulator
+* the interfaces found must be those it is configured with, also after a reconfiguration.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Probe every ifIndex with moca_IfGetStaticInfo | ifIndex = 0 .. MOCA_MULTI_MAX_INTERFACES - 1 | At least one STATUS_SUCCESS | Should be successful |
+* | 02 | Compare the names and MAC addresses reported | Discovered interfaces | All different | Should be successful |
+* | 03 | Reconfigure the simulator and probe again | numInterfaces = MOCA_MULTI_SIM_INTERFACES | Interfaces 0 .. MOCA_MULTI_SIM_INTERFACES - 1 found | Simulator only |
+* | 04 | Restore the simulator configuration and probe again | Saved configuration | The configured interfaces found | Simulator only |
+*/
+void test_l2_moca_hal_multi_interface_Discover(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_multi_interface_Discover...");
+
+    uint32_t count = moca_multi_discover();
+    uint32_t i, j;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved, multi;
+#endif
+
+    UT_LOG("Interfaces found: %u", count);
+    UT_ASSERT_TRUE(count >= 1);
+    for (i = 0; i < count; i++)
+    {
+        const UCHAR *pMac = gMultiInterfaces[i].macAddress;
+
+        UT_LOG("ifIndex %lu: %s %02x:%02x:%02x:%02x:%02x:%02x", gMultiInterfaces[i].ifIndex, gMultiInterfaces[i].name,
+               pMac[0], pMac[1], pMac[2], pMac[3], pMac[4], pMac[5]);
+        for (j = 0; j < i; j++)
+        {
+            UT_ASSERT_TRUE(strcmp(gMultiInterfaces[i].name, gMultiInterfaces[j].name) != 0);
+            UT_ASSERT_TRUE(memcmp(gMultiInterfaces[i].macAddress, gMultiInterfaces[j].macAddress, sizeof(gMultiInterfaces[i].macAddress)) != 0);
+        }
+    }
+
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(count, saved.numInterfaces);
+    multi = saved;
+    multi.numInterfaces = MOCA_MULTI_SIM_INTERFACES;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&multi), STATUS_SUCCESS);
+    count = moca_multi_discover();
+    UT_LOG("Interfaces found with the simulator configured for %u: %u", MOCA_MULTI_SIM_INTERFACES, count);
+    UT_ASSERT_EQUAL(count, MOCA_MULTI_SIM_INTERFACES);
+    for (i = 0; i < count; i++)
+    {
+        UT_ASSERT_EQUAL(gMultiInterfaces[i].ifIndex, i);
+    }
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_multi_discover(), saved.numInterfaces);
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_multi_interface_Discover...");
+}
+
+/**
+* @brief Polls moca_IfGetStats and moca_IfGetDynamicInfo on an increasing number of interfaces at once.
+*
+* One thread per interface alternates the two APIs, as the per interface pollers of an agent do. For 1, 2, 4 ...
+* up to every discovered interface the aggregate throughput, the scaling efficiency against a single interface, with
+* at most one poller per CPU running at once, and the latency percentiles of each API are logged and written to
+* MOCA_BENCH_RESULTS. Every result must be consistent.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Reconfigure the simulator | numInterfaces = MOCA_MULTI_SIM_INTERFACES | STATUS_SUCCESS | Simulator only |
+* | 02 | Discover the interfaces | ifIndex = 0 .. MOCA_MULTI_MAX_INTERFACES - 1 | At least one found | Should be successful |
+* | 03 | Poll 1, 2, 4 ... all interfaces, one thread each, for MOCA_MULTI_DURATION_MS | moca_IfGetStats, moca_IfGetDynamicInfo | All calls return STATUS_SUCCESS, results consistent per interface | Throughput, efficiency and percentiles logged |
+* | 04 | Restore the simulator configuration | Saved configuration | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_multi_interface_PollScaling(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_multi_interface_PollScaling...");
+
+    uint32_t durationMs = moca_bench_env_u32("MOCA_MULTI_DURATION_MS", MOCA_MULTI_DEFAULT_DURATION_MS, 60000);
+    uint64_t failures = 0;
+    uint64_t inconsistencies = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    double baseline = 0.0;
+    uint32_t count, interfaces;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_config_t saved, multi;
+
+    UT_ASSERT_EQUAL(moca_sim_GetConfig(&saved), STATUS_SUCCESS);
+    multi = saved;
+    multi.numInterfaces = MOCA_MULTI_SIM_INTERFACES;
+    UT_ASSERT_EQUAL(moca_sim_Configure(&multi), STATUS_SUCCESS);
+#endif
+
+    count = moca_multi_discover();
+    UT_LOG("Polling up to %u interfaces on %ld CPUs", count, cpus);
+    UT_ASSERT_TRUE(count >= 1);
+    for (interfaces = 1; count > 0; interfaces = (interfaces * 2 < count) ? interfaces * 2 : count)
+    {
+        double callsPerSec = moca_multi_run(interfaces, durationMs, &failures, &inconsistencies);
+
+        if (interfaces == 1)
+        {
+            baseline = callsPerSec;
+        }
+        else
+        {
+            uint32_t concurrent = (cpus > 0 && (uint32_t)cpus < interfaces) ? (uint32_t)cpus : interfaces;
+            double efficiency = (baseline > 0.0) ? callsPerSec / (baseline * concurrent) : 0.0;
+
+            UT_LOG("interfaces=%u scaling efficiency=%.2f", interfaces, efficiency);
+            if (concurrent > 1 && efficiency < MOCA_MULTI_LOW_EFFICIENCY)
+            {
+                UT_LOG("Polling scales poorly at %u interfaces, the HAL may serialise the interfaces", interfaces);
+            }
+        }
+        if (interfaces >= count)
+        {
+            break;
+        }
+    }
+
+#ifdef MOCA_HAL_SIMULATOR
+    UT_ASSERT_EQUAL(moca_sim_Configure(&saved), STATUS_SUCCESS);
+#endif
+    UT_LOG("Failed calls: %llu, inconsistent results: %llu", (unsigned long long)failures, (unsigned long long)inconsistencies);
+    UT_ASSERT_EQUAL(failures, 0);
+    UT_ASSERT_EQUAL(inconsistencies, 0);
+
+    UT_LOG("Exiting test_l2_moca_hal_multi_interface_PollScaling...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_multi_interface_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal multi interface]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_multi_interface_Discover", test_l2_moca_hal_multi_interface_Discover);
+    UT_add_test(pSuite, "l2_moca_hal_multi_interface_PollScaling", test_l2_moca_hal_multi_interface_PollScaling);
+
+    return 0;
+}
@@ -0,0 +1,475 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_poller.c
+* @page moca_hal_poller Level 2 Adaptive Poller Tests
+*
+* ## Module's Role
+* This module checks the adaptive rate poller of moca_poller.h against the traffic profiles
+* an agent sees: an idle link, on which it must back off to its slowest interval, and a bursty
+* one, on which it must speed up within one slow interval of a burst starting. The bursty
+* profile is also polled at a fixed interval at either bound of the adaptive poller, and for
+* every run the suite reports the sample count, the CPU time per sample, the staleness of the
+* latest sample and the sample error, the bytes the latest sample is behind the counters read
+* at that moment.
+* An interface reset under a running poller must restart the counters without adding a wrap
+* to the byte totals.
+*
+* The traffic profiles are set with moca_sim_SetTraffic(), so only the interval calculation is
+* tested without MOCA_HAL_SIMULATOR.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_POLLER_DURATION_MS | Run time of each traffic profile | 1200 |
+*
+* **Pre-Conditions:**  None
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdint.h>
+#include <string.h>
+#include "moca_bench.h"
+#include "moca_poller.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_POLLER_TEST_MIN_INTERVAL_MS       10
+#define MOCA_POLLER_TEST_MAX_INTERVAL_MS       200
+#define MOCA_POLLER_TEST_BYTES_PER_SAMPLE      (256 * 1024)
+#define MOCA_POLLER_TEST_DEFAULT_DURATION_MS   1200
+#define MOCA_POLLER_TEST_BURST_MS              200     /**< Traffic on at the start of every period */
+#define MOCA_POLLER_TEST_PERIOD_MS             600
+#define MOCA_POLLER_TEST_CHECK_MS              5       /**< Interval the test reads the counters to measure the error */
+#define MOCA_POLLER_TEST_SLACK_MS              100     /**< Scheduling allowance on the staleness bound */
+#define MOCA_POLLER_TEST_ADVANCE_BYTES         0xC0000000UL  /**< Far enough that a restart read as a wrap is 1 GiB */
+
+extern int init_moca_hal_init(void);
+
+#ifdef MOCA_HAL_SIMULATOR
+
+static ULONG gPollerIfIndex = 0;
+
+typedef struct
+{
+    uint32_t minIntervalMs;
+    uint32_t maxIntervalMs;
+} moca_poller_test_seen_t;
+
+typedef struct
+{
+    uint64_t samples;
+    uint64_t failures;
+    uint64_t cpuNs;
+    uint64_t maxGapNs;
+    uint64_t checks;
+    double meanBytesBehind;
+    uint64_t maxBytesBehind;
+    moca_poller_test_seen_t seen;
+} moca_poller_test_result_t;
+
+static moca_bench_histogram_t gPollerStaleness;
+
+/* Bytes the counters moved from the sample to now, wrap aware as in the poller */
+static uint64_t moca_poller_test_behind(ULONG sampled, ULONG current)
+{
+    return (current >= sampled) ? (uint64_t)(current - sampled) : (uint64_t)(uint32_t)(current - sampled);
+}
+
+static void moca_poller_test_on_sample(const moca_poller_sample_t *pSample, void *pContext)
+{
+    moca_poller_test_seen_t *pSeen = (moca_poller_test_seen_t *)pContext;
+
+    if (pSample->nextIntervalMs < pSeen->minIntervalMs)
+    {
+        pSeen->minIntervalMs = pSample->nextIntervalMs;
+    }
+    if (pSample->nextIntervalMs > pSeen->maxIntervalMs)
+    {
+        pSeen->maxIntervalMs = pSample->nextIntervalMs;
+    }
+}
+
+static void moca_poller_test_set_traffic(BOOL on)
+{
+    moca_sim_config_t config;
+
+    moca_sim_GetConfig(&config);
+    if (on)
+    {
+        moca_sim_SetTraffic(gPollerIfIndex, config.txBytesPerSec, config.rxBytesPerSec);
+    }
+    else
+    {
+        moca_sim_SetTraffic(gPollerIfIndex, 0, 0);
+    }
+}
+
+/*
+* Runs a poller for durationMs, bursty switches the traffic on for the first MOCA_POLLER_TEST_BURST_MS of every
+* MOCA_POLLER_TEST_PERIOD_MS. Every MOCA_POLLER_TEST_CHECK_MS the counters are read and compared with the latest sample.
+*/
+static void moca_poller_test_run(const char *pName, moca_poller_config_t *pConfig, uint32_t durationMs, BOOL bursty,
+                                 moca_poller_test_result_t *pResult)
+{
+    moca_poller_t poller;
+    moca_poller_stats_t stats;
+    moca_poller_sample_t sample;
+    moca_stats_t truth;
+    uint64_t begin, now, bytesBehind, totalBehind = 0;
+    BOOL trafficOn = FALSE;
+    char name[64];
+
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->seen.minIntervalMs = UINT32_MAX;
+    pConfig->callback = moca_poller_test_on_sample;
+    pConfig->pContext = &pResult->seen;
+    moca_bench_histogram_reset(&gPollerStaleness);
+    moca_poller_test_set_traffic(bursty);
+    trafficOn = bursty;
+
+    if (moca_poller_start(&poller, pConfig) != STATUS_SUCCESS)
+    {
+        moca_poller_test_set_traffic(TRUE);
+        UT_FAIL("moca_poller_start failed");
+        return;
+    }
+    begin = moca_bench_now_ns();
+    while ((now = moca_bench_now_ns()) - begin < (uint64_t)durationMs * 1000000ULL)
+    {
+        if (bursty)
+        {
+            BOOL on = (((now - begin) / 1000000ULL) % MOCA_POLLER_TEST_PERIOD_MS) < MOCA_POLLER_TEST_BURST_MS;
+
+            if (on != trafficOn)
+            {
+                moca_poller_test_set_traffic(on);
+                trafficOn = on;
+            }
+        }
+        if (moca_poller_latest(&poller, &sample) == STATUS_SUCCESS &&
+            moca_IfGetStats(gPollerIfIndex, &truth) == STATUS_SUCCESS)
+        {
+            now = moca_bench_now_ns();
+            bytesBehind = moca_poller_test_behind(sample.stats.BytesSent, truth.BytesSent) +
+                          moca_poller_test_behind(sample.stats.BytesReceived, truth.BytesReceived);
+            totalBehind += bytesBehind;
+            if (bytesBehind > pResult->maxBytesBehind)
+            {
+                pResult->maxBytesBehind = bytesBehind;
+            }
+            moca_bench_histogram_record(&gPollerStaleness, (now > sample.timestampNs) ? now - sample.timestampNs : 0);
+            pResult->checks++;
+        }
+        moca_bench_sleep_ns(MOCA_POLLER_TEST_CHECK_MS * 1000000ULL);
+    }
+    moca_poller_stop(&poller);
+    moca_poller_test_set_traffic(TRUE);
+
+    moca_poller_get_stats(&poller, &stats);
+    pResult->samples = stats.samples;
+    pResult->failures = stats.failures;
+    pResult->cpuNs = stats.cpuNs;
+    pResult->maxGapNs = stats.maxGapNs;
+    pResult->meanBytesBehind = (pResult->checks > 0) ? (double)totalBehind / (double)pResult->checks : 0.0;
+
+    UT_LOG("%s: samples=%llu failures=%llu cpu/sample=%llu ns cpu=%.3f%% max gap=%llu ms interval=%u..%u ms",
+           pName, (unsigned long long)pResult->samples, (unsigned long long)pResult->failures,
+           (unsigned long long)(pResult->samples > 0 ? pResult->cpuNs / pResult->samples : 0),
+           100.0 * (double)pResult->cpuNs / ((double)durationMs * 1e6), (unsigned long long)(pResult->maxGapNs / 1000000ULL),
+           pResult->seen.minIntervalMs, pResult->seen.maxIntervalMs);
+    UT_LOG("%s: sample error over %llu checks: mean=%.0f bytes max=%llu bytes", pName,
+           (unsigned long long)pResult->checks, pResult->meanBytesBehind, (unsigned long long)pResult->maxBytesBehind);
+    snprintf(name, sizeof(name), "%s staleness", pName);
+    moca_bench_report(name, &gPollerStaleness);
+}
+
+static void moca_poller_test_config(moca_poller_config_t *pConfig)
+{
+    moca_poller_default_config(gPollerIfIndex, pConfig);
+    pConfig->minIntervalMs = MOCA_POLLER_TEST_MIN_INTERVAL_MS;
+    pConfig->maxIntervalMs = MOCA_POLLER_TEST_MAX_INTERVAL_MS;
+    pConfig->bytesPerSample = MOCA_POLLER_TEST_BYTES_PER_SAMPLE;
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+/**
+* @brief Checks the interval the poller chooses from the traffic observed.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | No traffic | currentMs = 10, 150, 200 | 20, 200, 200 | Backs off by doubling up to the maximum |
+* | 02 | 10 MB/s with 1 MB per sample | currentMs = 10, 100 | 20, 100 | Backs off towards the 100 ms target |
+* | 03 | 1 GB/s with 1 MB per sample | currentMs = 200 | 10 | Speeds up to the minimum at once |
+* | 04 | bytesPerSample = 0 | Any traffic | 10 | Fixed interval |
+*/
+void test_l2_moca_hal_poller_NextInterval(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_poller_NextInterval...");
+
+    moca_poller_config_t config;
+
+    moca_poller_default_config(0, &config);
+    config.minIntervalMs = 10;
+    config.maxIntervalMs = 200;
+    config.bytesPerSample = 1000000;
+
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 10, 0, 1000000000ULL), 20);
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 150, 0, 1000000000ULL), 200);
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 200, 0, 1000000000ULL), 200);
+
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 10, 10000000ULL, 1000000000ULL), 20);
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 100, 10000000ULL, 1000000000ULL), 100);
+
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 200, 1000000000ULL, 1000000000ULL), 10);
+
+    config.bytesPerSample = 0;
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 200, 0, 1000000000ULL), 10);
+    UT_ASSERT_EQUAL(moca_poller_next_interval_ms(&config, 10, 1000000000ULL, 1000000000ULL), 10);
+
+    UT_LOG("Exiting test_l2_moca_hal_poller_NextInterval...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+/**
+* @brief Polls an idle link, the poller must back off to its slowest interval.
+*
+* The extended counters are read with every sample. Compared with fixed polling at the minimum interval the samples
+* saved are logged.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Stop the traffic and poll for MOCA_POLLER_DURATION_MS | moca_sim_SetTraffic(0, 0, 0), extCounter = TRUE | No failures, extended counters read | Simulator only |
+* | 02 | Check the interval | Poller statistics | maxIntervalMs, samples within the doubling ramp plus duration / maxIntervalMs | Should be successful |
+* | 03 | Check the byte totals and the staleness | Latest sample | No bytes counted, latest sample at most maxIntervalMs old | Should be successful |
+* | 04 | Restore the traffic | Configured rates | Returns | Should be successful |
+*/
+void test_l2_moca_hal_poller_Idle(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_poller_Idle...");
+
+    uint32_t durationMs = moca_bench_env_u32("MOCA_POLLER_DURATION_MS", MOCA_POLLER_TEST_DEFAULT_DURATION_MS, 60000);
+    uint32_t ramp = 0;
+    uint32_t intervalMs;
+    moca_poller_config_t config;
+    moca_poller_test_result_t result;
+
+    moca_poller_test_config(&config);
+    config.extCounter = TRUE;
+    for (intervalMs = config.minIntervalMs; intervalMs < config.maxIntervalMs; intervalMs *= 2)
+    {
+        ramp++;
+    }
+    moca_poller_test_run("moca_poller idle", &config, durationMs, FALSE, &result);
+
+    UT_LOG("Samples taken: %llu, fixed polling every %u ms takes %u", (unsigned long long)result.samples,
+           config.minIntervalMs, durationMs / config.minIntervalMs);
+    UT_ASSERT_TRUE(result.samples >= 1);
+    UT_ASSERT_EQUAL(result.failures, 0);
+    UT_ASSERT_EQUAL(result.seen.maxIntervalMs, config.maxIntervalMs);
+    UT_ASSERT_TRUE(result.samples <= ramp + durationMs / config.maxIntervalMs + 2);
+    UT_ASSERT_TRUE(result.maxGapNs <= (uint64_t)(config.maxIntervalMs + MOCA_POLLER_TEST_SLACK_MS) * 1000000ULL);
+    UT_ASSERT_EQUAL(result.maxBytesBehind, 0);
+    UT_ASSERT_TRUE(moca_bench_histogram_percentile(&gPollerStaleness, 100.0) <=
+                   (uint64_t)(config.maxIntervalMs + MOCA_POLLER_TEST_SLACK_MS) * 1000000ULL);
+
+    UT_LOG("Exiting test_l2_moca_hal_poller_Idle...");
+}
+
+/**
+* @brief Polls a bursty link adaptively and at fixed intervals at either bound.
+*
+* The traffic runs for MOCA_POLLER_TEST_BURST_MS of every MOCA_POLLER_TEST_PERIOD_MS. The adaptive poller must reach
+* its minimum interval within the bursts and keep the latest sample within its staleness bound. Against fixed polling
+* at its maximum interval, the same staleness bound, it must be behind by fewer bytes, and against fixed polling at its
+* minimum interval it must take fewer samples.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Poll adaptively for MOCA_POLLER_DURATION_MS of bursty traffic | 10 .. 200 ms, 256 KiB per sample | No failures, minimum interval reached, gaps within maxIntervalMs | Simulator only |
+* | 02 | Poll every maxIntervalMs | bytesPerSample = 0 | No failures, mean error above the adaptive one | Simulator only |
+* | 03 | Poll every minIntervalMs | bytesPerSample = 0 | No failures, more samples than the adaptive poller | Simulator only |
+* | 04 | Restore the traffic | Configured rates | Returns | Should be successful |
+*/
+void test_l2_moca_hal_poller_Bursty(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_poller_Bursty...");
+
+    uint32_t durationMs = moca_bench_env_u32("MOCA_POLLER_DURATION_MS", MOCA_POLLER_TEST_DEFAULT_DURATION_MS, 60000);
+    moca_poller_config_t config, fixedConfig;
+    moca_poller_test_result_t adaptive, slow, fast;
+
+    moca_poller_test_config(&config);
+    moca_poller_test_run("moca_poller bursty adaptive", &config, durationMs, TRUE, &adaptive);
+    UT_ASSERT_EQUAL(adaptive.failures, 0);
+    UT_ASSERT_EQUAL(adaptive.seen.minIntervalMs, config.minIntervalMs);
+    UT_ASSERT_TRUE(adaptive.maxGapNs <= (uint64_t)(config.maxIntervalMs + MOCA_POLLER_TEST_SLACK_MS) * 1000000ULL);
+
+    fixedConfig = config;
+    fixedConfig.minIntervalMs = config.maxIntervalMs;
+    fixedConfig.bytesPerSample = 0;
+    moca_poller_test_run("moca_poller bursty fixed slow", &fixedConfig, durationMs, TRUE, &slow);
+    UT_ASSERT_EQUAL(slow.failures, 0);
+
+    fixedConfig = config;
+    fixedConfig.maxIntervalMs = config.minIntervalMs;
+    fixedConfig.bytesPerSample = 0;
+    moca_poller_test_run("moca_poller bursty fixed fast", &fixedConfig, durationMs, TRUE, &fast);
+    UT_ASSERT_EQUAL(fast.failures, 0);
+
+    UT_LOG("Adaptive against every %u ms: sample error %.2fx, samples %.2fx", config.maxIntervalMs,
+           (slow.meanBytesBehind > 0.0) ? adaptive.meanBytesBehind / slow.meanBytesBehind : 0.0,
+           (slow.samples > 0) ? (double)adaptive.samples / (double)slow.samples : 0.0);
+    UT_LOG("Adaptive against every %u ms: sample error %.2fx, samples %.2fx", config.minIntervalMs,
+           (fast.meanBytesBehind > 0.0) ? adaptive.meanBytesBehind / fast.meanBytesBehind : 0.0,
+           (fast.samples > 0) ? (double)adaptive.samples / (double)fast.samples : 0.0);
+    UT_ASSERT_TRUE(adaptive.meanBytesBehind < slow.meanBytesBehind);
+    UT_ASSERT_TRUE(adaptive.samples < fast.samples);
+
+    UT_LOG("Exiting test_l2_moca_hal_poller_Bursty...");
+}
+
+/**
+* @brief Resets the interface under a running poller, the restarted counters must not be taken as a wrap.
+*
+* Reapplying the configuration with moca_SetIfConfig() re-forms the link, which restarts the byte counters from zero
+* and increments moca_GetResetCount(). The counters are advanced first, so reading the drop as a wrap would add 1 GiB
+* to the totals of an idle link.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Stop the traffic, advance the counters and start the poller | 0xC0000000 bytes | First sample taken | Simulator only |
+* | 02 | Reapply the configuration and wait two maximum intervals | moca_GetIfConfig, moca_SetIfConfig | One reset counted, byte totals unchanged, no failures | Simulator only |
+* | 03 | Restore the traffic | Configured rates | Returns | Should be successful |
+*/
+void test_l2_moca_hal_poller_Reset(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_poller_Reset...");
+
+    moca_poller_config_t config;
+    moca_poller_t poller;
+    moca_poller_stats_t stats;
+    moca_poller_sample_t before, after;
+    moca_cfg_t ifConfig;
+    ULONG resetCount = 0;
+    uint32_t waitedMs;
+
+    moca_poller_test_config(&config);
+    moca_poller_test_set_traffic(FALSE);
+    UT_ASSERT_EQUAL(moca_sim_AdvanceCounters(gPollerIfIndex, MOCA_POLLER_TEST_ADVANCE_BYTES, MOCA_POLLER_TEST_ADVANCE_BYTES, 0),
+                    STATUS_SUCCESS);
+    if (moca_poller_start(&poller, &config) != STATUS_SUCCESS)
+    {
+        moca_poller_test_set_traffic(TRUE);
+        UT_FAIL("moca_poller_start failed");
+        return;
+    }
+    for (waitedMs = 0; moca_poller_latest(&poller, &before) != STATUS_SUCCESS && waitedMs < config.maxIntervalMs;
+         waitedMs += MOCA_POLLER_TEST_CHECK_MS)
+    {
+        moca_bench_sleep_ns(MOCA_POLLER_TEST_CHECK_MS * 1000000ULL);
+    }
+    UT_ASSERT_EQUAL(moca_poller_latest(&poller, &before), STATUS_SUCCESS);
+
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gPollerIfIndex, &ifConfig), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gPollerIfIndex, &ifConfig), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetResetCount(&resetCount), STATUS_SUCCESS);
+    moca_bench_sleep_ns((uint64_t)(2 * config.maxIntervalMs + MOCA_POLLER_TEST_SLACK_MS) * 1000000ULL);
+    moca_poller_stop(&poller);
+    moca_poller_test_set_traffic(TRUE);
+
+    moca_poller_get_stats(&poller, &stats);
+    UT_ASSERT_EQUAL(moca_poller_latest(&poller, &after), STATUS_SUCCESS);
+    UT_LOG("Reset count %lu, sample %lu: BytesSent %lu -> %lu, txBytes %llu -> %llu, resets=%llu failures=%llu",
+           before.resetCount, after.resetCount, before.stats.BytesSent, after.stats.BytesSent,
+           (unsigned long long)before.txBytes, (unsigned long long)after.txBytes, (unsigned long long)stats.resets,
+           (unsigned long long)stats.failures);
+    UT_ASSERT_EQUAL(after.resetCount, resetCount);
+    UT_ASSERT_EQUAL(stats.resets, 1);
+    UT_ASSERT_EQUAL(stats.failures, 0);
+    UT_ASSERT_EQUAL(after.txBytes, before.txBytes);
+    UT_ASSERT_EQUAL(after.rxBytes, before.rxBytes);
+
+    UT_LOG("Exiting test_l2_moca_hal_poller_Reset...");
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_poller_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal poller]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_poller_NextInterval", test_l2_moca_hal_poller_NextInterval);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_poller_Idle", test_l2_moca_hal_poller_Idle);
+    UT_add_test(pSuite, "l2_moca_hal_poller_Bursty", test_l2_moca_hal_poller_Bursty);
+    UT_add_test(pSuite, "l2_moca_hal_poller_Reset", test_l2_moca_hal_poller_Reset);
+#endif
+
+    return 0;
+}
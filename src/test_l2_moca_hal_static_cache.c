@@ -0,0 +1,489 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_static_cache.c
+* @page moca_hal_static_cache Level 2 Static Info Cache Tests
+*
+* ## Module's Role
+* This module checks the moca_IfGetStaticInfo() cache of moca_static_cache.h. Lookups must hit
+* once an interface was read, and the cache must drop an entry on every configuration applied
+* through it and on every reset the driver counts.
+*
+* Against the simulator the static info is changed by a configuration applied through the cache,
+* by one applied to the driver directly, and by a firmware upgrade. Reader threads then look the
+* static info up while the firmware is upgraded again and again, and every lookup is checked
+* against the upgrades completed before it started. The benchmark compares a hit with the driver
+* call.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_STATIC_CACHE_READERS | Concurrent reader threads | 4 |
+* | MOCA_STATIC_CACHE_DURATION_MS | Run time of the concurrent lookup test | 500 |
+*
+* **Pre-Conditions:**  None
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "moca_bench.h"
+#include "moca_static_cache.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_STATIC_CACHE_DEFAULT_READERS       4
+#define MOCA_STATIC_CACHE_MAX_READERS           64
+#define MOCA_STATIC_CACHE_DEFAULT_DURATION_MS   500
+#define MOCA_STATIC_CACHE_UPGRADE_NS            1000000ULL      /**< Time between two firmware upgrades */
+#define MOCA_STATIC_CACHE_REVALIDATE_MS         60000           /**< Long enough to outlast a test */
+#define MOCA_STATIC_CACHE_VERSION_FORMAT        "moca-sim-upgrade-%u"
+#define MOCA_STATIC_CACHE_SLOW_DRIVER_US        100             /**< Firmware mailbox round trip of a static info read */
+
+extern int init_moca_hal_init(void);
+
+typedef struct
+{
+    pthread_t thread;
+    uint64_t lookups;
+    uint64_t failures;
+    uint64_t stale;                 /**< Lookups older than an upgrade completed before they started */
+} moca_static_cache_reader_t;
+
+static ULONG gStaticCacheIfIndex = 0;
+static moca_static_cache_t gStaticCache;
+static moca_bench_histogram_t gStaticCacheHistogram;
+#ifdef MOCA_HAL_SIMULATOR
+static uint32_t gStaticCacheUpgrades = 0;
+static int gStaticCacheStop = 0;
+#endif
+
+static int moca_static_cache_op_Driver(void *pContext)
+{
+    moca_static_info_t info;
+    (void)pContext;
+
+    return moca_IfGetStaticInfo(gStaticCacheIfIndex, &info);
+}
+
+static int moca_static_cache_op_Hit(void *pContext)
+{
+    moca_static_info_t info;
+    (void)pContext;
+
+    return moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info);
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+static INT moca_static_cache_upgrade(uint32_t upgrade)
+{
+    char version[64];
+
+    snprintf(version, sizeof(version), MOCA_STATIC_CACHE_VERSION_FORMAT, upgrade);
+    return moca_sim_SetFirmwareVersion(gStaticCacheIfIndex, version);
+}
+
+static void *moca_static_cache_reader_main(void *pArg)
+{
+    moca_static_cache_reader_t *pReader = (moca_static_cache_reader_t *)pArg;
+    moca_static_info_t info;
+    uint32_t completed, upgrade;
+
+    while (__atomic_load_n(&gStaticCacheStop, __ATOMIC_RELAXED) == 0)
+    {
+        completed = __atomic_load_n(&gStaticCacheUpgrades, __ATOMIC_ACQUIRE);
+        if (moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info) != STATUS_SUCCESS ||
+            sscanf(info.FirmwareVersion, MOCA_STATIC_CACHE_VERSION_FORMAT, &upgrade) != 1)
+        {
+            pReader->failures++;
+            continue;
+        }
+        pReader->lookups++;
+        pReader->stale += (upgrade < completed);
+    }
+    return NULL;
+}
+
+static void *moca_static_cache_writer_main(void *pArg)
+{
+    uint64_t *pFailures = (uint64_t *)pArg;
+    uint32_t upgrade = __atomic_load_n(&gStaticCacheUpgrades, __ATOMIC_RELAXED);
+
+    while (__atomic_load_n(&gStaticCacheStop, __ATOMIC_RELAXED) == 0)
+    {
+        upgrade++;
+        if (moca_static_cache_upgrade(upgrade) != STATUS_SUCCESS)
+        {
+            (*pFailures)++;
+            break;
+        }
+        __atomic_store_n(&gStaticCacheUpgrades, upgrade, __ATOMIC_RELEASE);
+        moca_bench_sleep_ns(MOCA_STATIC_CACHE_UPGRADE_NS);
+    }
+    return NULL;
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+/**
+* @brief Checks lookups hit after the first one and miss after an invalidation.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Look up twice | ifIndex = 0 | Same as moca_IfGetStaticInfo, one miss then one hit | Should be successful |
+* | 02 | Invalidate and look up | ifIndex = 0 | One more miss | Should be successful |
+* | 03 | Look up an interface beyond the cache | ifIndex = MOCA_STATIC_CACHE_MAX_INTERFACES + 1 | STATUS_FAILURE from the driver | Should be successful |
+* | 04 | Pass NULL | pCache, pInfo = NULL | STATUS_FAILURE | Should be successful |
+*/
+void test_l2_moca_hal_static_cache_Lookup(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_static_cache_Lookup...");
+
+    moca_static_info_t driver, cached;
+    moca_static_cache_stats_t stats;
+
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_IfGetStaticInfo(gStaticCacheIfIndex, &driver), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &cached), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&driver, &cached, sizeof(driver)), 0);
+    memset(&cached, 0, sizeof(cached));
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &cached), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&driver, &cached, sizeof(driver)), 0);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.misses, 1);
+    UT_ASSERT_EQUAL(stats.hits, 1);
+
+    moca_static_cache_invalidate(&gStaticCache, gStaticCacheIfIndex);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &cached), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&driver, &cached, sizeof(driver)), 0);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.misses, 2);
+    UT_ASSERT_EQUAL(stats.invalidations, 1);
+
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, MOCA_STATIC_CACHE_MAX_INTERFACES + 1, &cached), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, NULL), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_static_cache_get(NULL, gStaticCacheIfIndex, &cached), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_static_cache_init(NULL, 0), STATUS_FAILURE);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.failures, 1);
+    moca_static_cache_destroy(&gStaticCache);
+
+    UT_LOG("Exiting test_l2_moca_hal_static_cache_Lookup...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+
+/**
+* @brief Changes the static info in every way the simulator can and checks the next lookup sees it.
+*
+* A configuration applied through the cache drops the entry itself, a partial one only if it changed a field. One
+* applied with moca_SetIfConfig() directly and a firmware upgrade are only seen through moca_GetResetCount(). A
+* partial one applied with moca_SetIfConfigFields() directly counts no reset and is not seen until the entry is
+* invalidated, as documented. A cache that skips the reset count for MOCA_STATIC_CACHE_REVALIDATE_MS keeps the old firmware version until it is
+* invalidated, as documented.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Lower TxPowerLimit through the cache | moca_static_cache_set_config, TxPowerLimit - 5 | TxBcastPowerReduction up by 5 | Simulator only |
+* | 02 | Restore TxPowerLimit with moca_SetIfConfig | Original configuration | TxBcastPowerReduction back, one reset seen | Simulator only |
+* | 03 | Lower and restore TxPowerLimit with moca_static_cache_set_config_fields, then apply it unchanged | fieldMask = MOCA_CFG_ALL_FIELDS | TxBcastPowerReduction follows without a reset, the unchanged apply keeps the entry | Simulator only |
+* | 04 | Lower TxPowerLimit with moca_SetIfConfigFields directly, then restore it through the cache | fieldMask = MOCA_CFG_ALL_FIELDS | Old TxBcastPowerReduction until invalidated, no reset seen | Simulator only |
+* | 05 | Upgrade the firmware | moca_sim_SetFirmwareVersion | New FirmwareVersion | Simulator only |
+* | 06 | Upgrade with a revalidating cache | revalidateMs = MOCA_STATIC_CACHE_REVALIDATE_MS | Old version until invalidated | Simulator only |
+* | 07 | Restore the firmware | Original version | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_static_cache_Invalidation(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_static_cache_Invalidation...");
+
+    moca_static_cache_t revalidating;
+    moca_static_cache_stats_t stats;
+    moca_static_info_t original, info;
+    moca_cfg_t config, lowered;
+    moca_cfg_apply_result_t result;
+
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_init(&revalidating, MOCA_STATIC_CACHE_REVALIDATE_MS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_GetIfConfig(gStaticCacheIfIndex, &config), STATUS_SUCCESS);
+
+    lowered = config;
+    lowered.TxPowerLimit -= 5;
+    UT_ASSERT_EQUAL(moca_static_cache_set_config(&gStaticCache, gStaticCacheIfIndex, &lowered), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_LOG("TxBcastPowerReduction %lu after TxPowerLimit %d", info.TxBcastPowerReduction, lowered.TxPowerLimit);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction + 5);
+
+    UT_ASSERT_EQUAL(moca_SetIfConfig(gStaticCacheIfIndex, &config), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.invalidations, 1);
+    UT_ASSERT_EQUAL(stats.resets, 1);
+
+    UT_ASSERT_EQUAL(moca_static_cache_set_config_fields(&gStaticCache, gStaticCacheIfIndex, &lowered, MOCA_CFG_ALL_FIELDS,
+                                                        &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.reformMask, 0);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction + 5);
+    UT_ASSERT_EQUAL(moca_static_cache_set_config_fields(&gStaticCache, gStaticCacheIfIndex, &config, MOCA_CFG_ALL_FIELDS,
+                                                        NULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_set_config_fields(&gStaticCache, gStaticCacheIfIndex, &config, MOCA_CFG_ALL_FIELDS,
+                                                        NULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.invalidations, 3);
+    UT_ASSERT_EQUAL(stats.resets, 1);
+
+    UT_ASSERT_EQUAL(moca_SetIfConfigFields(gStaticCacheIfIndex, &lowered, MOCA_CFG_ALL_FIELDS, &result), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(result.reformMask, 0);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_LOG("TxBcastPowerReduction %lu cached after moca_SetIfConfigFields with TxPowerLimit %d", info.TxBcastPowerReduction,
+           lowered.TxPowerLimit);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction);
+    moca_static_cache_invalidate(&gStaticCache, gStaticCacheIfIndex);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction + 5);
+    UT_ASSERT_EQUAL(moca_static_cache_set_config_fields(&gStaticCache, gStaticCacheIfIndex, &config, MOCA_CFG_ALL_FIELDS,
+                                                        NULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(info.TxBcastPowerReduction, original.TxBcastPowerReduction);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_ASSERT_EQUAL(stats.invalidations, 5);
+    UT_ASSERT_EQUAL(stats.resets, 1);
+
+    UT_ASSERT_EQUAL(moca_static_cache_get(&revalidating, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_sim_SetFirmwareVersion(gStaticCacheIfIndex, "moca-sim-test"), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(info.FirmwareVersion, "moca-sim-test"), 0);
+
+    UT_ASSERT_EQUAL(moca_static_cache_get(&revalidating, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(info.FirmwareVersion, original.FirmwareVersion), 0);
+    moca_static_cache_invalidate(&revalidating, gStaticCacheIfIndex);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&revalidating, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(strcmp(info.FirmwareVersion, "moca-sim-test"), 0);
+
+    UT_ASSERT_EQUAL(moca_sim_SetFirmwareVersion(gStaticCacheIfIndex, original.FirmwareVersion), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_get(&gStaticCache, gStaticCacheIfIndex, &info), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(memcmp(&info, &original, sizeof(info)), 0);
+    moca_static_cache_destroy(&revalidating);
+    moca_static_cache_destroy(&gStaticCache);
+
+    UT_LOG("Exiting test_l2_moca_hal_static_cache_Invalidation...");
+}
+
+/**
+* @brief Looks the static info up from several threads while the firmware is upgraded again and again.
+*
+* The writer numbers its upgrades and publishes the number of an upgrade once moca_sim_SetFirmwareVersion() returned.
+* A lookup is stale if the version it returns is older than the upgrade published before it started.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Start MOCA_STATIC_CACHE_READERS readers and an upgrading writer | One upgrade per millisecond | Threads start | Simulator only |
+* | 02 | Run for MOCA_STATIC_CACHE_DURATION_MS and stop | None | No stale lookup, no failure, hits | Simulator only |
+* | 03 | Restore the firmware | Original version | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_static_cache_NeverStale(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_static_cache_NeverStale...");
+
+    uint32_t readers = moca_bench_env_u32("MOCA_STATIC_CACHE_READERS", MOCA_STATIC_CACHE_DEFAULT_READERS,
+                                             MOCA_STATIC_CACHE_MAX_READERS);
+    uint32_t durationMs = moca_bench_env_u32("MOCA_STATIC_CACHE_DURATION_MS", MOCA_STATIC_CACHE_DEFAULT_DURATION_MS, 60000);
+    moca_static_cache_reader_t reader[MOCA_STATIC_CACHE_MAX_READERS];
+    moca_static_cache_reader_t total;
+    moca_static_cache_stats_t stats;
+    moca_static_info_t original;
+    uint64_t writerFailures = 0;
+    pthread_t writer;
+    uint32_t started, i;
+
+    UT_ASSERT_EQUAL(moca_IfGetStaticInfo(gStaticCacheIfIndex, &original), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, 0), STATUS_SUCCESS);
+    __atomic_store_n(&gStaticCacheUpgrades, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&gStaticCacheStop, 0, __ATOMIC_RELAXED);
+    UT_ASSERT_EQUAL(moca_static_cache_upgrade(0), STATUS_SUCCESS);
+
+    for (started = 0; started < readers; started++)
+    {
+        memset(&reader[started], 0, sizeof(reader[started]));
+        if (pthread_create(&reader[started].thread, NULL, moca_static_cache_reader_main, &reader[started]) != 0)
+        {
+            break;
+        }
+    }
+    UT_ASSERT_EQUAL(started, readers);
+    UT_ASSERT_EQUAL(pthread_create(&writer, NULL, moca_static_cache_writer_main, &writerFailures), 0);
+    moca_bench_sleep_ns((uint64_t)durationMs * 1000000ULL);
+    __atomic_store_n(&gStaticCacheStop, 1, __ATOMIC_RELAXED);
+    pthread_join(writer, NULL);
+
+    memset(&total, 0, sizeof(total));
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(reader[i].thread, NULL);
+        total.lookups += reader[i].lookups;
+        total.failures += reader[i].failures;
+        total.stale += reader[i].stale;
+    }
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_LOG("%u readers, %u upgrades: %llu lookups, %llu stale, %llu failed; %llu hits, %llu misses, %llu resets seen",
+           started, __atomic_load_n(&gStaticCacheUpgrades, __ATOMIC_RELAXED), (unsigned long long)total.lookups,
+           (unsigned long long)total.stale, (unsigned long long)total.failures, (unsigned long long)stats.hits,
+           (unsigned long long)stats.misses, (unsigned long long)stats.resets);
+    UT_ASSERT_EQUAL(writerFailures, 0);
+    UT_ASSERT_EQUAL(total.stale, 0);
+    UT_ASSERT_EQUAL(total.failures, 0);
+    UT_ASSERT_TRUE(__atomic_load_n(&gStaticCacheUpgrades, __ATOMIC_RELAXED) > 0);
+    UT_ASSERT_TRUE(stats.hits > 0);
+    moca_static_cache_destroy(&gStaticCache);
+
+    UT_ASSERT_EQUAL(moca_sim_SetFirmwareVersion(gStaticCacheIfIndex, original.FirmwareVersion), STATUS_SUCCESS);
+    UT_LOG("Exiting test_l2_moca_hal_static_cache_NeverStale...");
+}
+
+#endif /* MOCA_HAL_SIMULATOR */
+
+/**
+* @brief Measures a hit against the driver call it saves.
+*
+* A hit of a cache with revalidateMs 0 still reads moca_GetResetCount(), one with a revalidation interval only copies
+* the entry. The simulator answers moca_IfGetStaticInfo() from memory, as fast as a hit, so against the simulator the
+* driver call and a hit are timed again with MOCA_STATIC_CACHE_SLOW_DRIVER_US of latency added to
+* moca_IfGetStaticInfo(), as a driver reading the firmware would take.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 004
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Time moca_IfGetStaticInfo | ifIndex = 0 | STATUS_SUCCESS | Percentiles logged |
+* | 02 | Time hits with revalidateMs 0 | ifIndex = 0 | STATUS_SUCCESS, every lookup after the first a hit | Percentiles logged |
+* | 03 | Time hits with a revalidation interval | revalidateMs = MOCA_STATIC_CACHE_REVALIDATE_MS | STATUS_SUCCESS | Percentiles logged |
+* | 04 | Slow moca_IfGetStaticInfo down and time it and hits again | Fixed latency of MOCA_STATIC_CACHE_SLOW_DRIVER_US | STATUS_SUCCESS | Simulator only |
+* | 05 | Clear the fault | moca_sim_SetFault(MOCA_SIM_API_IfGetStaticInfo, NULL) | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_static_cache_Benchmark(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_static_cache_Benchmark...");
+
+    uint32_t iterations = moca_bench_iterations();
+    moca_static_cache_stats_t stats;
+#ifdef MOCA_HAL_SIMULATOR
+    moca_sim_fault_t slow;
+#endif
+
+    UT_ASSERT_EQUAL(moca_bench_run(moca_static_cache_op_Driver, NULL, iterations, &gStaticCacheHistogram), 0);
+    moca_bench_report("moca_IfGetStaticInfo", &gStaticCacheHistogram);
+
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_static_cache_op_Hit, NULL, iterations, &gStaticCacheHistogram), 0);
+    moca_bench_report("moca_static_cache_get", &gStaticCacheHistogram);
+    moca_static_cache_get_stats(&gStaticCache, &stats);
+    UT_LOG("%llu hits, %llu misses", (unsigned long long)stats.hits, (unsigned long long)stats.misses);
+    UT_ASSERT_EQUAL(stats.misses, 1);
+    moca_static_cache_destroy(&gStaticCache);
+
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, MOCA_STATIC_CACHE_REVALIDATE_MS), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_static_cache_op_Hit, NULL, iterations, &gStaticCacheHistogram), 0);
+    moca_bench_report("moca_static_cache_get revalidating", &gStaticCacheHistogram);
+    moca_static_cache_destroy(&gStaticCache);
+
+#ifdef MOCA_HAL_SIMULATOR
+    memset(&slow, 0, sizeof(slow));
+    slow.latency = MOCA_SIM_LATENCY_FIXED;
+    slow.minUs = MOCA_STATIC_CACHE_SLOW_DRIVER_US;
+    slow.maxUs = MOCA_STATIC_CACHE_SLOW_DRIVER_US;
+    UT_ASSERT_EQUAL(moca_sim_SetFault(MOCA_SIM_API_IfGetStaticInfo, &slow), STATUS_SUCCESS);
+    /* Every driver call takes MOCA_STATIC_CACHE_SLOW_DRIVER_US, fewer of them are enough */
+    iterations = (iterations / 10 > 0) ? iterations / 10 : 1;
+    UT_ASSERT_EQUAL(moca_bench_run(moca_static_cache_op_Driver, NULL, iterations, &gStaticCacheHistogram), 0);
+    moca_bench_report("moca_IfGetStaticInfo slow driver", &gStaticCacheHistogram);
+    UT_ASSERT_EQUAL(moca_static_cache_init(&gStaticCache, 0), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_static_cache_op_Hit, NULL, iterations, &gStaticCacheHistogram), 0);
+    moca_bench_report("moca_static_cache_get slow driver", &gStaticCacheHistogram);
+    moca_static_cache_destroy(&gStaticCache);
+    UT_ASSERT_EQUAL(moca_sim_SetFault(MOCA_SIM_API_IfGetStaticInfo, NULL), STATUS_SUCCESS);
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_static_cache_Benchmark...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_static_cache_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal static cache]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_static_cache_Lookup", test_l2_moca_hal_static_cache_Lookup);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_static_cache_Invalidation", test_l2_moca_hal_static_cache_Invalidation);
+    UT_add_test(pSuite, "l2_moca_hal_static_cache_NeverStale", test_l2_moca_hal_static_cache_NeverStale);
+#endif
+    UT_add_test(pSuite, "l2_moca_hal_static_cache_Benchmark", test_l2_moca_hal_static_cache_Benchmark);
+
+    return 0;
+}
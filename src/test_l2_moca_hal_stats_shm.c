@@ -0,0 +1,548 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_stats_shm.c
+* @page moca_hal_stats_shm Level 2 Shared Memory Statistics Tests
+*
+* ## Module's Role
+* This module checks the shared memory publication of moca_stats_shm.h. A publisher writes the
+* statistics and aggregate counters of an interface to a shared memory object, and readers in
+* other threads and processes copy them out under a sequence lock.
+*
+* Snapshots are checked for tearing by a writer that fills every counter of a snapshot with its
+* sequence number, while reader threads and a forked reader process copy it out as fast as they
+* can. A publisher restarting under an open reader must retire the old object rather than
+* shrink it, the reader then reopens the name. The benchmark compares the latency of a reader with the HAL calls each consumer makes
+* today, and the cost of a publication with and without readers running.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_SHM_READERS | Concurrent reader threads | 4 |
+* | MOCA_SHM_DURATION_MS | Run time of the concurrent read test | 500 |
+*
+* **Pre-Conditions:**  POSIX shared memory is available, /dev/shm on Linux.
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "moca_bench.h"
+#include "moca_stats_shm.h"
+
+#define MOCA_SHM_DEFAULT_READERS       4
+#define MOCA_SHM_MAX_READERS           64
+#define MOCA_SHM_DEFAULT_DURATION_MS   500
+#define MOCA_SHM_INTERFACES            2
+
+extern int init_moca_hal_init(void);
+
+typedef struct
+{
+    pthread_t thread;
+    moca_stats_shm_t shm;
+    uint64_t reads;
+    uint64_t failures;
+    uint64_t torn;
+    uint64_t regressions;           /**< Sequence went backwards */
+} moca_shm_reader_t;
+
+static ULONG gShmIfIndex = 0;
+static char gShmName[64];
+static moca_stats_shm_t gShmPublisher;
+static moca_stats_shm_t gShmReader;
+static int gShmStop = 0;
+static moca_bench_histogram_t gShmHistogram;
+static moca_bench_histogram_t gShmBaselineHistogram;
+
+/* Fills every counter with value, a reader seeing two different values got a torn copy */
+static void moca_shm_pattern(ULONG value, moca_stats_t *pStats, moca_aggregate_counters_t *pAggregateCounters)
+{
+    ULONG *pCounters = (ULONG *)pStats;
+    size_t i;
+
+    for (i = 0; i < sizeof(*pStats) / sizeof(ULONG); i++)
+    {
+        pCounters[i] = value;
+    }
+    pAggregateCounters->Tx = value;
+    pAggregateCounters->Rx = value;
+}
+
+static BOOL moca_shm_pattern_ok(const moca_stats_shm_snapshot_t *pSnapshot)
+{
+    const ULONG *pCounters = (const ULONG *)&pSnapshot->stats;
+    ULONG value = (ULONG)pSnapshot->sequence;
+    size_t i;
+
+    for (i = 0; i < sizeof(pSnapshot->stats) / sizeof(ULONG); i++)
+    {
+        if (pCounters[i] != value)
+        {
+            return FALSE;
+        }
+    }
+    return (pSnapshot->aggregateCounters.Tx == value && pSnapshot->aggregateCounters.Rx == value &&
+            pSnapshot->haveStats && pSnapshot->haveAggregateCounters) ? TRUE : FALSE;
+}
+
+/* Writes the pattern of the next sequence number to slot 0 */
+static INT moca_shm_write_next(moca_stats_shm_t *pShm)
+{
+    moca_stats_shm_snapshot_t current;
+    moca_stats_t stats;
+    moca_aggregate_counters_t aggregateCounters;
+    ULONG next = 1;
+
+    /* The publisher owns the slot, reading it back cannot race */
+    if (moca_stats_shm_read(pShm, 0, &current) == STATUS_SUCCESS)
+    {
+        next = (ULONG)(current.sequence + 1);
+    }
+    moca_shm_pattern(next, &stats, &aggregateCounters);
+    return moca_stats_shm_write(pShm, 0, gShmIfIndex, &stats, &aggregateCounters);
+}
+
+static void moca_shm_reader_check(moca_shm_reader_t *pReader, uint64_t *pLastSequence)
+{
+    moca_stats_shm_snapshot_t snapshot;
+
+    if (moca_stats_shm_read(&pReader->shm, 0, &snapshot) != STATUS_SUCCESS)
+    {
+        pReader->failures++;
+        return;
+    }
+    pReader->reads++;
+    pReader->torn += (moca_shm_pattern_ok(&snapshot) == FALSE);
+    pReader->regressions += (snapshot.sequence < *pLastSequence);
+    *pLastSequence = snapshot.sequence;
+}
+
+static void *moca_shm_reader_main(void *pArg)
+{
+    moca_shm_reader_t *pReader = (moca_shm_reader_t *)pArg;
+    uint64_t lastSequence = 0;
+
+    while (__atomic_load_n(&gShmStop, __ATOMIC_RELAXED) == 0)
+    {
+        moca_shm_reader_check(pReader, &lastSequence);
+    }
+    return NULL;
+}
+
+static void *moca_shm_writer_main(void *pArg)
+{
+    uint64_t *pWrites = (uint64_t *)pArg;
+
+    while (__atomic_load_n(&gShmStop, __ATOMIC_RELAXED) == 0)
+    {
+        if (moca_shm_write_next(&gShmPublisher) == STATUS_SUCCESS)
+        {
+            (*pWrites)++;
+        }
+    }
+    return NULL;
+}
+
+/* Starts count readers, each with its own read only mapping, returns how many started */
+static uint32_t moca_shm_start_readers(moca_shm_reader_t *pReaders, uint32_t count)
+{
+    uint32_t started;
+
+    for (started = 0; started < count; started++)
+    {
+        memset(&pReaders[started], 0, sizeof(pReaders[started]));
+        if (moca_stats_shm_open(gShmName, &pReaders[started].shm) != STATUS_SUCCESS)
+        {
+            break;
+        }
+        if (pthread_create(&pReaders[started].thread, NULL, moca_shm_reader_main, &pReaders[started]) != 0)
+        {
+            moca_stats_shm_close(&pReaders[started].shm);
+            break;
+        }
+    }
+    return started;
+}
+
+static void moca_shm_stop_readers(moca_shm_reader_t *pReaders, uint32_t count, moca_shm_reader_t *pTotal)
+{
+    uint32_t i;
+
+    memset(pTotal, 0, sizeof(*pTotal));
+    for (i = 0; i < count; i++)
+    {
+        pthread_join(pReaders[i].thread, NULL);
+        moca_stats_shm_close(&pReaders[i].shm);
+        pTotal->reads += pReaders[i].reads;
+        pTotal->failures += pReaders[i].failures;
+        pTotal->torn += pReaders[i].torn;
+        pTotal->regressions += pReaders[i].regressions;
+    }
+}
+
+static int moca_shm_setup(void)
+{
+    snprintf(gShmName, sizeof(gShmName), "/moca_hal_test_%ld", (long)getpid());
+    if (moca_stats_shm_create(gShmName, MOCA_SHM_INTERFACES, &gShmPublisher) != STATUS_SUCCESS)
+    {
+        return -1;
+    }
+    if (moca_stats_shm_open(gShmName, &gShmReader) != STATUS_SUCCESS)
+    {
+        moca_stats_shm_close(&gShmPublisher);
+        moca_stats_shm_unlink(gShmName);
+        return -1;
+    }
+    return 0;
+}
+
+static void moca_shm_teardown(void)
+{
+    moca_stats_shm_close(&gShmReader);
+    moca_stats_shm_close(&gShmPublisher);
+    moca_stats_shm_unlink(gShmName);
+}
+
+static int moca_shm_op_HalRead(void *pContext)
+{
+    (void)pContext;
+    moca_stats_t stats;
+    moca_aggregate_counters_t aggregateCounters;
+    INT status = moca_IfGetStats(gShmIfIndex, &stats);
+
+    return status | moca_IfGetExtAggrCounter(gShmIfIndex, &aggregateCounters);
+}
+
+static int moca_shm_op_Publish(void *pContext)
+{
+    (void)pContext;
+
+    return moca_stats_shm_publish(&gShmPublisher, 1, gShmIfIndex);
+}
+
+static int moca_shm_op_Write(void *pContext)
+{
+    (void)pContext;
+
+    return moca_shm_write_next(&gShmPublisher);
+}
+
+static int moca_shm_op_Read(void *pContext)
+{
+    (void)pContext;
+    moca_stats_shm_snapshot_t snapshot;
+
+    return moca_stats_shm_read(&gShmReader, 0, &snapshot);
+}
+
+/**
+* @brief Publishes the statistics of an interface and reads them back through a separate mapping.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 001
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Read slots before any publication | slot = 0, 1 and numInterfaces | STATUS_FAILURE | Should be successful |
+* | 02 | Publish slot 1 from the HAL and read it | ifIndex = 0 | STATUS_SUCCESS, sequence 1, both results present | Should be successful |
+* | 03 | Write known values to slot 0 and read them | Pattern 1, no aggregate counters | Values read back, haveAggregateCounters FALSE | Should be successful |
+* | 04 | Write through the read only mapping | Reader mapping | STATUS_FAILURE | Should be successful |
+* | 05 | Open a missing object | Unknown name | STATUS_FAILURE | Should be successful |
+* | 06 | Restart the publisher under the open reader | moca_stats_shm_create on the same name | Old mapping retired and still readable without a fault, reads fail | Should be successful |
+* | 07 | Reopen the reader and read the new object | Pattern 2 in slot 0 | Not retired, sequence 1, values read back | Should be successful |
+*/
+void test_l2_moca_hal_stats_shm_PublishRead(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stats_shm_PublishRead...");
+
+    moca_stats_shm_snapshot_t snapshot;
+    moca_stats_t stats, expected;
+    moca_aggregate_counters_t aggregateCounters;
+    moca_stats_shm_t missing;
+
+    if (moca_shm_setup() != 0)
+    {
+        UT_FAIL("Cannot create the shared memory object");
+        return;
+    }
+    UT_ASSERT_EQUAL(moca_stats_shm_interfaces(&gShmReader), MOCA_SHM_INTERFACES);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 0, &snapshot), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 1, &snapshot), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, MOCA_SHM_INTERFACES, &snapshot), STATUS_FAILURE);
+
+    UT_ASSERT_EQUAL(moca_stats_shm_publish(&gShmPublisher, 1, gShmIfIndex), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_IfGetStats(gShmIfIndex, &stats), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 1, &snapshot), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(snapshot.sequence, 1);
+    UT_ASSERT_EQUAL(snapshot.ifIndex, gShmIfIndex);
+    UT_ASSERT_TRUE(snapshot.haveStats);
+    UT_ASSERT_TRUE(snapshot.haveAggregateCounters);
+    UT_ASSERT_TRUE(snapshot.timestampNs > 0);
+    UT_LOG("Published BytesSent=%lu BytesReceived=%lu, read after BytesSent=%lu BytesReceived=%lu",
+           snapshot.stats.BytesSent, snapshot.stats.BytesReceived, stats.BytesSent, stats.BytesReceived);
+
+    moca_shm_pattern(1, &expected, &aggregateCounters);
+    UT_ASSERT_EQUAL(moca_stats_shm_write(&gShmPublisher, 0, gShmIfIndex, &expected, NULL), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 0, &snapshot), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(snapshot.sequence, 1);
+    UT_ASSERT_TRUE(snapshot.haveStats);
+    UT_ASSERT_FALSE(snapshot.haveAggregateCounters);
+    UT_ASSERT_EQUAL(memcmp(&snapshot.stats, &expected, sizeof(expected)), 0);
+
+    UT_ASSERT_EQUAL(moca_stats_shm_write(&gShmReader, 0, gShmIfIndex, &expected, NULL), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_stats_shm_open("/moca_hal_test_missing", &missing), STATUS_FAILURE);
+
+    moca_stats_shm_close(&gShmPublisher);
+    UT_ASSERT_EQUAL(moca_stats_shm_create(gShmName, MOCA_SHM_INTERFACES, &gShmPublisher), STATUS_SUCCESS);
+    UT_ASSERT_TRUE(moca_stats_shm_retired(&gShmReader));
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 0, &snapshot), STATUS_FAILURE);
+    UT_ASSERT_EQUAL(moca_stats_shm_interfaces(&gShmReader), MOCA_SHM_INTERFACES);
+
+    moca_stats_shm_close(&gShmReader);
+    UT_ASSERT_EQUAL(moca_stats_shm_open(gShmName, &gShmReader), STATUS_SUCCESS);
+    UT_ASSERT_FALSE(moca_stats_shm_retired(&gShmReader));
+    moca_shm_pattern(2, &expected, &aggregateCounters);
+    UT_ASSERT_EQUAL(moca_stats_shm_write(&gShmPublisher, 0, gShmIfIndex, &expected, &aggregateCounters), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(moca_stats_shm_read(&gShmReader, 0, &snapshot), STATUS_SUCCESS);
+    UT_ASSERT_EQUAL(snapshot.sequence, 1);
+    UT_ASSERT_EQUAL(memcmp(&snapshot.stats, &expected, sizeof(expected)), 0);
+
+    moca_shm_teardown();
+    UT_LOG("Exiting test_l2_moca_hal_stats_shm_PublishRead...");
+}
+
+/**
+* @brief Reads snapshots from many threads and another process while a writer updates them continuously.
+*
+* Every snapshot the writer publishes holds its sequence number in every counter, so any reader copy mixing two
+* publications is detected. Reads per second and publications per second are logged.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 002
+* **Priority:** High
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Fork a reader process mapping the object by name | Slot 0 | Exits with 0, no torn snapshot | Should be successful |
+* | 02 | Start MOCA_SHM_READERS reader threads and a writer thread for MOCA_SHM_DURATION_MS | Slot 0 | Every read consistent, sequence never goes backwards | Should be successful |
+*/
+void test_l2_moca_hal_stats_shm_ConcurrentReaders(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stats_shm_ConcurrentReaders...");
+
+    uint32_t numReaders = moca_bench_env_u32("MOCA_SHM_READERS", MOCA_SHM_DEFAULT_READERS, MOCA_SHM_MAX_READERS);
+    uint32_t durationMs = moca_bench_env_u32("MOCA_SHM_DURATION_MS", MOCA_SHM_DEFAULT_DURATION_MS, 60000);
+    moca_shm_reader_t *pReaders;
+    moca_shm_reader_t total;
+    pthread_t writer;
+    uint64_t writes = 0;
+    uint32_t started;
+    int childStatus = 0;
+    pid_t child;
+
+    if (moca_shm_setup() != 0)
+    {
+        UT_FAIL("Cannot create the shared memory object");
+        return;
+    }
+    pReaders = calloc(numReaders, sizeof(moca_shm_reader_t));
+    if (pReaders == NULL)
+    {
+        moca_shm_teardown();
+        UT_FAIL("Out of memory");
+        return;
+    }
+    UT_ASSERT_EQUAL(moca_shm_write_next(&gShmPublisher), STATUS_SUCCESS);
+    __atomic_store_n(&gShmStop, 0, __ATOMIC_RELAXED);
+
+    /* Forked before any thread exists, the child only maps the object and reads it */
+    child = fork();
+    if (child == 0)
+    {
+        moca_shm_reader_t reader;
+        uint64_t lastSequence = 0;
+        uint64_t deadline = moca_bench_now_ns() + (uint64_t)durationMs * 1000000ULL;
+
+        memset(&reader, 0, sizeof(reader));
+        if (moca_stats_shm_open(gShmName, &reader.shm) != STATUS_SUCCESS)
+        {
+            _exit(2);
+        }
+        while (moca_bench_now_ns() < deadline)
+        {
+            moca_shm_reader_check(&reader, &lastSequence);
+        }
+        _exit((reader.torn != 0 || reader.regressions != 0 || reader.reads == 0) ? 1 : 0);
+    }
+    UT_ASSERT_TRUE(child > 0);
+
+    started = moca_shm_start_readers(pReaders, numReaders);
+    UT_ASSERT_EQUAL(started, numReaders);
+    UT_ASSERT_EQUAL(pthread_create(&writer, NULL, moca_shm_writer_main, &writes), 0);
+    moca_bench_sleep_ns((uint64_t)durationMs * 1000000ULL);
+    __atomic_store_n(&gShmStop, 1, __ATOMIC_RELAXED);
+    pthread_join(writer, NULL);
+    moca_shm_stop_readers(pReaders, started, &total);
+    if (child > 0)
+    {
+        waitpid(child, &childStatus, 0);
+        UT_LOG("Reader process exit status: %d", WIFEXITED(childStatus) ? WEXITSTATUS(childStatus) : -1);
+        UT_ASSERT_TRUE(WIFEXITED(childStatus) && WEXITSTATUS(childStatus) == 0);
+    }
+
+    UT_LOG("readers=%u writes=%llu writes/s=%.0f reads=%llu reads/s=%.0f busy=%llu torn=%llu regressions=%llu",
+           started, (unsigned long long)writes, (double)writes * 1000.0 / durationMs, (unsigned long long)total.reads,
+           (double)total.reads * 1000.0 / durationMs, (unsigned long long)total.failures, (unsigned long long)total.torn,
+           (unsigned long long)total.regressions);
+    UT_ASSERT_TRUE(writes > 0);
+    UT_ASSERT_TRUE(total.reads > 0);
+    UT_ASSERT_EQUAL(total.torn, 0);
+    UT_ASSERT_EQUAL(total.regressions, 0);
+
+    free(pReaders);
+    moca_shm_teardown();
+    UT_LOG("Exiting test_l2_moca_hal_stats_shm_ConcurrentReaders...");
+}
+
+/**
+* @brief Measures the latency of a reader and the overhead of the publisher.
+*
+* The reader is compared with moca_IfGetStats() followed by moca_IfGetExtAggrCounter(), the calls every consumer
+* makes without the shared memory object. Reads are then timed with a writer updating the slot continuously and
+* MOCA_SHM_READERS - 1 other readers, and writes with MOCA_SHM_READERS readers, the worst case for each side.
+*
+* **Test Group ID:** Module: 02
+* **Test Case ID:** 003
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Time the HAL calls and a publication from the HAL | ifIndex = 0 | STATUS_SUCCESS | Percentiles logged |
+* | 02 | Time writes and reads without contention | Slot 0 | STATUS_SUCCESS | Percentiles logged |
+* | 03 | Time reads with a busy writer and other readers | MOCA_SHM_READERS - 1 readers | STATUS_SUCCESS | Percentiles logged |
+* | 04 | Time writes with readers | MOCA_SHM_READERS readers | STATUS_SUCCESS | Percentiles logged |
+*/
+void test_l2_moca_hal_stats_shm_Benchmark(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stats_shm_Benchmark...");
+
+    uint32_t numReaders = moca_bench_env_u32("MOCA_SHM_READERS", MOCA_SHM_DEFAULT_READERS, MOCA_SHM_MAX_READERS);
+    uint32_t iterations = moca_bench_iterations();
+    moca_shm_reader_t *pReaders;
+    moca_shm_reader_t total;
+    pthread_t writer;
+    uint64_t writes = 0;
+    uint32_t started;
+    char name[64];
+
+    if (moca_shm_setup() != 0)
+    {
+        UT_FAIL("Cannot create the shared memory object");
+        return;
+    }
+    pReaders = calloc(numReaders, sizeof(moca_shm_reader_t));
+    if (pReaders == NULL)
+    {
+        moca_shm_teardown();
+        UT_FAIL("Out of memory");
+        return;
+    }
+
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_HalRead, NULL, iterations, &gShmBaselineHistogram), 0);
+    moca_bench_report("moca_IfGetStats+moca_IfGetExtAggrCounter", &gShmBaselineHistogram);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_Publish, NULL, iterations, &gShmHistogram), 0);
+    moca_bench_report("moca_stats_shm_publish", &gShmHistogram);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_Write, NULL, iterations, &gShmHistogram), 0);
+    moca_bench_report("moca_stats_shm_write", &gShmHistogram);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_Read, NULL, iterations, &gShmHistogram), 0);
+    moca_bench_report("moca_stats_shm_read", &gShmHistogram);
+    UT_LOG("p50 of a read against the HAL calls: %llu ns against %llu ns",
+           (unsigned long long)moca_bench_histogram_percentile(&gShmHistogram, 50.0),
+           (unsigned long long)moca_bench_histogram_percentile(&gShmBaselineHistogram, 50.0));
+
+    __atomic_store_n(&gShmStop, 0, __ATOMIC_RELAXED);
+    started = moca_shm_start_readers(pReaders, numReaders - 1);
+    UT_ASSERT_EQUAL(started, numReaders - 1);
+    UT_ASSERT_EQUAL(pthread_create(&writer, NULL, moca_shm_writer_main, &writes), 0);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_Read, NULL, iterations, &gShmHistogram), 0);
+    __atomic_store_n(&gShmStop, 1, __ATOMIC_RELAXED);
+    pthread_join(writer, NULL);
+    moca_shm_stop_readers(pReaders, started, &total);
+    snprintf(name, sizeof(name), "moca_stats_shm_read readers=%u writer=busy", numReaders);
+    moca_bench_report(name, &gShmHistogram);
+    UT_ASSERT_EQUAL(total.torn, 0);
+
+    __atomic_store_n(&gShmStop, 0, __ATOMIC_RELAXED);
+    started = moca_shm_start_readers(pReaders, numReaders);
+    UT_ASSERT_EQUAL(started, numReaders);
+    UT_ASSERT_EQUAL(moca_bench_run(moca_shm_op_Write, NULL, iterations, &gShmHistogram), 0);
+    __atomic_store_n(&gShmStop, 1, __ATOMIC_RELAXED);
+    moca_shm_stop_readers(pReaders, started, &total);
+    snprintf(name, sizeof(name), "moca_stats_shm_write readers=%u", numReaders);
+    moca_bench_report(name, &gShmHistogram);
+    UT_ASSERT_EQUAL(total.torn, 0);
+
+    free(pReaders);
+    moca_shm_teardown();
+    UT_LOG("Exiting test_l2_moca_hal_stats_shm_Benchmark...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_stats_shm_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal stats shm]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_stats_shm_PublishRead", test_l2_moca_hal_stats_shm_PublishRead);
+    UT_add_test(pSuite, "l2_moca_hal_stats_shm_ConcurrentReaders", test_l2_moca_hal_stats_shm_ConcurrentReaders);
+    UT_add_test(pSuite, "l2_moca_hal_stats_shm_Benchmark", test_l2_moca_hal_stats_shm_Benchmark);
+
+    return 0;
+}
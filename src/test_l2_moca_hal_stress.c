@@ -0,0 +1,572 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_l2_moca_hal_stress.c
+* @page moca_hal_stress Level 2 Concurrency Stress Tests
+*
+* ## Module's Role
+* This module calls the read-side moca_hal APIs that a management agent polls
+* (moca_IfGetStats, moca_IfGetDynamicInfo, moca_GetAssociatedDevices) from 1, 2, 4 ... up to
+* MOCA_STRESS_MAX_THREADS threads at once. For every thread count it reports the aggregate
+* calls per second, the scaling efficiency against a single thread and the p99 latency
+* under contention. A HAL that serialises on a global lock shows an efficiency close to
+* 1 / threads.
+*
+* Every result is checked for consistency while it is read:
+* - moca_IfGetStats counters must never go backwards within a thread, other than a 32 bit wrap
+* - moca_IfGetDynamicInfo must keep reporting the same NodeID and NetworkCoordinator
+* - moca_GetAssociatedDevices must return valid, unique node IDs
+*
+* Against the skeleton simulator the mixed load is also run with latency, errors and hangs
+* injected into the driver (moca_sim_SetFault()), to show how pollers degrade on a slow driver.
+*
+* | Variable | Description | Default |
+* | -------- | ----------- | ------- |
+* | MOCA_STRESS_MAX_THREADS | Highest thread count tried | 8 |
+* | MOCA_STRESS_DURATION_MS | Run time per thread count | 250 |
+*
+* **Pre-Conditions:**  The network topology must not change while the suite runs.
+* **Dependencies:** None
+*
+* Ref to API Definition specification documentation : [halSpec.md](../../../docs/halSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "moca_hal.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include "moca_bench.h"
+#ifdef MOCA_HAL_SIMULATOR
+#include "moca_hal_sim.h"
+#endif
+
+#define MOCA_STRESS_DEFAULT_MAX_THREADS   8
+#define MOCA_STRESS_DEFAULT_DURATION_MS   250
+#define MOCA_STRESS_MAX_THREADS_LIMIT     64
+#define MOCA_STRESS_LOW_EFFICIENCY        0.5
+#define MOCA_STRESS_WRAP_THRESHOLD        0x80000000UL
+
+extern int init_moca_hal_init(void);
+
+typedef struct moca_stress_thread moca_stress_thread_t;
+typedef INT (*moca_stress_reader_t)(moca_stress_thread_t *pThread);
+
+struct moca_stress_thread
+{
+    pthread_t thread;
+    moca_stress_reader_t reader;
+    uint64_t calls;
+    uint64_t failures;
+    uint64_t inconsistencies;
+    moca_bench_histogram_t histogram;
+    /* Per reader consistency state */
+    BOOL haveStats;
+    moca_stats_t lastStats;
+    BOOL haveDynamicInfo;
+    ULONG nodeId;
+    ULONG networkCoordinator;
+    uint32_t nextReader;
+};
+
+static ULONG gStressIfIndex = 0;
+static int gStressGo = 0;
+static int gStressStop = 0;
+
+/* A counter may only move forward, or wrap from the top half of a 32 bit register */
+static BOOL moca_stress_counter_ok(ULONG previous, ULONG current)
+{
+    return (current >= previous) || (previous >= MOCA_STRESS_WRAP_THRESHOLD && current < MOCA_STRESS_WRAP_THRESHOLD);
+}
+
+static INT moca_stress_read_stats(moca_stress_thread_t *pThread)
+{
+    moca_stats_t stats;
+    INT status = moca_IfGetStats(gStressIfIndex, &stats);
+
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    if (pThread->haveStats)
+    {
+        const moca_stats_t *pLast = &pThread->lastStats;
+
+        if (!moca_stress_counter_ok(pLast->BytesSent, stats.BytesSent) ||
+            !moca_stress_counter_ok(pLast->BytesReceived, stats.BytesReceived) ||
+            !moca_stress_counter_ok(pLast->PacketsSent, stats.PacketsSent) ||
+            !moca_stress_counter_ok(pLast->PacketsReceived, stats.PacketsReceived) ||
+            !moca_stress_counter_ok(pLast->UnicastPacketsSent, stats.UnicastPacketsSent) ||
+            !moca_stress_counter_ok(pLast->UnicastPacketsReceived, stats.UnicastPacketsReceived))
+        {
+            pThread->inconsistencies++;
+        }
+    }
+    pThread->lastStats = stats;
+    pThread->haveStats = TRUE;
+    return status;
+}
+
+static INT moca_stress_read_dynamic_info(moca_stress_thread_t *pThread)
+{
+    moca_dynamic_info_t dynamicInfo;
+    INT status = moca_IfGetDynamicInfo(gStressIfIndex, &dynamicInfo);
+
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    if (dynamicInfo.NodeID >= kMoca_MaxMocaNodes || dynamicInfo.NetworkCoordinator >= kMoca_MaxMocaNodes)
+    {
+        pThread->inconsistencies++;
+    }
+    else if (pThread->haveDynamicInfo &&
+             (dynamicInfo.NodeID != pThread->nodeId || dynamicInfo.NetworkCoordinator != pThread->networkCoordinator))
+    {
+        pThread->inconsistencies++;
+    }
+    pThread->nodeId = dynamicInfo.NodeID;
+    pThread->networkCoordinator = dynamicInfo.NetworkCoordinator;
+    pThread->haveDynamicInfo = TRUE;
+    return status;
+}
+
+static INT moca_stress_read_associated_devices(moca_stress_thread_t *pThread)
+{
+    moca_associated_device_t *pDevices = NULL;
+    ULONG count = 0;
+    uint32_t seen = 0;
+    ULONG i;
+    INT status;
+
+    status = moca_GetNumAssociatedDevices(gStressIfIndex, &count);
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    status = moca_GetAssociatedDevices(gStressIfIndex, &pDevices);
+    if (status != STATUS_SUCCESS)
+    {
+        return status;
+    }
+    if (count > 0 && pDevices == NULL)
+    {
+        pThread->inconsistencies++;
+    }
+    for (i = 0; pDevices != NULL && i < count; i++)
+    {
+        ULONG nodeId = pDevices[i].NodeID;
+
+        if (nodeId >= kMoca_MaxMocaNodes || (seen & (1u << nodeId)) != 0)
+        {
+            pThread->inconsistencies++;
+            break;
+        }
+        seen |= 1u << nodeId;
+    }
+    free(pDevices);
+    return status;
+}
+
+static INT moca_stress_read_mixed(moca_stress_thread_t *pThread)
+{
+    static const moca_stress_reader_t readers[] =
+    {
+        moca_stress_read_stats,
+        moca_stress_read_dynamic_info,
+        moca_stress_read_associated_devices
+    };
+
+    return readers[pThread->nextReader++ % (sizeof(readers) / sizeof(readers[0]))](pThread);
+}
+
+static void *moca_stress_thread_main(void *pArg)
+{
+    moca_stress_thread_t *pThread = (moca_stress_thread_t *)pArg;
+
+    /* Spin until every thread exists so they all start contending together */
+    while (__atomic_load_n(&gStressGo, __ATOMIC_ACQUIRE) == 0)
+    {
+        sched_yield();
+    }
+    while (__atomic_load_n(&gStressStop, __ATOMIC_RELAXED) == 0)
+    {
+        uint64_t start = moca_bench_now_ns();
+        INT status = pThread->reader(pThread);
+
+        moca_bench_histogram_record(&pThread->histogram, moca_bench_now_ns() - start);
+        pThread->calls++;
+        if (status != STATUS_SUCCESS)
+        {
+            pThread->failures++;
+        }
+    }
+    return NULL;
+}
+
+/* Runs reader on numThreads threads for durationMs, returns aggregate calls per second and optionally the p99 latency */
+static double moca_stress_run(const char *pApi, moca_stress_reader_t reader, uint32_t numThreads, uint32_t durationMs,
+                              uint64_t *pFailures, uint64_t *pInconsistencies, uint64_t *pP99Ns)
+{
+    moca_stress_thread_t *pThreads = calloc(numThreads, sizeof(moca_stress_thread_t));
+    moca_bench_histogram_t *pMerged = malloc(sizeof(moca_bench_histogram_t));
+    uint64_t calls = 0;
+    uint64_t begin, elapsed;
+    uint32_t started = 0;
+    uint32_t i;
+    double callsPerSec;
+
+    if (pThreads == NULL || pMerged == NULL)
+    {
+        free(pThreads);
+        free(pMerged);
+        UT_FAIL("Out of memory");
+        return 0.0;
+    }
+    moca_bench_histogram_reset(pMerged);
+    __atomic_store_n(&gStressGo, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&gStressStop, 0, __ATOMIC_RELAXED);
+    for (i = 0; i < numThreads; i++)
+    {
+        pThreads[i].reader = reader;
+        moca_bench_histogram_reset(&pThreads[i].histogram);
+        if (pthread_create(&pThreads[i].thread, NULL, moca_stress_thread_main, &pThreads[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started < numThreads)
+    {
+        UT_FAIL("pthread_create failed");
+    }
+
+    begin = moca_bench_now_ns();
+    __atomic_store_n(&gStressGo, 1, __ATOMIC_RELEASE);
+    moca_bench_sleep_ns((uint64_t)durationMs * 1000000ULL);
+    __atomic_store_n(&gStressStop, 1, __ATOMIC_RELAXED);
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(pThreads[i].thread, NULL);
+        calls += pThreads[i].calls;
+        *pFailures += pThreads[i].failures;
+        *pInconsistencies += pThreads[i].inconsistencies;
+        moca_bench_histogram_merge(pMerged, &pThreads[i].histogram);
+    }
+    elapsed = moca_bench_now_ns() - begin;
+
+    callsPerSec = (double)calls * 1e9 / (double)elapsed;
+    UT_LOG("%s threads=%u calls=%llu calls/s=%.0f p50=%lluns p99=%lluns",
+           pApi, numThreads, (unsigned long long)calls, callsPerSec,
+           (unsigned long long)moca_bench_histogram_percentile(pMerged, 50.0),
+           (unsigned long long)moca_bench_histogram_percentile(pMerged, 99.0));
+    if (pP99Ns != NULL)
+    {
+        *pP99Ns = moca_bench_histogram_percentile(pMerged, 99.0);
+    }
+
+    free(pMerged);
+    free(pThreads);
+    return callsPerSec;
+}
+
+/* Scales reader from one thread up to MOCA_STRESS_MAX_THREADS and checks every result was consistent */
+static void moca_stress_scale(const char *pApi, moca_stress_reader_t reader)
+{
+    uint32_t maxThreads = moca_bench_env_u32("MOCA_STRESS_MAX_THREADS", MOCA_STRESS_DEFAULT_MAX_THREADS, MOCA_STRESS_MAX_THREADS_LIMIT);
+    uint32_t durationMs = moca_bench_env_u32("MOCA_STRESS_DURATION_MS", MOCA_STRESS_DEFAULT_DURATION_MS, 60000);
+    uint64_t failures = 0;
+    uint64_t inconsistencies = 0;
+    double baseline = 0.0;
+    uint32_t threads;
+
+    for (threads = 1; ; threads = (threads * 2 < maxThreads) ? threads * 2 : maxThreads)
+    {
+        double callsPerSec = moca_stress_run(pApi, reader, threads, durationMs, &failures, &inconsistencies, NULL);
+
+        if (threads == 1)
+        {
+            baseline = callsPerSec;
+        }
+        else
+        {
+            double efficiency = (baseline > 0.0) ? callsPerSec / (baseline * threads) : 0.0;
+
+            UT_LOG("%s threads=%u scaling efficiency=%.2f", pApi, threads, efficiency);
+            if (efficiency < MOCA_STRESS_LOW_EFFICIENCY)
+            {
+                UT_LOG("%s scales poorly at %u threads, the HAL may serialise callers", pApi, threads);
+            }
+        }
+        if (threads >= maxThreads)
+        {
+            break;
+        }
+    }
+
+    UT_LOG("Failed calls: %llu, inconsistent results: %llu", (unsigned long long)failures, (unsigned long long)inconsistencies);
+    UT_ASSERT_EQUAL(failures, 0);
+    UT_ASSERT_EQUAL(inconsistencies, 0);
+}
+
+/**
+* @brief Stresses moca_IfGetStats from an increasing number of concurrent threads.
+*
+* Measures aggregate throughput and scaling efficiency while checking that no thread observes
+* a counter going backwards, which would indicate a torn read.
+*
+* **Test Group ID:** Stress: 03
+* **Test Case ID:** 001
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Call moca_IfGetStats from 1 .. MOCA_STRESS_MAX_THREADS threads | ifIndex = 0 | All calls return STATUS_SUCCESS, counters monotonic per thread | Throughput and efficiency logged |
+*/
+void test_l2_moca_hal_stress_IfGetStats(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stress_IfGetStats...");
+
+    moca_stress_scale("moca_IfGetStats", moca_stress_read_stats);
+
+    UT_LOG("Exiting test_l2_moca_hal_stress_IfGetStats...");
+}
+
+/**
+* @brief Stresses moca_IfGetDynamicInfo from an increasing number of concurrent threads.
+*
+* Measures aggregate throughput and scaling efficiency while checking that the node identity
+* reported stays stable across concurrent reads.
+*
+* **Test Group ID:** Stress: 03
+* **Test Case ID:** 002
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Call moca_IfGetDynamicInfo from 1 .. MOCA_STRESS_MAX_THREADS threads | ifIndex = 0 | All calls return STATUS_SUCCESS, NodeID and NetworkCoordinator stable | Throughput and efficiency logged |
+*/
+void test_l2_moca_hal_stress_IfGetDynamicInfo(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stress_IfGetDynamicInfo...");
+
+    moca_stress_scale("moca_IfGetDynamicInfo", moca_stress_read_dynamic_info);
+
+    UT_LOG("Exiting test_l2_moca_hal_stress_IfGetDynamicInfo...");
+}
+
+/**
+* @brief Stresses moca_GetAssociatedDevices from an increasing number of concurrent threads.
+*
+* Each call reads the device count, fetches and frees the device array, and checks the node IDs
+* returned are valid and unique.
+*
+* **Test Group ID:** Stress: 03
+* **Test Case ID:** 003
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Call moca_GetNumAssociatedDevices and moca_GetAssociatedDevices from 1 .. MOCA_STRESS_MAX_THREADS threads | ifIndex = 0 | All calls return STATUS_SUCCESS, node IDs valid and unique | Throughput and efficiency logged |
+*/
+void test_l2_moca_hal_stress_GetAssociatedDevices(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stress_GetAssociatedDevices...");
+
+    moca_stress_scale("moca_GetAssociatedDevices", moca_stress_read_associated_devices);
+
+    UT_LOG("Exiting test_l2_moca_hal_stress_GetAssociatedDevices...");
+}
+
+/**
+* @brief Stresses a mix of the three polled APIs from an increasing number of concurrent threads.
+*
+* Every thread rotates through moca_IfGetStats, moca_IfGetDynamicInfo and moca_GetAssociatedDevices,
+* as an agent with several pollers would.
+*
+* **Test Group ID:** Stress: 03
+* **Test Case ID:** 004
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Rotate through the three APIs from 1 .. MOCA_STRESS_MAX_THREADS threads | ifIndex = 0 | All calls return STATUS_SUCCESS, all results consistent | Throughput and efficiency logged |
+*/
+void test_l2_moca_hal_stress_Mixed(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stress_Mixed...");
+
+    moca_stress_scale("mixed", moca_stress_read_mixed);
+
+    UT_LOG("Exiting test_l2_moca_hal_stress_Mixed...");
+}
+
+#ifdef MOCA_HAL_SIMULATOR
+/* Sum of the errors injected into the APIs the mixed reader calls */
+static uint64_t moca_stress_injected_errors(void)
+{
+    static const moca_sim_api_t apis[] =
+    {
+        MOCA_SIM_API_IfGetStats,
+        MOCA_SIM_API_IfGetDynamicInfo,
+        MOCA_SIM_API_GetNumAssociatedDevices,
+        MOCA_SIM_API_GetAssociatedDevices
+    };
+    moca_sim_fault_stats_t stats;
+    uint64_t errors = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(apis) / sizeof(apis[0]); i++)
+    {
+        if (moca_sim_GetFaultStats(apis[i], &stats) == STATUS_SUCCESS)
+        {
+            errors += stats.errors;
+        }
+    }
+    return errors;
+}
+#endif
+
+/**
+* @brief Runs the mixed poll load against a simulated slow and unreliable driver.
+*
+* Real drivers block on firmware mailboxes, so a few calls take orders of magnitude longer than
+* the rest, some fail and some stall. The simulator injects long tail latency, errors and bounded
+* hangs into every API and the mixed load is rerun under each, logging throughput and p99 against
+* a clean run. Every failure seen must be one the simulator injected, and results must stay consistent.
+*
+* **Test Group ID:** Stress: 03
+* **Test Case ID:** 005
+* **Priority:** Medium
+*
+* **Pre-Conditions:** None
+* **Dependencies:** None
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
+*
+* **Test Procedure:**
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Run the mixed load without faults | 4 threads, MOCA_STRESS_DURATION_MS | No failures, all results consistent | Simulator only |
+* | 02 | Add long tail latency to every API and rerun | min = 20us, max = 100ms, tail = 10% | No failures, all results consistent | Throughput and p99 logged |
+* | 03 | Also fail 1% of the calls and rerun | errorPpm = 10000 | Failures equal the errors injected, all results consistent | Simulator only |
+* | 04 | Replace with bounded hangs and rerun | hangPpm = 100, hangMs = 50 | No failures, all results consistent | Simulator only |
+* | 05 | Clear the faults | moca_sim_SetFault(MOCA_SIM_API_ALL, NULL) | STATUS_SUCCESS | Simulator only |
+*/
+void test_l2_moca_hal_stress_SlowDriver(void)
+{
+    UT_LOG("Entering test_l2_moca_hal_stress_SlowDriver...");
+
+#ifdef MOCA_HAL_SIMULATOR
+    static const struct
+    {
+        const char *pName;
+        moca_sim_fault_t fault;
+    } scenarios[] =
+    {
+        { "clean", { MOCA_SIM_LATENCY_NONE, 0, 0, 0, 0, 0, 0 } },
+        { "long tail", { MOCA_SIM_LATENCY_LONG_TAIL, 20, 100000, 10, 0, 0, 0 } },
+        { "long tail with errors", { MOCA_SIM_LATENCY_LONG_TAIL, 20, 100000, 10, 10000, 0, 0 } },
+        { "bounded hangs", { MOCA_SIM_LATENCY_NONE, 0, 0, 0, 0, 100, 50 } }
+    };
+    uint32_t maxThreads = moca_bench_env_u32("MOCA_STRESS_MAX_THREADS", MOCA_STRESS_DEFAULT_MAX_THREADS, MOCA_STRESS_MAX_THREADS_LIMIT);
+    uint32_t durationMs = moca_bench_env_u32("MOCA_STRESS_DURATION_MS", MOCA_STRESS_DEFAULT_DURATION_MS, 60000);
+    uint32_t threads = (maxThreads < 4) ? maxThreads : 4;
+    double cleanCallsPerSec = 0.0;
+    uint64_t cleanP99Ns = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        uint64_t failures = 0;
+        uint64_t inconsistencies = 0;
+        uint64_t p99Ns = 0;
+        uint64_t errors;
+        double callsPerSec;
+
+        UT_ASSERT_EQUAL(moca_sim_SetFault(MOCA_SIM_API_ALL, (i == 0) ? NULL : &scenarios[i].fault), STATUS_SUCCESS);
+        errors = moca_stress_injected_errors();
+        callsPerSec = moca_stress_run(scenarios[i].pName, moca_stress_read_mixed, threads, durationMs, &failures, &inconsistencies, &p99Ns);
+        errors = moca_stress_injected_errors() - errors;
+
+        if (i == 0)
+        {
+            cleanCallsPerSec = callsPerSec;
+            cleanP99Ns = p99Ns;
+        }
+        else
+        {
+            UT_LOG("%s throughput=%.2fx p99=%.1fx of clean", scenarios[i].pName,
+                   (cleanCallsPerSec > 0.0) ? callsPerSec / cleanCallsPerSec : 0.0,
+                   (cleanP99Ns > 0) ? (double)p99Ns / (double)cleanP99Ns : 0.0);
+        }
+        UT_LOG("%s failed calls: %llu, injected errors: %llu, inconsistent results: %llu", scenarios[i].pName,
+               (unsigned long long)failures, (unsigned long long)errors, (unsigned long long)inconsistencies);
+        UT_ASSERT_EQUAL(failures, errors);
+        UT_ASSERT_EQUAL(inconsistencies, 0);
+    }
+    UT_ASSERT_EQUAL(moca_sim_SetFault(MOCA_SIM_API_ALL, NULL), STATUS_SUCCESS);
+#else
+    UT_LOG("Fault injection needs the skeleton simulator, test skipped");
+#endif
+
+    UT_LOG("Exiting test_l2_moca_hal_stress_SlowDriver...");
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+int test_moca_hal_stress_register(void)
+{
+    // Create the test suite
+    pSuite = UT_add_suite("[L2 moca_hal stress]", init_moca_hal_init, NULL);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    // List of test function names and strings
+    UT_add_test(pSuite, "l2_moca_hal_stress_IfGetStats", test_l2_moca_hal_stress_IfGetStats);
+    UT_add_test(pSuite, "l2_moca_hal_stress_IfGetDynamicInfo", test_l2_moca_hal_stress_IfGetDynamicInfo);
+    UT_add_test(pSuite, "l2_moca_hal_stress_GetAssociatedDevices", test_l2_moca_hal_stress_GetAssociatedDevices);
+    UT_add_test(pSuite, "l2_moca_hal_stress_Mixed", test_l2_moca_hal_stress_Mixed);
+#ifdef MOCA_HAL_SIMULATOR
+    UT_add_test(pSuite, "l2_moca_hal_stress_SlowDriver", test_l2_moca_hal_stress_SlowDriver);
+#endif
+
+    return 0;
+}
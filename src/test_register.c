@@ -19,11 +19,33 @@
 /* L1 Testing Functions */
 extern int test_moca_hal_register(void);
 
+/* L2 Testing Functions */
+extern int test_moca_hal_benchmark_register(void);
+extern int test_moca_hal_stress_register(void);
+extern int test_moca_hal_callback_register(void);
+extern int test_moca_hal_multi_interface_register(void);
+extern int test_moca_hal_poller_register(void);
+extern int test_moca_hal_stats_shm_register(void);
+extern int test_moca_hal_event_ring_register(void);
+extern int test_moca_hal_counters_register(void);
+extern int test_moca_hal_static_cache_register(void);
+extern int test_moca_hal_config_register(void);
+
 int register_hal_tests( void )
 {
     int registerFailed=0;
 
     registerFailed |= test_moca_hal_register();
+    registerFailed |= test_moca_hal_benchmark_register();
+    registerFailed |= test_moca_hal_stress_register();
+    registerFailed |= test_moca_hal_callback_register();
+    registerFailed |= test_moca_hal_multi_interface_register();
+    registerFailed |= test_moca_hal_poller_register();
+    registerFailed |= test_moca_hal_stats_shm_register();
+    registerFailed |= test_moca_hal_event_ring_register();
+    registerFailed |= test_moca_hal_counters_register();
+    registerFailed |= test_moca_hal_static_cache_register();
+    registerFailed |= test_moca_hal_config_register();
 
     return registerFailed;
 }